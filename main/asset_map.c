@@ -0,0 +1,97 @@
+#include "asset_map.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "asset_map";
+
+// 映射后的镜像
+static const uint8_t *asset_image = NULL;
+static uint32_t asset_image_size = 0;
+static esp_partition_mmap_handle_t asset_mmap_handle;
+
+/**
+ * 校验镜像头和索引表的范围
+ */
+static bool asset_check(const void *image, uint32_t image_size) {
+    const asset_header_t *header = image;
+    if (image_size < sizeof(*header) || memcmp(header->magic, ASSET_MAGIC, 4) != 0) {
+        return false;
+    }
+    // 声明的大小比头部还小时下面的减法会回绕
+    if (header->size > image_size || header->size < sizeof(*header)) {
+        return false;
+    }
+    return (header->size - sizeof(*header)) / sizeof(asset_entry_t) >= header->count;
+}
+
+const void *asset_map_find(const void *image, uint32_t image_size, const char *name, uint32_t *size) {
+    if (image == NULL || !asset_check(image, image_size)) {
+        return NULL;
+    }
+    const asset_header_t *header = image;
+    const asset_entry_t *entries = (const asset_entry_t *)&header[1];
+    // 索引按名字排好序，二分查找
+    uint32_t lo = 0, hi = header->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        int cmp = strncmp(name, entries[mid].name, ASSET_NAME_LEN);
+        if (cmp == 0) {
+            const asset_entry_t *entry = &entries[mid];
+            if (entry->offset > header->size || entry->size > header->size - entry->offset) {
+                return NULL;
+            }
+            if (size) {
+                *size = entry->size;
+            }
+            return (const uint8_t *)image + entry->offset;
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t asset_map_init(void) {
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSET_PART_SUBTYPE,
+                                                           ASSET_PART_LABEL);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "partition %s not found", ASSET_PART_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // 先读头确定镜像大小，只映射用到的部分，节省MMU页
+    asset_header_t header;
+    esp_err_t ret = esp_partition_read(part, 0, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (memcmp(header.magic, ASSET_MAGIC, 4) != 0 || header.size > part->size) {
+        ESP_LOGW(TAG, "no asset image in partition %s", ASSET_PART_LABEL);
+        return ESP_ERR_INVALID_STATE;
+    }
+    const void *ptr = NULL;
+    ret = esp_partition_mmap(part, 0, header.size, ESP_PARTITION_MMAP_DATA, &ptr, &asset_mmap_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "mmap %s fail: %s", ASSET_PART_LABEL, esp_err_to_name(ret));
+        return ret;
+    }
+    if (!asset_check(ptr, header.size)) {
+        ESP_LOGW(TAG, "invalid asset index");
+        esp_partition_munmap(asset_mmap_handle);
+        return ESP_ERR_INVALID_STATE;
+    }
+    asset_image = ptr;
+    asset_image_size = header.size;
+    ESP_LOGI(TAG, "mapped %" PRIu32 " assets, %" PRIu32 " bytes", header.count, header.size);
+    return ESP_OK;
+}
+
+const void *asset_map_get(const char *name, uint32_t *size) {
+    return asset_map_find(asset_image, asset_image_size, name, size);
+}
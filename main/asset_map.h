@@ -0,0 +1,49 @@
+#ifndef __ASSET_MAP_H__
+#define __ASSET_MAP_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// 资源镜像魔数
+#define ASSET_MAGIC           "AST1"
+// 资源名最大长度(含结尾0)，如 "pack/disdain_out.epk"
+#define ASSET_NAME_LEN        32
+// 每个资源数据的对齐字节数
+#define ASSET_ALIGN           4
+
+// 资源镜像头(格式见 tools/asset_pack.py)
+typedef struct {
+    char     magic[4];
+    uint32_t count;              // 资源个数
+    uint32_t size;               // 整个镜像的字节数
+    uint32_t reserved;
+} asset_header_t;
+
+// 索引项，按name升序排列
+typedef struct {
+    char     name[ASSET_NAME_LEN];
+    uint32_t offset;             // 数据相对镜像开头的偏移
+    uint32_t size;               // 数据字节数
+} asset_entry_t;
+
+/**
+ * 把资源分区只读映射到地址空间，分区不存在或镜像无效时返回错误，之后 asset_map_get 都找不到
+ */
+esp_err_t asset_map_init(void);
+
+/**
+ * 按名字(如 "gif/blink_once.gif")查找资源，返回映射在flash中的数据指针，不拷贝
+ * @param name 资源名
+ * @param size 返回数据字节数，可为NULL
+ * @return     数据指针，找不到返回NULL
+ */
+const void *asset_map_get(const char *name, uint32_t *size);
+
+/**
+ * 在内存中的资源镜像里查找资源，不依赖分区，主机端也可使用
+ * @param image      镜像起始地址
+ * @param image_size 镜像可访问的字节数
+ */
+const void *asset_map_find(const void *image, uint32_t image_size, const char *name, uint32_t *size);
+
+#endif
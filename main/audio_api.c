@@ -1,104 +1,452 @@
 #include "audio_api.h"
 #include "esp_log.h"
 #include "stdio.h"
+#include <inttypes.h>
 #include <sys/stat.h>
-#include "d_speak.h"
+#include <string.h>
+#include "audio_stream.h"
+#include "audio_mixer.h"
+#include "audio_codec.h"
+#include "asset_map.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <sys/param.h>
 
 const static char *TAG = "audio_api";
 
+#define AUDIO_PLAY_TASK_STACK     4096
+// 和音频流任务一样，低于混音任务
+#define AUDIO_PLAY_TASK_PRIORITY  4
+#define AUDIO_PLAY_QUEUE_LEN      4
+// 读取WAV头的字节数，data 块要在这之内
+#define AUDIO_PLAY_HEAD_SIZE      256
+
+// 一个声部上的本地播放，只在本地播放任务中修改
+typedef struct {
+    audio_play_handle_t handle;  // 0为空闲
+    audio_play_cfg_t cfg;
+    const uint8_t *data;         // 映射的资源，NULL时从 file 读
+    FILE *file;
+    uint32_t data_offset;        // 文件中PCM数据的起点
+    uint32_t size;               // PCM数据字节数(偶数)
+    uint32_t pos;                // 这一遍已写入混音器的字节数
+    uint32_t written;            // 开始以来写入混音器的字节数
+    uint32_t buf_pos;            // 读取缓冲中已写入混音器的字节数
+    uint32_t buf_len;
+    bool draining;               // 不再写入，等混音器取完或者淡出结束
+    bool stopping;               // 已让混音器淡出，淡出时继续写入
+    TickType_t progress_tick;
+} audio_play_slot_t;
+
+typedef struct {
+    bool stop;
+    audio_play_slot_t slot;      // 开始时是准备好的播放，停止时只用 handle
+} audio_play_cmd_t;
+
+static const char *const play_result_names[] = {"done", "stopped", "error"};
+
+static audio_play_slot_t play_slots[AUDIO_MIXER_VOICES];
+// 声部正在淡出停止时，等它结束再开始的播放
+static audio_play_slot_t play_next[AUDIO_MIXER_VOICES];
+static uint8_t play_bufs[AUDIO_MIXER_VOICES][AUDIO_PLAY_BUF_SIZE];
+static QueueHandle_t play_cmd_q;
+static TaskHandle_t play_task_handle;
+static atomic_uint play_gen;
+
+// 出错时已经写入混音器的数据照常播完
+static void play_finish(audio_play_slot_t *slot, audio_play_result_t result) {
+    if (slot->file) {
+        fclose(slot->file);
+    }
+    audio_play_slot_t done = *slot;
+    memset(slot, 0, sizeof(*slot));
+    ESP_LOGI(TAG, "play %" PRIu32 " %s: %" PRIu32 " bytes", done.handle, play_result_names[result], done.written);
+    if (done.cfg.on_done) {
+        done.cfg.on_done(done.handle, result, done.cfg.arg);
+    }
+}
+
+static void play_stop_slot(audio_play_slot_t *slot) {
+    if (!slot->stopping) {
+        slot->stopping = true;
+        audio_mixer_stop(slot->cfg.voice);
+    }
+}
+
+/**
+ * 往声部写入能放下的数据，不等待
+ * @return 有没有进展(写入了数据或者状态变化)
+ */
+static bool play_feed(audio_play_slot_t *slot) {
+    int voice = slot->cfg.voice;
+    if (slot->stopping && !audio_mixer_stopping(voice)) {
+        play_finish(slot, AUDIO_PLAY_STOPPED);
+        return true;
+    }
+    if (slot->draining) {
+        if (!slot->stopping && audio_mixer_pending(voice) == 0) {
+            play_finish(slot, AUDIO_PLAY_DONE);
+            return true;
+        }
+        return false;
+    }
+    const uint8_t *p;
+    uint32_t len;
+    if (slot->data) {
+        p = slot->data + slot->pos;
+        len = slot->size - slot->pos;
+    } else {
+        if (slot->buf_pos == slot->buf_len && slot->pos < slot->size) {
+            uint8_t *buf = play_bufs[voice];
+            size_t got = fread(buf, 1, MIN(AUDIO_PLAY_BUF_SIZE, slot->size - slot->pos), slot->file);
+            if (got == 0 && ferror(slot->file)) {
+                ESP_LOGE(TAG, "play %" PRIu32 ": read fail at %" PRIu32, slot->handle, slot->data_offset + slot->pos);
+                play_finish(slot, AUDIO_PLAY_ERROR);
+                return true;
+            }
+            // 文件比头中写的短时就播到文件末尾，奇数字节的最后一个丢弃
+            if (got < 2) {
+                slot->size = slot->pos;
+            }
+            slot->buf_pos = 0;
+            slot->buf_len = got & ~1u;
+        }
+        p = play_bufs[voice] + slot->buf_pos;
+        len = slot->buf_len - slot->buf_pos;
+    }
+    if (slot->pos >= slot->size) {
+        if (!slot->cfg.loop || slot->size == 0) {
+            slot->draining = true;
+            return true;
+        }
+        slot->pos = 0;
+        slot->buf_pos = slot->buf_len = 0;
+        if (slot->file && fseek(slot->file, slot->data_offset, SEEK_SET) != 0) {
+            play_finish(slot, AUDIO_PLAY_ERROR);
+        }
+        return true;
+    }
+    uint32_t n = audio_mixer_write(voice, (const int16_t *)p, len / 2, 0) * 2;
+    slot->pos += n;
+    slot->written += n;
+    slot->buf_pos += slot->data ? 0 : n;
+    if (slot->stopping && n && !audio_mixer_stopping(voice)) {
+        // 淡出在写入之前刚结束，这些数据不能再播，再淡出一次(增益已是0)丢弃它们
+        audio_mixer_stop(voice);
+        slot->draining = true;
+        return true;
+    }
+    TickType_t now = xTaskGetTickCount();
+    if (n && slot->cfg.on_progress && now - slot->progress_tick >= pdMS_TO_TICKS(AUDIO_PLAY_PROGRESS_MS)) {
+        slot->progress_tick = now;
+        slot->cfg.on_progress(slot->handle, slot->written - audio_mixer_pending(voice) * 2, slot->size,
+                              slot->cfg.arg);
+    }
+    return n > 0;
+}
+
+static void audio_play_task(void *arg) {
+    while (1) {
+        audio_play_cmd_t cmd;
+        while (xQueueReceive(play_cmd_q, &cmd, 0) == pdTRUE) {
+            int voice = cmd.slot.handle % AUDIO_MIXER_VOICES;
+            audio_play_slot_t *slot = &play_slots[voice];
+            audio_play_slot_t *next = &play_next[voice];
+            if (cmd.stop) {
+                if (slot->handle == cmd.slot.handle) {
+                    play_stop_slot(slot);
+                } else if (next->handle == cmd.slot.handle) {
+                    play_finish(next, AUDIO_PLAY_STOPPED);
+                }
+                continue;
+            }
+            // 同一声部上的播放先淡出，结束后再开始新的
+            if (next->handle) {
+                play_finish(next, AUDIO_PLAY_STOPPED);
+            }
+            *next = cmd.slot;
+            if (slot->handle) {
+                play_stop_slot(slot);
+            }
+        }
+        // 写到所有声部都放不下为止，之后等混音器取走数据、淡出结束或者新的命令
+        bool progress = false;
+        for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+            if (play_slots[v].handle == 0 && play_next[v].handle) {
+                play_slots[v] = play_next[v];
+                play_slots[v].progress_tick = xTaskGetTickCount();
+                memset(&play_next[v], 0, sizeof(play_next[v]));
+            }
+            if (play_slots[v].handle) {
+                progress |= play_feed(&play_slots[v]);
+            }
+        }
+        if (!progress) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+esp_err_t audio_play_init(void) {
+    play_cmd_q = xQueueCreate(AUDIO_PLAY_QUEUE_LEN, sizeof(audio_play_cmd_t));
+    if (play_cmd_q == NULL || xTaskCreatePinnedToCore(audio_play_task, "audio_play", AUDIO_PLAY_TASK_STACK, NULL,
+                                                      AUDIO_PLAY_TASK_PRIORITY, &play_task_handle,
+                                                      AUDIO_STREAM_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+        if (v != AUDIO_VOICE_STREAM) {
+            audio_mixer_set_notify(v, play_task_handle);
+        }
+    }
+    return ESP_OK;
+}
+
 /**
- * 播放本地pcm
+ * 检查WAV头，只支持与混音器相同的格式，返回PCM数据的位置；不是WAV时整个文件都是PCM
  */
+static esp_err_t play_parse_head(const uint8_t *head, size_t len, uint32_t *offset, uint32_t *size) {
+    wav_info_t info;
+    if (len < 12 || memcmp(head, "RIFF", 4) != 0 || memcmp(head + 8, "WAVE", 4) != 0) {
+        *offset = 0;
+        return ESP_OK;
+    }
+    if (!wav_head_info(head, len, &info)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (info.audio_format != AUDIO_WAVE_FORMAT_PCM || info.bits_per_sample != 16 || info.num_channels != 1 ||
+        info.sample_rate != SPK_SAMPLE_RATE) {
+        ESP_LOGE(TAG, "local playback needs %d Hz 16 bit mono PCM", SPK_SAMPLE_RATE);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    *offset = info.data_offset;
+    *size = MIN(*size - info.data_offset, info.data_size);
+    return ESP_OK;
+}
+
+esp_err_t audio_play_start(const char *path, const audio_play_cfg_t *cfg, audio_play_handle_t *handle) {
+    if (play_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg->voice < 0 || cfg->voice >= AUDIO_MIXER_VOICES || cfg->voice == AUDIO_VOICE_STREAM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    audio_play_cmd_t cmd = {.stop = false, .slot = {.cfg = *cfg}};
+    audio_play_slot_t *slot = &cmd.slot;
+    esp_err_t err;
+    // 资源分区中有同名资源(去掉/spiffs/前缀)时直接播放映射的数据，不经过文件系统也不拷贝
+    const char *name = strncmp(path, "/spiffs/", 8) == 0 ? path + 8 : path;
+    slot->data = asset_map_get(name, &slot->size);
+    if (slot->data) {
+        err = play_parse_head(slot->data, MIN(slot->size, AUDIO_PLAY_HEAD_SIZE), &slot->data_offset, &slot->size);
+        slot->data += slot->data_offset;
+    } else {
+        struct stat st;
+        slot->file = stat(path, &st) == 0 ? fopen(path, "rb") : NULL;
+        if (slot->file == NULL) {
+            ESP_LOGE(TAG, "file: %s open fail!", path);
+            return ESP_ERR_NOT_FOUND;
+        }
+        slot->size = st.st_size;
+        uint8_t head[AUDIO_PLAY_HEAD_SIZE];
+        size_t len = fread(head, 1, sizeof(head), slot->file);
+        err = play_parse_head(head, len, &slot->data_offset, &slot->size);
+        if (err == ESP_OK && fseek(slot->file, slot->data_offset, SEEK_SET) != 0) {
+            err = ESP_FAIL;
+        }
+    }
+    slot->size &= ~1u;
+    if (err == ESP_OK) {
+        slot->handle = (atomic_fetch_add(&play_gen, 1) + 1) * AUDIO_MIXER_VOICES + cfg->voice;
+        err = xQueueSend(play_cmd_q, &cmd, pdMS_TO_TICKS(100)) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+    }
+    if (err != ESP_OK) {
+        if (slot->file) {
+            fclose(slot->file);
+        }
+        return err;
+    }
+    ESP_LOGI(TAG, "play %" PRIu32 ": %s (%s, %" PRIu32 " bytes) on voice %d", slot->handle, path, slot->data ? "mapped" : "file",
+             slot->size, cfg->voice);
+    xTaskNotifyGive(play_task_handle);
+    if (handle) {
+        *handle = slot->handle;
+    }
+    return ESP_OK;
+}
+
+void audio_play_stop(audio_play_handle_t handle) {
+    if (play_task_handle == NULL || handle == 0) {
+        return;
+    }
+    audio_play_cmd_t cmd = {.stop = true, .slot = {.handle = handle}};
+    if (xQueueSend(play_cmd_q, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
+        xTaskNotifyGive(play_task_handle);
+    }
+}
+
+static void play_local_done(audio_play_handle_t handle, audio_play_result_t result, void *arg) {
+    xSemaphoreGive((SemaphoreHandle_t)arg);
+}
+
 void audio_play_local(const char *path) {
-  const size_t write_size_byte = 4096;
-  struct stat st;
-  if(stat(path, &st) == 0)
-  {
-      ESP_LOGI(TAG,"file: %s filesize:%ld", path, st.st_size);
-  }
-  FILE *f = fopen(path, "r");
-  if(!f)
-  {
-      ESP_LOGI(TAG,"file: %s open fail!", path);
-      return;
-  }
-  ESP_LOGI(TAG,"start play: %s", path);
-  uint8_t *i2s_write_buff = malloc(write_size_byte);
-  if(!i2s_write_buff)
-  {
-      fclose(f);
-      return;
-  }
-  size_t read_byte = 0;
-  do
-  {
-      fread(i2s_write_buff,write_size_byte,1, f);
-      read_byte += speak_write(i2s_write_buff, write_size_byte);
-      vTaskDelay(pdMS_TO_TICKS(5));
-  } while (read_byte < st.st_size);
-  free(i2s_write_buff);
-  fclose(f);
-  ESP_LOGI(TAG,"play finished: %s", path);
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    if (done == NULL) {
+        return;
+    }
+    audio_play_cfg_t cfg = AUDIO_PLAY_CFG_DEFAULT();
+    cfg.on_done = play_local_done;
+    cfg.arg = done;
+    if (audio_play_start(path, &cfg, NULL) == ESP_OK) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+}
+
+static uint16_t rd16(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
 }
 
 /**
- * 获取 wav 头信息
+ * 获取 wav 头信息: 依次查找 fmt 块和 data 块，跳过其他块(ADPCM 的 fact、LIST 等)，
+ * data 块之前的内容必须都在 data 中
  */
-wav_header_t *wav_head_info(const uint8_t *data, size_t size) {
-    if(size < sizeof(wav_header_t)) {
-        ESP_LOGE(TAG, "Failed to read WAV header");
-        return NULL;
-    }
-    wav_header_t *header = (wav_header_t *)data;
-
-    // 检查RIFF头
-    if (memcmp(header->chunk_id, "RIFF", 4) != 0) {
-        ESP_LOGE(TAG, "Invalid WAV file: Not a RIFF file");
-        return NULL;
-    }
-    // 检查WAVE格式
-    if (memcmp(header->format, "WAVE", 4) != 0) {
-        ESP_LOGE(TAG, "Invalid WAV file: Not a WAVE file");
-        return NULL;
-    }
-    // 检查fmt块
-    if (memcmp(header->fmtchunk_id, "fmt ", 4) != 0) {
-        ESP_LOGE(TAG, "Invalid WAV file: fmt chunk not found");
-        return NULL;
-    }
-    // 检查音频格式
-    if (header->audio_format != 1) {
-        ESP_LOGE(TAG, "Unsupported audio format: %d (only PCM supported)", header->audio_format);
-        return NULL;
-    }
-    // 检查数据块
-    if (memcmp(header->datachunk_id, "data", 4) != 0) {
-        ESP_LOGE(TAG, "Invalid WAV file: data chunk not found");
-        return NULL;
-    }
-    
-    ESP_LOGI(TAG, "WAV File Info:");
-    ESP_LOGI(TAG, "  Sample Rate: %d Hz", header->sample_rate);
-    ESP_LOGI(TAG, "  Channels: %d", header->num_channels);
-    ESP_LOGI(TAG, "  Bits per Sample: %d", header->bits_per_sample);
-    ESP_LOGI(TAG, "  Data Size: %d bytes", header->datachunk_size);
-    
-    return header;
+bool wav_head_info(const uint8_t *data, size_t size, wav_info_t *info) {
+    // 检查RIFF头和WAVE格式
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        ESP_LOGE(TAG, "Invalid WAV file: Not a RIFF WAVE file");
+        return false;
+    }
+    memset(info, 0, sizeof(*info));
+    bool has_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = data + pos;
+        uint32_t chunk_size = rd32(chunk + 4);
+        if (memcmp(chunk, "data", 4) == 0) {
+            if (!has_fmt) {
+                break;
+            }
+            info->data_offset = pos + 8;
+            info->data_size = chunk_size;
+            ESP_LOGI(TAG, "WAV File Info:");
+            ESP_LOGI(TAG, "  Format: 0x%04x", info->audio_format);
+            ESP_LOGI(TAG, "  Sample Rate: %" PRIu32 " Hz", info->sample_rate);
+            ESP_LOGI(TAG, "  Channels: %d", info->num_channels);
+            ESP_LOGI(TAG, "  Bits per Sample: %d", info->bits_per_sample);
+            ESP_LOGI(TAG, "  Data Size: %" PRIu32 " bytes", info->data_size);
+            return true;
+        }
+        if (chunk_size > size - pos - 8) {
+            break;
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+            info->audio_format = rd16(chunk + 8);
+            info->num_channels = rd16(chunk + 10);
+            info->sample_rate = rd32(chunk + 12);
+            info->block_align = rd16(chunk + 20);
+            info->bits_per_sample = rd16(chunk + 22);
+            has_fmt = true;
+        }
+        // 块按偶数字节对齐
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+    ESP_LOGE(TAG, "Invalid WAV file: %s chunk not found", has_fmt ? "data" : "fmt");
+    return false;
 }
 
+// /ws 收到的流的解码器，只在httpd任务中使用
+static audio_codec_t wb_codec;
+static bool wb_stream_ok = false;
+
 /**
- * wav流数据播放
+ * 按WAV头选择解码器并开始一个新的流，解码后都是16位PCM(PCM原样播放)
+ */
+static esp_err_t audio_wb_begin(const wav_info_t *info) {
+    uint32_t bits = info->bits_per_sample;
+    uint32_t length = info->data_size == 0xffffffff ? 0 : info->data_size;
+    audio_codec_type_t type;
+    switch (info->audio_format) {
+        case AUDIO_WAVE_FORMAT_PCM:
+            type = AUDIO_CODEC_PCM;
+            break;
+        case AUDIO_WAVE_FORMAT_MULAW:
+            if (bits != 8) {
+                goto unsupported;
+            }
+            type = AUDIO_CODEC_MULAW;
+            bits = 16;
+            length *= 2;
+            break;
+        case AUDIO_WAVE_FORMAT_IMA_ADPCM:
+            if (bits != 4 || info->num_channels != 1 || audio_codec_adpcm_block_samples(info->block_align) == 0) {
+                goto unsupported;
+            }
+            type = AUDIO_CODEC_IMA_ADPCM;
+            bits = 16;
+            // 最后一块可能不完整
+            length = length / info->block_align * audio_codec_adpcm_block_samples(info->block_align) * 2 +
+                     (length % info->block_align ? audio_codec_adpcm_block_samples(length % info->block_align) * 2 : 0);
+            break;
+        default:
+            goto unsupported;
+    }
+    audio_codec_init(&wb_codec, type, info->block_align);
+    return audio_stream_begin(info->sample_rate, bits, info->num_channels, length);
+unsupported:
+    ESP_LOGE(TAG, "Unsupported audio format: 0x%04x, %d bits, %d channels", info->audio_format,
+             info->bits_per_sample, info->num_channels);
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+/**
+ * 解码后直接写进音频流的环形缓冲，放不下的输入丢弃
+ */
+static void audio_wb_decode(const uint8_t *data, size_t len) {
+    if (wb_codec.type == AUDIO_CODEC_PCM) {
+        // PCM 不用解码，按帧写入和丢弃，帧可能不是2字节
+        audio_stream_write(data, len);
+        return;
+    }
+    while (len) {
+        uint8_t *buf;
+        size_t room = audio_stream_prepare(&buf);
+        size_t used;
+        size_t n = audio_codec_decode(&wb_codec, data, len, &used, buf, room);
+        audio_stream_commit(n);
+        if (n == 0 && used == 0) {
+            break;
+        }
+        data += used;
+        len -= used;
+    }
+    // 放不下的输入不经过解码器，让解码器跳过它们，ADPCM之后的块头才能对上
+    audio_codec_skip(&wb_codec, len);
+    audio_stream_drop(len);
+}
+
+/**
+ * wav流数据播放: 以WAV头开始的数据开始一个新的流，按头中的格式(PCM、mu-law、IMA-ADPCM)解码后
+ * 交给音频流任务播放，这里不会阻塞
  */
-wav_header_t *wav_header = NULL;
 void audio_play_wb(uint8_t *data, int len) {
-    if(wav_header){
-        speak_write(data, len);
-    }else{
-        wav_header = wav_head_info(data, len);
-        if (wav_header){
-            speak_cfg_change(wav_header->sample_rate, wav_header->bits_per_sample, wav_header->num_channels);
+    wav_info_t info;
+    if (len >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WAVE", 4) == 0) {
+        wb_stream_ok = wav_head_info(data, len, &info) && audio_wb_begin(&info) == ESP_OK;
+        if (wb_stream_ok) {
+            audio_wb_decode(data + info.data_offset, len - info.data_offset);
         }
+        return;
+    }
+    // 格式不支持的流丢弃
+    if (wb_stream_ok) {
+        audio_wb_decode(data, len);
     }
 }
@@ -1,30 +1,72 @@
 #ifndef __AUDIO_API_H__
 #define __AUDIO_API_H__
 
+#include <stdbool.h>
 #include <stdio.h>
+#include "esp_err.h"
 #include "freertos/FreeRTOS.h"
+#include "config.h"
 
-// WAV文件头结构
+// WAV头中播放需要的信息
 typedef struct {
-    char     chunk_id[4];        // "RIFF"
-    uint32_t chunk_size;         // 文件大小-8
-    char     format[4];          // "WAVE"
-    char     fmtchunk_id[4];     // "fmt "
-    uint32_t fmtchunk_size;      // fmt块大小 (16 for PCM)
-    uint16_t audio_format;       // 音频格式 (1 = PCM)
+    uint16_t audio_format;       // 音频格式 (1 = PCM, 7 = mu-law, 0x11 = IMA-ADPCM，见 audio_codec.h)
     uint16_t num_channels;       // 声道数
     uint32_t sample_rate;        // 采样率
-    uint32_t byte_rate;          // 字节率
-    uint16_t block_align;        // 块对齐
-    uint16_t bits_per_sample;    // 位深度
-    char     datachunk_id[4];    // "data"
-    uint32_t datachunk_size;     // 数据块大小
-} wav_header_t;
+    uint16_t block_align;        // 块对齐(ADPCM为一块的字节数)
+    uint16_t bits_per_sample;    // 位深度(ADPCM为4，mu-law为8)
+    uint32_t data_offset;        // 数据在文件中的偏移
+    uint32_t data_size;          // 数据块大小
+} wav_info_t;
 
+// 本地播放的句柄，0为无效
+typedef uint32_t audio_play_handle_t;
+
+typedef enum {
+    AUDIO_PLAY_DONE = 0,         // 数据全部播完(混音器已取完)
+    AUDIO_PLAY_STOPPED,          // 被 audio_play_stop 或同一声部的新播放停止
+    AUDIO_PLAY_ERROR,            // 读取文件失败
+} audio_play_result_t;
+
+// 回调在本地播放任务中调用，不能阻塞
+typedef void (*audio_play_done_cb_t)(audio_play_handle_t handle, audio_play_result_t result, void *arg);
+// played 为开始以来播放的字节数(循环时会超过 total)，total 为一遍的字节数
+typedef void (*audio_play_progress_cb_t)(audio_play_handle_t handle, uint32_t played, uint32_t total, void *arg);
+
+typedef struct {
+    int voice;                   // 混音器声部，不能是 AUDIO_VOICE_STREAM
+    bool loop;                   // 循环播放到 audio_play_stop
+    audio_play_done_cb_t on_done;
+    audio_play_progress_cb_t on_progress;  // 最多每 AUDIO_PLAY_PROGRESS_MS 调用一次
+    void *arg;
+} audio_play_cfg_t;
+
+#define AUDIO_PLAY_CFG_DEFAULT() { .voice = AUDIO_VOICE_EFFECT }
+
+/**
+ * 创建本地播放任务，需在 audio_mixer_init 之后调用
+ */
+esp_err_t audio_play_init(void);
+
+/**
+ * 开始播放本地PCM或WAV(SPK_SAMPLE_RATE 16位单声道PCM)，不阻塞。
+ * 资源分区中有同名资源(去掉/spiffs/前缀)时直接从映射的flash写入混音器，否则从文件系统读。
+ * 同一声部正在播放的会被停止(淡出后开始新的)
+ * @param handle 返回句柄，可为NULL
+ */
+esp_err_t audio_play_start(const char *path, const audio_play_cfg_t *cfg, audio_play_handle_t *handle);
+
+/**
+ * 停止播放，按声部的渐变时长淡出，句柄已结束时什么也不做
+ */
+void audio_play_stop(audio_play_handle_t handle);
+
+/**
+ * 在音效声部播放本地PCM，播完才返回
+ */
 void audio_play_local(const char *path);
 
 void audio_play_wb(uint8_t *data, int len);
 
-wav_header_t *wav_head_info(const uint8_t *data, size_t size);
+bool wav_head_info(const uint8_t *data, size_t size, wav_info_t *info);
 
 #endif
\ No newline at end of file
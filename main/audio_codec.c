@@ -0,0 +1,211 @@
+#include "audio_codec.h"
+#include <string.h>
+#include <sys/param.h>
+
+#define ADPCM_STEPS         89
+#define ADPCM_BLOCK_HEADER  4
+
+// G.711 mu-law 解码表
+static const int16_t mulaw_table[256] = {
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956,
+    -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764,
+    -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+    -11900, -11388, -10876, -10364,  -9852,  -9340,  -8828,  -8316,
+     -7932,  -7676,  -7420,  -7164,  -6908,  -6652,  -6396,  -6140,
+     -5884,  -5628,  -5372,  -5116,  -4860,  -4604,  -4348,  -4092,
+     -3900,  -3772,  -3644,  -3516,  -3388,  -3260,  -3132,  -3004,
+     -2876,  -2748,  -2620,  -2492,  -2364,  -2236,  -2108,  -1980,
+     -1884,  -1820,  -1756,  -1692,  -1628,  -1564,  -1500,  -1436,
+     -1372,  -1308,  -1244,  -1180,  -1116,  -1052,   -988,   -924,
+      -876,   -844,   -812,   -780,   -748,   -716,   -684,   -652,
+      -620,   -588,   -556,   -524,   -492,   -460,   -428,   -396,
+      -372,   -356,   -340,   -324,   -308,   -292,   -276,   -260,
+      -244,   -228,   -212,   -196,   -180,   -164,   -148,   -132,
+      -120,   -112,   -104,    -96,    -88,    -80,    -72,    -64,
+       -56,    -48,    -40,    -32,    -24,    -16,     -8,      0,
+     32124,  31100,  30076,  29052,  28028,  27004,  25980,  24956,
+     23932,  22908,  21884,  20860,  19836,  18812,  17788,  16764,
+     15996,  15484,  14972,  14460,  13948,  13436,  12924,  12412,
+     11900,  11388,  10876,  10364,   9852,   9340,   8828,   8316,
+      7932,   7676,   7420,   7164,   6908,   6652,   6396,   6140,
+      5884,   5628,   5372,   5116,   4860,   4604,   4348,   4092,
+      3900,   3772,   3644,   3516,   3388,   3260,   3132,   3004,
+      2876,   2748,   2620,   2492,   2364,   2236,   2108,   1980,
+      1884,   1820,   1756,   1692,   1628,   1564,   1500,   1436,
+      1372,   1308,   1244,   1180,   1116,   1052,    988,    924,
+       876,    844,    812,    780,    748,    716,    684,    652,
+       620,    588,    556,    524,    492,    460,    428,    396,
+       372,    356,    340,    324,    308,    292,    276,    260,
+       244,    228,    212,    196,    180,    164,    148,    132,
+       120,    112,    104,     96,     88,     80,     72,     64,
+        56,     48,     40,     32,     24,     16,      8,      0
+};
+
+// IMA-ADPCM 步长表
+static const int16_t adpcm_step_table[ADPCM_STEPS] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+// 4位码的低3位对步长索引的调整，符号位不影响
+static const int8_t adpcm_index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// 按 [步长索引][码的低3位] 预先算好的差值和下一个步长索引，每个采样只查两次表，不用移位累加和索引钳位。
+// 差值与标准的 step>>3 + step>>2 + step>>1 + step 逐位累加完全相同，最大 61436，用 uint16_t 存
+static uint16_t adpcm_diff[ADPCM_STEPS][8];
+static uint8_t adpcm_next[ADPCM_STEPS][8];
+static bool adpcm_tables_ready;
+
+static void adpcm_tables_init(void) {
+    for (int i = 0; i < ADPCM_STEPS; i++) {
+        int32_t step = adpcm_step_table[i];
+        for (int n = 0; n < 8; n++) {
+            int32_t diff = step >> 3;
+            if (n & 4) {
+                diff += step;
+            }
+            if (n & 2) {
+                diff += step >> 1;
+            }
+            if (n & 1) {
+                diff += step >> 2;
+            }
+            adpcm_diff[i][n] = diff;
+            adpcm_next[i][n] = MIN(MAX(i + adpcm_index_table[n], 0), ADPCM_STEPS - 1);
+        }
+    }
+    adpcm_tables_ready = true;
+}
+
+void audio_codec_init(audio_codec_t *codec, audio_codec_type_t type, uint16_t block_align) {
+    memset(codec, 0, sizeof(*codec));
+    codec->type = type;
+    codec->block_align = MAX(block_align, ADPCM_BLOCK_HEADER + 1);
+    if (type == AUDIO_CODEC_IMA_ADPCM && !adpcm_tables_ready) {
+        adpcm_tables_init();
+    }
+}
+
+uint32_t audio_codec_adpcm_block_samples(uint16_t block_align) {
+    return block_align > ADPCM_BLOCK_HEADER ? (block_align - ADPCM_BLOCK_HEADER) * 2 + 1 : 0;
+}
+
+static inline void put_sample(uint8_t *out, int32_t s) {
+    out[0] = (uint8_t)s;
+    out[1] = (uint8_t)(s >> 8);
+}
+
+static inline int32_t adpcm_nibble(int32_t *predictor, int32_t *index, uint32_t code) {
+    int32_t diff = adpcm_diff[*index][code & 7];
+    int32_t p = code & 8 ? *predictor - diff : *predictor + diff;
+    p = p < -32768 ? -32768 : (p > 32767 ? 32767 : p);
+    *predictor = p;
+    *index = adpcm_next[*index][code & 7];
+    return p;
+}
+
+static size_t adpcm_decode(audio_codec_t *c, const uint8_t *in, size_t in_len, size_t *in_used, uint8_t *out,
+                           size_t out_len) {
+    size_t i = 0;
+    size_t o = 0;
+    int32_t predictor = c->predictor;
+    int32_t index = c->index;
+    uint32_t pos = c->block_pos;
+    if (c->skip) {
+        i = MIN(c->skip, in_len);
+        c->skip -= i;
+    }
+    while (i < in_len) {
+        if (pos < ADPCM_BLOCK_HEADER) {
+            // 块头: 第一个采样原样输出，并重置预测值和步长索引
+            c->header[pos++] = in[i++];
+            if (pos == ADPCM_BLOCK_HEADER) {
+                predictor = (int16_t)(c->header[0] | c->header[1] << 8);
+                index = MIN(c->header[2], ADPCM_STEPS - 1);
+                if (o + 2 > out_len) {
+                    c->pending = predictor;
+                    c->has_pending = true;
+                    break;
+                }
+                put_sample(out + o, predictor);
+                o += 2;
+            }
+            continue;
+        }
+        if (o + 2 > out_len) {
+            break;
+        }
+        // 一个字节两个采样，低4位在前
+        uint32_t b = in[i++];
+        put_sample(out + o, adpcm_nibble(&predictor, &index, b & 0x0f));
+        o += 2;
+        int32_t s = adpcm_nibble(&predictor, &index, b >> 4);
+        if (++pos == c->block_align) {
+            pos = 0;
+        }
+        if (o + 2 > out_len) {
+            c->pending = s;
+            c->has_pending = true;
+            break;
+        }
+        put_sample(out + o, s);
+        o += 2;
+    }
+    c->predictor = predictor;
+    c->index = index;
+    c->block_pos = pos;
+    *in_used = i;
+    return o;
+}
+
+void audio_codec_skip(audio_codec_t *codec, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    codec->has_pending = false;
+    if (codec->type == AUDIO_CODEC_IMA_ADPCM) {
+        // 还在跳过上一次丢弃所在的块时，块内位置是 block_align - skip
+        uint32_t pos = codec->skip ? codec->block_align - codec->skip : codec->block_pos;
+        pos = (pos + len) % codec->block_align;
+        codec->skip = pos ? codec->block_align - pos : 0;
+        codec->block_pos = 0;
+    }
+}
+
+size_t audio_codec_decode(audio_codec_t *codec, const uint8_t *in, size_t in_len, size_t *in_used, uint8_t *out,
+                          size_t out_len) {
+    size_t o = 0;
+    *in_used = 0;
+    if (codec->has_pending) {
+        if (out_len < 2) {
+            return 0;
+        }
+        put_sample(out, codec->pending);
+        codec->has_pending = false;
+        o = 2;
+    }
+    size_t n;
+    switch (codec->type) {
+        case AUDIO_CODEC_MULAW:
+            n = MIN(in_len, (out_len - o) / 2);
+            for (size_t i = 0; i < n; i++) {
+                put_sample(out + o + i * 2, mulaw_table[in[i]]);
+            }
+            *in_used = n;
+            return o + n * 2;
+        case AUDIO_CODEC_IMA_ADPCM:
+            return o + adpcm_decode(codec, in, in_len, in_used, out + o, out_len - o);
+        default:
+            n = MIN(in_len, out_len - o);
+            memcpy(out + o, in, n);
+            *in_used = n;
+            return o + n;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef __AUDIO_CODEC_H__
+#define __AUDIO_CODEC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// WAV fmt 块中的格式编号
+#define AUDIO_WAVE_FORMAT_PCM        0x0001
+#define AUDIO_WAVE_FORMAT_MULAW      0x0007
+#define AUDIO_WAVE_FORMAT_IMA_ADPCM  0x0011
+
+typedef enum {
+    AUDIO_CODEC_PCM = 0,         // 原样输出
+    AUDIO_CODEC_MULAW,           // G.711 mu-law，1字节一个采样
+    AUDIO_CODEC_IMA_ADPCM,       // IMA-ADPCM(WAV的块格式)，单声道
+} audio_codec_type_t;
+
+// 解码器状态，输入可以在任意字节处切开分多次解码
+typedef struct {
+    audio_codec_type_t type;
+    uint16_t block_align;        // ADPCM块字节数，块头4字节: 第一个采样(int16)、步长索引、保留
+    uint16_t block_pos;          // 当前块已处理的字节数
+    uint16_t skip;               // 丢弃数据后还要跳过的字节数，到下一块开头为止
+    int32_t predictor;
+    int32_t index;
+    bool has_pending;            // 输出放不下的第二个采样
+    int16_t pending;
+    uint8_t header[4];
+} audio_codec_t;
+
+/**
+ * @param block_align ADPCM块字节数，其他格式忽略
+ */
+void audio_codec_init(audio_codec_t *codec, audio_codec_type_t type, uint16_t block_align);
+
+/**
+ * 把 in 解码为16位PCM(小端)写入 out，out 放不下时停下，剩下的输入下次再传入
+ * @param in_used 返回消耗的输入字节数
+ * @return 写入 out 的字节数，PCM以外的格式总是偶数
+ */
+size_t audio_codec_decode(audio_codec_t *codec, const uint8_t *in, size_t in_len, size_t *in_used, uint8_t *out,
+                          size_t out_len);
+
+/**
+ * 跳过没有解码就丢弃的 len 字节输入，保持ADPCM块对齐: 丢弃点落在块中间时，
+ * 这一块剩下的数据也不解码(没有块头的预测值)，从下一块开始继续
+ */
+void audio_codec_skip(audio_codec_t *codec, size_t len);
+
+/**
+ * ADPCM 一块数据解码出的采样数
+ */
+uint32_t audio_codec_adpcm_block_samples(uint16_t block_align);
+
+#endif
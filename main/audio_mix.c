@@ -0,0 +1,37 @@
+#include "audio_mix.h"
+
+// 渐变时增益多保留的小数位，Q15 << 14 在最大增益时正好放进 int32
+#define MIX_RAMP_SHIFT  14
+
+void audio_mix_add(int32_t *acc, const int16_t *in, size_t n, int32_t gain_from, int32_t gain_to) {
+    if (n == 0 || (gain_from == 0 && gain_to == 0)) {
+        return;
+    }
+    if (gain_from == gain_to) {
+        if (gain_to == AUDIO_MIX_UNITY) {
+            for (size_t i = 0; i < n; i++) {
+                acc[i] += in[i];
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                acc[i] += (in[i] * gain_to) >> 15;
+            }
+        }
+        return;
+    }
+    int32_t g = gain_from << MIX_RAMP_SHIFT;
+    int32_t step = ((gain_to - gain_from) << MIX_RAMP_SHIFT) / (int32_t)n;
+    for (size_t i = 0; i + 1 < n; i++) {
+        g += step;
+        acc[i] += (in[i] * (g >> MIX_RAMP_SHIFT)) >> 15;
+    }
+    // 除法的余数补在最后一个采样上
+    acc[n - 1] += (in[n - 1] * gain_to) >> 15;
+}
+
+void audio_mix_out(const int32_t *acc, int16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int32_t v = acc[i];
+        out[i] = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+    }
+}
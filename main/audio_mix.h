@@ -0,0 +1,22 @@
+#ifndef __AUDIO_MIX_H__
+#define __AUDIO_MIX_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 增益为Q15，AUDIO_MIX_UNITY 为1，最大 AUDIO_MIX_MAX_GAIN(2倍)
+#define AUDIO_MIX_UNITY     32768
+#define AUDIO_MIX_MAX_GAIN  65536
+
+/**
+ * 把 in 乘以增益累加到32位混音缓冲 acc，增益从 gain_from 线性变到 gain_to(第 n 个采样正好是 gain_to)。
+ * 增益不变且为1时直接相加，结果与输入逐采样相同
+ */
+void audio_mix_add(int32_t *acc, const int16_t *in, size_t n, int32_t gain_from, int32_t gain_to);
+
+/**
+ * 混音结果饱和到16位
+ */
+void audio_mix_out(const int32_t *acc, int16_t *out, size_t n);
+
+#endif
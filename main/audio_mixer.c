@@ -0,0 +1,272 @@
+#include "audio_mixer.h"
+#include "audio_mix.h"
+#include "d_speak.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/param.h>
+
+static const char *TAG = "audio_mixer";
+
+#define AUDIO_MIXER_TASK_STACK     4096
+// 比音频流任务高，解码和重采样不会让I2S等待
+#define AUDIO_MIXER_TASK_PRIORITY  5
+
+_Static_assert((AUDIO_MIXER_FIFO & (AUDIO_MIXER_FIFO - 1)) == 0, "fifo size must be a power of 2");
+_Static_assert(AUDIO_MIXER_BLOCK <= AUDIO_MIXER_FIFO, "block must fit in the fifo");
+
+// 一个声部: 单生产者(写入的任务)单消费者(混音任务)的环形缓冲，读写位置是回绕的采样计数
+typedef struct {
+    int16_t *buf;
+    atomic_uint wpos;
+    atomic_uint rpos;
+    atomic_bool stopping;        // 正在淡出，淡出时仍接收数据，结束后丢弃缓冲中剩下的
+    SemaphoreHandle_t space;     // 混音任务取走数据后给出，缓冲满时写入的任务等它
+    TaskHandle_t notify;         // 取走数据后再通知的任务，写入时不等待的任务用它
+    // 只在混音任务中使用
+    int32_t gain;                // 当前增益，向设置的增益渐变
+    bool playing;                // 上一块有数据，没有数据后再开始时重新淡入
+} mixer_voice_t;
+
+static mixer_voice_t mixer_voices[AUDIO_MIXER_VOICES];
+static TaskHandle_t mixer_task_handle;
+// 声部设置和统计由 mixer_lock 保护
+static portMUX_TYPE mixer_lock = portMUX_INITIALIZER_UNLOCKED;
+static audio_mixer_voice_cfg_t mixer_cfg[AUDIO_MIXER_VOICES];
+static audio_mixer_stats_t mixer_stats;
+
+static int32_t mixer_acc[AUDIO_MIXER_BLOCK];
+static int16_t mixer_out[AUDIO_MIXER_BLOCK];
+
+// 声部缓冲有了空间，唤醒写入的任务
+static void mixer_wake(mixer_voice_t *mv) {
+    xSemaphoreGive(mv->space);
+    if (mv->notify) {
+        xTaskNotifyGive(mv->notify);
+    }
+}
+
+// 丢弃声部缓冲中的数据，结束淡出
+static void mixer_flush(mixer_voice_t *mv) {
+    atomic_store_explicit(&mv->rpos, atomic_load_explicit(&mv->wpos, memory_order_acquire), memory_order_release);
+    atomic_store_explicit(&mv->stopping, false, memory_order_release);
+    mv->playing = false;
+    mv->gain = 0;
+    mixer_wake(mv);
+}
+
+// 混合一个声部的 n 个采样，返回混合后的增益
+static int32_t mixer_voice_add(mixer_voice_t *mv, uint32_t r, uint32_t n, int32_t gain_to) {
+    uint32_t off = r & (AUDIO_MIXER_FIFO - 1);
+    uint32_t first = MIN(n, AUDIO_MIXER_FIFO - off);
+    // 缓冲回绕时分两段，渐变在两段之间连续
+    int32_t gain_mid = mv->gain + (int32_t)((int64_t)(gain_to - mv->gain) * first / n);
+    audio_mix_add(mixer_acc, mv->buf + off, first, mv->gain, gain_mid);
+    audio_mix_add(mixer_acc + first, mv->buf, n - first, gain_mid, gain_to);
+    return gain_to;
+}
+
+static void audio_mixer_task(void *arg) {
+    TickType_t duck_until = 0;
+    while (1) {
+        audio_mixer_voice_cfg_t cfg[AUDIO_MIXER_VOICES];
+        portENTER_CRITICAL(&mixer_lock);
+        memcpy(cfg, mixer_cfg, sizeof(cfg));
+        portEXIT_CRITICAL(&mixer_lock);
+
+        // 本块的长度是数据最多的声部的数据量，最多一块；数据不够的声部只混合已有的部分
+        uint32_t rpos[AUDIO_MIXER_VOICES];
+        uint32_t avail[AUDIO_MIXER_VOICES];
+        uint32_t n = 0;
+        bool ducker = false;
+        for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+            mixer_voice_t *mv = &mixer_voices[v];
+            rpos[v] = atomic_load_explicit(&mv->rpos, memory_order_relaxed);
+            avail[v] = atomic_load_explicit(&mv->wpos, memory_order_acquire) - rpos[v];
+            n = MAX(n, MIN(avail[v], AUDIO_MIXER_BLOCK));
+            ducker |= cfg[v].ducker && avail[v] > 0;
+        }
+        if (n == 0) {
+            // 都没有数据时不写I2S，让它和直接写I2S时一样欠载
+            for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+                if (atomic_load_explicit(&mixer_voices[v].stopping, memory_order_relaxed)) {
+                    mixer_flush(&mixer_voices[v]);
+                }
+                mixer_voices[v].playing = false;
+            }
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        int64_t start = esp_timer_get_time();
+        TickType_t now = xTaskGetTickCount();
+        if (ducker) {
+            duck_until = now + pdMS_TO_TICKS(AUDIO_MIXER_DUCK_HOLD_MS);
+        }
+        bool ducking = (int32_t)(duck_until - now) > 0;
+        memset(mixer_acc, 0, n * sizeof(int32_t));
+        uint32_t voices = 0;
+        uint32_t voice_samples[AUDIO_MIXER_VOICES] = {0};
+        for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+            mixer_voice_t *mv = &mixer_voices[v];
+            bool stopping = atomic_load_explicit(&mv->stopping, memory_order_relaxed);
+            uint32_t m = MIN(avail[v], n);
+            if (m == 0) {
+                if (stopping) {
+                    mixer_flush(mv);
+                }
+                mv->playing = false;
+                continue;
+            }
+            int32_t target = stopping ? 0 : cfg[v].gain;
+            if (ducking && !cfg[v].ducker) {
+                target = MIN((int64_t)target * cfg[v].duck_gain >> 15, AUDIO_MIX_MAX_GAIN);
+            }
+            if (!mv->playing) {
+                mv->gain = cfg[v].fade_ms ? 0 : target;
+                mv->playing = true;
+            }
+            // 渐变时长内从0变到1，每块按采样数限制增益的变化；没有渐变时长时也在一块之内线性变化，不会突变
+            int32_t next = target;
+            if (cfg[v].fade_ms) {
+                int64_t fade_samples = (int64_t)cfg[v].fade_ms * SPK_SAMPLE_RATE / 1000;
+                int32_t max_step = MAX((int64_t)AUDIO_MIX_UNITY * m / MAX(fade_samples, 1), 1);
+                next = MAX(MIN(target, mv->gain + max_step), mv->gain - max_step);
+            }
+            mv->gain = mixer_voice_add(mv, rpos[v], m, next);
+            atomic_store_explicit(&mv->rpos, rpos[v] + m, memory_order_release);
+            mixer_wake(mv);
+            voice_samples[v] = m;
+            voices++;
+            if (stopping && mv->gain == 0) {
+                mixer_flush(mv);
+            }
+        }
+        audio_mix_out(mixer_acc, mixer_out, n);
+        uint32_t mix_us = esp_timer_get_time() - start;
+
+        portENTER_CRITICAL(&mixer_lock);
+        mixer_stats.blocks++;
+        mixer_stats.samples += n;
+        mixer_stats.mix_us += mix_us;
+        mixer_stats.max_voices = MAX(mixer_stats.max_voices, voices);
+        for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+            mixer_stats.voice_samples[v] += voice_samples[v];
+        }
+        portEXIT_CRITICAL(&mixer_lock);
+
+        speak_write((uint8_t *)mixer_out, n * sizeof(int16_t));
+    }
+}
+
+esp_err_t audio_mixer_init(void) {
+    for (int v = 0; v < AUDIO_MIXER_VOICES; v++) {
+        mixer_voice_t *mv = &mixer_voices[v];
+        mv->buf = heap_caps_malloc(AUDIO_MIXER_FIFO * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        mv->space = xSemaphoreCreateBinary();
+        if (mv->buf == NULL || mv->space == NULL) {
+            ESP_LOGE(TAG, "no memory for voice %d", v);
+            return ESP_ERR_NO_MEM;
+        }
+        // 语音压低其他声部到1/4(-12dB)，背景循环淡入淡出
+        mixer_cfg[v] = (audio_mixer_voice_cfg_t){
+            .gain = AUDIO_MIX_UNITY,
+            .duck_gain = AUDIO_MIX_UNITY / 4,
+            .ducker = v == AUDIO_VOICE_STREAM,
+            .fade_ms = v == AUDIO_VOICE_LOOP ? 200 : 0,
+        };
+    }
+    if (xTaskCreatePinnedToCore(audio_mixer_task, "audio_mixer", AUDIO_MIXER_TASK_STACK, NULL,
+                                AUDIO_MIXER_TASK_PRIORITY, &mixer_task_handle, AUDIO_STREAM_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "%d voices, block %d samples, fifo %d samples", AUDIO_MIXER_VOICES, AUDIO_MIXER_BLOCK,
+             AUDIO_MIXER_FIFO);
+    return ESP_OK;
+}
+
+size_t audio_mixer_write(int voice, const int16_t *samples, size_t n, TickType_t wait) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES || mixer_task_handle == NULL) {
+        return 0;
+    }
+    mixer_voice_t *mv = &mixer_voices[voice];
+    TickType_t start = xTaskGetTickCount();
+    size_t done = 0;
+    while (done < n) {
+        uint32_t w = atomic_load_explicit(&mv->wpos, memory_order_relaxed);
+        uint32_t room = AUDIO_MIXER_FIFO - (w - atomic_load_explicit(&mv->rpos, memory_order_acquire));
+        if (room == 0) {
+            TickType_t waited = xTaskGetTickCount() - start;
+            if (waited >= wait || xSemaphoreTake(mv->space, wait - waited) != pdTRUE) {
+                break;
+            }
+            continue;
+        }
+        uint32_t off = w & (AUDIO_MIXER_FIFO - 1);
+        uint32_t len = MIN(MIN(room, n - done), AUDIO_MIXER_FIFO - off);
+        memcpy(mv->buf + off, samples + done, len * sizeof(int16_t));
+        atomic_store_explicit(&mv->wpos, w + len, memory_order_release);
+        done += len;
+        xTaskNotifyGive(mixer_task_handle);
+    }
+    return done;
+}
+
+void audio_mixer_set_notify(int voice, TaskHandle_t task) {
+    if (voice >= 0 && voice < AUDIO_MIXER_VOICES) {
+        mixer_voices[voice].notify = task;
+    }
+}
+
+void audio_mixer_stop(int voice) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES || mixer_task_handle == NULL) {
+        return;
+    }
+    atomic_store_explicit(&mixer_voices[voice].stopping, true, memory_order_relaxed);
+    xTaskNotifyGive(mixer_task_handle);
+}
+
+bool audio_mixer_stopping(int voice) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES) {
+        return false;
+    }
+    return atomic_load_explicit(&mixer_voices[voice].stopping, memory_order_acquire);
+}
+
+size_t audio_mixer_pending(int voice) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES) {
+        return 0;
+    }
+    mixer_voice_t *mv = &mixer_voices[voice];
+    return atomic_load_explicit(&mv->wpos, memory_order_relaxed) -
+           atomic_load_explicit(&mv->rpos, memory_order_relaxed);
+}
+
+void audio_mixer_set_voice(int voice, const audio_mixer_voice_cfg_t *cfg) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES) {
+        return;
+    }
+    portENTER_CRITICAL(&mixer_lock);
+    mixer_cfg[voice] = *cfg;
+    mixer_cfg[voice].gain = MAX(MIN(cfg->gain, AUDIO_MIX_MAX_GAIN), 0);
+    mixer_cfg[voice].duck_gain = MAX(MIN(cfg->duck_gain, AUDIO_MIX_MAX_GAIN), 0);
+    portEXIT_CRITICAL(&mixer_lock);
+}
+
+void audio_mixer_get_voice(int voice, audio_mixer_voice_cfg_t *cfg) {
+    if (voice < 0 || voice >= AUDIO_MIXER_VOICES) {
+        return;
+    }
+    portENTER_CRITICAL(&mixer_lock);
+    *cfg = mixer_cfg[voice];
+    portEXIT_CRITICAL(&mixer_lock);
+}
+
+void audio_mixer_get_stats(audio_mixer_stats_t *stats) {
+    portENTER_CRITICAL(&mixer_lock);
+    *stats = mixer_stats;
+    portEXIT_CRITICAL(&mixer_lock);
+}
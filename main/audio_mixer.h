@@ -0,0 +1,69 @@
+#ifndef __AUDIO_MIXER_H__
+#define __AUDIO_MIXER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// 声部设置，增益都是Q15(见 audio_mix.h)
+typedef struct {
+    int32_t gain;                // 增益
+    int32_t duck_gain;           // 有压低其他声部的声部在播放时，本声部再乘的增益
+    bool ducker;                 // 播放时压低其他声部(例如语音)
+    uint32_t fade_ms;            // 开始、停止和增益变化的渐变时长，0为立即生效
+} audio_mixer_voice_cfg_t;
+
+// 混音统计，计数开机后一直累加
+typedef struct {
+    uint32_t blocks;             // 写入I2S的混音块数
+    uint32_t samples;            // 写入I2S的采样数
+    uint32_t mix_us;             // 混音运算的总耗时
+    uint32_t max_voices;         // 一块中同时混合的最多声部数
+    uint32_t voice_samples[AUDIO_MIXER_VOICES];  // 各声部被混合的采样数
+} audio_mixer_stats_t;
+
+/**
+ * 创建各声部的缓冲和混音任务，需在 speak_init 之后调用
+ */
+esp_err_t audio_mixer_init(void);
+
+/**
+ * 写入一个声部的采样(SPK_SAMPLE_RATE 16位单声道)，缓冲满时最多等待 wait，同一声部只能在一个任务中写。
+ * 至少一个声部有数据时混音任务才写I2S，没有数据时I2S欠载，和直接写I2S时一样
+ * @return 写入的采样数
+ */
+size_t audio_mixer_write(int voice, const int16_t *samples, size_t n, TickType_t wait);
+
+/**
+ * 混音任务从声部取走数据或丢弃数据后用 xTaskNotifyGive 通知 task，
+ * 同时给多个声部写入、不能在一个声部上阻塞的任务用它等待缓冲空间，NULL 取消
+ */
+void audio_mixer_set_notify(int voice, TaskHandle_t task);
+
+/**
+ * 按渐变时长淡出声部，结束后丢弃缓冲中剩下的数据。淡出时仍接收写入的数据，
+ * 缓冲比渐变时长短，写入的任务要继续写到 audio_mixer_stopping 返回 false 为止，淡出才不会提前结束
+ */
+void audio_mixer_stop(int voice);
+
+/**
+ * audio_mixer_stop 之后淡出还没有结束，结束时也会通知 audio_mixer_set_notify 设置的任务
+ */
+bool audio_mixer_stopping(int voice);
+
+/**
+ * 声部缓冲中还没有混合的采样数
+ */
+size_t audio_mixer_pending(int voice);
+
+void audio_mixer_set_voice(int voice, const audio_mixer_voice_cfg_t *cfg);
+
+void audio_mixer_get_voice(int voice, audio_mixer_voice_cfg_t *cfg);
+
+void audio_mixer_get_stats(audio_mixer_stats_t *stats);
+
+#endif
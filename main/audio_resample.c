@@ -0,0 +1,179 @@
+#include "audio_resample.h"
+#include "esp_heap_caps.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+// 截止频率相对两个采样率中较低者奈奎斯特频率的比例，过渡带跨过奈奎斯特频率，混叠只落在过渡带里
+#define RESAMPLE_ROLLOFF      0.9f
+// Kaiser 窗参数，阻带约 80dB
+#define RESAMPLE_KAISER_BETA  8.0f
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 第一类零阶修正贝塞尔函数，级数到收敛
+static float bessel_i0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float half = x / 2;
+    for (int k = 1; k < 50 && term > sum * 1e-8f; k++) {
+        term *= (half / k) * (half / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// 原型滤波器长度 up * taps，第 j 个系数属于相位 j % up，与 j / up 个采样之前的输入相乘
+// 每个相位 |系数| 和超过2(累加可能溢出 int32)时失败
+static esp_err_t design(audio_resample_t *rs) {
+    uint32_t up = rs->up;
+    uint32_t taps = rs->taps;
+    float len = (float)up * taps;
+    float center = (len - 1) / 2;
+    float fc = 0.5f * RESAMPLE_ROLLOFF / MAX(up, rs->down);   // 上采样序列中的截止频率(周期/采样)
+    float i0_beta = bessel_i0(RESAMPLE_KAISER_BETA);
+    float proto[AUDIO_RESAMPLE_MAX_TAPS];
+    for (uint32_t p = 0; p < up; p++) {
+        float sum = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            float t = p + (float)k * up - center;
+            float x = 2 * fc * t;
+            float sinc = fabsf(x) < 1e-6f ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+            float r = 2 * t / (len - 1);
+            float win = bessel_i0(RESAMPLE_KAISER_BETA * sqrtf(MAX(1 - r * r, 0.0f))) / i0_beta;
+            proto[k] = sinc * win;
+            sum += proto[k];
+        }
+        // 每个相位单独归一化到直流增益1，避免各相位增益不同把直流调制到相位频率上。
+        // 舍入后的和与32768的差，每次补1在舍入误差最大、改动后最接近原值的系数上
+        int16_t *c = rs->coefs + p * taps;
+        int32_t qsum = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            proto[k] = proto[k] / sum * 32768.0f;
+            c[taps - 1 - k] = (int16_t)lrintf(proto[k]);
+            qsum += c[taps - 1 - k];
+        }
+        while (qsum != 32768) {
+            int step = qsum < 32768 ? 1 : -1;
+            uint32_t best = 0;
+            float best_err = -1e9f;
+            for (uint32_t k = 0; k < taps; k++) {
+                float err = (proto[k] - c[taps - 1 - k]) * step;
+                if (err > best_err) {
+                    best_err = err;
+                    best = k;
+                }
+            }
+            c[taps - 1 - best] += step;
+            qsum += step;
+        }
+        int32_t abs_sum = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            abs_sum += abs(c[k]);
+        }
+        if (abs_sum >= 65536) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_resample_init(audio_resample_t *rs, uint32_t in_rate, uint32_t out_rate) {
+    if (in_rate == 0 || out_rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rs->in_rate == in_rate && rs->out_rate == out_rate) {
+        audio_resample_reset(rs);
+        return ESP_OK;
+    }
+    audio_resample_deinit(rs);
+    uint32_t g = gcd(in_rate, out_rate);
+    uint32_t up = out_rate / g;
+    uint32_t down = in_rate / g;
+    uint32_t taps = 0;
+    if (up != down) {
+        // 降采样时截止频率按输出算，滤波器覆盖的输入采样数要同比加长
+        taps = (AUDIO_RESAMPLE_TAPS * down + up - 1) / up;
+        taps = MAX(taps, AUDIO_RESAMPLE_TAPS);
+        if (up > AUDIO_RESAMPLE_MAX_PHASES || taps > AUDIO_RESAMPLE_MAX_TAPS) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        // 每个输出都要读全部系数，放内部RAM
+        rs->coefs = heap_caps_malloc((up + 2) * taps * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (rs->coefs == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        rs->hist = rs->coefs + up * taps;
+    }
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->up = up;
+    rs->down = down;
+    rs->taps = taps;
+    if (taps && design(rs) != ESP_OK) {
+        audio_resample_deinit(rs);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    audio_resample_reset(rs);
+    return ESP_OK;
+}
+
+void audio_resample_deinit(audio_resample_t *rs) {
+    heap_caps_free(rs->coefs);
+    memset(rs, 0, sizeof(*rs));
+}
+
+void audio_resample_reset(audio_resample_t *rs) {
+    rs->phase = rs->up;
+    rs->hist_pos = 0;
+    if (rs->hist) {
+        memset(rs->hist, 0, 2 * rs->taps * sizeof(int16_t));
+    }
+}
+
+size_t audio_resample_process(audio_resample_t *rs, const int16_t *in, size_t in_n, size_t *in_used, int16_t *out,
+                              size_t out_n) {
+    if (rs->taps == 0) {
+        size_t n = MIN(in_n, out_n);
+        memcpy(out, in, n * sizeof(int16_t));
+        *in_used = n;
+        return n;
+    }
+    const uint32_t taps = rs->taps;
+    size_t i = 0;
+    size_t o = 0;
+    while (o < out_n) {
+        // 下一个输出还要更新的输入
+        while (rs->phase >= rs->up) {
+            if (i == in_n) {
+                *in_used = i;
+                return o;
+            }
+            rs->hist[rs->hist_pos] = in[i];
+            rs->hist[rs->hist_pos + taps] = in[i];
+            rs->hist_pos = rs->hist_pos + 1 == taps ? 0 : rs->hist_pos + 1;
+            rs->phase -= rs->up;
+            i++;
+        }
+        // design 保证每个相位的 |系数| 和小于2，16位输入的累加不会超出 int32
+        const int16_t *c = rs->coefs + rs->phase * taps;
+        const int16_t *x = rs->hist + rs->hist_pos;
+        int32_t acc = 1 << 14;
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += c[k] * x[k];
+        }
+        acc >>= 15;
+        out[o++] = (int16_t)MAX(MIN(acc, INT16_MAX), INT16_MIN);
+        rs->phase += rs->down;
+    }
+    *in_used = i;
+    return o;
+}
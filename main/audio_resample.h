@@ -0,0 +1,51 @@
+#ifndef __AUDIO_RESAMPLE_H__
+#define __AUDIO_RESAMPLE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 每个相位的滤波器阶数(以输入和输出中较低的采样率计)，降采样时按比例加长
+#define AUDIO_RESAMPLE_TAPS        32
+// 约分后插值倍数的上限，22.05k->24k 是 160，11.025k->24k 是 320
+#define AUDIO_RESAMPLE_MAX_PHASES  320
+// 每个相位阶数的上限，96k->24k 正好用满
+#define AUDIO_RESAMPLE_MAX_TAPS    128
+
+// 有理数比例 L/M 的多相FIR采样率转换，单声道16位，系数Q15，每个相位的系数和为1
+typedef struct {
+    uint32_t in_rate;
+    uint32_t out_rate;
+    uint32_t up;                 // L: 插值倍数(约分后)
+    uint32_t down;               // M: 抽取倍数(约分后)
+    uint32_t taps;               // 每个相位的阶数，0为直接拷贝
+    uint32_t phase;              // 下一个输出在L倍上采样序列中相对最新输入的位置，不小于 up 时要先移入输入
+    uint32_t hist_pos;           // 最旧的输入采样在 hist 中的位置
+    int16_t *coefs;              // up 组，每组 taps 个，和 hist 窗口一样从旧到新排列
+    int16_t *hist;               // 输入历史存两份(2 * taps)，窗口总是连续的
+} audio_resample_t;
+
+/**
+ * 按输入输出采样率生成滤波器，采样率相同时不滤波直接拷贝
+ * 用浮点生成 Kaiser 窗 sinc 系数，相位多时要几毫秒，rs 已经是同样的采样率时只清空历史
+ * @param rs 第一次使用前清零
+ * @return 比例超出 AUDIO_RESAMPLE_MAX_PHASES/AUDIO_RESAMPLE_MAX_TAPS 或内存不够时失败
+ */
+esp_err_t audio_resample_init(audio_resample_t *rs, uint32_t in_rate, uint32_t out_rate);
+
+void audio_resample_deinit(audio_resample_t *rs);
+
+/**
+ * 清空历史，开始新的一段音频
+ */
+void audio_resample_reset(audio_resample_t *rs);
+
+/**
+ * 转换 in 中的采样，out 放满或输入用完时返回，没有消耗的输入下次再传入
+ * @param in_used 返回消耗的输入采样数
+ * @return 写入 out 的采样数
+ */
+size_t audio_resample_process(audio_resample_t *rs, const int16_t *in, size_t in_n, size_t *in_used, int16_t *out,
+                              size_t out_n);
+
+#endif
@@ -0,0 +1,362 @@
+#include "audio_stream.h"
+#include "audio_mixer.h"
+#include "audio_resample.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/param.h>
+
+static const char *TAG = "audio_stream";
+
+#define AUDIO_STREAM_TASK_STACK     4096
+#define AUDIO_STREAM_TASK_PRIORITY  4
+// 还没轮到的流(格式切换)最多排几个
+#define AUDIO_STREAM_FMT_QUEUE_LEN  4
+
+_Static_assert((AUDIO_STREAM_RING_SIZE & (AUDIO_STREAM_RING_SIZE - 1)) == 0, "ring size must be a power of 2");
+_Static_assert(AUDIO_STREAM_CHUNK < AUDIO_STREAM_RING_SIZE, "chunk must be smaller than the ring");
+_Static_assert(AUDIO_RESAMPLE_MAX_TAPS / 2 <= AUDIO_STREAM_CONV_FRAMES, "resampler flush must fit the conversion buffer");
+
+// 一个流的格式，从写入位置 pos 起生效
+typedef struct {
+    uint32_t pos;
+    uint32_t gen;                // 流的序号，从1开始
+    uint32_t sample_rate;
+    uint32_t length;             // 流的字节数，0为未知
+    uint8_t bits;
+    uint8_t channels;
+} audio_stream_fmt_t;
+
+// 单生产者(httpd任务)单消费者(播放任务)的环形缓冲，读写位置是回绕的字节计数，
+// 生产者只写 wpos，消费者只写 rpos，两者之差就是缓冲中的数据量
+static uint8_t *stream_ring;
+static atomic_uint stream_wpos;
+static atomic_uint stream_rpos;
+static QueueHandle_t stream_fmt_q;
+static TaskHandle_t stream_task_handle;
+static atomic_uint stream_latency_ms = AUDIO_STREAM_LATENCY_MS;
+// 播放任务在流中途放空缓冲时记下流的序号，同一个流的数据再到达时计一次欠载
+static atomic_uint stream_starved;
+
+// 只在生产者中修改
+static uint32_t stream_gen;
+// 当前流一帧的字节数，和写入时被分包切开、还不完整的一帧(最大32位双声道)
+static uint32_t stream_frame_bytes = 2;
+static uint8_t stream_partial[8];
+static uint32_t stream_partial_len;
+static uint32_t stream_max_fill;
+static atomic_uint stream_overruns;
+static atomic_uint stream_dropped;
+static atomic_uint stream_underruns;
+// 只在播放任务中修改
+static atomic_uint stream_starts;
+// 格式不是 SPK_SAMPLE_RATE 16位单声道时的转换缓冲
+static audio_resample_t stream_rs;
+static int16_t stream_conv[AUDIO_STREAM_CONV_FRAMES];
+static int16_t stream_out[AUDIO_STREAM_CHUNK / 2];
+
+// 从环形缓冲 r 处取 frames 帧转为单声道16位，帧可以跨过缓冲末尾。
+// 多声道取平均，24/32位只留高16位，8位WAV是无符号数
+static void stream_convert(uint32_t r, const audio_stream_fmt_t *fmt, int16_t *out, uint32_t frames) {
+    const uint32_t mask = AUDIO_STREAM_RING_SIZE - 1;
+    const uint32_t bytes = fmt->bits / 8;
+    for (uint32_t f = 0; f < frames; f++) {
+        int32_t sum = 0;
+        for (uint32_t ch = 0; ch < fmt->channels; ch++) {
+            uint32_t hi = r + bytes - 1;
+            if (bytes == 1) {
+                sum += (stream_ring[hi & mask] - 128) << 8;
+            } else {
+                sum += (int16_t)(stream_ring[hi & mask] << 8 | stream_ring[(hi - 1) & mask]);
+            }
+            r += bytes;
+        }
+        out[f] = fmt->channels == 2 ? sum >> 1 : sum;
+    }
+}
+
+// 把 stream_conv 中的 frames 个采样重采样到 SPK_SAMPLE_RATE 写进混音器
+static void stream_resample_write(uint32_t frames) {
+    size_t done = 0;
+    while (done < frames) {
+        size_t used;
+        size_t n = audio_resample_process(&stream_rs, stream_conv + done, frames - done, &used, stream_out,
+                                          sizeof(stream_out) / sizeof(stream_out[0]));
+        if (n) {
+            audio_mixer_write(AUDIO_VOICE_STREAM, stream_out, n, portMAX_DELAY);
+        }
+        done += used;
+    }
+}
+
+// 转换 frames 帧并重采样写进混音器
+static void stream_play_converted(uint32_t r, const audio_stream_fmt_t *fmt, uint32_t frames) {
+    stream_convert(r, fmt, stream_conv, frames);
+    stream_resample_write(frames);
+}
+
+// 滤波器有 taps/2 个输入采样的延迟，流结束时最后这些采样还在历史里，送入同样多的0把它们推出来
+static void stream_flush_converted(void) {
+    uint32_t zeros = stream_rs.taps / 2;
+    memset(stream_conv, 0, zeros * sizeof(stream_conv[0]));
+    stream_resample_write(zeros);
+}
+
+static void audio_stream_task(void *arg) {
+    audio_stream_fmt_t cur = {0};
+    audio_stream_fmt_t next;
+    bool has_next = false;
+    bool playing = false;
+    bool idle = false;
+    bool direct = true;          // 与混音器格式相同，直接从环形缓冲写
+    bool skip = false;           // 不支持的采样率，丢弃整个流
+    bool tail = false;           // 重采样滤波器里还有没输出的采样
+    uint32_t frame_bytes = 2;
+    uint32_t r = atomic_load_explicit(&stream_rpos, memory_order_relaxed);
+    while (1) {
+        uint32_t w = atomic_load_explicit(&stream_wpos, memory_order_acquire);
+        if (!has_next) {
+            has_next = xQueueReceive(stream_fmt_q, &next, 0) == pdTRUE;
+        }
+        // 到达新流的起点: 之前的数据已全部交给混音器，切换格式。I2S不重新配置，采样率在这里转换
+        if (has_next && r == next.pos) {
+            if (tail) {
+                stream_flush_converted();
+                tail = false;
+            }
+            cur = next;
+            has_next = false;
+            playing = false;
+            idle = false;
+            frame_bytes = cur.bits / 8 * cur.channels;
+            direct = cur.sample_rate == SPK_SAMPLE_RATE && cur.bits == 16 && cur.channels == 1;
+            esp_err_t err = audio_resample_init(&stream_rs, cur.sample_rate, SPK_SAMPLE_RATE);
+            skip = err != ESP_OK;
+            if (skip) {
+                ESP_LOGE(TAG, "can't resample %" PRIu32 " Hz: %s", cur.sample_rate, esp_err_to_name(err));
+            }
+            continue;
+        }
+        // 当前流可以播放的数据，后面有排队的流时只到它的起点
+        uint32_t end = has_next ? next.pos : w;
+        uint32_t avail = end - r;
+        bool complete = has_next || (cur.length && end - cur.pos >= cur.length);
+        // 流末尾不完整的帧(和对齐用的填充字节)不播放
+        if ((avail < frame_bytes && has_next) || (skip && avail > 0)) {
+            r = end;
+            atomic_store_explicit(&stream_rpos, r, memory_order_release);
+            continue;
+        }
+        if (avail < frame_bytes) {
+            avail = 0;
+        }
+        if (!playing) {
+            // 缓冲到目标延迟再开始，流已收完或者一个目标延迟内没有新数据时不再等
+            uint32_t latency_ms = atomic_load_explicit(&stream_latency_ms, memory_order_relaxed);
+            uint32_t watermark = MIN((uint64_t)latency_ms * cur.sample_rate * frame_bytes / 1000,
+                                     AUDIO_STREAM_RING_SIZE - AUDIO_STREAM_CHUNK);
+            if (avail == 0 || (avail < watermark && !complete && !idle)) {
+                idle = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MAX(latency_ms, 1))) == 0 && avail > 0;
+                continue;
+            }
+            playing = true;
+            atomic_fetch_add_explicit(&stream_starts, 1, memory_order_relaxed);
+        }
+        if (avail == 0) {
+            playing = false;
+            if (!complete) {
+                atomic_store_explicit(&stream_starved, cur.gen, memory_order_relaxed);
+            } else if (tail) {
+                // 流已收完并放空，不会再有数据把滤波器里的采样推出来
+                stream_flush_converted();
+                tail = false;
+            }
+            continue;
+        }
+        idle = false;
+        uint32_t off = r & (AUDIO_STREAM_RING_SIZE - 1);
+        uint32_t n = MIN(avail, MIN(AUDIO_STREAM_CHUNK, AUDIO_STREAM_RING_SIZE - off));
+        n -= n % frame_bytes;
+        if (direct && n > 0) {
+            // 直接从环形缓冲写进混音器的声部缓冲，不再经过中间缓冲(流的起点和帧都是偶数字节)
+            audio_mixer_write(AUDIO_VOICE_STREAM, (const int16_t *)(stream_ring + off), n / 2, portMAX_DELAY);
+        } else {
+            uint32_t frames = MIN(avail / frame_bytes, AUDIO_STREAM_CONV_FRAMES);
+            stream_play_converted(r, &cur, frames);
+            n = frames * frame_bytes;
+            tail = stream_rs.taps > 0;
+        }
+        r += n;
+        atomic_store_explicit(&stream_rpos, r, memory_order_release);
+    }
+}
+
+esp_err_t audio_stream_init(void) {
+    stream_ring = heap_caps_malloc(AUDIO_STREAM_RING_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (stream_ring == NULL) {
+        stream_ring = heap_caps_malloc(AUDIO_STREAM_RING_SIZE, MALLOC_CAP_DEFAULT);
+    }
+    stream_fmt_q = xQueueCreate(AUDIO_STREAM_FMT_QUEUE_LEN, sizeof(audio_stream_fmt_t));
+    if (stream_ring == NULL || stream_fmt_q == NULL) {
+        ESP_LOGE(TAG, "no memory for %d bytes ring", AUDIO_STREAM_RING_SIZE);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(audio_stream_task, "audio_stream", AUDIO_STREAM_TASK_STACK, NULL,
+                                AUDIO_STREAM_TASK_PRIORITY, &stream_task_handle, AUDIO_STREAM_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "ring %d bytes, latency %d ms", AUDIO_STREAM_RING_SIZE, AUDIO_STREAM_LATENCY_MS);
+    return ESP_OK;
+}
+
+esp_err_t audio_stream_begin(uint32_t sample_rate, uint8_t bits, uint8_t channels, uint32_t length) {
+    if (stream_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (sample_rate == 0 || (bits != 8 && bits != 16 && bits != 24 && bits != 32) || channels == 0 ||
+        channels > 2) {
+        ESP_LOGE(TAG, "unsupported format: %" PRIu32 " Hz, %d bits, %d channels", sample_rate, bits, channels);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // 新流从偶数位置开始，解码器按整个采样写入，环形缓冲末尾不会只剩半个采样的空间
+    uint8_t *pad;
+    if ((atomic_load_explicit(&stream_wpos, memory_order_relaxed) & 1) && audio_stream_prepare(&pad) > 0) {
+        *pad = 0;
+        audio_stream_commit(1);
+    }
+    audio_stream_fmt_t fmt = {
+        .pos = atomic_load_explicit(&stream_wpos, memory_order_relaxed),
+        .gen = stream_gen + 1,
+        .sample_rate = sample_rate,
+        .length = length,
+        .bits = bits,
+        .channels = channels,
+    };
+    if (xQueueSend(stream_fmt_q, &fmt, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "too many pending streams");
+        return ESP_ERR_NO_MEM;
+    }
+    stream_gen++;
+    // 上一个流末尾不完整的帧不再播放
+    stream_frame_bytes = bits / 8 * channels;
+    stream_partial_len = 0;
+    xTaskNotifyGive(stream_task_handle);
+    return ESP_OK;
+}
+
+size_t audio_stream_prepare(uint8_t **buf) {
+    // 第一个流开始之前的数据没有格式，和以前一样丢弃
+    if (stream_gen == 0) {
+        return 0;
+    }
+    uint32_t w = atomic_load_explicit(&stream_wpos, memory_order_relaxed);
+    uint32_t r = atomic_load_explicit(&stream_rpos, memory_order_acquire);
+    uint32_t off = w & (AUDIO_STREAM_RING_SIZE - 1);
+    *buf = stream_ring + off;
+    return MIN(AUDIO_STREAM_RING_SIZE - (w - r), AUDIO_STREAM_RING_SIZE - off);
+}
+
+void audio_stream_commit(size_t len) {
+    if (len == 0) {
+        return;
+    }
+    uint32_t w = atomic_load_explicit(&stream_wpos, memory_order_relaxed) + len;
+    atomic_store_explicit(&stream_wpos, w, memory_order_release);
+    stream_max_fill = MAX(stream_max_fill, w - atomic_load_explicit(&stream_rpos, memory_order_relaxed));
+    if (atomic_exchange_explicit(&stream_starved, 0, memory_order_relaxed) == stream_gen) {
+        atomic_fetch_add_explicit(&stream_underruns, 1, memory_order_relaxed);
+    }
+    xTaskNotifyGive(stream_task_handle);
+}
+
+void audio_stream_drop(size_t len) {
+    if (len) {
+        atomic_fetch_add_explicit(&stream_overruns, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&stream_dropped, len, memory_order_relaxed);
+    }
+}
+
+static uint32_t stream_free(void) {
+    return AUDIO_STREAM_RING_SIZE - (atomic_load_explicit(&stream_wpos, memory_order_relaxed) -
+                                     atomic_load_explicit(&stream_rpos, memory_order_acquire));
+}
+
+// 写入 len 字节(不超过空闲空间)，回绕时分两段拷贝
+static void stream_put(const uint8_t *data, size_t len) {
+    for (int i = 0; i < 2 && len; i++) {
+        uint8_t *buf;
+        size_t n = MIN(audio_stream_prepare(&buf), len);
+        memcpy(buf, data, n);
+        audio_stream_commit(n);
+        data += n;
+        len -= n;
+    }
+}
+
+size_t audio_stream_write(const uint8_t *data, size_t len) {
+    if (stream_gen == 0) {
+        return 0;
+    }
+    const uint32_t frame = stream_frame_bytes;
+    size_t total = len;
+    size_t dropped = 0;          // 丢弃的字节数(整帧)
+    size_t lost = 0;             // 其中属于这次输入的字节数
+    // 先补齐上次留下的不完整的帧
+    if (stream_partial_len) {
+        size_t n = MIN(frame - stream_partial_len, len);
+        memcpy(stream_partial + stream_partial_len, data, n);
+        stream_partial_len += n;
+        data += n;
+        len -= n;
+        if (stream_partial_len < frame) {
+            return total;
+        }
+        if (stream_free() >= frame) {
+            stream_put(stream_partial, frame);
+        } else {
+            dropped += frame;
+            lost += n;
+        }
+        stream_partial_len = 0;
+    }
+    // 只写入和丢弃整帧，缓冲满时也不会把后面的采样错开
+    size_t whole = len - len % frame;
+    size_t n = MIN(stream_free(), whole);
+    n -= n % frame;
+    stream_put(data, n);
+    dropped += whole - n;
+    lost += whole - n;
+    // 末尾被切开的帧留到下次
+    stream_partial_len = len - whole;
+    memcpy(stream_partial, data + whole, stream_partial_len);
+    audio_stream_drop(dropped);
+    return total - lost;
+}
+
+void audio_stream_set_latency(uint32_t ms) {
+    atomic_store_explicit(&stream_latency_ms, ms, memory_order_relaxed);
+}
+
+void audio_stream_get_stats(audio_stream_stats_t *stats) {
+    uint32_t r = atomic_load_explicit(&stream_rpos, memory_order_relaxed);
+    uint32_t w = atomic_load_explicit(&stream_wpos, memory_order_relaxed);
+    *stats = (audio_stream_stats_t){
+        .size = AUDIO_STREAM_RING_SIZE,
+        .latency_ms = atomic_load_explicit(&stream_latency_ms, memory_order_relaxed),
+        .fill = w - r,
+        .max_fill = stream_max_fill,
+        .streams = stream_gen,
+        .starts = atomic_load_explicit(&stream_starts, memory_order_relaxed),
+        .underruns = atomic_load_explicit(&stream_underruns, memory_order_relaxed),
+        .overruns = atomic_load_explicit(&stream_overruns, memory_order_relaxed),
+        .dropped = atomic_load_explicit(&stream_dropped, memory_order_relaxed),
+        .written = w,
+        .played = r,
+    };
+}
@@ -0,0 +1,64 @@
+#ifndef __AUDIO_STREAM_H__
+#define __AUDIO_STREAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 音频流统计，计数开机后一直累加(字节数32位回绕)
+typedef struct {
+    uint32_t size;               // 环形缓冲字节数
+    uint32_t latency_ms;         // 目标延迟
+    uint32_t fill;               // 当前缓冲中的字节数
+    uint32_t max_fill;           // 开机以来缓冲的最大字节数
+    uint32_t streams;            // 开始的流(收到的WAV头)数
+    uint32_t starts;             // 缓冲到水位开始播放的次数(包括欠载后重新缓冲)
+    uint32_t underruns;          // 流中途缓冲放空、播放停顿的次数
+    uint32_t overruns;           // 缓冲放不下、丢弃了数据的写入次数
+    uint32_t dropped;            // 丢弃的字节数
+    uint32_t written;            // 写入缓冲的字节数
+    uint32_t played;             // 交给混音器的字节数
+} audio_stream_stats_t;
+
+/**
+ * 分配PSRAM环形缓冲并创建播放任务，需在 audio_mixer_init 之后调用，播放的数据写进 AUDIO_VOICE_STREAM 声部
+ */
+esp_err_t audio_stream_init(void);
+
+/**
+ * 开始一个新的流，从当前写入位置起生效: 之前写入的数据按原格式播完后才切换到新格式。
+ * 混音器和I2S固定为 SPK_SAMPLE_RATE 16位单声道，其他格式由播放任务转为单声道16位并重采样(见 audio_resample.h)
+ * @param length 流的字节数，0表示未知(收到最后的数据后等一个目标延迟再开始播放)
+ */
+esp_err_t audio_stream_begin(uint32_t sample_rate, uint8_t bits, uint8_t channels, uint32_t length);
+
+/**
+ * 写入PCM数据，不阻塞，可以在httpd任务中调用。按当前流的帧(位数/8*声道数)写入，缓冲放不下的整帧丢弃并计一次 overrun，
+ * 末尾被分包切开的不完整的帧暂存起来，和下次写入的数据拼成整帧
+ * @return 写入(包括暂存)的字节数
+ */
+size_t audio_stream_write(const uint8_t *data, size_t len);
+
+/**
+ * 取环形缓冲写入位置起连续的空闲空间，解码器直接把输出写进去，再用 audio_stream_commit 提交。
+ * 只用于16位单声道的流，提交的长度必须是偶数(整帧)；与 audio_stream_write 一样只能在一个任务中调用
+ * @return 可以写入的字节数，缓冲满或者还没有开始流时为0
+ */
+size_t audio_stream_prepare(uint8_t **buf);
+
+void audio_stream_commit(size_t len);
+
+/**
+ * 缓冲放不下、丢弃了 len 字节输入时调用，计一次 overrun
+ */
+void audio_stream_drop(size_t len);
+
+/**
+ * 设置目标延迟: 缓冲达到这么多毫秒的数据才开始播放，用来吸收网络抖动，下次开始缓冲时生效
+ */
+void audio_stream_set_latency(uint32_t ms);
+
+void audio_stream_get_stats(audio_stream_stats_t *stats);
+
+#endif
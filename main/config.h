@@ -12,6 +12,8 @@
 #define PIN_NUM_DC             GPIO_NUM_41
 #define PIN_NUM_RST            GPIO_NUM_42
 #define PIN_NUM_CS             GPIO_NUM_40
+// 第二块屏(第二只眼)的片选，其余引脚和第一块屏共用(见 Kconfig 的 LCD_PANEL_COUNT)
+#define PIN_NUM_CS2            GPIO_NUM_39
 // 定义LCD相关分辨率
 #define LCD_H_RES              240
 #define LCD_V_RES              240
@@ -40,6 +42,40 @@ typedef enum {
 
 // 眨眼时间间隔(毫秒)
 #define EMOJI_BLINK_INTEVEL  10000
+// 表情使用编译期预解码的RGB565帧包(spiffs/pack/*.epk)播放，置0则运行时解码GIF
+#define EMOJI_USE_FRAME_PACK  1
+// GIF在另一个核上的解码任务中提前解码到帧槽，LVGL任务每帧只切换图像数据指针;
+// 只用于运行时解码GIF(EMOJI_USE_FRAME_PACK 为0)，帧包播放不解码，用不到
+#define EMOJI_GIF_DECODE_TASK  1
+// 解码任务运行的核，LVGL任务固定在另一个核(见 d_lcd.c)
+#define EMOJI_GIF_DECODE_CORE  1
+// 帧槽数量: 显示中 + 解码中 + 至少一帧预解码，不能少于3
+#define EMOJI_GIF_FRAME_SLOTS  3
+// 表情清单，开机时解析，改清单即可增删表情而不用重新烧录固件
+#define EMOJI_MANIFEST_PATH   "/spiffs/emoji/emotions.json"
+// 清单中表情数量上限
+#define EMOJI_MAX_EMOTIONS    16
+// 每个表情的片段数量上限
+#define EMOJI_MAX_STEPS       8
+// 表情名/片段名最大长度(含结尾0)
+#define EMOJI_NAME_LEN        16
+// 片段播完后停留时间(hold)的上限(毫秒)，超出的表情无效
+#define EMOJI_MAX_HOLD_MS     (3600 * 1000)
+// 表情命令队列长度，突发的命令超出后挤掉最旧的
+#define EMOJI_CMD_QUEUE_LEN   8
+
+// 资源分区，GIF/帧包/音频打包后直接从flash映射读取(格式见 tools/asset_pack.py)
+#define ASSET_PART_LABEL      "assets"
+#define ASSET_PART_SUBTYPE    0x40
+
+// 屏幕镜像(见 mirror.c): 捕获块数量，每块20行整屏宽，LVGL任务拿不到空闲块时丢弃这次刷新并请求整屏重画
+#define MIRROR_POOL_BLOCKS    4
+// 发送缓冲数量，都在发送中时跳过编码，变化合并到下一帧
+#define MIRROR_TX_BUFS        2
+// 镜像帧率上限
+#define MIRROR_MAX_FPS        30
+// 编码和发送任务运行的核，不和LVGL任务抢
+#define MIRROR_TASK_CORE      1
 
 //WIFI相关
 #define WIFI_AP_SSID "Robot_Cilow"
@@ -50,5 +86,31 @@ typedef enum {
 #define SPK_PIN_LRC   GPIO_NUM_6
 #define SPK_PIN_BCLK  GPIO_NUM_5
 #define SPK_PIN_DIN   GPIO_NUM_4
+// 音频流(见 audio_stream.c): /ws 收到的PCM先进PSRAM环形缓冲，由播放任务写I2S，httpd任务不会被I2S阻塞
+// 环形缓冲字节数(2的幂)，24kHz 16位单声道约2.7秒
+#define AUDIO_STREAM_RING_SIZE   (128 * 1024)
+// 默认目标延迟(毫秒): 缓冲到这么多数据才开始播放，能吸收同样长的网络抖动，可以通过 /ws 的 audio 事件修改
+#define AUDIO_STREAM_LATENCY_MS  200
+// 每次写I2S的字节数
+#define AUDIO_STREAM_CHUNK       2048
+// 需要转换格式时每次从环形缓冲取的帧数
+#define AUDIO_STREAM_CONV_FRAMES 256
+// 播放任务运行的核，不和LVGL任务抢
+#define AUDIO_STREAM_TASK_CORE   1
+// 混音器(见 audio_mixer.c): 每个声部有自己的缓冲，混音任务按块混合后写I2S，音效不会打断语音
+#define AUDIO_MIXER_VOICES       3
+#define AUDIO_VOICE_STREAM       0   // /ws 音频流，播放时压低其他声部
+#define AUDIO_VOICE_EFFECT       1   // 本地音效(audio_play_local)
+#define AUDIO_VOICE_LOOP         2   // 背景循环
+// 每次混音的采样数(约10ms)
+#define AUDIO_MIXER_BLOCK        256
+// 每个声部缓冲的采样数，写入的任务最多领先I2S这么多
+#define AUDIO_MIXER_FIFO         1024
+// 压低声部停止后，其他声部再等这么久才恢复音量，避免语音的停顿间音量来回变化
+#define AUDIO_MIXER_DUCK_HOLD_MS 300
+// 本地播放(见 audio_play_start): 不在资源分区中的文件每个声部用一个这么大的静态读取缓冲
+#define AUDIO_PLAY_BUF_SIZE      2048
+// 本地播放的进度回调间隔
+#define AUDIO_PLAY_PROGRESS_MS   100
 
 #endif
\ No newline at end of file
@@ -1,63 +1,709 @@
 #include "config.h"
 #include "esp_lcd_gc9a01.h"
 #include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_commands.h"
 #include "esp_lcd_panel_ops.h"
 #include "lvgl.h"
+#include "lvgl_private.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "d_lcd.h"
+#include "telemetry.h"
+#include "mirror.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <string.h>
 #include <sys/param.h>
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+#include "esp_heap_caps.h"
+#endif
 
 
 #define LCD_PIXEL_CLOCK_HZ (20 * 1000 * 1000)
 #define LCD_CMD_BITS 8
 #define LCD_PARAM_BITS 8
-#define LVGL_TICK_PERIOD_MS 2
-#define LVGL_TASK_MAX_DELAY_MS 500
 #define LVGL_TASK_MIN_DELAY_MS 1000 / CONFIG_FREERTOS_HZ
 #define LVGL_TASK_STACK_SIZE (4 * 1024)
 #define LVGL_TASK_PRIORITY 2
+// LVGL任务固定在核0，GIF解码任务在另一个核(EMOJI_GIF_DECODE_CORE)
+#define LVGL_TASK_CORE 0
 #define LVGL_DRAW_BUF_LINES 20
+// SPI屏是大端字节序，LVGL直接按交换后的字节序渲染，flush时不再逐像素交换
+#define LCD_COLOR_FORMAT LV_COLOR_FORMAT_RGB565_SWAPPED
+// LVGL任务统计周期，打印每秒唤醒次数和空闲占比
+#define LVGL_STATS_PERIOD_MS 10000
+// GC9A01 退出睡眠后5ms才能发下一条命令，退出睡眠后120ms内不能再进入睡眠
+#define LCD_SLPOUT_DELAY_MS 5
+#define LCD_SLPOUT_TO_SLPIN_MS 120
+// 空闲时的重画不经过SPI，捕获块用完时等镜像编码任务归还的最长时间
+#define LCD_IDLE_MIRROR_WAIT_MS 100
+// 屏幕(眼睛)数量，多块屏挂在同一条SPI总线上，只有片选不同
+#define LCD_PANEL_CNT CONFIG_LCD_PANEL_COUNT
+// LVGL显示数量和每个显示刷新到的屏数: 第二只眼跟随第一只时只渲染一次，同一块缓冲发给所有屏
+#if CONFIG_LCD_SECOND_EYE_OWN
+#define LCD_DISP_CNT LCD_PANEL_CNT
+#define LCD_DISP_PANEL_CNT 1
+#else
+#define LCD_DISP_CNT 1
+#define LCD_DISP_PANEL_CNT LCD_PANEL_CNT
+#endif
 
 
 static const char *TAG = "LCD";
 
-esp_lcd_panel_io_handle_t io_handle = NULL;
-esp_lcd_panel_handle_t panel_handle = NULL;
+// 记录排队时间的在途传输上限，部分模式1个，直接模式最多 LCD_BOUNCE_BUF_CNT 个
+#define LCD_TRANS_QUEUE_LEN 4
+
+// 一块屏: 第i个显示刷新到第 i * LCD_DISP_PANEL_CNT 起的 LCD_DISP_PANEL_CNT 块屏
+typedef struct {
+  esp_lcd_panel_io_handle_t io;
+  esp_lcd_panel_handle_t panel;
+  // 在途传输，同一块屏的传输按排队顺序完成，由 lcd_flush_lock 保护
+  uint8_t trans_buf[LCD_TRANS_QUEUE_LEN];        // 传输的缓冲编号
+  int64_t trans_queued_us[LCD_TRANS_QUEUE_LEN];  // 排队时间
+  uint32_t trans_bytes[LCD_TRANS_QUEUE_LEN];     // 字节数
+  uint8_t trans_head;
+  uint8_t trans_cnt;
+} lcd_panel_t;
+
+static lcd_panel_t lcd_panels[LCD_PANEL_CNT];
+static lv_display_t *lcd_disps[LCD_DISP_CNT];
+
+static TaskHandle_t lvgl_task_handle = NULL;
+static lvgl_port_wake_cb_t lvgl_wake_cb = NULL;
+static volatile bool lvgl_redraw_pending = false;
+
+// 屏幕电源状态，只在LVGL任务中切换
+typedef enum {
+  LCD_POWER_ON,               // 正常渲染和刷新
+  LCD_POWER_IDLE,             // 停止渲染，LVGL定时器不运行，屏幕保持最后一帧
+  LCD_POWER_SLEEP,            // 屏幕睡眠(SLPIN)，不显示但显存保留
+} lcd_power_state_t;
+
+static lcd_power_state_t lcd_power_state = LCD_POWER_ON;
+static int64_t lcd_power_since_us;    // 上次计入空闲统计的时间
+static int64_t lcd_idle_since_us;     // 进入空闲的时间
+static int64_t lcd_slpout_us;         // 上次退出睡眠的时间
+static int64_t lcd_wake_us;           // 退出空闲的时间，之后第一次传输完成时清零，由 lcd_flush_lock 保护
+
+// 空闲统计，每个统计周期清零。唤醒延迟为退出空闲到第一块新像素发送完成
+typedef struct {
+  uint64_t idle_us;           // 空闲(含睡眠)时间，LVGL任务中累计
+  uint64_t sleep_us;          // 其中屏幕睡眠的时间
+  uint32_t wakes;             // 退出空闲次数
+  uint32_t first_px;          // 已发送出第一块像素的唤醒次数，以下由 lcd_flush_lock 保护
+  uint64_t first_px_us;
+  uint32_t first_px_max_us;
+} lcd_power_stats_t;
+
+static lcd_power_stats_t lcd_power_stats;
+
+// LVGL任务统计，每个统计周期清零
+typedef struct {
+  uint32_t wakeups;           // 唤醒次数
+  uint32_t notified;          // 其中被通知(界面失效/定时器恢复/其它任务投递)唤醒的次数
+  uint64_t busy_us;           // lv_timer_handler 累计耗时
+  int64_t start_us;           // 统计周期开始时间
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+  configRUN_TIME_COUNTER_TYPE idle_start;   // 本核空闲任务的运行时间
+  configRUN_TIME_COUNTER_TYPE total_start;
+#endif
+} lvgl_port_stats_t;
+
+static lvgl_port_stats_t lvgl_stats;
+
+// 刷新流水线统计，LVGL渲染和SPI DMA并行的时间 = SPI忙碌 - 等待DMA - 刷新结束后DMA的收尾
+typedef struct {
+  uint32_t frames;            // 有内容发送的刷新次数
+  uint32_t trans;             // 完成的SPI传输次数
+  uint64_t refr_us;           // 刷新(渲染+flush)累计耗时，含等待DMA
+  uint64_t wait_us;           // 其中LVGL任务等待DMA完成的时间
+  uint64_t spi_us;            // SPI DMA忙碌时间
+  uint64_t tail_us;           // 刷新结束后DMA还在发送、没有与渲染重叠的时间
+} lcd_flush_stats_t;
+
+static lcd_flush_stats_t lcd_flush_stats;
+static portMUX_TYPE lcd_flush_lock = portMUX_INITIALIZER_UNLOCKED;
+// 每块缓冲还没发完的屏数，发给所有屏后才能归还。部分模式编号为显示序号(每个显示同时只有一次flush)，直接模式为中转缓冲序号
+static uint8_t lcd_buf_pending[LCD_TRANS_QUEUE_LEN];
+static uint8_t lcd_trans_cnt;         // 所有屏在途的传输数
+static int64_t lcd_trans_done_us;     // 总线上一次传输完成的时间
+static int64_t lcd_refr_start_us;
+static uint32_t lcd_refr_wait_us;     // 本次刷新中等待DMA的时间
+static int64_t lcd_tail_start_us;     // 刷新结束时DMA还在忙的起点，0为没有
+static bool lcd_refr_flushed;         // 本次刷新是否发送过内容
+
+#if !CONFIG_LCD_RENDER_MODE_DIRECT
+static SemaphoreHandle_t lcd_flush_done_sem;   // DMA发完一块缓冲时释放，LVGL等待缓冲空出时阻塞在这里
+#else
+// 直接渲染模式: 整帧缓冲在PSRAM，刷新时脏区逐行拷贝到内部RAM的中转缓冲再发送，
+// 中转缓冲复用部分渲染模式的两块20行缓冲
+#define LCD_BOUNCE_BUF_CNT 2
+#define LCD_BOUNCE_BUF_SIZE (LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t))
+static uint8_t *lcd_bounce_buf[LCD_BOUNCE_BUF_CNT];
+static uint8_t lcd_bounce_index;
+static SemaphoreHandle_t lcd_bounce_sem;   // 空闲的中转缓冲数，SPI传输完成时归还
+#endif
 
 static void disp_init(void);
 
 static void disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
 
-void increase_lvgl_tick(void *arg)
+/* LVGL直接读取系统时间，不再用周期中断累加tick */
+static uint32_t lvgl_tick_get(void)
+{
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void lvgl_port_wake(void)
+{
+  if (lvgl_task_handle && xTaskGetCurrentTaskHandle() != lvgl_task_handle) {
+    xTaskNotifyGive(lvgl_task_handle);
+  }
+}
+
+void lvgl_port_set_wake_cb(lvgl_port_wake_cb_t cb)
+{
+  lvgl_wake_cb = cb;
+}
+
+void lvgl_port_redraw(void)
+{
+  lvgl_redraw_pending = true;
+  lvgl_port_wake();
+}
+
+/* 定时器被创建/恢复/重置(包括界面失效时恢复刷新定时器)，如果是其它任务持有lv_lock操作的，唤醒LVGL任务重新计算截止时间 */
+static void lvgl_timer_resume_cb(void *data)
+{
+  lvgl_port_wake();
+}
+
+static void lvgl_stats_reset(void)
+{
+  memset(&lvgl_stats, 0, sizeof(lvgl_stats));
+  lvgl_stats.start_us = esp_timer_get_time();
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+  lvgl_stats.idle_start = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(LVGL_TASK_CORE));
+  lvgl_stats.total_start = portGET_RUN_TIME_COUNTER_VALUE();
+#endif
+}
+
+/* 把当前电源状态持续的时间计入空闲统计 */
+static void lcd_power_account(int64_t now)
+{
+  if (lcd_power_state != LCD_POWER_ON) {
+    lcd_power_stats.idle_us += now - lcd_power_since_us;
+  }
+  if (lcd_power_state == LCD_POWER_SLEEP) {
+    lcd_power_stats.sleep_us += now - lcd_power_since_us;
+  }
+  lcd_power_since_us = now;
+}
+
+/* 打印统计周期内每秒唤醒次数、LVGL忙碌占比，开启运行时间统计时再打印本核空闲占比 */
+static void lvgl_stats_log(void)
+{
+  int64_t elapsed_us = esp_timer_get_time() - lvgl_stats.start_us;
+  if (elapsed_us < LVGL_STATS_PERIOD_MS * 1000) {
+    return;
+  }
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+  configRUN_TIME_COUNTER_TYPE idle = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(LVGL_TASK_CORE)) - lvgl_stats.idle_start;
+  configRUN_TIME_COUNTER_TYPE total = portGET_RUN_TIME_COUNTER_VALUE() - lvgl_stats.total_start;
+  ESP_LOGI(TAG, "lvgl wakeups: %" PRIu32 "/s (notified %" PRIu32 "), busy: %" PRIu32 ".%02" PRIu32 "%%, core%d idle: %" PRIu32 "%%",
+           (uint32_t)(lvgl_stats.wakeups * 1000000LL / elapsed_us), lvgl_stats.notified,
+           (uint32_t)(lvgl_stats.busy_us * 100 / elapsed_us), (uint32_t)(lvgl_stats.busy_us * 10000 / elapsed_us % 100),
+           LVGL_TASK_CORE, (uint32_t)(total ? (uint64_t)idle * 100 / total : 0));
+#else
+  ESP_LOGI(TAG, "lvgl wakeups: %" PRIu32 "/s (notified %" PRIu32 "), busy: %" PRIu32 ".%02" PRIu32 "%%",
+           (uint32_t)(lvgl_stats.wakeups * 1000000LL / elapsed_us), lvgl_stats.notified,
+           (uint32_t)(lvgl_stats.busy_us * 100 / elapsed_us), (uint32_t)(lvgl_stats.busy_us * 10000 / elapsed_us % 100));
+#endif
+  lvgl_stats_reset();
+
+  lcd_power_stats_t ps;
+  lcd_power_account(esp_timer_get_time());
+  portENTER_CRITICAL(&lcd_flush_lock);
+  ps = lcd_power_stats;
+  memset(&lcd_power_stats, 0, sizeof(lcd_power_stats));
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  if (ps.idle_us || ps.wakes) {
+    ESP_LOGI(TAG, "lcd idle: %" PRIu32 "%% (sleep %" PRIu32 "%%), wakes: %" PRIu32 ", wake to first pixel: avg %" PRIu32 " us, max %" PRIu32 " us",
+             (uint32_t)(ps.idle_us * 100 / elapsed_us), (uint32_t)(ps.sleep_us * 100 / elapsed_us), ps.wakes,
+             (uint32_t)(ps.first_px ? ps.first_px_us / ps.first_px : 0), ps.first_px_max_us);
+  }
+
+  lcd_flush_stats_t fs;
+  portENTER_CRITICAL(&lcd_flush_lock);
+  fs = lcd_flush_stats;
+  memset(&lcd_flush_stats, 0, sizeof(lcd_flush_stats));
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  if (fs.frames) {
+    uint64_t render_us = fs.refr_us - MIN(fs.wait_us, fs.refr_us);
+    uint64_t idle_spi_us = fs.wait_us + fs.tail_us;
+    uint64_t overlap_us = fs.spi_us > idle_spi_us ? fs.spi_us - idle_spi_us : 0;
+    ESP_LOGI(TAG, "lcd frames: %" PRIu32 ", trans: %" PRIu32 ", per frame render: %" PRIu32 " us, spi: %" PRIu32 " us, overlap: %" PRIu32 " us (%" PRIu32 "%% of render), wait: %" PRIu32 " us",
+             fs.frames, fs.trans, (uint32_t)(render_us / fs.frames), (uint32_t)(fs.spi_us / fs.frames),
+             (uint32_t)(overlap_us / fs.frames), (uint32_t)(render_us ? overlap_us * 100 / render_us : 0),
+             (uint32_t)(fs.wait_us / fs.frames));
+  }
+}
+
+/* 一次 draw_bitmap 排队，传输在总线上前一次传输完成后才真正开始 */
+static void lcd_trans_queued(lcd_panel_t *panel, uint8_t buf, uint32_t bytes)
+{
+  portENTER_CRITICAL(&lcd_flush_lock);
+  uint8_t slot = (panel->trans_head + panel->trans_cnt) % LCD_TRANS_QUEUE_LEN;
+  panel->trans_buf[slot] = buf;
+  panel->trans_queued_us[slot] = esp_timer_get_time();
+  panel->trans_bytes[slot] = bytes;
+  panel->trans_cnt++;
+  lcd_trans_cnt++;
+  lcd_refr_flushed = true;
+  portEXIT_CRITICAL(&lcd_flush_lock);
+}
+
+/* 传输完成中断中调用，累计DMA忙碌时间。返回发完了所有屏、可以归还的缓冲编号，没有返回-1 */
+static int lcd_trans_done(lcd_panel_t *panel)
+{
+  int64_t now = esp_timer_get_time();
+  int64_t start_us = 0;
+  uint32_t bytes = 0;
+  int released = -1;
+  portENTER_CRITICAL_ISR(&lcd_flush_lock);
+  if (panel->trans_cnt) {
+    uint8_t head = panel->trans_head;
+    start_us = MAX(panel->trans_queued_us[head], lcd_trans_done_us);
+    bytes = panel->trans_bytes[head];
+    if (--lcd_buf_pending[panel->trans_buf[head]] == 0) {
+      released = panel->trans_buf[head];
+    }
+    lcd_flush_stats.spi_us += now - start_us;
+    lcd_flush_stats.trans++;
+    panel->trans_head = (head + 1) % LCD_TRANS_QUEUE_LEN;
+    panel->trans_cnt--;
+    lcd_trans_cnt--;
+  }
+  lcd_trans_done_us = now;
+  if (lcd_wake_us) {
+    uint32_t wake_us = now - lcd_wake_us;
+    lcd_power_stats.first_px++;
+    lcd_power_stats.first_px_us += wake_us;
+    lcd_power_stats.first_px_max_us = MAX(lcd_power_stats.first_px_max_us, wake_us);
+    lcd_wake_us = 0;
+  }
+  if (lcd_trans_cnt == 0 && lcd_tail_start_us) {
+    lcd_flush_stats.tail_us += now - lcd_tail_start_us;
+    lcd_tail_start_us = 0;
+  }
+  portEXIT_CRITICAL_ISR(&lcd_flush_lock);
+  if (bytes) {
+    telemetry_record(TELEMETRY_FLUSH, start_us, now, bytes);
+  }
+  return released;
+}
+
+static void lcd_wait_add(int64_t start_us)
+{
+  int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&lcd_flush_lock);
+  lcd_flush_stats.wait_us += now - start_us;
+  lcd_refr_wait_us += now - start_us;
+  portEXIT_CRITICAL(&lcd_flush_lock);
+}
+
+/* 刷新开始/结束。结束时还在发送的部分，到下次刷新开始前都没有与渲染重叠 */
+static void lcd_refr_event_cb(lv_event_t *e)
+{
+  int64_t now = esp_timer_get_time();
+  bool flushed = false;
+  portENTER_CRITICAL(&lcd_flush_lock);
+  if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+    lcd_refr_start_us = now;
+    lcd_refr_wait_us = 0;
+    lcd_refr_flushed = false;
+    if (lcd_tail_start_us) {
+      lcd_flush_stats.tail_us += now - lcd_tail_start_us;
+      lcd_tail_start_us = 0;
+    }
+  } else if (lcd_refr_flushed) {
+    flushed = true;
+    lcd_flush_stats.frames++;
+    lcd_flush_stats.refr_us += now - lcd_refr_start_us;
+    if (lcd_trans_cnt) {
+      lcd_tail_start_us = now;
+    }
+  }
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  // 只在LVGL任务中写 lcd_refr_start_us/lcd_refr_wait_us，出了临界区也可以读
+  if (flushed) {
+    telemetry_record(TELEMETRY_REFR, lcd_refr_start_us, now, lcd_refr_wait_us);
+    // 屏幕镜像只发第一只眼
+    if (lv_event_get_current_target(e) == lcd_disps[0]) {
+      mirror_frame_done();
+    }
+  }
+}
+
+#if CONFIG_LCD_ROUND_DISPLAY
+/* 圆屏每行可见的像素区间: 像素中心在屏幕内切圆内即可见，半径多留一个像素给抗锯齿的边 */
+#define LCD_ROUND_MARGIN 1
+// 行带高度与部分渲染缓冲的行数相同，整屏刷新时一个行带正好渲染、发送一次
+#define LCD_ROUND_BAND_LINES LVGL_DRAW_BUF_LINES
+// 相邻行带合并后多画的像素不超过两行就合并，20MHz SPI下约0.4ms
+#define LCD_ROUND_MERGE_PX (LCD_H_RES * 2)
+static int16_t lcd_round_x1[LCD_V_RES];
+static int16_t lcd_round_x2[LCD_V_RES];
+
+static void lcd_round_init(void)
+{
+  // 坐标乘2，圆心和像素中心都落在整数上
+  int32_t r2 = (LCD_H_RES + 2 * LCD_ROUND_MARGIN) * (LCD_H_RES + 2 * LCD_ROUND_MARGIN);
+  for (int32_t y = 0; y < LCD_V_RES; y++) {
+    int32_t dy = 2 * y + 1 - LCD_V_RES;
+    int32_t x = 0;
+    while (x < LCD_H_RES / 2 && (2 * x + 1 - LCD_H_RES) * (2 * x + 1 - LCD_H_RES) + dy * dy > r2) {
+      x++;
+    }
+    lcd_round_x1[y] = x;
+    lcd_round_x2[y] = LCD_H_RES - 1 - x;
+  }
+}
+
+/* 先去掉上下与可见区间不相交的行，再把左右裁到剩下各行可见区间的并集。整块不可见返回false */
+static bool lcd_round_crop(lv_area_t *area)
+{
+  while (area->y1 <= area->y2 && (lcd_round_x2[area->y1] < area->x1 || lcd_round_x1[area->y1] > area->x2)) {
+    area->y1++;
+  }
+  while (area->y2 >= area->y1 && (lcd_round_x2[area->y2] < area->x1 || lcd_round_x1[area->y2] > area->x2)) {
+    area->y2--;
+  }
+  if (area->y1 > area->y2) {
+    return false;
+  }
+  int32_t x1 = LCD_H_RES, x2 = -1;
+  for (int32_t y = area->y1; y <= area->y2; y++) {
+    x1 = MIN(x1, lcd_round_x1[y]);
+    x2 = MAX(x2, lcd_round_x2[y]);
+  }
+  area->x1 = MAX(area->x1, x1);
+  area->x2 = MIN(area->x2, x2);
+  return true;
+}
+
+static uint32_t lcd_round_size(const lv_area_t *area)
 {
-  /* Tell LVGL how many milliseconds has elapsed */
-  lv_tick_inc(LVGL_TICK_PERIOD_MS);
+  lv_area_t cropped = *area;
+  return lcd_round_crop(&cropped) ? lv_area_get_size(&cropped) : 0;
 }
 
+/* 失效区域按行带拆开，每段各自裁剪到可见圆内。相邻行带合并后多画的像素不超过 LCD_ROUND_MERGE_PX 就不拆，
+ * 屏幕中部各行宽度相近，拆开只会多出区域的固定开销。这里只保留第一段，其余部分重新失效(再进入这里时继续拆)。
+ * 事件中不能丢弃区域，整块不可见时换成已有的第一个失效区域(包含在内，LVGL不再保存)，没有则缩成1个像素。
+ * 渲染过程中LVGL也会发这个事件，用来试探缓冲行数的取整，那不是失效区域，不处理 */
+static void lcd_round_invalidate_cb(lv_event_t *e)
+{
+  lv_display_t *disp = lv_event_get_current_target(e);
+  lv_area_t *area = lv_event_get_invalidated_area(e);
+  if (disp->rendering_in_progress) {
+    return;
+  }
+  lv_area_t group = *area;
+  group.y2 = MIN(area->y2, group.y1 / LCD_ROUND_BAND_LINES * LCD_ROUND_BAND_LINES + LCD_ROUND_BAND_LINES - 1);
+  while (group.y2 < area->y2) {
+    lv_area_t next = group, merged = group;
+    next.y1 = group.y2 + 1;
+    next.y2 = MIN(area->y2, group.y2 + LCD_ROUND_BAND_LINES);
+    merged.y2 = next.y2;
+    if (lcd_round_size(&merged) > lcd_round_size(&group) + lcd_round_size(&next) + LCD_ROUND_MERGE_PX) {
+      break;
+    }
+    group.y2 = next.y2;
+  }
+  if (group.y2 < area->y2) {
+    lv_area_t rest = *area;
+    rest.y1 = group.y2 + 1;
+    area->y2 = group.y2;
+    lv_inv_area(disp, &rest);
+  }
+  // 裁剪失败时 area 的行已被移出原范围，在副本上裁剪，缩成1个像素时仍取原区域左上角
+  lv_area_t cropped = *area;
+  if (lcd_round_crop(&cropped)) {
+    *area = cropped;
+  } else if (disp->inv_p) {
+    *area = disp->inv_areas[0];
+  } else {
+    area->x2 = area->x1;
+    area->y2 = area->y1;
+  }
+}
+#endif
+
+/* SPI传输完成中断: 只有这里才能告诉LVGL缓冲可以重用，同一块缓冲发给几块屏时最后一块屏发完才归还 */
 bool notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
-  lv_display_t *disp = (lv_display_t *)user_ctx;
-  lv_display_flush_ready(disp);
-  return false;
+  BaseType_t need_yield = pdFALSE;
+  int buf = lcd_trans_done((lcd_panel_t *)user_ctx);
+  if (buf < 0) {
+    return false;
+  }
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+  xSemaphoreGiveFromISR(lcd_bounce_sem, &need_yield);
+#else
+  lv_display_flush_ready(lcd_disps[buf]);
+  xSemaphoreGiveFromISR(lcd_flush_done_sem, &need_yield);
+#endif
+  return need_yield == pdTRUE;
+}
+
+#if !CONFIG_LCD_RENDER_MODE_DIRECT
+/* LVGL要往正在发送的缓冲里画时阻塞等待，不再空转。几个显示共用一个信号量，只有LVGL任务在等，
+ * 中断可能在LVGL检查 flushing 之前就已释放过信号量，也可能是别的显示的缓冲发完了，所以循环检查 flushing */
+static void lcd_flush_wait_cb(lv_display_t *disp)
+{
+  int64_t start_us = esp_timer_get_time();
+  while (disp->flushing) {
+    xSemaphoreTake(lcd_flush_done_sem, portMAX_DELAY);
+  }
+  lcd_wait_add(start_us);
 }
+#endif
 
+#if CONFIG_LCD_DRAW_THREAD_PIN
+/* LVGL的FreeRTOS移植用 xTaskCreate 创建绘制线程，不固定核。链接时用 --wrap 接管 lv_thread_init(见 main/CMakeLists.txt)，
+ * 第i个绘制线程固定在 (LVGL_TASK_CORE + i) 核上: 一个绘制单元时和LVGL任务在同一个核，两个时各占一个核 */
+lv_result_t __real_lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                                  void (*callback)(void *), size_t stack_size, void *user_data);
+
+static void lvgl_draw_thread_run(void *arg)
+{
+  lv_thread_t *thread = arg;
+  thread->pvStartRoutine(thread->pTaskArg);
+  vTaskDelete(NULL);
+}
+
+lv_result_t __wrap_lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                                  void (*callback)(void *), size_t stack_size, void *user_data)
+{
+  static uint32_t draw_thread_cnt;
+  if (strcmp(name, "swdraw") != 0) {
+    return __real_lv_thread_init(thread, name, prio, callback, stack_size, user_data);
+  }
+  BaseType_t core = (LVGL_TASK_CORE + draw_thread_cnt++) % portNUM_PROCESSORS;
+  thread->pvStartRoutine = callback;
+  thread->pTaskArg = user_data;
+  if (xTaskCreatePinnedToCore(lvgl_draw_thread_run, name, stack_size / sizeof(StackType_t), thread,
+                              tskIDLE_PRIORITY + prio, &thread->xTaskHandle, core) != pdPASS) {
+    ESP_LOGE(TAG, "create draw thread on core %d fail", (int)core);
+    return LV_RESULT_INVALID;
+  }
+  ESP_LOGI(TAG, "Draw thread %" PRIu32 " pinned to core %d", draw_thread_cnt - 1, (int)core);
+  return LV_RESULT_OK;
+}
+#endif
+
+#if LV_DRAW_SW_DRAW_UNIT_CNT > 1
+/* 一个对象只产生一个绘制任务，多个绘制单元也只有一个在画。把对象竖着切成 LV_DRAW_SW_DRAW_UNIT_CNT 条，
+ * 每条用缩小的裁剪区调一次对象自己的绘制，各条互不重叠，分给不同的绘制线程同时画 */
+static void lvgl_split_draw_cb(lv_event_t *e)
+{
+  lv_obj_t *obj = lv_event_get_current_target(e);
+  lv_layer_t *layer = lv_event_get_layer(e);
+  lv_area_t clip = layer->_clip_area;
+  int32_t w = lv_area_get_width(&obj->coords);
+  for (int32_t i = 0; i < LV_DRAW_SW_DRAW_UNIT_CNT; i++) {
+    lv_area_t slice = clip;
+    // 首尾两条延伸到裁剪区边缘，对象之外的阴影、轮廓等不会漏画
+    if (i > 0) {
+      slice.x1 = obj->coords.x1 + w * i / LV_DRAW_SW_DRAW_UNIT_CNT;
+    }
+    if (i < LV_DRAW_SW_DRAW_UNIT_CNT - 1) {
+      slice.x2 = obj->coords.x1 + w * (i + 1) / LV_DRAW_SW_DRAW_UNIT_CNT - 1;
+    }
+    if (!lv_area_intersect(&layer->_clip_area, &clip, &slice)) {
+      continue;
+    }
+    if (lv_obj_event_base(NULL, e) != LV_RESULT_OK) {
+      break;
+    }
+  }
+  layer->_clip_area = clip;
+  // 已经画过，不再按整个裁剪区调用对象的绘制
+  lv_event_stop_processing(e);
+}
+#endif
+
+void lvgl_port_split_draw(lv_obj_t *obj)
+{
+#if LV_DRAW_SW_DRAW_UNIT_CNT > 1
+  lv_obj_add_event_cb(obj, lvgl_split_draw_cb, LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS, NULL);
+#endif
+}
+
+/* 设置电源状态并把上一个状态的持续时间计入统计 */
+static void lcd_power_set(lcd_power_state_t state)
+{
+  lcd_power_account(esp_timer_get_time());
+  lcd_power_state = state;
+}
+
+/* 空闲足够久后让所有屏进入睡眠(LVGL任务中执行)，显存内容保留 */
+static void lcd_power_sleep(void)
+{
+  // tx_param 会先等排队的像素传输发完
+  for (int i = 0; i < LCD_PANEL_CNT; i++) {
+    ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(lcd_panels[i].io, LCD_CMD_SLPIN, NULL, 0));
+  }
+  lcd_power_set(LCD_POWER_SLEEP);
+}
+
+/* 空闲时LVGL任务下一次必须醒来的时间，不需要醒来返回 portMAX_DELAY */
+static TickType_t lcd_power_idle_wait(void)
+{
+#if CONFIG_LCD_IDLE_SLEEP_MS > 0
+  if (lcd_power_state == LCD_POWER_IDLE) {
+    // 退出睡眠后至少120ms才能再进入睡眠
+    int64_t sleep_us = MAX(lcd_idle_since_us + CONFIG_LCD_IDLE_SLEEP_MS * 1000LL,
+                           lcd_slpout_us + LCD_SLPOUT_TO_SLPIN_MS * 1000LL);
+    int64_t left_us = MAX(sleep_us - esp_timer_get_time(), 0);
+    return (left_us / 1000 + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS + 1;
+  }
+#endif
+  return portMAX_DELAY;
+}
+
+void disp_enter_idle(void)
+{
+  if (lcd_power_state != LCD_POWER_ON) {
+    return;
+  }
+  // 还没画出来的脏区先刷到屏幕上，屏幕停在完整的最后一帧
+  for (int i = 0; i < LCD_DISP_CNT; i++) {
+    if (lcd_disps[i]->inv_p) {
+      lv_refr_now(lcd_disps[i]);
+    }
+    lv_display_enable_invalidation(lcd_disps[i], false);
+    lv_timer_pause(lv_display_get_refr_timer(lcd_disps[i]));
+  }
+  portENTER_CRITICAL(&lcd_flush_lock);
+  lcd_wake_us = 0;
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  lcd_power_set(LCD_POWER_IDLE);
+  lcd_idle_since_us = lcd_power_since_us;
+}
+
+void disp_exit_idle(void)
+{
+  if (lcd_power_state == LCD_POWER_ON) {
+    return;
+  }
+  int64_t now = esp_timer_get_time();
+  if (lcd_power_state == LCD_POWER_SLEEP) {
+    for (int i = 0; i < LCD_PANEL_CNT; i++) {
+      ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(lcd_panels[i].io, LCD_CMD_SLPOUT, NULL, 0));
+    }
+    lcd_slpout_us = esp_timer_get_time();
+    // 退出睡眠后5ms才能发下一条命令，显存里的最后一帧立即重新显示
+    vTaskDelay(MAX(pdMS_TO_TICKS(LCD_SLPOUT_DELAY_MS), 1));
+  }
+  for (int i = 0; i < LCD_DISP_CNT; i++) {
+    lv_display_enable_invalidation(lcd_disps[i], true);
+    lv_timer_resume(lv_display_get_refr_timer(lcd_disps[i]));
+  }
+  portENTER_CRITICAL(&lcd_flush_lock);
+  lcd_wake_us = now;
+  lcd_power_stats.wakes++;
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  lcd_power_set(LCD_POWER_ON);
+}
+
+/* 整屏重画(LVGL任务中)。空闲时失效被禁止: 不改变电源状态，临时允许失效并立即渲染，
+ * 只交给镜像，不发送到屏幕(显存里已是同样的画面)，睡眠中的屏幕不唤醒，也不计入唤醒次数 */
+static void lvgl_port_do_redraw(void)
+{
+  bool idle = lcd_power_state != LCD_POWER_ON;
+  lvgl_redraw_pending = false;
+  for (int i = 0; i < LCD_DISP_CNT; i++) {
+    if (idle) {
+      lv_display_enable_invalidation(lcd_disps[i], true);
+    }
+    lv_obj_invalidate(lv_display_get_screen_active(lcd_disps[i]));
+    if (idle) {
+      lv_refr_now(lcd_disps[i]);
+      lv_display_enable_invalidation(lcd_disps[i], false);
+      // 没有发送到屏幕，刷新结束事件不会结束镜像帧
+      if (i == 0) {
+        mirror_frame_done();
+      }
+    }
+  }
+}
+
+/* 没有定时器到期时一直阻塞，直到下一个定时器的截止时间，或者被其它任务唤醒。
+ * 屏幕空闲时不运行LVGL定时器，只处理唤醒回调 */
 void lvgl_port_task(void *arg)
 {
   ESP_LOGI(TAG, "Starting LVGL task");
   uint32_t time_till_next_ms = 0;
+  bool notified = false;
+  lvgl_stats_reset();
   while (1)
   {
+    int64_t start_us = esp_timer_get_time();
     lv_lock();
-    time_till_next_ms = lv_timer_handler();
+    if (notified && lvgl_wake_cb) {
+      lvgl_wake_cb();
+    }
+    if (lvgl_redraw_pending) {
+      lvgl_port_do_redraw();
+    }
+    if (lcd_power_state == LCD_POWER_ON) {
+      int64_t handler_us = esp_timer_get_time();
+      time_till_next_ms = lv_timer_handler();
+      telemetry_record(TELEMETRY_LVGL, handler_us, esp_timer_get_time(), time_till_next_ms);
+    }
     lv_unlock();
-    // in case of triggering a task watch dog time out
-    time_till_next_ms = MAX(time_till_next_ms, LVGL_TASK_MIN_DELAY_MS);
-    // in case of lvgl display not ready yet
-    time_till_next_ms = MIN(time_till_next_ms, LVGL_TASK_MAX_DELAY_MS);
-    vTaskDelay(pdMS_TO_TICKS(time_till_next_ms));
+    lvgl_stats.busy_us += esp_timer_get_time() - start_us;
+    lvgl_stats_log();
+
+    TickType_t wait = portMAX_DELAY;
+    if (lcd_power_state != LCD_POWER_ON) {
+      wait = lcd_power_idle_wait();
+    } else if (time_till_next_ms != LV_NO_TIMER_READY) {
+      // in case of triggering a task watch dog time out
+      time_till_next_ms = MAX(time_till_next_ms, LVGL_TASK_MIN_DELAY_MS);
+      // 向上取整到系统tick，避免在截止时间之前醒来空转一次
+      wait = (time_till_next_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    }
+    if (lvgl_redraw_pending) {
+      // 渲染过程中(flush里)请求的重画
+      wait = 0;
+    }
+    notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
+    if (!notified && lcd_power_state == LCD_POWER_IDLE && wait != portMAX_DELAY) {
+      lcd_power_sleep();
+    }
+    lvgl_stats.wakeups++;
+    if (notified) {
+      lvgl_stats.notified++;
+    }
   }
 }
 
+lv_display_t *lvgl_port_get_display(uint32_t index)
+{
+  return index < LCD_DISP_CNT ? lcd_disps[index] : NULL;
+}
+
+uint32_t lvgl_port_get_display_count(void)
+{
+  return LCD_DISP_CNT;
+}
+
 void lv_port_disp_init(void)
 {
   /*-------------------------
@@ -66,43 +712,87 @@ void lv_port_disp_init(void)
   disp_init();
   // lvgl initialize
   lv_init();
-  /*------------------------------------
-   * Create a display and set a flush_cb
-   * -----------------------------------*/
-  lv_display_t *disp = lv_display_create(LCD_H_RES, LCD_V_RES);
-  lv_display_set_flush_cb(disp, disp_flush);
 
-  /* Two buffers for partial rendering
+  /* Two buffers for partial rendering per display
    * In flush_cb DMA or similar hardware should be used to update the display in the background.*/
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+#define LCD_DRAW_BUF_SETS 1
+#else
+#define LCD_DRAW_BUF_SETS LCD_DISP_CNT
+#endif
   LV_ATTRIBUTE_MEM_ALIGN
-  static uint8_t buf_1[LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t)];
+  static uint8_t buf_1[LCD_DRAW_BUF_SETS][LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t)];
   LV_ATTRIBUTE_MEM_ALIGN
-  static uint8_t buf_2[LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t)];
-
-  lv_display_set_buffers(disp, buf_1, buf_2, sizeof(buf_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
-  lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
-  // associate the mipi panel handle to the display
-  lv_display_set_user_data(disp, panel_handle);
-  ESP_LOGI(TAG, "Install LVGL tick timer");
-  // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
-  const esp_timer_create_args_t lvgl_tick_timer_args = {
-      .callback = &increase_lvgl_tick,
-      .name = "lvgl_tick"};
-  esp_timer_handle_t lvgl_tick_timer = NULL;
-  ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-  ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000));
+  static uint8_t buf_2[LCD_DRAW_BUF_SETS][LCD_H_RES * LVGL_DRAW_BUF_LINES * sizeof(lv_color16_t)];
+
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+  // 两块小缓冲作为所有显示共用的SPI中转缓冲
+  lcd_bounce_buf[0] = buf_1[0];
+  lcd_bounce_buf[1] = buf_2[0];
+  lcd_bounce_sem = xSemaphoreCreateCounting(LCD_BOUNCE_BUF_CNT, LCD_BOUNCE_BUF_CNT);
+  assert(lcd_bounce_sem);
+#else
+  /* 一块缓冲由DMA发送时LVGL在另一块里渲染，缓冲只在传输完成中断中归还 */
+  lcd_flush_done_sem = xSemaphoreCreateBinary();
+  assert(lcd_flush_done_sem);
+#endif
+#if CONFIG_LCD_ROUND_DISPLAY
+  lcd_round_init();
+#endif
+
+  /*------------------------------------
+   * Create a display and set a flush_cb
+   * 第一个显示是默认显示，只有一个显示时它刷新到所有屏
+   * -----------------------------------*/
+  for (int i = 0; i < LCD_DISP_CNT; i++) {
+    lv_display_t *disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    lv_display_set_flush_cb(disp, disp_flush);
+    lv_display_set_color_format(disp, LCD_COLOR_FORMAT);
+    lcd_disps[i] = disp;
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+    /* Two full-frame buffers in PSRAM: LVGL only redraws the dirty areas and copies
+     * them into the other buffer before the next frame, the small buffers become SPI bounce buffers */
+    uint32_t fb_size = lv_draw_buf_width_to_stride(LCD_H_RES, LCD_COLOR_FORMAT) * LCD_V_RES;
+    void *fb_1 = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, fb_size, MALLOC_CAP_SPIRAM);
+    void *fb_2 = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, fb_size, MALLOC_CAP_SPIRAM);
+    assert(fb_1 && fb_2);
+    lv_display_set_buffers(disp, fb_1, fb_2, fb_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+    ESP_LOGI(TAG, "Display %d render mode: direct, 2 x %" PRIu32 " bytes in PSRAM", i, fb_size);
+#else
+    lv_display_set_buffers(disp, buf_1[i], buf_2[i], sizeof(buf_1[i]), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_wait_cb(disp, lcd_flush_wait_cb);
+    ESP_LOGI(TAG, "Display %d render mode: partial, 2 x %d lines", i, LVGL_DRAW_BUF_LINES);
+#endif
+    lv_display_add_event_cb(disp, lcd_refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, lcd_refr_event_cb, LV_EVENT_REFR_READY, NULL);
+#if CONFIG_LCD_ROUND_DISPLAY
+    // 圆屏四角不渲染也不发送
+    lv_display_add_event_cb(disp, lcd_round_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+#endif
+    // 显示序号，flush时找到它刷新到的屏
+    lv_display_set_user_data(disp, (void *)(uintptr_t)i);
+  }
+  lv_display_set_default(lcd_disps[0]);
+  ESP_LOGI(TAG, "%d panel(s), %d display(s)", LCD_PANEL_CNT, LCD_DISP_CNT);
+  // Tick interface for LVGL: read esp_timer directly, no periodic tick interrupt
+  lv_tick_set_cb(lvgl_tick_get);
+  lv_timer_handler_set_resume_cb(lvgl_timer_resume_cb, NULL);
 
   ESP_LOGI(TAG, "Register io panel event callback for LVGL flush ready notification");
   const esp_lcd_panel_io_callbacks_t cbs = {
       .on_color_trans_done = notify_lvgl_flush_ready,
   };
   /* Register done callback */
-  ESP_ERROR_CHECK(esp_lcd_panel_io_register_event_callbacks(io_handle, &cbs, disp));
+  for (int i = 0; i < LCD_PANEL_CNT; i++) {
+    ESP_ERROR_CHECK(esp_lcd_panel_io_register_event_callbacks(lcd_panels[i].io, &cbs, &lcd_panels[i]));
+  }
 
   ESP_LOGI(TAG, "Create LVGL task");
-  xTaskCreate(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL);
+  xTaskCreatePinnedToCore(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, &lvgl_task_handle, LVGL_TASK_CORE);
 }
 
+/* 所有屏共用 SCLK/MOSI/DC/RST，片选分开。RST只接在第一块屏的驱动上，硬件复位时所有屏一起复位，
+ * 其余屏的驱动没有复位脚，复位时发软件复位命令 */
 static void disp_init(void)
 {
   ESP_LOGI(TAG, "Initialize LCD SPI bus");
@@ -116,52 +806,110 @@ static void disp_init(void)
   };
   ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
 
-  ESP_LOGI(TAG, "Initialize panel IO");
-  esp_lcd_panel_io_spi_config_t io_config = {
-      .dc_gpio_num = PIN_NUM_DC,
-      .cs_gpio_num = PIN_NUM_CS,
-      .pclk_hz = LCD_PIXEL_CLOCK_HZ,
-      .lcd_cmd_bits = LCD_CMD_BITS,
-      .lcd_param_bits = LCD_PARAM_BITS,
-      .spi_mode = 0,
-      .trans_queue_depth = 10,
-  };
-  // Attach the LCD to the SPI bus
-  ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle));
-
-  ESP_LOGI(TAG, "Initialize GC9A01 panel driver");
-  esp_lcd_panel_dev_config_t panel_config = {
-      .reset_gpio_num = PIN_NUM_RST,
-      .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
-      .bits_per_pixel = 16,
-  };
-  ESP_ERROR_CHECK(esp_lcd_new_panel_gc9a01(io_handle, &panel_config, &panel_handle));
-  ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
-  ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
-  ESP_ERROR_CHECK(esp_lcd_panel_invert_color(panel_handle, true));
-  ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, true, false));
-  ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
+  static const int cs_pins[] = {PIN_NUM_CS, PIN_NUM_CS2};
+  for (int i = 0; i < LCD_PANEL_CNT; i++) {
+    ESP_LOGI(TAG, "Initialize panel %d IO, CS: %d", i, cs_pins[i]);
+    esp_lcd_panel_io_spi_config_t io_config = {
+        .dc_gpio_num = PIN_NUM_DC,
+        .cs_gpio_num = cs_pins[i],
+        .pclk_hz = LCD_PIXEL_CLOCK_HZ,
+        .lcd_cmd_bits = LCD_CMD_BITS,
+        .lcd_param_bits = LCD_PARAM_BITS,
+        .spi_mode = 0,
+        .trans_queue_depth = 10,
+    };
+    // Attach the LCD to the SPI bus
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &lcd_panels[i].io));
+
+    ESP_LOGI(TAG, "Initialize GC9A01 panel %d driver", i);
+    esp_lcd_panel_dev_config_t panel_config = {
+        .reset_gpio_num = i == 0 ? PIN_NUM_RST : -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+    };
+    ESP_ERROR_CHECK(esp_lcd_new_panel_gc9a01(lcd_panels[i].io, &panel_config, &lcd_panels[i].panel));
+  }
+  // 先硬件复位(所有屏)，再逐块软件复位、初始化
+  for (int i = 0; i < LCD_PANEL_CNT; i++) {
+    esp_lcd_panel_handle_t panel = lcd_panels[i].panel;
+    ESP_ERROR_CHECK(esp_lcd_panel_reset(panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_init(panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_invert_color(panel, true));
+#if CONFIG_LCD_SECOND_EYE_FLIP
+    // 第二只眼左右翻转由屏幕扫描方向完成，两只眼的画面对称，不多渲染
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel, i == 0, false));
+#else
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel, true, false));
+#endif
+    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel, true));
+  }
 }
 
 esp_err_t lcd_reset(void) {
-  return esp_lcd_panel_reset(panel_handle);
+  for (int i = 0; i < LCD_PANEL_CNT; i++) {
+    esp_err_t err = esp_lcd_panel_reset(lcd_panels[i].panel);
+    if (err != ESP_OK) {
+      return err;
+    }
+  }
+  return ESP_OK;
 }
 
-volatile bool disp_flush_enabled = true;
-
-/* Enable updating the screen (the flushing process) when disp_flush() is called by LVGL
- */
-void disp_enable_update(void)
+/* 把一块像素发给显示对应的所有屏，buf 为这块像素所在缓冲的编号，最后一块屏发完时归还(见 notify_lvgl_flush_ready)。
+ * CASET/RASET 是轮询发送的，要先占用总线，总线上还有像素在发(包括发给另一块屏的)时阻塞到发完，算作等待DMA */
+static void lcd_draw(uint32_t disp_index, uint8_t buf, int x1, int y1, int x2, int y2, const uint8_t *px)
 {
-    disp_flush_enabled = true;
+  uint32_t bytes = (x2 - x1) * (y2 - y1) * sizeof(lv_color16_t);
+  portENTER_CRITICAL(&lcd_flush_lock);
+  lcd_buf_pending[buf] = LCD_DISP_PANEL_CNT;
+  portEXIT_CRITICAL(&lcd_flush_lock);
+  for (int i = 0; i < LCD_DISP_PANEL_CNT; i++) {
+    lcd_panel_t *panel = &lcd_panels[disp_index * LCD_DISP_PANEL_CNT + i];
+    int64_t start_us = esp_timer_get_time();
+    lcd_trans_queued(panel, buf, bytes);
+    esp_lcd_panel_draw_bitmap(panel->panel, x1, y1, x2, y2, px);
+    lcd_wait_add(start_us);
+  }
 }
 
-/* Disable updating the screen (the flushing process) when disp_flush() is called by LVGL
- */
-void disp_disable_update(void)
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+/* px_map 是整帧缓冲，脏区的行不连续: 按中转缓冲能放下的行数分块拷贝后发送。
+ * 拷贝完帧缓冲就不再被读取，可以马上告诉LVGL flush完成；两块中转缓冲同时在途，由传输完成中断归还 */
+static void disp_flush_direct(uint32_t disp_index, const lv_area_t *area, const uint8_t *px_map)
 {
-    disp_flush_enabled = false;
+  uint32_t stride = lv_draw_buf_width_to_stride(LCD_H_RES, LCD_COLOR_FORMAT);
+  uint32_t line_size = lv_area_get_width(area) * sizeof(lv_color16_t);
+  int32_t lines = LCD_BOUNCE_BUF_SIZE / line_size;
+  const uint8_t *src = px_map + area->y1 * stride + area->x1 * sizeof(lv_color16_t);
+  for (int32_t y = area->y1; y <= area->y2; y += lines) {
+    int32_t h = MIN(lines, area->y2 - y + 1);
+    if (xSemaphoreTake(lcd_bounce_sem, 0) != pdTRUE) {
+      int64_t start_us = esp_timer_get_time();
+      xSemaphoreTake(lcd_bounce_sem, portMAX_DELAY);
+      lcd_wait_add(start_us);
+    }
+    uint8_t index = lcd_bounce_index;
+    uint8_t *dst = lcd_bounce_buf[index];
+    lcd_bounce_index = (lcd_bounce_index + 1) % LCD_BOUNCE_BUF_CNT;
+    for (int32_t i = 0; i < h; i++) {
+      memcpy(dst + i * line_size, src, line_size);
+      src += stride;
+    }
+    if (lcd_power_state != LCD_POWER_ON) {
+      // 空闲时的重画只给镜像(见 lvgl_port_do_redraw)，中转缓冲直接归还
+      if (disp_index == 0) {
+        mirror_capture(area->x1, y, lv_area_get_width(area), h, dst, LCD_IDLE_MIRROR_WAIT_MS);
+      }
+      xSemaphoreGive(lcd_bounce_sem);
+      continue;
+    }
+    if (disp_index == 0) {
+      mirror_capture(area->x1, y, lv_area_get_width(area), h, dst, 0);
+    }
+    lcd_draw(disp_index, index, area->x1, y, area->x2 + 1, y + h, dst);
+  }
 }
+#endif
 
 /*Flush the content of the internal buffer the specific area on the display.
  *`px_map` contains the rendered image as raw pixel map and it should be copied to `area` on the display.
@@ -169,21 +917,29 @@ void disp_disable_update(void)
  *'lv_display_flush_ready()' has to be called when it's finished.*/
 static void disp_flush(lv_display_t * disp_drv, const lv_area_t * area, uint8_t * px_map)
 {
-    if(disp_flush_enabled) {
-      int x1 = area->x1;
-      int x2 = area->x2;
-      int y1 = area->y1;
-      int y2 = area->y2;
-      // 计算像素数量
-      uint32_t pixel_count = (x2 - x1 + 1) * (y2 - y1 + 1);
-      // because SPI LCD is big-endian, we need to swap the RGB bytes order
-      lv_draw_sw_rgb565_swap(px_map, pixel_count);
-      esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp_drv);
-      // copy a buffer's content to a specific area of the display
-      esp_lcd_panel_draw_bitmap(panel_handle, x1, y1, x2 + 1, y2 + 1, px_map);
-    }
-
-    /*IMPORTANT!!!
-     *Inform the graphics library that you are ready with the flushing*/
+    uint32_t disp_index = (uintptr_t)lv_display_get_user_data(disp_drv);
+#if CONFIG_LCD_RENDER_MODE_DIRECT
+    disp_flush_direct(disp_index, area, px_map);
     lv_display_flush_ready(disp_drv);
-}
\ No newline at end of file
+#else
+    int x1 = area->x1;
+    int x2 = area->x2;
+    int y1 = area->y1;
+    int y2 = area->y2;
+    // px_map is already in the panel's big-endian byte order (LCD_COLOR_FORMAT), send it as is
+    // copy a buffer's content to a specific area of the display,
+    // px_map is handed back to LVGL from the transfer done ISR (notify_lvgl_flush_ready)
+    if (lcd_power_state != LCD_POWER_ON) {
+      // 空闲时的重画只给镜像(见 lvgl_port_do_redraw)，不发送到屏幕
+      if (disp_index == 0) {
+        mirror_capture(x1, y1, x2 - x1 + 1, y2 - y1 + 1, px_map, LCD_IDLE_MIRROR_WAIT_MS);
+      }
+      lv_display_flush_ready(disp_drv);
+      return;
+    }
+    if (disp_index == 0) {
+      mirror_capture(x1, y1, x2 - x1 + 1, y2 - y1 + 1, px_map, 0);
+    }
+    lcd_draw(disp_index, disp_index, x1, y1, x2 + 1, y2 + 1, px_map);
+#endif
+}
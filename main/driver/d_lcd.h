@@ -1,11 +1,56 @@
 #ifndef __D_LCD_H__
 #define __D_LCD_H__
 
+#include "esp_err.h"
+#include "lvgl.h"
+
+typedef void (*lvgl_port_wake_cb_t)(void);
+
 void lv_port_disp_init(void);
 
-void disp_enable_update(void);
+/**
+ * 唤醒LVGL任务。LVGL任务没有到期的定时器时一直阻塞，其它任务投递了要在LVGL任务中处理的工作后调用
+ */
+void lvgl_port_wake(void);
+
+/**
+ * 注册LVGL任务被 lvgl_port_wake 唤醒后调用的回调(持有lv_lock，在 lv_timer_handler 之前执行)
+ */
+void lvgl_port_set_wake_cb(lvgl_port_wake_cb_t cb);
+
+/**
+ * 请求整屏重画(任何任务中都可调用)，在LVGL任务下一次循环中失效整个屏幕。
+ * 屏幕空闲时也立即画一次再回到空闲，画面不变，只是重新经过 flush
+ */
+void lvgl_port_redraw(void);
+
+/**
+ * 第 index 个LVGL显示，不存在返回NULL。第0个是默认显示(第一只眼)，
+ * 配置了 LCD_SECOND_EYE_OWN 时第1个显示给第二只眼，否则第二只眼跟随第0个显示
+ */
+lv_display_t *lvgl_port_get_display(uint32_t index);
+
+/**
+ * LVGL显示的数量
+ */
+uint32_t lvgl_port_get_display_count(void);
+
+/**
+ * 多个绘制单元(LV_DRAW_SW_DRAW_UNIT_CNT > 1)时把对象竖着切成几条分别提交绘制，由各个绘制线程同时画，
+ * 用于占满屏幕的大图像。只有一个绘制单元时什么都不做
+ */
+void lvgl_port_split_draw(lv_obj_t *obj);
+
+/**
+ * 屏幕进入空闲(LVGL任务中调用)：先把未画完的脏区刷出去，然后暂停刷新定时器、停止运行LVGL定时器，
+ * 屏幕停在最后一帧。配置了 LCD_IDLE_SLEEP_MS 时空闲超过该时间屏幕进入睡眠
+ */
+void disp_enter_idle(void);
 
-void disp_disable_update(void);
+/**
+ * 退出空闲(LVGL任务中调用)：屏幕睡眠时先唤醒屏幕，显存里的最后一帧立即重新显示，然后恢复渲染
+ */
+void disp_exit_idle(void);
 
 esp_err_t lcd_reset(void);
 
@@ -30,7 +30,7 @@ void set_servo_angle(int16_t angle_deg)
     ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty));
     ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0));
 
-    ESP_LOGI(TAG, "Angle: %d deg, Pulse: %dus, Duty: %.2f\%", angle_deg - SERVO_RANGE_DEG / 2, pulse_width_us, (float)pulse_width_us / 20000 * 100);
+    ESP_LOGI(TAG, "Angle: %d deg, Pulse: %dus, Duty: %.2f%%", angle_deg - SERVO_RANGE_DEG / 2, pulse_width_us, (float)pulse_width_us / 20000 * 100);
 }
 
 
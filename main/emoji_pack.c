@@ -0,0 +1,480 @@
+#include "emoji_pack.h"
+#include "config.h"
+#include "telemetry.h"
+#include "lvgl_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "emoji_pack";
+
+// 帧延时不超过10ms时按100ms播放，与 gif2pack.py 换算GIF延时和 emoji_gif 的规则相同
+#define PACK_SHORT_FRAME_DELAY_MAX 10
+#define PACK_SHORT_FRAME_DELAY 100
+
+// 帧包播放对象，画布为RGB565(或与屏幕同为RGB565_SWAPPED)，每帧只把变化的矩形直接拷贝进画布
+typedef struct {
+    lv_image_t img;
+    lv_fs_file_t fd;
+    bool opened;
+    const uint8_t *data;         // 内存中(资源分区映射)的帧包，帧表和帧数据直接从这里读取
+    emoji_pack_header_t header;
+    const emoji_pack_frame_t *frames; // 帧表
+    uint8_t *canvas;             // 16位画布，字节序与帧包相同
+    uint8_t *scratch;            // 单帧数据读取缓存，内存中的帧包不需要
+    uint8_t *buf;                // 外部提供的内存，NULL则每次打开时申请
+    uint32_t buf_size;
+    lv_image_dsc_t imgdsc;
+    lv_timer_t *timer;
+    uint16_t frame_index;        // 当前显示的帧
+    int32_t loop_count;
+    uint32_t last_call;
+} emoji_pack_t;
+
+static void emoji_pack_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void emoji_pack_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void next_frame_task_cb(lv_timer_t *t);
+static void schedule_next(emoji_pack_t *pack);
+
+const lv_obj_class_t emoji_pack_class = {
+    .constructor_cb = emoji_pack_constructor,
+    .destructor_cb = emoji_pack_destructor,
+    .instance_size = sizeof(emoji_pack_t),
+    .base_class = &lv_image_class,
+    .name = "emoji_pack",
+};
+
+/**
+ * 释放帧包资源
+ */
+static void emoji_pack_close(emoji_pack_t *pack) {
+    if (pack->canvas) {
+        lv_image_cache_drop(&pack->imgdsc);
+    }
+    if (pack->opened) {
+        lv_fs_close(&pack->fd);
+        pack->opened = false;
+    }
+    if (pack->buf == NULL) {
+        if (pack->data == NULL) {
+            lv_free((void *)pack->frames);
+        }
+        lv_free(pack->canvas);
+        lv_free(pack->scratch);
+    }
+    pack->data = NULL;
+    pack->frames = NULL;
+    pack->canvas = NULL;
+    pack->scratch = NULL;
+}
+
+/**
+ * 画布字节数(RGB565)
+ */
+static uint32_t pack_canvas_size(const emoji_pack_header_t *header) {
+    return (uint32_t)header->width * header->height * 2;
+}
+
+/**
+ * 以header打开帧包需要的内存: 画布 + 帧表 + 单帧缓存，内存中的帧包只需要画布
+ */
+static uint32_t pack_mem_size(const emoji_pack_header_t *header, bool in_memory) {
+    uint32_t canvas_size = LV_ALIGN_UP(pack_canvas_size(header), 4);
+    if (in_memory) {
+        return canvas_size;
+    }
+    uint32_t table_size = header->frame_count * sizeof(emoji_pack_frame_t);
+    return canvas_size + table_size + header->max_frame_size;
+}
+
+/**
+ * 校验帧包头: 画面不超过屏幕；单帧缓存不超过两倍画布(整帧RLE最坏也只比画布大1/256)，算内存时不会溢出
+ */
+static bool check_header(const emoji_pack_header_t *header) {
+    return memcmp(header->magic, EMOJI_PACK_MAGIC, 4) == 0 && header->frame_count != 0 &&
+           header->width <= LCD_H_RES && header->height <= LCD_V_RES &&
+           header->max_frame_size <= pack_canvas_size(header) * 2;
+}
+
+/**
+ * 读取并校验帧包头
+ */
+static bool read_header(lv_fs_file_t *fd, emoji_pack_header_t *header) {
+    uint32_t read = 0;
+    lv_fs_read(fd, header, sizeof(*header), &read);
+    return read == sizeof(*header) && check_header(header);
+}
+
+/**
+ * 校验一帧的矩形在画面之内，数据不超过单帧缓存，不压缩的帧数据正好是整个矩形
+ */
+static bool check_frame(const emoji_pack_header_t *header, const emoji_pack_frame_t *frame) {
+    if ((uint32_t)frame->x + frame->w > header->width || (uint32_t)frame->y + frame->h > header->height ||
+        frame->size > header->max_frame_size) {
+        return false;
+    }
+    return (frame->flags & EMOJI_PACK_FRAME_RLE) || frame->size == (uint32_t)frame->w * frame->h * 2;
+}
+
+/**
+ * 校验帧表，返回第一个无效帧的序号，全部有效时返回 frame_count
+ */
+static uint16_t check_frames(const emoji_pack_header_t *header, const emoji_pack_frame_t *frames) {
+    uint16_t i = 0;
+    while (i < header->frame_count && check_frame(header, &frames[i])) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * 校验内存中的帧包头和帧表范围
+ */
+static bool check_data(const uint8_t *data, uint32_t size) {
+    const emoji_pack_header_t *header = (const emoji_pack_header_t *)data;
+    if (size < sizeof(*header) || !check_header(header)) {
+        return false;
+    }
+    const emoji_pack_frame_t *frames = (const emoji_pack_frame_t *)&header[1];
+    if ((size - sizeof(*header)) / sizeof(emoji_pack_frame_t) < header->frame_count) {
+        return false;
+    }
+    for (uint16_t i = 0; i < header->frame_count; i++) {
+        if (frames[i].offset > size || frames[i].size > size - frames[i].offset) {
+            return false;
+        }
+    }
+    return check_frames(header, frames) == header->frame_count;
+}
+
+/**
+ * RLE解码到画布的矩形区域，格式见 tools/gif2pack.py，数据不够填满矩形时返回false
+ */
+static bool decode_rle(emoji_pack_t *pack, const emoji_pack_frame_t *frame, const uint8_t *src, uint32_t size) {
+    const uint8_t *end = src + size;
+    uint32_t stride = pack->header.width;
+    uint16_t *row = (uint16_t *)pack->canvas + frame->y * stride + frame->x;
+    uint16_t x = 0, y = 0;
+    while (src < end && y < frame->h) {
+        uint8_t ctrl = *src++;
+        uint16_t count = (ctrl & 0x7F) + 1;
+        bool run = ctrl & 0x80;
+        uint16_t color = 0;
+        if (run) {
+            if (end - src < 2) {
+                return false;
+            }
+            color = src[0] | (src[1] << 8);
+            src += 2;
+        } else if (end - src < count * 2) {
+            return false;
+        }
+        while (count) {
+            uint16_t n = LV_MIN(count, frame->w - x);
+            if (run) {
+                for (uint16_t i = 0; i < n; i++) {
+                    row[x + i] = color;
+                }
+            } else {
+                memcpy(&row[x], src, n * 2);
+                src += n * 2;
+            }
+            count -= n;
+            x += n;
+            if (x == frame->w) {
+                x = 0;
+                y++;
+                row += stride;
+                if (y == frame->h) {
+                    break;
+                }
+            }
+        }
+    }
+    return y == frame->h;
+}
+
+/**
+ * 把第index帧的变化区域写入画布，并只刷新该区域
+ */
+static bool apply_frame(lv_obj_t *obj, uint16_t index) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    const emoji_pack_frame_t *frame = &pack->frames[index];
+    pack->frame_index = index;
+    if (frame->w == 0 || frame->h == 0) {
+        return true;
+    }
+    const uint8_t *src = pack->scratch;
+    if (pack->data) {
+        // 直接从映射的flash中解码，不经过缓存
+        src = pack->data + frame->offset;
+    } else {
+        uint32_t read = 0;
+        lv_fs_seek(&pack->fd, frame->offset, LV_FS_SEEK_SET);
+        if (lv_fs_read(&pack->fd, pack->scratch, frame->size, &read) != LV_FS_RES_OK || read != frame->size) {
+            ESP_LOGW(TAG, "read frame %d failed", index);
+            return false;
+        }
+    }
+    if (frame->flags & EMOJI_PACK_FRAME_RLE) {
+        if (!decode_rle(pack, frame, src, frame->size)) {
+            ESP_LOGW(TAG, "frame %d: rle data too short", index);
+            return false;
+        }
+    } else {
+        uint32_t row_size = frame->w * 2;
+        uint32_t stride = pack->header.width * 2;
+        uint8_t *dst = pack->canvas + frame->y * stride + frame->x * 2;
+        for (uint16_t j = 0; j < frame->h; j++) {
+            memcpy(dst, src, row_size);
+            dst += stride;
+            src += row_size;
+        }
+    }
+    lv_image_cache_drop(&pack->imgdsc);
+    // 只刷新变化的矩形
+    lv_area_t area;
+    area.x1 = obj->coords.x1 + frame->x;
+    area.y1 = obj->coords.y1 + frame->y;
+    area.x2 = area.x1 + frame->w - 1;
+    area.y2 = area.y1 + frame->h - 1;
+    lv_obj_invalidate_area(obj, &area);
+    return true;
+}
+
+lv_obj_t *emoji_pack_create(lv_obj_t *parent) {
+    lv_obj_t *obj = lv_obj_class_create_obj(&emoji_pack_class, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+uint32_t emoji_pack_probe(const char *path) {
+    lv_fs_file_t fd;
+    emoji_pack_header_t header;
+    if (lv_fs_open(&fd, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        ESP_LOGW(TAG, "open %s failed", path);
+        return 0;
+    }
+    bool ok = read_header(&fd, &header);
+    lv_fs_close(&fd);
+    if (!ok) {
+        ESP_LOGW(TAG, "invalid frame pack: %s", path);
+        return 0;
+    }
+    return pack_mem_size(&header, false);
+}
+
+uint32_t emoji_pack_probe_data(const void *data, uint32_t size) {
+    if (!check_data(data, size)) {
+        ESP_LOGW(TAG, "invalid frame pack data");
+        return 0;
+    }
+    return pack_mem_size(data, true);
+}
+
+void emoji_pack_set_buffer(lv_obj_t *obj, void *buf, uint32_t buf_size) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    emoji_pack_close(pack);
+    lv_timer_pause(pack->timer);
+    pack->buf = buf;
+    pack->buf_size = buf_size;
+}
+
+/**
+ * 为已读出header的帧包分配画布(以及帧表和单帧缓存)，优先使用外部提供的内存
+ */
+static bool pack_alloc(emoji_pack_t *pack) {
+    bool in_memory = pack->data != NULL;
+    uint32_t canvas_size = pack_canvas_size(&pack->header);
+    uint32_t table_size = pack->header.frame_count * sizeof(emoji_pack_frame_t);
+    if (pack->buf) {
+        // 在预分配的内存中原地打开，不再申请
+        uint32_t need = pack_mem_size(&pack->header, in_memory);
+        if (need > pack->buf_size) {
+            ESP_LOGE(TAG, "buffer too small: %" PRIu32 " < %" PRIu32, pack->buf_size, need);
+            return false;
+        }
+        pack->canvas = pack->buf;
+        if (!in_memory) {
+            pack->frames = (emoji_pack_frame_t *)(pack->buf + LV_ALIGN_UP(canvas_size, 4));
+            pack->scratch = (uint8_t *)pack->frames + table_size;
+        }
+        return true;
+    }
+    pack->canvas = lv_malloc(canvas_size);
+    if (!in_memory) {
+        pack->frames = lv_malloc(table_size);
+        pack->scratch = lv_malloc(pack->header.max_frame_size);
+    }
+    return pack->canvas && pack->frames && (in_memory || pack->scratch);
+}
+
+/**
+ * 帧表就绪后显示第0帧并开始播放，第0帧解不出来时关闭帧包，画布里可能还是上一段的残留
+ */
+static bool pack_start(lv_obj_t *obj) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    memset(&pack->imgdsc, 0, sizeof(pack->imgdsc));
+    pack->imgdsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    pack->imgdsc.header.flags = LV_IMAGE_FLAGS_MODIFIABLE;
+    // 帧包像素已按屏幕字节序保存时，LVGL绘制画布只需拷贝
+    pack->imgdsc.header.cf = (pack->header.flags & EMOJI_PACK_SWAPPED) ? LV_COLOR_FORMAT_RGB565_SWAPPED
+                                                                     : LV_COLOR_FORMAT_RGB565;
+    pack->imgdsc.header.w = pack->header.width;
+    pack->imgdsc.header.h = pack->header.height;
+    pack->imgdsc.header.stride = pack->header.width * 2;
+    pack->imgdsc.data_size = pack_canvas_size(&pack->header);
+    pack->imgdsc.data = pack->canvas;
+
+    // 第0帧总是整幅画面
+    if (!apply_frame(obj, 0)) {
+        emoji_pack_close(pack);
+        lv_image_set_src(obj, NULL);
+        return false;
+    }
+    lv_image_set_src(obj, &pack->imgdsc);
+
+    pack->last_call = lv_tick_get();
+    lv_timer_resume(pack->timer);
+    schedule_next(pack);
+    return true;
+}
+
+void emoji_pack_set_src(lv_obj_t *obj, const char *path) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    emoji_pack_close(pack);
+    lv_timer_pause(pack->timer);
+
+    if (lv_fs_open(&pack->fd, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        ESP_LOGW(TAG, "open %s failed", path);
+        return;
+    }
+    pack->opened = true;
+    if (!read_header(&pack->fd, &pack->header)) {
+        ESP_LOGW(TAG, "invalid frame pack: %s", path);
+        emoji_pack_close(pack);
+        return;
+    }
+    if (!pack_alloc(pack)) {
+        ESP_LOGE(TAG, "no memory for frame pack: %s", path);
+        emoji_pack_close(pack);
+        return;
+    }
+    uint32_t table_size = pack->header.frame_count * sizeof(emoji_pack_frame_t);
+    uint32_t read = 0;
+    lv_fs_read(&pack->fd, (void *)pack->frames, table_size, &read);
+    if (read != table_size || check_frames(&pack->header, pack->frames) != pack->header.frame_count) {
+        ESP_LOGW(TAG, "invalid frame table: %s", path);
+        emoji_pack_close(pack);
+        return;
+    }
+    if (!pack_start(obj)) {
+        ESP_LOGW(TAG, "invalid first frame: %s", path);
+    }
+}
+
+void emoji_pack_set_data(lv_obj_t *obj, const void *data, uint32_t size) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    emoji_pack_close(pack);
+    lv_timer_pause(pack->timer);
+
+    if (!check_data(data, size)) {
+        ESP_LOGW(TAG, "invalid frame pack data");
+        return;
+    }
+    // 帧表直接指向内存中的帧包，只有画布需要分配
+    pack->data = data;
+    memcpy(&pack->header, data, sizeof(pack->header));
+    pack->frames = (const emoji_pack_frame_t *)(pack->data + sizeof(emoji_pack_header_t));
+    if (!pack_alloc(pack)) {
+        ESP_LOGE(TAG, "no memory for frame pack data");
+        emoji_pack_close(pack);
+        return;
+    }
+    if (!pack_start(obj)) {
+        ESP_LOGW(TAG, "invalid first frame in frame pack data");
+    }
+}
+
+bool emoji_pack_is_loaded(lv_obj_t *obj) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    return pack->canvas != NULL;
+}
+
+void emoji_pack_set_loop_count(lv_obj_t *obj, int32_t count) {
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    pack->loop_count = count;
+}
+
+static void emoji_pack_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj) {
+    LV_UNUSED(class_p);
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    pack->opened = false;
+    pack->data = NULL;
+    pack->frames = NULL;
+    pack->canvas = NULL;
+    pack->scratch = NULL;
+    pack->buf = NULL;
+    pack->buf_size = 0;
+    pack->loop_count = 0;
+    pack->timer = lv_timer_create(next_frame_task_cb, 10, obj);
+    lv_timer_pause(pack->timer);
+}
+
+static void emoji_pack_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj) {
+    LV_UNUSED(class_p);
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    emoji_pack_close(pack);
+    lv_timer_delete(pack->timer);
+}
+
+/**
+ * 当前帧的显示时长(ms)
+ */
+static uint32_t frame_delay(const emoji_pack_t *pack) {
+    uint32_t delay = pack->frames[pack->frame_index].delay;
+    return delay <= PACK_SHORT_FRAME_DELAY_MAX ? PACK_SHORT_FRAME_DELAY : delay;
+}
+
+/**
+ * 把定时器设到当前帧显示满帧延时的时刻，LVGL任务据此阻塞到下一帧
+ */
+static void schedule_next(emoji_pack_t *pack) {
+    uint32_t delay = frame_delay(pack);
+    uint32_t elaps = lv_tick_elaps(pack->last_call);
+    lv_timer_set_period(pack->timer, delay > elaps ? delay - elaps : 1);
+    lv_timer_reset(pack->timer);
+}
+
+static void next_frame_task_cb(lv_timer_t *t) {
+    lv_obj_t *obj = lv_timer_get_user_data(t);
+    emoji_pack_t *pack = (emoji_pack_t *)obj;
+    if (lv_tick_elaps(pack->last_call) < frame_delay(pack)) {
+        schedule_next(pack);
+        return;
+    }
+    pack->last_call = lv_tick_get();
+    int64_t start_us = esp_timer_get_time();
+
+    uint16_t next = pack->frame_index + 1;
+    if (next == pack->header.frame_count) {
+        // 最后一次循环播放完毕
+        if (pack->loop_count == 1) {
+            lv_timer_pause(t);
+            lv_obj_send_event(obj, LV_EVENT_READY, NULL);
+            return;
+        }
+        if (pack->loop_count > 1) {
+            pack->loop_count--;
+        }
+        next = 0;
+    }
+    if (!apply_frame(obj, next)) {
+        lv_timer_pause(t);
+        lv_obj_send_event(obj, LV_EVENT_READY, NULL);
+        return;
+    }
+    schedule_next(pack);
+    telemetry_record(TELEMETRY_FRAME, start_us, esp_timer_get_time(), pack->frames[next].w * pack->frames[next].h);
+}
@@ -0,0 +1,79 @@
+#ifndef __EMOJI_PACK_H__
+#define __EMOJI_PACK_H__
+
+#include "lvgl.h"
+
+// 帧包文件魔数
+#define EMOJI_PACK_MAGIC      "EPK1"
+// 帧数据为RLE编码
+#define EMOJI_PACK_FRAME_RLE  0x0001
+// 帧包头标志: 像素为高字节在前(RGB565_SWAPPED，与SPI屏相同)，否则为LVGL原生的RGB565
+#define EMOJI_PACK_SWAPPED    0x0001
+
+// 帧包头(格式见 tools/gif2pack.py)
+typedef struct {
+    char     magic[4];
+    uint16_t width;
+    uint16_t height;
+    uint16_t frame_count;
+    uint16_t flags;
+    uint32_t max_frame_size;     // 最大一帧的数据字节数
+} emoji_pack_header_t;
+
+// 帧表项，x/y/w/h为本帧相对上一帧变化的矩形
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint16_t delay;              // 本帧显示时长(毫秒)
+    uint16_t flags;
+    uint32_t offset;             // 数据在文件中的偏移
+    uint32_t size;               // 数据字节数
+} emoji_pack_frame_t;
+
+extern const lv_obj_class_t emoji_pack_class;
+
+/**
+ * 创建帧包播放对象，播放完毕后发送 LV_EVENT_READY
+ */
+lv_obj_t *emoji_pack_create(lv_obj_t *parent);
+
+/**
+ * 读取帧包头，返回打开该帧包需要的内存字节数，失败返回0
+ */
+uint32_t emoji_pack_probe(const char *path);
+
+/**
+ * 校验内存中的帧包，返回以 emoji_pack_set_data 打开它需要的内存字节数(只有画布)，失败返回0
+ */
+uint32_t emoji_pack_probe_data(const void *data, uint32_t size);
+
+/**
+ * 指定画布、帧表和单帧缓存使用的内存，之后切换帧包都在这块内存中原地打开，
+ * 大小取所有帧包 emoji_pack_probe 的最大值，传NULL恢复自行申请
+ */
+void emoji_pack_set_buffer(lv_obj_t *obj, void *buf, uint32_t buf_size);
+
+/**
+ * 设置帧包文件(如 "S:/pack/blink_once.epk")，并从第0帧开始播放
+ */
+void emoji_pack_set_src(lv_obj_t *obj, const char *path);
+
+/**
+ * 设置内存中的帧包(如资源分区中映射的数据)，帧表和帧数据直接从data读取，不拷贝，
+ * data需在播放期间一直有效
+ */
+void emoji_pack_set_data(lv_obj_t *obj, const void *data, uint32_t size);
+
+/**
+ * 帧包是否加载成功
+ */
+bool emoji_pack_is_loaded(lv_obj_t *obj);
+
+/**
+ * 设置播放次数，0为无限循环
+ */
+void emoji_pack_set_loop_count(lv_obj_t *obj, int32_t count);
+
+#endif
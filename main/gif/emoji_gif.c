@@ -0,0 +1,706 @@
+/**
+ * GIF播放对象，移植自 LVGL 的 lv_gif (src/libs/gif/lv_gif.c)
+ */
+#include "emoji_gif.h"
+#include "lvgl_private.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "telemetry.h"
+#if EMOJI_GIF_DECODE_TASK
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#endif
+
+#if EMOJI_GIF_DECODE_TASK && EMOJI_GIF_FRAME_SLOTS < 3
+#error "EMOJI_GIF_FRAME_SLOTS must be at least 3"
+#endif
+
+#define MY_CLASS (&emoji_gif_class)
+
+#define DECODE_TASK_STACK_SIZE  (4 * 1024)
+#define DECODE_TASK_PRIORITY    2
+
+/* GIF 帧延时不超过10ms(0或1个单位)时按100ms播放，浏览器也这样处理，gif2pack.py 和帧包用同一规则 */
+#define SHORT_FRAME_DELAY_MAX   10
+#define SHORT_FRAME_DELAY       100
+/* 到时间解码任务还没交帧时，隔多久再取 */
+#define LATE_RETRY_PERIOD       2
+
+#if EMOJI_GIF_DECODE_TASK
+/* 帧槽: 解码任务把画布复制进来，LVGL 只切换 imgdsc.data 指向哪个槽 */
+typedef struct {
+    uint8_t * buf;
+    lv_area_t area;             /* 相对上一帧变化的区域，显示时刷新 */
+    lv_area_t dirty;            /* 上次填充后画布又变化过的区域，填充时只复制这部分 */
+    uint32_t delay;             /* 本帧显示时长(ms) */
+    uint32_t gen;               /* 所属的源，切换源后旧帧丢弃 */
+    bool last;                  /* 动画结束标记，不含画面 */
+} emoji_gif_slot_t;
+#endif
+
+typedef struct {
+    lv_image_t img;
+    gif_dec_t * gif;
+    lv_timer_t * timer;
+    lv_image_dsc_t imgdsc;
+    uint32_t last_call;
+    lv_color_format_t cf;
+    void * buf;                 /* 外部提供的解码内存，NULL则每次打开时申请 */
+    uint32_t buf_size;
+    emoji_gif_stats_t stats;
+#if EMOJI_GIF_DECODE_TASK
+    TaskHandle_t task;
+    SemaphoreHandle_t lock;     /* 保护解码器、帧槽内容和 gen */
+    QueueHandle_t free_q;       /* 空闲帧槽序号 */
+    QueueHandle_t ready_q;      /* 已解码、按顺序等待显示的帧槽序号 */
+    emoji_gif_slot_t slots[EMOJI_GIF_FRAME_SLOTS];
+    uint32_t slot_size;         /* 自行申请的帧槽大小，0为没有申请(帧槽在外部内存中或未分配) */
+    int8_t shown;               /* 正在显示的帧槽，-1为无 */
+    uint32_t gen;
+    bool run;                   /* 允许解码任务往前解码 */
+    bool done;                  /* 已解码到动画结尾 */
+#endif
+} emoji_gif_t;
+
+static void emoji_gif_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void emoji_gif_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void next_frame_task_cb(lv_timer_t * t);
+static void schedule_next(emoji_gif_t * gifobj, uint32_t delay);
+static uint32_t frame_delay(const gif_dec_t * gif);
+static void invalidate_frame(lv_obj_t * obj, const lv_area_t * area);
+#if EMOJI_GIF_DECODE_TASK
+static void decode_task(void * arg);
+static void slots_free(emoji_gif_t * gifobj);
+static bool decode_start(emoji_gif_t * gifobj);
+static void decode_reset(emoji_gif_t * gifobj);
+#endif
+
+const lv_obj_class_t emoji_gif_class = {
+    .constructor_cb = emoji_gif_constructor,
+    .destructor_cb = emoji_gif_destructor,
+    .instance_size = sizeof(emoji_gif_t),
+    .base_class = &lv_image_class,
+    .name = "emoji_gif",
+};
+
+lv_obj_t * emoji_gif_create(lv_obj_t * parent)
+{
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void emoji_gif_set_color_format(lv_obj_t * obj, lv_color_format_t cf)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    gifobj->cf = cf;
+}
+
+/* 解码器之后依次放各帧槽，都按8字节对齐 */
+static uint32_t mem_size(uint32_t dec_size, uint32_t canvas_size)
+{
+    if(dec_size == 0) return 0;
+#if EMOJI_GIF_DECODE_TASK
+    return LV_ALIGN_UP(dec_size, 8) + EMOJI_GIF_FRAME_SLOTS * LV_ALIGN_UP(canvas_size, 8);
+#else
+    LV_UNUSED(canvas_size);
+    return dec_size;
+#endif
+}
+
+uint32_t emoji_gif_probe_file(const char * path, lv_color_format_t cf)
+{
+    uint32_t canvas_size;
+    uint32_t dec_size = gif_dec_probe_file(path, cf, &canvas_size);
+    return mem_size(dec_size, canvas_size);
+}
+
+uint32_t emoji_gif_probe_data(const void * data, lv_color_format_t cf)
+{
+    uint32_t canvas_size;
+    uint32_t dec_size = gif_dec_probe_data(data, cf, &canvas_size);
+    return mem_size(dec_size, canvas_size);
+}
+
+void emoji_gif_set_buffer(lv_obj_t * obj, void * buf, uint32_t buf_size)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    gifobj->buf = buf;
+    gifobj->buf_size = buf_size;
+}
+
+#if EMOJI_GIF_DECODE_TASK
+#define DECODE_LOCK(gifobj)   do { if((gifobj)->task) xSemaphoreTake((gifobj)->lock, portMAX_DELAY); } while(0)
+#define DECODE_UNLOCK(gifobj) do { if((gifobj)->task) xSemaphoreGive((gifobj)->lock); } while(0)
+#else
+#define DECODE_LOCK(gifobj)
+#define DECODE_UNLOCK(gifobj)
+#endif
+
+void emoji_gif_set_src(lv_obj_t * obj, const void * src)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    gif_dec_t * gif = gifobj->gif;
+
+    DECODE_LOCK(gifobj);
+    /*Close previous gif if any*/
+    if(gif != NULL) {
+        lv_image_cache_drop(lv_image_get_src(obj));
+
+        gif_dec_close(gif);
+        gifobj->gif = NULL;
+        gifobj->imgdsc.data = NULL;
+    }
+
+    if(lv_image_src_get_type(src) == LV_IMAGE_SRC_VARIABLE) {
+        const lv_image_dsc_t * img_dsc = src;
+        gif = gif_dec_open_data(img_dsc->data, gifobj->cf, gifobj->buf, gifobj->buf_size);
+    }
+    else if(lv_image_src_get_type(src) == LV_IMAGE_SRC_FILE) {
+        gif = gif_dec_open_file(src, gifobj->cf, gifobj->buf, gifobj->buf_size);
+    }
+    gifobj->gif = gif;
+#if EMOJI_GIF_DECODE_TASK
+    if(gif != NULL && gifobj->task && !decode_start(gifobj)) {
+        gif_dec_close(gif);
+        gif = gifobj->gif = NULL;
+    }
+#endif
+    DECODE_UNLOCK(gifobj);
+    if(gif == NULL) {
+        LV_LOG_WARN("Couldn't load the source");
+        lv_timer_pause(gifobj->timer);
+        return;
+    }
+
+#if EMOJI_GIF_DECODE_TASK
+    if(gifobj->task) {
+        /* 第0帧已经由 decode_start 同步解码到帧槽 */
+        gifobj->imgdsc.data = gifobj->shown >= 0 ? gifobj->slots[gifobj->shown].buf : gif->canvas;
+    }
+    else
+#endif
+    {
+        gifobj->imgdsc.data = gif->canvas;
+    }
+    gifobj->imgdsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    gifobj->imgdsc.header.flags = LV_IMAGE_FLAGS_MODIFIABLE;
+    gifobj->imgdsc.header.cf = gif->cf;
+    gifobj->imgdsc.header.h = gif->height;
+    gifobj->imgdsc.header.w = gif->width;
+    gifobj->imgdsc.header.stride = gif->width * gif_dec_canvas_bpp(gif);
+    gifobj->imgdsc.data_size = gif_dec_canvas_size(gif);
+
+    gifobj->last_call = lv_tick_get();
+    lv_memzero(&gifobj->stats, sizeof(gifobj->stats));
+
+    lv_image_set_src(obj, &gifobj->imgdsc);
+
+    lv_timer_set_period(gifobj->timer, 0);
+    lv_timer_resume(gifobj->timer);
+    lv_timer_reset(gifobj->timer);
+
+#if EMOJI_GIF_DECODE_TASK
+    if(gifobj->task) return;
+#endif
+    next_frame_task_cb(gifobj->timer);
+}
+
+void emoji_gif_restart(lv_obj_t * obj)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    if(gifobj->gif == NULL) {
+        LV_LOG_WARN("Gif resource not loaded correctly");
+        return;
+    }
+
+    DECODE_LOCK(gifobj);
+    gif_dec_rewind(gifobj->gif);
+#if EMOJI_GIF_DECODE_TASK
+    if(gifobj->task) decode_reset(gifobj);
+#endif
+    DECODE_UNLOCK(gifobj);
+    lv_timer_set_period(gifobj->timer, 0);
+    lv_timer_resume(gifobj->timer);
+    lv_timer_reset(gifobj->timer);
+}
+
+void emoji_gif_pause(lv_obj_t * obj)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    lv_timer_pause(gifobj->timer);
+}
+
+void emoji_gif_resume(lv_obj_t * obj)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    if(gifobj->gif == NULL) {
+        LV_LOG_WARN("Gif resource not loaded correctly");
+        return;
+    }
+
+    lv_timer_resume(gifobj->timer);
+}
+
+bool emoji_gif_is_loaded(lv_obj_t * obj)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    return (gifobj->gif != NULL);
+}
+
+int32_t emoji_gif_get_loop_count(lv_obj_t * obj)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    if(gifobj->gif == NULL) {
+        return -1;
+    }
+
+    return gifobj->gif->loop_count;
+}
+
+void emoji_gif_set_loop_count(lv_obj_t * obj, int32_t count)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    if(gifobj->gif == NULL) {
+        LV_LOG_WARN("Gif resource not loaded correctly");
+        return;
+    }
+
+    DECODE_LOCK(gifobj);
+    gifobj->gif->loop_count = count;
+    DECODE_UNLOCK(gifobj);
+}
+
+void emoji_gif_get_stats(lv_obj_t * obj, emoji_gif_stats_t * stats)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    *stats = gifobj->stats;
+}
+
+static void emoji_gif_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    gifobj->gif = NULL;
+    gifobj->cf = LV_COLOR_FORMAT_ARGB8888;
+    gifobj->buf = NULL;
+    gifobj->buf_size = 0;
+    lv_memzero(&gifobj->stats, sizeof(gifobj->stats));
+    gifobj->timer = lv_timer_create(next_frame_task_cb, 10, obj);
+    lv_timer_pause(gifobj->timer);
+
+#if EMOJI_GIF_DECODE_TASK
+    gifobj->task = NULL;
+    gifobj->shown = -1;
+    gifobj->slot_size = 0;
+    gifobj->gen = 0;
+    gifobj->run = false;
+    gifobj->done = true;
+    lv_memzero(gifobj->slots, sizeof(gifobj->slots));
+    gifobj->lock = xSemaphoreCreateMutex();
+    gifobj->free_q = xQueueCreate(EMOJI_GIF_FRAME_SLOTS, sizeof(uint8_t));
+    gifobj->ready_q = xQueueCreate(EMOJI_GIF_FRAME_SLOTS, sizeof(uint8_t));
+    if(gifobj->lock && gifobj->free_q && gifobj->ready_q) {
+        for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) xQueueSend(gifobj->free_q, &i, 0);
+        xTaskCreatePinnedToCore(decode_task, "gif_decode", DECODE_TASK_STACK_SIZE, gifobj,
+                                DECODE_TASK_PRIORITY, &gifobj->task, EMOJI_GIF_DECODE_CORE);
+    }
+    /* 创建失败时退回到在 LVGL 定时器里直接解码 */
+    if(gifobj->task == NULL) LV_LOG_WARN("gif decode task not created, decode in LVGL task");
+#endif
+}
+
+static void emoji_gif_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+
+    lv_image_cache_drop(lv_image_get_src(obj));
+
+#if EMOJI_GIF_DECODE_TASK
+    if(gifobj->task) {
+        /* 拿到锁时解码任务不在解码，可以直接删除 */
+        xSemaphoreTake(gifobj->lock, portMAX_DELAY);
+        vTaskDelete(gifobj->task);
+        gifobj->task = NULL;
+        xSemaphoreGive(gifobj->lock);
+    }
+    if(gifobj->lock) vSemaphoreDelete(gifobj->lock);
+    if(gifobj->free_q) vQueueDelete(gifobj->free_q);
+    if(gifobj->ready_q) vQueueDelete(gifobj->ready_q);
+    slots_free(gifobj);
+#endif
+
+    if(gifobj->gif)
+        gif_dec_close(gifobj->gif);
+    lv_timer_delete(gifobj->timer);
+}
+
+/**
+ * 按耗时(微秒)累计到对数分桶的直方图
+ */
+static void hist_add(uint32_t * hist, uint32_t us)
+{
+    uint32_t ms = us / 1000;
+    uint32_t i = 0;
+    while(ms && i < EMOJI_GIF_HIST_BUCKETS - 1) {
+        ms >>= 1;
+        i++;
+    }
+    hist[i]++;
+}
+
+/**
+ * 解码下一帧到 gif->canvas，area 返回画布变化的区域: 上一帧恢复背景或恢复到之前时的处置区域 + 新帧矩形
+ * @return gif_dec_get_frame 的返回值
+ */
+static int decode_frame(emoji_gif_t * gifobj, lv_area_t * area)
+{
+    gif_dec_t * gif = gifobj->gif;
+    int64_t t0 = esp_timer_get_time();
+
+    /* 记录上一帧的矩形和处置方式，恢复背景(2)和恢复到之前(3)都会改动这块画布 */
+    lv_area_t prev = {gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1};
+    bool prev_restored = gif->gce.disposal == 2 || gif->gce.disposal == 3;
+
+    int has_next = gif_dec_get_frame(gif);
+    /* 最后一帧之后处置已经改动了画布，重新画一次最后一帧，与 lv_gif 一致 */
+    gif_dec_render_frame(gif, gif->canvas);
+
+    area->x1 = gif->fx;
+    area->y1 = gif->fy;
+    area->x2 = gif->fx + gif->fw - 1;
+    area->y2 = gif->fy + gif->fh - 1;
+    if(prev_restored) lv_area_join(area, area, &prev);
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    hist_add(gifobj->stats.decode_hist, us);
+    gifobj->stats.decode_us += us;
+    return has_next;
+}
+
+/**
+ * 只刷新本帧改动过的区域
+ */
+static void invalidate_frame(lv_obj_t * obj, const lv_area_t * frame_area)
+{
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    gif_dec_t * gif = gifobj->gif;
+    lv_area_t area = *frame_area;
+
+    /* 缩放或旋转后帧坐标不再对应屏幕坐标，整个对象刷新 */
+    if(lv_image_get_scale(obj) != LV_SCALE_NONE || lv_image_get_rotation(obj) != 0 ||
+       lv_area_get_width(&area) <= 0 || lv_area_get_height(&area) <= 0) {
+        area.x1 = 0;
+        area.y1 = 0;
+        area.x2 = gif->width - 1;
+        area.y2 = gif->height - 1;
+        lv_obj_invalidate(obj);
+    }
+    else {
+        lv_area_t abs_area = area;
+        lv_area_move(&abs_area, obj->coords.x1, obj->coords.y1);
+        lv_obj_invalidate_area(obj, &abs_area);
+    }
+
+    gifobj->stats.frame_cnt++;
+    gifobj->stats.last_px = lv_area_get_size(&area);
+    gifobj->stats.total_px += gifobj->stats.last_px;
+}
+
+#if EMOJI_GIF_DECODE_TASK
+static void area_add(lv_area_t * dst, const lv_area_t * src)
+{
+    if(lv_area_get_width(dst) <= 0 || lv_area_get_height(dst) <= 0) *dst = *src;
+    else lv_area_join(dst, dst, src);
+}
+
+/**
+ * 把画布上该帧槽落后的区域复制进帧槽
+ */
+static void slot_fill(emoji_gif_t * gifobj, emoji_gif_slot_t * slot)
+{
+    gif_dec_t * gif = gifobj->gif;
+    lv_area_t * a = &slot->dirty;
+    int32_t w = lv_area_get_width(a);
+    if(w <= 0 || lv_area_get_height(a) <= 0) return;
+
+    uint32_t bpp = gif_dec_canvas_bpp(gif);
+    uint32_t stride = gif->width * bpp;
+    uint32_t offset = a->y1 * stride + a->x1 * bpp;
+    for(int32_t y = a->y1; y <= a->y2; y++) {
+        lv_memcpy(slot->buf + offset, gif->canvas + offset, w * bpp);
+        offset += stride;
+    }
+    if(gif->alpha) {
+        uint32_t plane = gif->width * gif->height * 2;
+        offset = plane + a->y1 * gif->width + a->x1;
+        for(int32_t y = a->y1; y <= a->y2; y++) {
+            lv_memcpy(slot->buf + offset, gif->canvas + offset, w);
+            offset += gif->width;
+        }
+    }
+    lv_area_set(a, 0, 0, -1, -1);
+}
+
+/**
+ * 解码下一帧并放入帧槽，调用前需持有 lock
+ */
+static void decode_to_slot(emoji_gif_t * gifobj, emoji_gif_slot_t * slot)
+{
+    lv_area_t area;
+    int has_next = decode_frame(gifobj, &area);
+
+    slot->gen = gifobj->gen;
+    slot->last = has_next <= 0;
+    if(slot->last) {
+        gifobj->done = true;
+        return;
+    }
+    for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) area_add(&gifobj->slots[i].dirty, &area);
+    slot_fill(gifobj, slot);
+    slot->area = area;
+    slot->delay = frame_delay(gifobj->gif);
+}
+
+/**
+ * 作废已解码的帧并要求所有帧槽整幅重新复制，调用前需持有 lock
+ */
+static void decode_reset(emoji_gif_t * gifobj)
+{
+    uint8_t idx;
+    gifobj->gen++;
+    gifobj->run = false;
+    gifobj->done = false;
+    while(xQueueReceive(gifobj->ready_q, &idx, 0) == pdTRUE) xQueueSend(gifobj->free_q, &idx, 0);
+    for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) {
+        lv_area_set(&gifobj->slots[i].dirty, 0, 0, gifobj->gif->width - 1, gifobj->gif->height - 1);
+    }
+}
+
+/**
+ * 释放自行申请的帧槽，外部内存中的帧槽只清空指针
+ */
+static void slots_free(emoji_gif_t * gifobj)
+{
+    for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) {
+        if(gifobj->slot_size) lv_free(gifobj->slots[i].buf);
+        gifobj->slots[i].buf = NULL;
+    }
+    gifobj->slot_size = 0;
+}
+
+/**
+ * 为刚打开的源准备帧槽: 有外部内存时放在解码器之后(大小见 emoji_gif_probe_file)，
+ * 否则自行申请，只增不减，所有片段尺寸相同时只在第一次申请。调用前需持有 lock
+ */
+static bool slots_alloc(emoji_gif_t * gifobj)
+{
+    uint32_t size = gif_dec_canvas_size(gifobj->gif);
+    if(gifobj->buf == NULL && gifobj->slot_size >= size) return true;
+
+    /* 帧槽换了位置，正在显示的帧槽也放回空闲队列 */
+    if(gifobj->shown >= 0) xQueueSend(gifobj->free_q, &gifobj->shown, 0);
+    gifobj->shown = -1;
+    slots_free(gifobj);
+    if(gifobj->buf) {
+        uint32_t offset = LV_ALIGN_UP(gif_dec_mem_size(gifobj->gif), 8);
+        uint32_t step = LV_ALIGN_UP(size, 8);
+        if(offset + EMOJI_GIF_FRAME_SLOTS * step > gifobj->buf_size) {
+            LV_LOG_WARN("buffer too small for gif frame slots");
+            return false;
+        }
+        for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) {
+            gifobj->slots[i].buf = (uint8_t *)gifobj->buf + offset + i * step;
+        }
+        return true;
+    }
+    for(uint8_t i = 0; i < EMOJI_GIF_FRAME_SLOTS; i++) {
+        gifobj->slots[i].buf = lv_malloc(size);
+        if(gifobj->slots[i].buf == NULL) {
+            LV_LOG_WARN("no memory for gif frame slots");
+            gifobj->slot_size = size;
+            slots_free(gifobj);
+            return false;
+        }
+    }
+    gifobj->slot_size = size;
+    return true;
+}
+
+/**
+ * 新的源打开后准备帧槽，并同步解出第0帧，调用前需持有 lock
+ */
+static bool decode_start(emoji_gif_t * gifobj)
+{
+    uint8_t idx;
+
+    if(!slots_alloc(gifobj)) return false;
+    decode_reset(gifobj);
+    /* 除了正在显示的和解码任务手里的，至少还有一个空闲帧槽 */
+    if(xQueueReceive(gifobj->free_q, &idx, 0) != pdTRUE) return false;
+    decode_to_slot(gifobj, &gifobj->slots[idx]);
+    if(gifobj->slots[idx].last) {
+        xQueueSend(gifobj->ready_q, &idx, 0);
+        return true;
+    }
+    if(gifobj->shown >= 0) xQueueSend(gifobj->free_q, &gifobj->shown, 0);
+    gifobj->shown = idx;
+    return true;
+}
+
+/**
+ * 解码任务，在另一个核上提前把后面的帧解码到空闲帧槽
+ */
+static void decode_task(void * arg)
+{
+    emoji_gif_t * gifobj = arg;
+    uint8_t idx;
+
+    while(1) {
+        xQueueReceive(gifobj->free_q, &idx, portMAX_DELAY);
+        xSemaphoreTake(gifobj->lock, portMAX_DELAY);
+        while(gifobj->gif == NULL || gifobj->done || !gifobj->run) {
+            xSemaphoreGive(gifobj->lock);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            xSemaphoreTake(gifobj->lock, portMAX_DELAY);
+        }
+        decode_to_slot(gifobj, &gifobj->slots[idx]);
+        xSemaphoreGive(gifobj->lock);
+        xQueueSend(gifobj->ready_q, &idx, portMAX_DELAY);
+    }
+}
+
+/**
+ * LVGL 侧: 到时间后取出下一个帧槽，只切换图像数据指针
+ */
+static void show_next_slot(lv_timer_t * t)
+{
+    lv_obj_t * obj = lv_timer_get_user_data(t);
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+    uint8_t idx;
+
+    /* run 只在 LVGL 任务中改写，这里不加锁读；解码任务持锁读，写入也要持锁 */
+    if(!gifobj->run) {
+        xSemaphoreTake(gifobj->lock, portMAX_DELAY);
+        gifobj->run = true;
+        xSemaphoreGive(gifobj->lock);
+        xTaskNotifyGive(gifobj->task);
+    }
+
+    uint32_t delay = gifobj->shown >= 0 ? gifobj->slots[gifobj->shown].delay : 0;
+    if(lv_tick_elaps(gifobj->last_call) < delay) {
+        schedule_next(gifobj, delay);
+        return;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    if(xQueueReceive(gifobj->ready_q, &idx, 0) != pdTRUE) {
+        /* 到时间了但解码任务还没交帧 */
+        gifobj->stats.late_cnt++;
+        lv_timer_set_period(t, LATE_RETRY_PERIOD);
+        lv_timer_reset(t);
+        return;
+    }
+    emoji_gif_slot_t * slot = &gifobj->slots[idx];
+    if(slot->gen != gifobj->gen) {
+        /* 切换源之前解出的旧帧 */
+        xQueueSend(gifobj->free_q, &idx, 0);
+        schedule_next(gifobj, delay);
+        return;
+    }
+
+    gifobj->last_call = lv_tick_get();
+
+    if(slot->last) {
+        /*It was the last repeat*/
+        xQueueSend(gifobj->free_q, &idx, 0);
+        lv_timer_pause(t);
+        lv_obj_send_event(obj, LV_EVENT_READY, NULL);
+        return;
+    }
+
+    if(gifobj->shown >= 0) xQueueSend(gifobj->free_q, &gifobj->shown, 0);
+    gifobj->shown = idx;
+    gifobj->imgdsc.data = slot->buf;
+
+    lv_image_cache_drop(lv_image_get_src(obj));
+    invalidate_frame(obj, &slot->area);
+    schedule_next(gifobj, slot->delay);
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    hist_add(gifobj->stats.show_hist, us);
+    gifobj->stats.show_us += us;
+    telemetry_record(TELEMETRY_FRAME, t0, t0 + us, lv_area_get_size(&slot->area));
+}
+#endif
+
+/**
+ * 把定时器设到当前帧显示满 delay 毫秒的时刻，LVGL任务据此阻塞到下一帧，不再每10ms轮询
+ */
+static void schedule_next(emoji_gif_t * gifobj, uint32_t delay)
+{
+    uint32_t elaps = lv_tick_elaps(gifobj->last_call);
+    lv_timer_set_period(gifobj->timer, delay > elaps ? delay - elaps : 1);
+    lv_timer_reset(gifobj->timer);
+}
+
+/**
+ * 当前帧的显示时长(ms)
+ */
+static uint32_t frame_delay(const gif_dec_t * gif)
+{
+    uint32_t delay = gif->gce.delay * 10;
+    return delay <= SHORT_FRAME_DELAY_MAX ? SHORT_FRAME_DELAY : delay;
+}
+
+static void next_frame_task_cb(lv_timer_t * t)
+{
+    lv_obj_t * obj = lv_timer_get_user_data(t);
+    emoji_gif_t * gifobj = (emoji_gif_t *) obj;
+#if EMOJI_GIF_DECODE_TASK
+    if(gifobj->task) {
+        show_next_slot(t);
+        return;
+    }
+#endif
+    gif_dec_t * gif = gifobj->gif;
+    uint32_t elaps = lv_tick_elaps(gifobj->last_call);
+    if(elaps < frame_delay(gif)) {
+        schedule_next(gifobj, frame_delay(gif));
+        return;
+    }
+
+    gifobj->last_call = lv_tick_get();
+
+    int64_t t0 = esp_timer_get_time();
+    lv_area_t area;
+    int has_next = decode_frame(gifobj, &area);
+    if(has_next == 0) {
+        /*It was the last repeat*/
+        lv_timer_pause(t);
+        lv_result_t res = lv_obj_send_event(obj, LV_EVENT_READY, NULL);
+        if(res != LV_RESULT_OK) return;
+        /* READY 回调里已经切换了源(同一块内存也会重新打开) */
+        if(!lv_timer_get_paused(t) || gifobj->gif == NULL) return;
+    }
+
+    lv_image_cache_drop(lv_image_get_src(obj));
+    invalidate_frame(obj, &area);
+    schedule_next(gifobj, frame_delay(gifobj->gif));
+
+    /* 不用解码任务时，LVGL 侧每帧的耗时就是解码耗时 */
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    hist_add(gifobj->stats.show_hist, us);
+    gifobj->stats.show_us += us;
+    telemetry_record(TELEMETRY_FRAME, t0, t0 + us, lv_area_get_size(&area));
+}
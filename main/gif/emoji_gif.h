@@ -0,0 +1,106 @@
+/**
+ * GIF播放对象，移植自 LVGL 的 lv_gif，解码器换成 gif_dec
+ */
+#ifndef __EMOJI_GIF_H__
+#define __EMOJI_GIF_H__
+
+#include "lvgl.h"
+#include "gif_dec.h"
+
+// 帧耗时直方图的分桶数，按毫秒对数分桶: <1, <2, <4, <8, <16, <32, <64, >=64
+#define EMOJI_GIF_HIST_BUCKETS  8
+
+// 刷新统计，用于衡量局部刷新节省的SPI带宽和每帧耗时
+typedef struct {
+    uint32_t frame_cnt;        // 已显示的帧数
+    uint32_t last_px;          // 最近一帧标记刷新的像素数
+    uint64_t total_px;         // 累计标记刷新的像素数
+    uint32_t decode_hist[EMOJI_GIF_HIST_BUCKETS]; // 解码+合成一帧的耗时
+    uint32_t show_hist[EMOJI_GIF_HIST_BUCKETS];   // LVGL任务中每帧的耗时，决定可达到的帧率
+    uint64_t decode_us;        // 累计解码耗时
+    uint64_t show_us;          // 累计LVGL任务中的耗时
+    uint32_t late_cnt;         // 到了换帧时间解码任务还没交帧的次数
+} emoji_gif_stats_t;
+
+extern const lv_obj_class_t emoji_gif_class;
+
+/**
+ * 创建gif对象
+ * @param parent 父对象
+ * @return       gif对象
+ */
+lv_obj_t * emoji_gif_create(lv_obj_t * parent);
+
+/**
+ * 设置画布颜色格式，在 emoji_gif_set_src 之前调用
+ * @param obj gif对象
+ * @param cf  LV_COLOR_FORMAT_ARGB8888(默认)、LV_COLOR_FORMAT_RGB565 或 LV_COLOR_FORMAT_RGB565_SWAPPED。
+ *            16位画布只有 ARGB8888 的一半大小，与屏幕格式相同时LVGL直接拷贝，GIF需要透明时自动使用 RGB565A8
+ */
+void emoji_gif_set_color_format(lv_obj_t * obj, lv_color_format_t cf);
+
+/**
+ * 只解析文件头，返回以cf格式播放该GIF需要的内存字节数(解码器和画布，开启 EMOJI_GIF_DECODE_TASK 时
+ * 还有帧槽)，失败返回0
+ */
+uint32_t emoji_gif_probe_file(const char * path, lv_color_format_t cf);
+
+/**
+ * 同 emoji_gif_probe_file，GIF数据在内存中
+ */
+uint32_t emoji_gif_probe_data(const void * data, lv_color_format_t cf);
+
+/**
+ * 指定解码器、画布和帧槽使用的内存，之后每次 emoji_gif_set_src 都在这块内存中原地打开，
+ * 不再申请/释放。大小取所有待播放GIF的 emoji_gif_probe_file 最大值，传NULL恢复自行申请
+ * @param obj      gif对象
+ * @param buf      内存，生命周期需长于gif对象
+ * @param buf_size 内存大小
+ */
+void emoji_gif_set_buffer(lv_obj_t * obj, void * buf, uint32_t buf_size);
+
+/**
+ * 设置要显示的gif
+ * @param obj gif对象
+ * @param src 1) 指向 lv_image_dsc_t 的指针(data为gif原始数据)
+ *            2) gif文件路径(如 "S:/gif/blink_once.gif")
+ */
+void emoji_gif_set_src(lv_obj_t * obj, const void * src);
+
+/**
+ * 重新开始播放
+ */
+void emoji_gif_restart(lv_obj_t * obj);
+
+/**
+ * 暂停播放
+ */
+void emoji_gif_pause(lv_obj_t * obj);
+
+/**
+ * 继续播放
+ */
+void emoji_gif_resume(lv_obj_t * obj);
+
+/**
+ * gif是否加载成功
+ */
+bool emoji_gif_is_loaded(lv_obj_t * obj);
+
+/**
+ * 获取剩余播放次数
+ */
+int32_t emoji_gif_get_loop_count(lv_obj_t * obj);
+
+/**
+ * 设置播放次数
+ */
+void emoji_gif_set_loop_count(lv_obj_t * obj, int32_t count);
+
+/**
+ * 获取刷新统计，每帧只刷新新帧矩形与上一帧处置区域的并集。
+ * 开启 EMOJI_GIF_DECODE_TASK 时解码在另一个核上进行，LVGL任务每帧只切换帧缓冲
+ */
+void emoji_gif_get_stats(lv_obj_t * obj, emoji_gif_stats_t * stats);
+
+#endif
@@ -0,0 +1,822 @@
+#include "gif_dec.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define MIN(A, B) ((A) < (B) ? (A) : (B))
+#define MAX(A, B) ((A) > (B) ? (A) : (B))
+
+/* Codes never exceed 12 bits, so the LZW table has a fixed 4096 entries.
+ * Each field is a flat array: walking a string touches only prefix[] and
+ * suffix[], and the table is sized once and kept with the canvas. */
+#define LZW_MAXBITS                 12
+#define LZW_TABLE_ENTRIES           (1 << LZW_MAXBITS)
+/* A sub-block is at most 255 bytes; keep room for the bytes left over from the
+ * previous one so the bit reader can always load a whole word. */
+#define LZW_BLOCK_BYTES             (255 + 4)
+#define LZW_KEY_END                 0x1000
+
+typedef struct {
+    uint16_t prefix[LZW_TABLE_ENTRIES];
+    uint16_t length[LZW_TABLE_ENTRIES];
+    uint8_t  suffix[LZW_TABLE_ENTRIES];
+    uint8_t  first[LZW_TABLE_ENTRIES];
+    uint8_t  block[LZW_BLOCK_BYTES];
+} lzw_table_t;
+
+#define LZW_TABLE_BYTES             (sizeof(lzw_table_t) + sizeof(void *))
+
+/* Bit reader over the image data sub-blocks. */
+typedef struct {
+    gif_dec_t * gif;
+    uint8_t * block;
+    uint32_t pos, len;
+    uint32_t bits;
+    int nbits;
+    bool eof;
+} lzw_reader_t;
+
+static gif_dec_t  * gif_open(gif_dec_t * gif, lv_color_format_t cf, void * buf, uint32_t buf_size);
+static bool f_gif_open(gif_dec_t * gif, const void * path, bool is_file);
+static void f_gif_read(gif_dec_t * gif, void * buf, size_t len);
+static int f_gif_seek(gif_dec_t * gif, size_t pos, int k);
+static void f_gif_close(gif_dec_t * gif);
+static void discard_sub_blocks(gif_dec_t * gif);
+
+static uint16_t
+read_num(gif_dec_t * gif)
+{
+    uint8_t bytes[2];
+
+    f_gif_read(gif, bytes, 2);
+    return bytes[0] + (((uint16_t) bytes[1]) << 8);
+}
+
+static inline uint16_t
+rgb_to_565(const uint8_t * rgb)
+{
+    return ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+}
+
+/* 16-bit canvas pixel; RGB565_SWAPPED stores the high byte first like the SPI panel. */
+static inline uint16_t
+rgb_to_canvas16(const gif_dec_t * gif, const uint8_t * rgb)
+{
+    uint16_t c = rgb_to_565(rgb);
+    return gif->cf == LV_COLOR_FORMAT_RGB565_SWAPPED ? (uint16_t)((c >> 8) | (c << 8)) : c;
+}
+
+gif_dec_t *
+gif_dec_open_file(const char * fname, lv_color_format_t cf, void * buf, uint32_t buf_size)
+{
+    gif_dec_t gif_base;
+    memset(&gif_base, 0, sizeof(gif_base));
+
+    bool res = f_gif_open(&gif_base, fname, true);
+    if(!res) return NULL;
+
+    return gif_open(&gif_base, cf, buf, buf_size);
+}
+
+gif_dec_t *
+gif_dec_open_data(const void * data, lv_color_format_t cf, void * buf, uint32_t buf_size)
+{
+    gif_dec_t gif_base;
+    memset(&gif_base, 0, sizeof(gif_base));
+
+    bool res = f_gif_open(&gif_base, data, false);
+    if(!res) return NULL;
+
+    return gif_open(&gif_base, cf, buf, buf_size);
+}
+
+uint32_t
+gif_dec_canvas_bpp(const gif_dec_t * gif)
+{
+    return gif->cf == LV_COLOR_FORMAT_ARGB8888 ? 4 : 2;
+}
+
+uint32_t
+gif_dec_canvas_size(const gif_dec_t * gif)
+{
+    uint32_t px = gif->width * gif->height;
+    return gif->cf == LV_COLOR_FORMAT_RGB565A8 ? px * 3 : px * gif_dec_canvas_bpp(gif);
+}
+
+uint32_t
+gif_dec_mem_size(const gif_dec_t * gif)
+{
+    /* Canvas plus one byte of frame index per pixel. */
+    return sizeof(gif_dec_t) + gif_dec_canvas_size(gif) + gif->width * gif->height + LZW_TABLE_BYTES;
+}
+
+/* Scan all blocks from the current position and report whether any frame restores
+ * to a transparent background, i.e. whether the canvas ever needs an alpha channel. */
+static bool
+scan_transparent_restore(gif_dec_t * gif)
+{
+    uint8_t sep, label, rdit, fisrz;
+    bool found = false;
+    size_t start = f_gif_seek(gif, 0, LV_FS_SEEK_CUR);
+
+    sep = 0;
+    f_gif_read(gif, &sep, 1);
+    while(!found && sep != ';') {
+        if(sep == '!') {
+            f_gif_read(gif, &label, 1);
+            if(label == 0xF9) {
+                /* Block size, packed fields, delay, transparent index, terminator. */
+                f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+                f_gif_read(gif, &rdit, 1);
+                found = ((rdit >> 2) & 3) == 2 && (rdit & 1);
+                f_gif_seek(gif, 4, LV_FS_SEEK_CUR);
+            }
+            else {
+                discard_sub_blocks(gif);
+            }
+        }
+        else if(sep == ',') {
+            /* Image descriptor, optional LCT, LZW code size and image data. */
+            f_gif_seek(gif, 8, LV_FS_SEEK_CUR);
+            f_gif_read(gif, &fisrz, 1);
+            if(fisrz & 0x80)
+                f_gif_seek(gif, 3 * (1 << ((fisrz & 0x07) + 1)), LV_FS_SEEK_CUR);
+            f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+            discard_sub_blocks(gif);
+        }
+        else break;
+        sep = 0;
+        f_gif_read(gif, &sep, 1);
+    }
+    f_gif_seek(gif, start, LV_FS_SEEK_SET);
+    return found;
+}
+
+/* Fill a canvas rectangle with an RGB color and opacity. */
+static void
+fill_rect(gif_dec_t * gif, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t * rgb, uint8_t opa)
+{
+    int i = y * gif->width + x;
+    int j, k;
+
+    if(gif->cf == LV_COLOR_FORMAT_ARGB8888) {
+        for(j = 0; j < h; j++) {
+            for(k = 0; k < w; k++) {
+                gif->canvas[(i + k) * 4 + 0] = rgb[2];
+                gif->canvas[(i + k) * 4 + 1] = rgb[1];
+                gif->canvas[(i + k) * 4 + 2] = rgb[0];
+                gif->canvas[(i + k) * 4 + 3] = opa;
+            }
+            i += gif->width;
+        }
+        return;
+    }
+
+    uint16_t c = rgb_to_canvas16(gif, rgb);
+    uint16_t * px = (uint16_t *) gif->canvas;
+    for(j = 0; j < h; j++) {
+        for(k = 0; k < w; k++) px[i + k] = c;
+        if(gif->alpha) memset(&gif->alpha[i], opa, w);
+        i += gif->width;
+    }
+}
+
+/* Parse the header into gif_base and pick the canvas format.
+ * Return the bytes needed for the decoder and its buffers, or 0 if the GIF is invalid. */
+static uint32_t
+read_header(gif_dec_t * gif_base, lv_color_format_t cf)
+{
+    uint8_t sigver[3];
+    uint16_t width, height;
+    uint8_t fdsz, aspect;
+    uint32_t px_size;
+
+    /* Header */
+    f_gif_read(gif_base, sigver, 3);
+    if(memcmp(sigver, "GIF", 3) != 0) {
+        LV_LOG_WARN("invalid signature");
+        return 0;
+    }
+    /* Version */
+    f_gif_read(gif_base, sigver, 3);
+    if(memcmp(sigver, "89a", 3) != 0) {
+        LV_LOG_WARN("invalid version");
+        return 0;
+    }
+    /* Width x Height */
+    width  = read_num(gif_base);
+    height = read_num(gif_base);
+    /* FDSZ */
+    f_gif_read(gif_base, &fdsz, 1);
+    /* Presence of GCT */
+    if(!(fdsz & 0x80)) {
+        LV_LOG_WARN("no global color table");
+        return 0;
+    }
+    /* Color Space's Depth */
+    gif_base->depth = ((fdsz >> 4) & 7) + 1;
+    /* Ignore Sort Flag. */
+    /* GCT Size */
+    gif_base->gct.size = 1 << ((fdsz & 0x07) + 1);
+    /* Background Color Index */
+    f_gif_read(gif_base, &gif_base->bgindex, 1);
+    /* Aspect Ratio */
+    f_gif_read(gif_base, &aspect, 1);
+    if(0 == width || 0 == height){
+        LV_LOG_WARN("Zero size image");
+        return 0;
+    }
+    gif_base->width = width;
+    gif_base->height = height;
+    /* 16-bit canvas gets an alpha plane only if some frame restores to transparent.
+     * LVGL has no swapped variant of RGB565A8, so such GIFs keep the native byte order. */
+    if(cf == LV_COLOR_FORMAT_RGB565 || cf == LV_COLOR_FORMAT_RGB565_SWAPPED || cf == LV_COLOR_FORMAT_RGB565A8) {
+        f_gif_seek(gif_base, 3 * gif_base->gct.size, LV_FS_SEEK_CUR);
+        if(scan_transparent_restore(gif_base)) cf = LV_COLOR_FORMAT_RGB565A8;
+        else if(cf == LV_COLOR_FORMAT_RGB565A8) cf = LV_COLOR_FORMAT_RGB565;
+        f_gif_seek(gif_base, 13, LV_FS_SEEK_SET);
+    }
+    else {
+        cf = LV_COLOR_FORMAT_ARGB8888;
+    }
+    gif_base->cf = cf;
+    /* Canvas bytes per pixel plus one byte of frame index. */
+    px_size = (cf == LV_COLOR_FORMAT_ARGB8888 ? 4 : cf == LV_COLOR_FORMAT_RGB565A8 ? 3 : 2) + 1;
+    if(0 == (INT_MAX - sizeof(gif_dec_t) - LZW_TABLE_BYTES) / width / height / px_size){
+        LV_LOG_WARN("Image dimensions are too large");
+        return 0;
+    }
+    return gif_dec_mem_size(gif_base);
+}
+
+uint32_t
+gif_dec_probe_file(const char * fname, lv_color_format_t cf, uint32_t * canvas_size)
+{
+    gif_dec_t gif_base;
+    memset(&gif_base, 0, sizeof(gif_base));
+
+    bool res = f_gif_open(&gif_base, fname, true);
+    if(!res) return 0;
+
+    uint32_t size = read_header(&gif_base, cf);
+    f_gif_close(&gif_base);
+    if(canvas_size) *canvas_size = size ? gif_dec_canvas_size(&gif_base) : 0;
+    return size;
+}
+
+uint32_t
+gif_dec_probe_data(const void * data, lv_color_format_t cf, uint32_t * canvas_size)
+{
+    gif_dec_t gif_base;
+    memset(&gif_base, 0, sizeof(gif_base));
+
+    f_gif_open(&gif_base, data, false);
+    uint32_t size = read_header(&gif_base, cf);
+    if(canvas_size) *canvas_size = size ? gif_dec_canvas_size(&gif_base) : 0;
+    return size;
+}
+
+static gif_dec_t * gif_open(gif_dec_t * gif_base, lv_color_format_t cf, void * buf, uint32_t buf_size)
+{
+    uint8_t * bgcolor;
+    uint32_t size;
+    uint32_t px_cnt;
+    gif_dec_t * gif = NULL;
+
+    size = read_header(gif_base, cf);
+    if(size == 0) goto fail;
+    /* Create gif_dec_t Structure, in the caller's buffer if one was given. */
+    if(buf) {
+        if(size > buf_size) {
+            LV_LOG_WARN("buffer too small: %" LV_PRIu32 " < %" LV_PRIu32, buf_size, size);
+            goto fail;
+        }
+        gif = buf;
+    }
+    else {
+        gif = lv_malloc(size);
+        if(!gif) goto fail;
+    }
+    memcpy(gif, gif_base, sizeof(gif_dec_t));
+    gif->own_mem = buf == NULL;
+    px_cnt = gif->width * gif->height;
+    /* Read GCT */
+    f_gif_read(gif, gif->gct.colors, 3 * gif->gct.size);
+    gif->palette = &gif->gct;
+    gif->canvas = (uint8_t *) &gif[1];
+    gif->alpha = NULL;
+    if(gif->cf == LV_COLOR_FORMAT_RGB565A8) gif->alpha = &gif->canvas[2 * px_cnt];
+    gif->frame = &gif->canvas[(gif->cf == LV_COLOR_FORMAT_ARGB8888 ? 4 : gif->alpha ? 3 : 2) * px_cnt];
+    memset(gif->frame, gif->bgindex, px_cnt);
+    bgcolor = &gif->palette->colors[gif->bgindex * 3];
+    gif->lzw_table = (void *) LV_ALIGN_UP((uintptr_t)(gif->frame + px_cnt), sizeof(void *));
+
+    fill_rect(gif, 0, 0, gif->width, gif->height, bgcolor, 0xff);
+    gif->anim_start = f_gif_seek(gif, 0, LV_FS_SEEK_CUR);
+    gif->loop_count = -1;
+    goto ok;
+fail:
+    f_gif_close(gif_base);
+ok:
+    return gif;
+}
+
+static void
+discard_sub_blocks(gif_dec_t * gif)
+{
+    uint8_t size;
+
+    do {
+        f_gif_read(gif, &size, 1);
+        f_gif_seek(gif, size, LV_FS_SEEK_CUR);
+    } while(size);
+}
+
+static void
+read_plain_text_ext(gif_dec_t * gif)
+{
+    /* Discard plain text metadata. */
+    f_gif_seek(gif, 13, LV_FS_SEEK_CUR);
+    /* Discard plain text sub-blocks. */
+    discard_sub_blocks(gif);
+}
+
+static void
+read_graphic_control_ext(gif_dec_t * gif)
+{
+    uint8_t rdit;
+
+    /* Discard block size (always 0x04). */
+    f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+    f_gif_read(gif, &rdit, 1);
+    gif->gce.disposal = (rdit >> 2) & 3;
+    gif->gce.input = rdit & 2;
+    gif->gce.transparency = rdit & 1;
+    gif->gce.delay = read_num(gif);
+    f_gif_read(gif, &gif->gce.tindex, 1);
+    /* Skip block terminator. */
+    f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+}
+
+static void
+read_comment_ext(gif_dec_t * gif)
+{
+    /* Discard comment sub-blocks. */
+    discard_sub_blocks(gif);
+}
+
+static void
+read_application_ext(gif_dec_t * gif)
+{
+    char app_id[8];
+    char app_auth_code[3];
+    uint16_t loop_count;
+
+    /* Discard block size (always 0x0B). */
+    f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+    /* Application Identifier. */
+    f_gif_read(gif, app_id, 8);
+    /* Application Authentication Code. */
+    f_gif_read(gif, app_auth_code, 3);
+    if(!strncmp(app_id, "NETSCAPE", sizeof(app_id))) {
+        /* Discard block size (0x03) and constant byte (0x01). */
+        f_gif_seek(gif, 2, LV_FS_SEEK_CUR);
+        loop_count = read_num(gif);
+        if(gif->loop_count < 0) {
+            if(loop_count == 0) {
+                gif->loop_count = 0;
+            }
+            else {
+                gif->loop_count = loop_count + 1;
+            }
+        }
+        /* Skip block terminator. */
+        f_gif_seek(gif, 1, LV_FS_SEEK_CUR);
+    }
+    else {
+        discard_sub_blocks(gif);
+    }
+}
+
+static void
+read_ext(gif_dec_t * gif)
+{
+    uint8_t label;
+
+    f_gif_read(gif, &label, 1);
+    switch(label) {
+        case 0x01:
+            read_plain_text_ext(gif);
+            break;
+        case 0xF9:
+            read_graphic_control_ext(gif);
+            break;
+        case 0xFE:
+            read_comment_ext(gif);
+            break;
+        case 0xFF:
+            read_application_ext(gif);
+            break;
+        default:
+            LV_LOG_WARN("unknown extension: %02X\n", label);
+    }
+}
+
+/* Append the next sub-block after the unread bytes of the current one. */
+static void
+lzw_refill(lzw_reader_t * r)
+{
+    uint8_t size;
+
+    if(r->eof) return;
+    r->len -= r->pos;
+    memmove(r->block, &r->block[r->pos], r->len);
+    r->pos = 0;
+    f_gif_read(r->gif, &size, 1);
+    if(size == 0) {
+        r->eof = true;
+        return;
+    }
+    f_gif_read(r->gif, &r->block[r->len], size);
+    r->len += size;
+}
+
+/* Return the next key, or LZW_KEY_END if the data ran out. */
+static inline uint16_t
+lzw_get_key(lzw_reader_t * r, int key_size)
+{
+    uint16_t key;
+
+    if(r->nbits < key_size) {
+        if(r->len - r->pos < 4) lzw_refill(r);
+        if(r->len - r->pos >= 4) {
+            /* Load a whole word and keep the bytes that fit in the bit buffer. */
+            const uint8_t * p = &r->block[r->pos];
+            uint32_t word = p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+            uint32_t n = (31 - r->nbits) >> 3;
+            r->bits |= word << r->nbits;
+            r->pos += n;
+            r->nbits += n * 8;
+            r->bits &= ((uint32_t) 1 << r->nbits) - 1;
+        }
+        else {
+            while(r->nbits < key_size && r->pos < r->len) {
+                r->bits |= (uint32_t) r->block[r->pos++] << r->nbits;
+                r->nbits += 8;
+            }
+            if(r->nbits < key_size) return LZW_KEY_END;
+        }
+    }
+    key = r->bits & ((1 << key_size) - 1);
+    r->bits >>= key_size;
+    r->nbits -= key_size;
+    return key;
+}
+
+/* Compute output index of y-th input line, in frame of height h. */
+static int
+interlaced_line_index(int h, int y)
+{
+    int p; /* number of lines in current pass */
+
+    p = (h - 1) / 8 + 1;
+    if(y < p)  /* pass 1 */
+        return y * 8;
+    y -= p;
+    p = (h - 5) / 8 + 1;
+    if(y < p)  /* pass 2 */
+        return y * 8 + 4;
+    y -= p;
+    p = (h - 3) / 4 + 1;
+    if(y < p)  /* pass 3 */
+        return y * 4 + 2;
+    y -= p;
+    /* pass 4 */
+    return y * 2 + 1;
+}
+
+static inline uint8_t *
+frame_line(gif_dec_t * gif, int interlace, int y)
+{
+    if(interlace) y = interlaced_line_index((int) gif->fh, y);
+    return &gif->frame[(gif->fy + y) * gif->width + gif->fx];
+}
+
+/* Decompress image pixels.
+ * Return 0 on success or -1 on parse error. */
+static int
+read_image_data(gif_dec_t * gif, int interlace)
+{
+    lzw_table_t * t = gif->lzw_table;
+    lzw_reader_t r;
+    uint8_t byte;
+    int init_key_size, key_size;
+    int frm_off, frm_size, len, x, y, i;
+    uint16_t key, code, clear, stop, next;
+    int prev;
+    uint8_t first_byte;
+    uint8_t * line;
+    uint8_t * dst;
+
+    f_gif_read(gif, &byte, 1);
+    if(byte >= LZW_MAXBITS) {
+        LV_LOG_WARN("invalid LZW code size");
+        return -1;
+    }
+    clear = 1 << byte;
+    stop = clear + 1;
+    init_key_size = byte + 1;
+    for(i = 0; i < clear; i++) {
+        t->length[i] = 1;
+        t->suffix[i] = i;
+        t->first[i] = i;
+    }
+    memset(&r, 0, sizeof(r));
+    r.gif = gif;
+    r.block = t->block;
+    key_size = init_key_size;
+    next = clear + 2;
+    prev = -1;
+    frm_off = 0;
+    frm_size = gif->fw * gif->fh;
+    x = y = 0;
+    line = frame_line(gif, interlace, 0);
+    while(frm_off < frm_size) {
+        key = lzw_get_key(&r, key_size);
+        if(key == clear) {
+            key_size = init_key_size;
+            next = clear + 2;
+            prev = -1;
+            continue;
+        }
+        if(key == stop || key == LZW_KEY_END) break;
+        if(key < next) {
+            code = key;
+            len = t->length[key];
+        }
+        else if(key == next && prev >= 0) {
+            /* KwKwK: the previous string followed by its own first byte. */
+            code = prev;
+            len = t->length[prev] + 1;
+        }
+        else {
+            LV_LOG_WARN("invalid LZW code");
+            return -1;
+        }
+        if(frm_off + len > frm_size) {
+            LV_LOG_WARN("LZW table token overflows the frame buffer");
+            return -1;
+        }
+        first_byte = t->first[code];
+        /* Emit the string back to front straight into the frame. */
+        if(x + len <= gif->fw) {
+            dst = &line[x + len - 1];
+            if(key != code) *dst-- = first_byte;
+            while(code >= clear) {
+                *dst-- = t->suffix[code];
+                code = t->prefix[code];
+            }
+            *dst = code;
+            x += len;
+        }
+        else {
+            /* The string wraps to the next line(s). */
+            int ex = x + len - 1, ey = y;
+            uint8_t * eline;
+            while(ex >= gif->fw) {
+                ex -= gif->fw;
+                ey++;
+            }
+            eline = frame_line(gif, interlace, ey);
+            for(i = len - 1; i >= 0; i--) {
+                if(i == len - 1 && key != code) eline[ex] = first_byte;
+                else {
+                    eline[ex] = code >= clear ? t->suffix[code] : code;
+                    code = t->prefix[code];
+                }
+                if(ex-- == 0 && i > 0) {
+                    ex = gif->fw - 1;
+                    eline = frame_line(gif, interlace, --ey);
+                }
+            }
+            x += len;
+        }
+        frm_off += len;
+        if(x >= gif->fw) {
+            y += x / gif->fw;
+            x %= gif->fw;
+            if(frm_off < frm_size) line = frame_line(gif, interlace, y);
+        }
+        /* New entry: the previous string plus the first byte of this one. */
+        if(prev >= 0 && next < LZW_TABLE_ENTRIES) {
+            t->prefix[next] = prev;
+            t->suffix[next] = first_byte;
+            t->first[next] = t->first[prev];
+            t->length[next] = t->length[prev] + 1;
+            next++;
+            if(next == (1 << key_size) && key_size < LZW_MAXBITS) key_size++;
+        }
+        prev = key;
+    }
+    /* Skip whatever is left of the image data. */
+    if(!r.eof) discard_sub_blocks(gif);
+    return 0;
+}
+
+/* Read image.
+ * Return 0 on success or -1 on out-of-memory (w.r.t. LZW code table) or parse error. */
+static int
+read_image(gif_dec_t * gif)
+{
+    uint8_t fisrz;
+    int interlace;
+
+    /* Image Descriptor. */
+    gif->fx = read_num(gif);
+    gif->fy = read_num(gif);
+    gif->fw = read_num(gif);
+    gif->fh = read_num(gif);
+    if(gif->fx + (uint32_t)gif->fw > gif->width || gif->fy + (uint32_t)gif->fh > gif->height){
+        LV_LOG_WARN("Frame coordinates out of image bounds");
+        return -1;
+    }
+    f_gif_read(gif, &fisrz, 1);
+    interlace = fisrz & 0x40;
+    /* Ignore Sort Flag. */
+    /* Local Color Table? */
+    if(fisrz & 0x80) {
+        /* Read LCT */
+        gif->lct.size = 1 << ((fisrz & 0x07) + 1);
+        f_gif_read(gif, gif->lct.colors, 3 * gif->lct.size);
+        gif->palette = &gif->lct;
+    }
+    else
+        gif->palette = &gif->gct;
+    /* Image Data. */
+    return read_image_data(gif, interlace);
+}
+
+static void
+render_frame_rect(gif_dec_t * gif, uint8_t * buffer)
+{
+    int i = gif->fy * gif->width + gif->fx;
+    int j, k;
+    uint8_t index, * color;
+    int tindex = gif->gce.transparency ? gif->gce.tindex : 0x100;
+
+    if(gif->cf == LV_COLOR_FORMAT_ARGB8888) {
+        for(j = 0; j < gif->fh; j++) {
+            for(k = 0; k < gif->fw; k++) {
+                index = gif->frame[(gif->fy + j) * gif->width + gif->fx + k];
+                color = &gif->palette->colors[index * 3];
+                if(index != tindex) {
+                    buffer[(i + k) * 4 + 0] = *(color + 2);
+                    buffer[(i + k) * 4 + 1] = *(color + 1);
+                    buffer[(i + k) * 4 + 2] = *(color + 0);
+                    buffer[(i + k) * 4 + 3] = 0xFF;
+                }
+            }
+            i += gif->width;
+        }
+        return;
+    }
+
+    /* 16-bit canvas: convert the palette once instead of every pixel. */
+    uint16_t pal[0x100];
+    uint16_t * px = (uint16_t *) buffer;
+    uint8_t * alpha = gif->alpha ? &buffer[2 * gif->width * gif->height] : NULL;
+    for(k = 0; k < gif->palette->size; k++) pal[k] = rgb_to_canvas16(gif, &gif->palette->colors[k * 3]);
+
+    for(j = 0; j < gif->fh; j++) {
+        const uint8_t * src = &gif->frame[i];
+        for(k = 0; k < gif->fw; k++) {
+            index = src[k];
+            if(index != tindex) {
+                px[i + k] = pal[index];
+                if(alpha) alpha[i + k] = 0xFF;
+            }
+        }
+        i += gif->width;
+    }
+}
+
+static void
+dispose(gif_dec_t * gif)
+{
+    uint8_t * bgcolor;
+    switch(gif->gce.disposal) {
+        case 2: /* Restore to background color. */
+            bgcolor = &gif->palette->colors[gif->bgindex * 3];
+
+            uint8_t opa = 0xff;
+            if(gif->gce.transparency) opa = 0x00;
+
+            fill_rect(gif, gif->fx, gif->fy, gif->fw, gif->fh, bgcolor, opa);
+            break;
+        case 3: /* Restore to previous, i.e., don't update canvas.*/
+            break;
+        default:
+            /* Add frame non-transparent pixels to canvas. */
+            render_frame_rect(gif, gif->canvas);
+    }
+}
+
+/* Return 1 if got a frame; 0 if got GIF trailer; -1 if error. */
+int
+gif_dec_get_frame(gif_dec_t * gif)
+{
+    char sep;
+
+    dispose(gif);
+    f_gif_read(gif, &sep, 1);
+    while(sep != ',') {
+        if(sep == ';') {
+            f_gif_seek(gif, gif->anim_start, LV_FS_SEEK_SET);
+            if(gif->loop_count == 1 || gif->loop_count < 0) {
+                return 0;
+            }
+            else if(gif->loop_count > 1) {
+                gif->loop_count--;
+            }
+        }
+        else if(sep == '!')
+            read_ext(gif);
+        else return -1;
+        f_gif_read(gif, &sep, 1);
+    }
+    if(read_image(gif) == -1)
+        return -1;
+    return 1;
+}
+
+void
+gif_dec_render_frame(gif_dec_t * gif, uint8_t * buffer)
+{
+    render_frame_rect(gif, buffer);
+}
+
+void
+gif_dec_rewind(gif_dec_t * gif)
+{
+    gif->loop_count = -1;
+    f_gif_seek(gif, gif->anim_start, LV_FS_SEEK_SET);
+}
+
+void
+gif_dec_close(gif_dec_t * gif)
+{
+    f_gif_close(gif);
+    if(gif->own_mem) lv_free(gif);
+}
+
+static bool f_gif_open(gif_dec_t * gif, const void * path, bool is_file)
+{
+    gif->f_rw_p = 0;
+    gif->data = NULL;
+    gif->is_file = is_file;
+
+    if(is_file) {
+        lv_fs_res_t res = lv_fs_open(&gif->fd, path, LV_FS_MODE_RD);
+        if(res != LV_FS_RES_OK) return false;
+        else return true;
+    }
+    else {
+        gif->data = path;
+        return true;
+    }
+}
+
+static void f_gif_read(gif_dec_t * gif, void * buf, size_t len)
+{
+    if(gif->is_file) {
+        lv_fs_read(&gif->fd, buf, len, NULL);
+    }
+    else {
+        memcpy(buf, &gif->data[gif->f_rw_p], len);
+        gif->f_rw_p += len;
+    }
+}
+
+static int f_gif_seek(gif_dec_t * gif, size_t pos, int k)
+{
+    if(gif->is_file) {
+        lv_fs_seek(&gif->fd, pos, k);
+        uint32_t x;
+        lv_fs_tell(&gif->fd, &x);
+        return x;
+    }
+    else {
+        if(k == LV_FS_SEEK_CUR) gif->f_rw_p += pos;
+        else if(k == LV_FS_SEEK_SET) gif->f_rw_p = pos;
+        return gif->f_rw_p;
+    }
+}
+
+static void f_gif_close(gif_dec_t * gif)
+{
+    if(gif->is_file) {
+        lv_fs_close(&gif->fd);
+    }
+}
+
@@ -0,0 +1,96 @@
+/**
+ * GIF解码器，移植自 LVGL 的 gifdec (src/libs/gif/gifdec.h，公有领域)
+ * 与原版的区别: 画布可直接解码成 RGB565 / RGB565_SWAPPED / RGB565A8，不再固定为 ARGB8888；
+ * LZW解码按字读取码流、使用固定4096项的平铺码表，字符串直接倒序写入帧，
+ * 不再区分 LV_GIF_CACHE_DECODE_DATA
+ */
+#ifndef __GIF_DEC_H__
+#define __GIF_DEC_H__
+
+#include "lvgl.h"
+#include <stdint.h>
+
+typedef struct _gif_dec_palette {
+    int size;
+    uint8_t colors[0x100 * 3];
+} gif_dec_palette_t;
+
+typedef struct _gif_dec_gce {
+    uint16_t delay;
+    uint8_t tindex;
+    uint8_t disposal;
+    int input;
+    int transparency;
+} gif_dec_gce_t;
+
+typedef struct _gif_dec {
+    lv_fs_file_t fd;
+    const char * data;
+    uint8_t is_file;
+    uint32_t f_rw_p;
+    int32_t anim_start;
+    uint16_t width, height;
+    uint16_t depth;
+    int32_t loop_count;
+    gif_dec_gce_t gce;
+    gif_dec_palette_t * palette;
+    gif_dec_palette_t lct, gct;
+    uint16_t fx, fy, fw, fh;
+    uint8_t bgindex;
+    lv_color_format_t cf;       /* 画布颜色格式 */
+    uint8_t * canvas, * frame;
+    uint8_t * alpha;            /* RGB565A8 的 alpha 平面，其它格式为 NULL */
+    bool own_mem;               /* 内存由解码器申请，关闭时释放 */
+    void * lzw_table;           /* 固定大小的LZW码表，与画布在同一块内存 */
+} gif_dec_t;
+
+/**
+ * 打开GIF文件
+ * @param fname    文件路径
+ * @param cf       画布格式: LV_COLOR_FORMAT_ARGB8888 / RGB565 / RGB565_SWAPPED / RGB565A8。
+ *                 传入 RGB565 / RGB565_SWAPPED 时若GIF需要透明(透明色+恢复背景的处置方式)，
+ *                 自动改用 RGB565A8(LVGL没有字节交换的RGB565A8，这种GIF的画布仍是原生字节序)
+ * @param buf      解码器和画布使用的内存，NULL则自行申请
+ * @param buf_size buf的大小，需不小于 gif_dec_probe_file 的返回值
+ */
+gif_dec_t * gif_dec_open_file(const char * fname, lv_color_format_t cf, void * buf, uint32_t buf_size);
+
+/**
+ * 打开内存中的GIF数据，参数同 gif_dec_open_file
+ */
+gif_dec_t * gif_dec_open_data(const void * data, lv_color_format_t cf, void * buf, uint32_t buf_size);
+
+/**
+ * 只解析文件头，返回以cf格式打开该GIF所需的内存字节数，失败返回0
+ * @param canvas_size 不为NULL时返回画布字节数(同打开后的 gif_dec_canvas_size)
+ */
+uint32_t gif_dec_probe_file(const char * fname, lv_color_format_t cf, uint32_t * canvas_size);
+
+/**
+ * 同 gif_dec_probe_file，GIF数据在内存中
+ */
+uint32_t gif_dec_probe_data(const void * data, lv_color_format_t cf, uint32_t * canvas_size);
+
+/**
+ * 画布每个像素占用的字节数(RGB565A8 不含 alpha 平面)
+ */
+uint32_t gif_dec_canvas_bpp(const gif_dec_t * gif);
+
+/**
+ * 画布总字节数
+ */
+uint32_t gif_dec_canvas_size(const gif_dec_t * gif);
+
+/**
+ * 解码器占用的内存字节数(与打开时 probe 的返回值相同)，放在调用者内存中时其后的部分可另作他用
+ */
+uint32_t gif_dec_mem_size(const gif_dec_t * gif);
+
+void gif_dec_render_frame(gif_dec_t * gif, uint8_t * buffer);
+
+/* Return 1 if got a frame; 0 if got GIF trailer; -1 if error. */
+int gif_dec_get_frame(gif_dec_t * gif);
+void gif_dec_rewind(gif_dec_t * gif);
+void gif_dec_close(gif_dec_t * gif);
+
+#endif
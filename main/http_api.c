@@ -1,12 +1,20 @@
 #include "http_api.h"
 #include "d_wifi.h"
+#include "config.h"
 #include <sys/stat.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "cJSON.h"
 
 #include "audio_api.h"
+#include "audio_stream.h"
+#include "audio_mixer.h"
+#include "audio_mix.h"
+#include "telemetry.h"
+#include "mirror.h"
 
 static const char *TAG = "http_api";
 
@@ -16,6 +24,8 @@ static const char *TAG = "http_api";
 httpd_handle_t http_server = NULL;
 //连接的客户端fds
 static int client_sockfd = -1;
+//ws发送锁，镜像发送任务和ws处理任务会同时发送，一帧的数据不能交错
+static SemaphoreHandle_t ws_send_lock = NULL;
 // Register all common captive portal detection endpoints
 const char* captive_portal_urls[] = {
   // Apple 强制门户检测
@@ -71,6 +81,9 @@ esp_err_t http_server_start(void)
   server_config.max_open_sockets = 7;
   server_config.lru_purge_enable = true;
   server_config.stack_size = 8192;
+  if(ws_send_lock == NULL) {
+    ws_send_lock = xSemaphoreCreateMutex();
+  }
   return httpd_start(&http_server, &server_config);
 }
 
@@ -110,6 +123,8 @@ esp_err_t ws_handler(httpd_req_t *req)
   if (req->method == HTTP_GET)
   {
       ESP_LOGI(TAG, "Handshake done, the new connection was opened");
+      //镜像只发给订阅的客户端，新客户端需要重新订阅
+      mirror_stop();
       //把套接字描述符保存下来，方便后续发送数据用
       client_sockfd = httpd_req_to_sockfd(req);
       ESP_LOGI(TAG,"Save client_fds:%d",client_sockfd);
@@ -140,7 +155,7 @@ esp_err_t ws_handler(httpd_req_t *req)
           return ret;
       }
   }
-  ESP_LOGI(TAG, "frame len is %d", ws_pkt.len);
+  ESP_LOGI(TAG, "frame len is %zu", ws_pkt.len);
   handle_ws_receive(ws_pkt.payload, ws_pkt.len, ws_pkt.type);
   free(buf);
   return ESP_OK;
@@ -174,6 +189,96 @@ static void wifi_scan_finish_handle(uint16_t ap_num, wifi_ap_record_t *ap_record
     cJSON_Delete(root);
 }
 
+/**
+ * 在http服务器任务中发送 ws_play_done 生成的通知并释放
+ */
+static void ws_play_done_send(void *arg)
+{
+  char* data = arg;
+  http_ws_send((uint8_t*)data, strlen(data));
+  cJSON_free(data);
+}
+
+/**
+ * 通过 play 事件开始的本地播放结束时通知客户端，在本地播放任务中调用;
+ * 发送会阻塞(等ws发送锁和socket)，交给http服务器任务发送，播放任务马上可以开始下一个
+ */
+static void ws_play_done(audio_play_handle_t handle, audio_play_result_t result, void *arg)
+{
+  static const char* result_names[] = {"done", "stopped", "error"};
+  cJSON* root = cJSON_CreateObject();
+  cJSON_AddStringToObject(root,"event", "play_done");
+  cJSON_AddNumberToObject(root,"handle", handle);
+  cJSON_AddStringToObject(root,"result", result_names[result]);
+  char* data = cJSON_PrintUnformatted(root);
+  cJSON_Delete(root);
+  if(data == NULL)
+  {
+    return;
+  }
+  if(http_server == NULL || httpd_queue_work(http_server, ws_play_done_send, data) != ESP_OK)
+  {
+    ESP_LOGW(TAG, "play_done of %" PRIu32 " not sent", handle);
+    cJSON_free(data);
+  }
+}
+
+/**
+ * 发送渲染/刷新统计和 since 之后的事件(格式见 telemetry.h)
+ * @param binary true发送二进制快照，false发送JSON，事件为 [序号, 结束时间us, 类型, 耗时us, aux]
+ * @param reset_max 发送后把最大耗时清零
+ */
+static void ws_send_telemetry(bool binary, uint32_t since, bool reset_max)
+{
+  static const char* type_names[TELEMETRY_TYPE_CNT] = {"lvgl", "refr", "flush", "frame"};
+  telemetry_snapshot_t* snap = malloc(sizeof(telemetry_snapshot_t));
+  if(!snap)
+  {
+    ESP_LOGE(TAG, "Failed to malloc telemetry snapshot");
+    return;
+  }
+  size_t size = telemetry_snapshot(snap, since, reset_max);
+  if(binary){
+    http_ws_send_bin((uint8_t*)snap, size);
+    free(snap);
+    return;
+  }
+  cJSON* root = cJSON_CreateObject();
+  cJSON_AddStringToObject(root, "event", "telemetry");
+  cJSON_AddNumberToObject(root, "time_us", snap->time_us);
+  cJSON_AddNumberToObject(root, "next_seq", snap->next_seq);
+  cJSON_AddNumberToObject(root, "dropped", snap->dropped);
+  cJSON* stats_js = cJSON_AddObjectToObject(root, "stats");
+  for(int i = 0; i < TELEMETRY_TYPE_CNT; i++){
+    cJSON* type_js = cJSON_AddObjectToObject(stats_js, type_names[i]);
+    cJSON_AddNumberToObject(type_js, "count", snap->hist[i].count);
+    cJSON_AddNumberToObject(type_js, "sum_us", snap->hist[i].sum_us);
+    cJSON_AddNumberToObject(type_js, "max_us", snap->hist[i].max_us);
+    cJSON* hist_js = cJSON_AddArrayToObject(type_js, "hist");
+    for(int j = 0; j < TELEMETRY_HIST_BUCKETS; j++){
+      cJSON_AddItemToArray(hist_js, cJSON_CreateNumber(snap->hist[i].hist[j]));
+    }
+  }
+  cJSON* events_js = cJSON_AddArrayToObject(root, "events");
+  for(uint32_t i = 0; i < snap->event_cnt; i++){
+    const telemetry_event_t* e = &snap->events[i];
+    cJSON* event_js = cJSON_CreateArray();
+    cJSON_AddItemToArray(event_js, cJSON_CreateNumber(e->seq));
+    cJSON_AddItemToArray(event_js, cJSON_CreateNumber(e->time_us));
+    cJSON_AddItemToArray(event_js, cJSON_CreateNumber(TELEMETRY_EVENT_TYPE(e)));
+    cJSON_AddItemToArray(event_js, cJSON_CreateNumber(TELEMETRY_EVENT_DUR(e)));
+    cJSON_AddItemToArray(event_js, cJSON_CreateNumber(e->aux));
+    cJSON_AddItemToArray(events_js, event_js);
+  }
+  free(snap);
+  char* data = cJSON_PrintUnformatted(root);
+  if(data){
+    http_ws_send((uint8_t*)data, strlen(data));
+    cJSON_free(data);
+  }
+  cJSON_Delete(root);
+}
+
 /**
  * 处理接收到的ws数据
  */
@@ -208,6 +313,148 @@ void handle_ws_receive(uint8_t* payload, int len, httpd_ws_type_t type) {
         cJSON* pass_js = cJSON_GetObjectItem(data_js,"pass");
         char* pass = cJSON_GetStringValue(pass_js);
         wifi_connect_sta(ssid, pass);
+      }else if(strcmp(event, "telemetry") == 0){
+        // {"event":"telemetry","data":{"format":"json"|"bin","since":next_seq,"reset_max":false}}，data可省略
+        // max_us 只在 reset_max 为 true 时清零，其它客户端的查询不会清掉它
+        cJSON* data_js = cJSON_GetObjectItem(root,"data");
+        char* format = cJSON_GetStringValue(cJSON_GetObjectItem(data_js,"format"));
+        cJSON* since_js = cJSON_GetObjectItem(data_js,"since");
+        uint32_t since = cJSON_IsNumber(since_js) ? (uint32_t)since_js->valuedouble : 0;
+        bool reset_max = cJSON_IsTrue(cJSON_GetObjectItem(data_js,"reset_max"));
+        ws_send_telemetry(format && strcmp(format, "bin") == 0, since, reset_max);
+      }else if(strcmp(event, "mirror") == 0){
+        // {"event":"mirror","data":{"on":true,"codec":"lz4"|"rle"|"raw","fps":15}}，帧格式见 mirror.h
+        cJSON* data_js = cJSON_GetObjectItem(root,"data");
+        esp_err_t err = ESP_OK;
+        if(cJSON_IsTrue(cJSON_GetObjectItem(data_js,"on"))){
+          char* codec = cJSON_GetStringValue(cJSON_GetObjectItem(data_js,"codec"));
+          cJSON* fps_js = cJSON_GetObjectItem(data_js,"fps");
+          mirror_codec_t c = MIRROR_CODEC_LZ4;
+          if(codec && strcmp(codec, "rle") == 0){
+            c = MIRROR_CODEC_RLE;
+          }else if(codec && strcmp(codec, "raw") == 0){
+            c = MIRROR_CODEC_RAW;
+          }
+          err = mirror_start(c, cJSON_IsNumber(fps_js) ? (uint32_t)fps_js->valuedouble : MIRROR_MAX_FPS);
+        }else{
+          mirror_stop();
+        }
+        cJSON* root_ret = cJSON_CreateObject();
+        cJSON_AddStringToObject(root_ret,"event", "mirror_ret");
+        cJSON_AddBoolToObject(root_ret,"ret", err == ESP_OK);
+        char* data_ret = cJSON_PrintUnformatted(root_ret);
+        http_ws_send((uint8_t*)data_ret, strlen(data_ret));
+        cJSON_free(data_ret);
+        cJSON_Delete(root_ret);
+      }else if(strcmp(event, "audio") == 0){
+        // {"event":"audio","data":{"latency":200}}，设置音频流的目标延迟(可省略)并返回统计
+        cJSON* latency_js = cJSON_GetObjectItem(cJSON_GetObjectItem(root,"data"),"latency");
+        if(cJSON_IsNumber(latency_js)){
+          audio_stream_set_latency((uint32_t)latency_js->valuedouble);
+        }
+        audio_stream_stats_t stats;
+        audio_stream_get_stats(&stats);
+        cJSON* root_ret = cJSON_CreateObject();
+        cJSON_AddStringToObject(root_ret,"event", "audio_ret");
+        cJSON_AddNumberToObject(root_ret,"size", stats.size);
+        cJSON_AddNumberToObject(root_ret,"latency", stats.latency_ms);
+        cJSON_AddNumberToObject(root_ret,"fill", stats.fill);
+        cJSON_AddNumberToObject(root_ret,"max_fill", stats.max_fill);
+        cJSON_AddNumberToObject(root_ret,"streams", stats.streams);
+        cJSON_AddNumberToObject(root_ret,"starts", stats.starts);
+        cJSON_AddNumberToObject(root_ret,"underruns", stats.underruns);
+        cJSON_AddNumberToObject(root_ret,"overruns", stats.overruns);
+        cJSON_AddNumberToObject(root_ret,"dropped", stats.dropped);
+        cJSON_AddNumberToObject(root_ret,"written", stats.written);
+        cJSON_AddNumberToObject(root_ret,"played", stats.played);
+        char* data_ret = cJSON_PrintUnformatted(root_ret);
+        http_ws_send((uint8_t*)data_ret, strlen(data_ret));
+        cJSON_free(data_ret);
+        cJSON_Delete(root_ret);
+      }else if(strcmp(event, "play") == 0){
+        // {"event":"play","data":{"path":"/spiffs/audio/a.pcm","voice":1,"loop":false}}，开始本地播放(不阻塞)，
+        // 返回句柄(失败时 err 为错误名)，播完或停止时再发 {"event":"play_done","handle":N,"result":"done"}
+        cJSON* data_js = cJSON_GetObjectItem(root,"data");
+        char* path = cJSON_GetStringValue(cJSON_GetObjectItem(data_js,"path"));
+        cJSON* voice_js = cJSON_GetObjectItem(data_js,"voice");
+        audio_play_cfg_t cfg = AUDIO_PLAY_CFG_DEFAULT();
+        if(cJSON_IsNumber(voice_js)){
+          cfg.voice = (int)voice_js->valuedouble;
+        }
+        cfg.loop = cJSON_IsTrue(cJSON_GetObjectItem(data_js,"loop"));
+        cfg.on_done = ws_play_done;
+        audio_play_handle_t handle = 0;
+        esp_err_t err = path ? audio_play_start(path, &cfg, &handle) : ESP_ERR_INVALID_ARG;
+        cJSON* root_ret = cJSON_CreateObject();
+        cJSON_AddStringToObject(root_ret,"event", "play_ret");
+        cJSON_AddBoolToObject(root_ret,"ret", err == ESP_OK);
+        cJSON_AddNumberToObject(root_ret,"handle", handle);
+        cJSON_AddStringToObject(root_ret,"err", esp_err_to_name(err));
+        char* data_ret = cJSON_PrintUnformatted(root_ret);
+        http_ws_send((uint8_t*)data_ret, strlen(data_ret));
+        cJSON_free(data_ret);
+        cJSON_Delete(root_ret);
+      }else if(strcmp(event, "play_stop") == 0){
+        // {"event":"play_stop","data":{"handle":N}}，淡出停止，结束时发 play_done
+        cJSON* handle_js = cJSON_GetObjectItem(cJSON_GetObjectItem(root,"data"),"handle");
+        if(cJSON_IsNumber(handle_js)){
+          audio_play_stop((audio_play_handle_t)handle_js->valuedouble);
+        }
+      }else if(strcmp(event, "mixer") == 0){
+        // {"event":"mixer","data":{"voice":1,"gain":0.5,"duck_gain":0.25,"ducker":false,"fade":200,"stop":true}}，
+        // 修改一个声部的设置(都可省略，增益0~2)或淡出停止，返回各声部的设置和混音统计
+        cJSON* data_js = cJSON_GetObjectItem(root,"data");
+        cJSON* voice_js = cJSON_GetObjectItem(data_js,"voice");
+        if(cJSON_IsNumber(voice_js)){
+          int voice = (int)voice_js->valuedouble;
+          audio_mixer_voice_cfg_t cfg;
+          audio_mixer_get_voice(voice, &cfg);
+          cJSON* gain_js = cJSON_GetObjectItem(data_js,"gain");
+          cJSON* duck_js = cJSON_GetObjectItem(data_js,"duck_gain");
+          cJSON* ducker_js = cJSON_GetObjectItem(data_js,"ducker");
+          cJSON* fade_js = cJSON_GetObjectItem(data_js,"fade");
+          if(cJSON_IsNumber(gain_js)){
+            cfg.gain = (int32_t)(gain_js->valuedouble * AUDIO_MIX_UNITY);
+          }
+          if(cJSON_IsNumber(duck_js)){
+            cfg.duck_gain = (int32_t)(duck_js->valuedouble * AUDIO_MIX_UNITY);
+          }
+          if(cJSON_IsTrue(ducker_js) || cJSON_IsFalse(ducker_js)){
+            cfg.ducker = cJSON_IsTrue(ducker_js);
+          }
+          if(cJSON_IsNumber(fade_js)){
+            cfg.fade_ms = (uint32_t)fade_js->valuedouble;
+          }
+          audio_mixer_set_voice(voice, &cfg);
+          if(cJSON_IsTrue(cJSON_GetObjectItem(data_js,"stop"))){
+            audio_mixer_stop(voice);
+          }
+        }
+        audio_mixer_stats_t stats;
+        audio_mixer_get_stats(&stats);
+        cJSON* root_ret = cJSON_CreateObject();
+        cJSON_AddStringToObject(root_ret,"event", "mixer_ret");
+        cJSON_AddNumberToObject(root_ret,"blocks", stats.blocks);
+        cJSON_AddNumberToObject(root_ret,"samples", stats.samples);
+        cJSON_AddNumberToObject(root_ret,"mix_us", stats.mix_us);
+        cJSON_AddNumberToObject(root_ret,"max_voices", stats.max_voices);
+        cJSON* voices_js = cJSON_AddArrayToObject(root_ret,"voices");
+        for(int v = 0; v < AUDIO_MIXER_VOICES; v++){
+          audio_mixer_voice_cfg_t cfg;
+          audio_mixer_get_voice(v, &cfg);
+          cJSON* v_js = cJSON_CreateObject();
+          cJSON_AddNumberToObject(v_js,"gain", (double)cfg.gain / AUDIO_MIX_UNITY);
+          cJSON_AddNumberToObject(v_js,"duck_gain", (double)cfg.duck_gain / AUDIO_MIX_UNITY);
+          cJSON_AddBoolToObject(v_js,"ducker", cfg.ducker);
+          cJSON_AddNumberToObject(v_js,"fade", cfg.fade_ms);
+          cJSON_AddNumberToObject(v_js,"pending", audio_mixer_pending(v));
+          cJSON_AddNumberToObject(v_js,"samples", stats.voice_samples[v]);
+          cJSON_AddItemToArray(voices_js, v_js);
+        }
+        char* data_ret = cJSON_PrintUnformatted(root_ret);
+        http_ws_send((uint8_t*)data_ret, strlen(data_ret));
+        cJSON_free(data_ret);
+        cJSON_Delete(root_ret);
       }
       cJSON_Delete(root);
     }else{
@@ -218,10 +465,7 @@ void handle_ws_receive(uint8_t* payload, int len, httpd_ws_type_t type) {
   }
 }
 
-/**
- * 发送ws数据给客户端
- */
-esp_err_t http_ws_send(uint8_t* data, int len)
+static esp_err_t http_ws_send_frame(uint8_t* data, int len, httpd_ws_type_t type)
 {
   if(client_sockfd < 0)
   {
@@ -231,8 +475,27 @@ esp_err_t http_ws_send(uint8_t* data, int len)
   memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
   ws_pkt.payload = data;
   ws_pkt.len = len;
-  ws_pkt.type = HTTPD_WS_TYPE_TEXT;
-  return httpd_ws_send_data(http_server, client_sockfd, &ws_pkt);
+  ws_pkt.type = type;
+  xSemaphoreTake(ws_send_lock, portMAX_DELAY);
+  esp_err_t ret = httpd_ws_send_data(http_server, client_sockfd, &ws_pkt);
+  xSemaphoreGive(ws_send_lock);
+  return ret;
+}
+
+/**
+ * 发送ws数据给客户端
+ */
+esp_err_t http_ws_send(uint8_t* data, int len)
+{
+  return http_ws_send_frame(data, len, HTTPD_WS_TYPE_TEXT);
+}
+
+/**
+ * 发送ws二进制数据给客户端
+ */
+esp_err_t http_ws_send_bin(uint8_t* data, int len)
+{
+  return http_ws_send_frame(data, len, HTTPD_WS_TYPE_BINARY);
 }
 
 /**
@@ -22,6 +22,9 @@ esp_err_t http_init(void);
 // websocket发送数据
 esp_err_t http_ws_send(uint8_t* data, int len);
 
+// websocket发送二进制数据
+esp_err_t http_ws_send_bin(uint8_t* data, int len);
+
 // 获取网页内容
 char* web_page_buffer_init(const char* html_path);
 
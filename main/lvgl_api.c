@@ -3,186 +3,594 @@
 #include "config.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
 #include "d_lcd.h"
+#include "emoji_pack.h"
+#include "emoji_gif.h"
+#include "asset_map.h"
+#include "cJSON.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/param.h>
 
 static const char *TAG = "lvgl_api";
 
-// emoji表情序列
-// 正常
-static char* EMOJI_NORMAL_SEQ_PATH[] = {
-    "S:/gif/blink_once.gif", 
-    NULL
-};
-// 疑惑
-static char* EMOJI_DOUBT_SEQ_PATH[] = {
-    "S:/gif/blink_twice.gif",
-    NULL
-};
-// 思考
-static char* EMOJI_THINK_SEQ_PATH[] = {
-    "S:/gif/look_lt_in.gif",
-    "S:/gif/look_lt_do.gif",
-    "S:/gif/look_lt_do.gif",
-    "S:/gif/look_lt_do.gif",
-    "S:/gif/look_lt_out.gif",
-    NULL
-};
-// 感知
-static char* EMOJI_PERCEPT_SEQ_PATH[] = {
-    "S:/gif/look_rt_in.gif",
-    "S:/gif/look_rt_do.gif",
-    "S:/gif/look_rt_do.gif",
-    "S:/gif/look_rt_do.gif",
-    "S:/gif/look_rt_out.gif",
-    NULL
-};
-// 恐慌
-static char* EMOJI_PANIC_SEQ_PATH[] = {
-    "S:/gif/panic_in.gif", 
-    "S:/gif/panic_do.gif", 
-    "S:/gif/panic_do.gif", 
-    "S:/gif/panic_do.gif", 
-    "S:/gif/panic_out.gif",
-    NULL
-};
-// 不屑
-static char* EMOJI_DISDAIN_SEQ_PATH[] = {
-    "S:/gif/disdain_in.gif",
-    "S:/gif/disdain_do.gif",
-    "S:/gif/disdain_do.gif",
-    "S:/gif/disdain_do.gif",
-    "S:/gif/disdain_out.gif",
-    NULL
-};
-// 生气
-static char* EMOJI_ANGRY_SEQ_PATH[] = {
-    "S:/gif/angry_in.gif", 
-    "S:/gif/angry_do.gif", 
-    "S:/gif/angry_do.gif", 
-    "S:/gif/angry_do.gif", 
-    "S:/gif/angry_out.gif",
-    NULL
-};
-// 兴奋
-static char* EMOJI_EXCITE_SEQ_PATH[] = {
-    "S:/gif/excite_in.gif", 
-    "S:/gif/excite_do.gif", 
-    "S:/gif/excite_do.gif", 
-    "S:/gif/excite_do.gif", 
-    "S:/gif/excite_out.gif",
-    NULL
+#define EMOJI_SCHED_TASK_STACK_SIZE (3 * 1024)
+// 高于LVGL任务，命令到达后立即处理
+#define EMOJI_SCHED_TASK_PRIORITY   3
+// 调度任务的通知位
+#define EMOJI_NOTIFY_CMD            0x01
+#define EMOJI_NOTIFY_DONE           0x02
+// 片段请求中表示停止播放
+#define EMOJI_NO_EMOTION            0xFF
+
+// 表情片段路径，序列中只记录片段名。优先使用资源分区中的同名资源，没有再读spiffs
+#if EMOJI_USE_FRAME_PACK
+#define EMOJI_CLIP_ASSET "pack/%s.epk"
+#else
+#define EMOJI_CLIP_ASSET "gif/%s.gif"
+#endif
+#define EMOJI_CLIP_PATH "S:/" EMOJI_CLIP_ASSET
+
+// 表情中的一段: 片段连续播放loops次(原地回绕，不重新打开)，播完后停在最后一帧hold_ms毫秒
+typedef struct {
+    char clip[EMOJI_NAME_LEN];
+    uint16_t loops;
+    uint32_t hold_ms;
+} emoji_step_t;
+
+// 一个表情由若干段组成
+typedef struct {
+    char name[EMOJI_NAME_LEN];
+    uint8_t priority;               // 优先级，不低于当前表情才能抢占
+    uint8_t step_cnt;
+    emoji_step_t steps[EMOJI_MAX_STEPS];
+} emoji_emotion_t;
+
+// 清单缺失或解析失败时使用的内置表情，与 spiffs/emoji/emotions.json 一致
+static const emoji_emotion_t EMOJI_DEFAULT_EMOTIONS[] = {
+    {"normal",  0, 1, {{"blink_once", 1, 0}}},
+    {"doubt",   1, 1, {{"blink_twice", 1, 0}}},
+    {"think",   1, 3, {{"look_lt_in", 1, 0}, {"look_lt_do", 3, 0}, {"look_lt_out", 1, 0}}},
+    {"percept", 1, 3, {{"look_rt_in", 1, 0}, {"look_rt_do", 3, 0}, {"look_rt_out", 1, 0}}},
+    {"angry",   2, 3, {{"angry_in", 1, 0}, {"angry_do", 3, 0}, {"angry_out", 1, 0}}},
+    {"sad",     2, 3, {{"sad_in", 1, 0}, {"sad_do", 3, 0}, {"sad_out", 1, 0}}},
+    {"excite",  2, 3, {{"excite_in", 1, 0}, {"excite_do", 3, 0}, {"excite_out", 1, 0}}},
+    {"panic",   3, 3, {{"panic_in", 1, 0}, {"panic_do", 3, 0}, {"panic_out", 1, 0}}},
+    {"disdain", 2, 3, {{"disdain_in", 1, 0}, {"disdain_do", 3, 0}, {"disdain_out", 1, 0}}},
 };
-// 悲伤
-static char* EMOJI_SAD_SEQ_PATH[] = {
-    "S:/gif/sad_in.gif", 
-    "S:/gif/sad_do.gif", 
-    "S:/gif/sad_do.gif", 
-    "S:/gif/sad_do.gif", 
-    "S:/gif/sad_out.gif",
-    NULL
+
+// EMOTE_TYPE 对应清单中的表情名
+static const char* const EMOTE_NAMES[] = {
+    [EMOTE_NORMAL]  = "normal",
+    [EMOTE_DOUBT]   = "doubt",
+    [EMOTE_THINK]   = "think",
+    [EMOTE_PERCEPT] = "percept",
+    [EMOTE_ANGRY]   = "angry",
+    [EMOTE_SAD]     = "sad",
+    [EMOTE_EXCITE]  = "excite",
+    [EMOTE_PANIC]   = "panic",
+    [EMOTE_DISDAIN] = "disdain",
 };
 
-// gif seq序列结构体
+// 开机时解析出的表情表
+static emoji_emotion_t emoji_emotions[EMOJI_MAX_EMOTIONS];
+static uint8_t emoji_emotion_cnt = 0;
+
+// 表情命令，由任意任务发给调度任务
 typedef struct {
-    char** seq_path;        // 序列路径数组
-    uint8_t seq_index;     // 当前播放序列索引
-} gif_seq_t;
+    uint8_t emotion;                // 表情在 emoji_emotions 中的序号
+    int64_t time_us;                // 发出命令的时间，用于统计到首帧的延迟
+} emoji_cmd_t;
 
-// 当前gif播放对象
-static lv_obj_t* emoji_gif = NULL;
+// 调度任务交给LVGL任务的片段请求，emotion 为 EMOJI_NO_EMOTION 时表示播放结束
+typedef struct {
+    uint8_t emotion;
+    uint8_t step;
+    uint32_t gen;
+    int64_t time_us;                // 表情第一段带上命令时间，其余为0
+} emoji_clip_req_t;
+
+// 调度器状态，只在调度任务中访问
+typedef struct {
+    const emoji_emotion_t* emotion; // 当前表情，NULL表示空闲
+    uint8_t step_index;             // 当前播放的段
+    bool exiting;                   // 已被抢占，正在播放退出段
+    bool holding;                   // 段已播完，停在最后一帧
+    TickType_t hold_until;
+    const emoji_emotion_t* pending; // 抢占后等待播放的表情，同级以上的新请求覆盖它
+    int64_t pending_time_us;
+    uint32_t gen;                   // 每发出一个片段加1，过期的播放完毕通知直接忽略
+} emoji_sched_t;
+
+// 调度统计
+typedef struct {
+    uint32_t received;              // 收到的命令
+    uint32_t coalesced;             // 与正在播放或等待中的表情相同而合并的命令
+    uint32_t dropped;               // 优先级不够被丢弃的命令
+    uint32_t preempted;             // 抢占次数
+} emoji_sched_stats_t;
+
+// 每个LVGL显示一个播放对象(第二只眼有自己的显示时两个)，所有片段在它们上面原地切换，
+// 第一个的播放完毕通知驱动调度
+#define EMOJI_EYE_MAX 2
+static lv_obj_t* emoji_gifs[EMOJI_EYE_MAX] = {NULL};
+static uint32_t emoji_eye_cnt = 0;
+// 解码内存池，每个播放对象一个，按最大的片段预分配，播放期间不再申请/释放
+static void* emoji_pools[EMOJI_EYE_MAX] = {NULL};
+// 有界的表情命令队列
+static QueueHandle_t emoji_cmd_queue = NULL;
+// 长度为1的片段请求邮箱，调度任务覆盖写，LVGL任务定时读取
+static QueueHandle_t emoji_clip_mailbox = NULL;
+static TaskHandle_t emoji_sched_task_handle = NULL;
+static emoji_sched_stats_t emoji_sched_stats = {0};
+// 命令队列满时被挤掉的旧命令，在调用 emoji_play_by_name 的任务中计数，可能有多个任务同时调用
+static atomic_uint emoji_cmd_overflow;
+// LVGL任务正在播放的片段，播放完毕时回报给调度任务
+static volatile uint32_t emoji_clip_gen = 0;
+static volatile uint32_t emoji_done_gen = 0;
 // emoji播放定时器
 static TimerHandle_t emoji_timer = NULL;
+#if !EMOJI_USE_FRAME_PACK
+// 资源分区中GIF数据的描述，播放期间一直有效
+static lv_image_dsc_t emoji_clip_dsc;
+#endif
+
+/**
+ * 解析一个表情，格式: {"name": "think", "priority": 1, "clips": [{"clip": "look_lt_do", "loop": 3, "hold": 500}, ...]}
+ * priority 默认0，loop 默认1，hold(毫秒) 默认0。最后一段是退出段，被抢占时直接跳到这里
+ * priority 超过255、loop 超过65535、hold 为负或超过 EMOJI_MAX_HOLD_MS 时整个表情无效，不截断
+ */
+static bool emoji_parse_emotion(const cJSON* emotion_js, emoji_emotion_t* emotion) {
+    const char* name = cJSON_GetStringValue(cJSON_GetObjectItem(emotion_js, "name"));
+    const cJSON* clips_js = cJSON_GetObjectItem(emotion_js, "clips");
+    if (name == NULL || !cJSON_IsArray(clips_js)) {
+        return false;
+    }
+    memset(emotion, 0, sizeof(*emotion));
+    strlcpy(emotion->name, name, sizeof(emotion->name));
+    const cJSON* priority_js = cJSON_GetObjectItem(emotion_js, "priority");
+    if (cJSON_IsNumber(priority_js) && priority_js->valuedouble > UINT8_MAX) {
+        ESP_LOGW(TAG, "emotion %s: priority %.0f more than %d", name, priority_js->valuedouble, UINT8_MAX);
+        return false;
+    }
+    emotion->priority = cJSON_IsNumber(priority_js) && priority_js->valueint > 0 ? priority_js->valueint : 0;
+    const cJSON* clip_js;
+    cJSON_ArrayForEach(clip_js, clips_js) {
+        const char* clip = cJSON_GetStringValue(cJSON_GetObjectItem(clip_js, "clip"));
+        if (clip == NULL) {
+            ESP_LOGW(TAG, "emotion %s: clip without name", name);
+            return false;
+        }
+        if (emotion->step_cnt == EMOJI_MAX_STEPS) {
+            ESP_LOGW(TAG, "emotion %s: more than %d clips", name, EMOJI_MAX_STEPS);
+            return false;
+        }
+        const cJSON* loop_js = cJSON_GetObjectItem(clip_js, "loop");
+        const cJSON* hold_js = cJSON_GetObjectItem(clip_js, "hold");
+        if (cJSON_IsNumber(loop_js) && loop_js->valuedouble > UINT16_MAX) {
+            ESP_LOGW(TAG, "emotion %s: loop %.0f more than %d", name, loop_js->valuedouble, UINT16_MAX);
+            return false;
+        }
+        if (cJSON_IsNumber(hold_js) && (hold_js->valuedouble < 0 || hold_js->valuedouble > EMOJI_MAX_HOLD_MS)) {
+            ESP_LOGW(TAG, "emotion %s: hold %.0f ms out of range 0..%d", name, hold_js->valuedouble, EMOJI_MAX_HOLD_MS);
+            return false;
+        }
+        emoji_step_t* step = &emotion->steps[emotion->step_cnt++];
+        strlcpy(step->clip, clip, sizeof(step->clip));
+        step->loops = cJSON_IsNumber(loop_js) && loop_js->valueint > 0 ? loop_js->valueint : 1;
+        step->hold_ms = cJSON_IsNumber(hold_js) ? hold_js->valueint : 0;
+    }
+    return emotion->step_cnt > 0;
+}
+
+/**
+ * 开机时解析表情清单到静态表，失败则使用内置表情
+ */
+static void emoji_manifest_load(const char* path) {
+    emoji_emotion_cnt = 0;
+    cJSON* root = NULL;
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        char* text = malloc(st.st_size + 1);
+        FILE* fp = fopen(path, "r");
+        if (text && fp && fread(text, st.st_size, 1, fp) == 1) {
+            text[st.st_size] = '\0';
+            root = cJSON_Parse(text);
+        }
+        if (fp) {
+            fclose(fp);
+        }
+        free(text);
+    }
+    const cJSON* emotion_js;
+    cJSON_ArrayForEach(emotion_js, cJSON_GetObjectItem(root, "emotions")) {
+        if (emoji_emotion_cnt == EMOJI_MAX_EMOTIONS) {
+            ESP_LOGW(TAG, "more than %d emotions in %s", EMOJI_MAX_EMOTIONS, path);
+            break;
+        }
+        if (emoji_parse_emotion(emotion_js, &emoji_emotions[emoji_emotion_cnt])) {
+            emoji_emotion_cnt++;
+        } else {
+            ESP_LOGW(TAG, "skip invalid emotion in %s", path);
+        }
+    }
+    cJSON_Delete(root);
+
+    if (emoji_emotion_cnt == 0) {
+        ESP_LOGW(TAG, "no emotion in %s, use built-in table", path);
+        emoji_emotion_cnt = sizeof(EMOJI_DEFAULT_EMOTIONS) / sizeof(EMOJI_DEFAULT_EMOTIONS[0]);
+        memcpy(emoji_emotions, EMOJI_DEFAULT_EMOTIONS, sizeof(EMOJI_DEFAULT_EMOTIONS));
+    }
+    ESP_LOGI(TAG, "%d emotions loaded", emoji_emotion_cnt);
+}
 
-void play_gif_seq(gif_seq_t* gif_seq);
+static const emoji_emotion_t* emoji_find_emotion(const char* name) {
+    for (int i = 0; i < emoji_emotion_cnt; i++) {
+        if (strcmp(emoji_emotions[i].name, name) == 0) {
+            return &emoji_emotions[i];
+        }
+    }
+    return NULL;
+}
 
-// gif每一序列播放完毕回调
-void gif_playback_complete_cb(lv_event_t * e) {
+#if !EMOJI_USE_FRAME_PACK
+// 直方图格式化成 "<1:n <2:n ... >=64:n"(毫秒)
+static void emoji_hist_format(const uint32_t* hist, char* buf, size_t size) {
+    int len = 0;
+    for (int i = 0; i < EMOJI_GIF_HIST_BUCKETS && len < size; i++) {
+        if (i < EMOJI_GIF_HIST_BUCKETS - 1) {
+            len += snprintf(buf + len, size - len, "<%d:%" PRIu32 " ", 1 << i, hist[i]);
+        } else {
+            len += snprintf(buf + len, size - len, ">=%d:%" PRIu32, 1 << (i - 1), hist[i]);
+        }
+    }
+}
+
+// 打印片段的刷新和帧耗时统计，LVGL任务每帧平均耗时决定可达到的最高帧率
+static void emoji_gif_log_stats(void) {
+    emoji_gif_stats_t stats;
+    char hist[96];
+    emoji_gif_get_stats(emoji_gifs[0], &stats);
+    if (stats.frame_cnt == 0) {
+        return;
+    }
+    // 局部刷新统计: 平均每帧刷新的像素占整幅画面的比例
+    ESP_LOGI(TAG, "gif frames: %" PRIu32 ", invalidated px/frame: %" PRIu32 " (%" PRIu32 "%% of full)",
+             stats.frame_cnt, (uint32_t)(stats.total_px / stats.frame_cnt),
+             (uint32_t)(stats.total_px * 100 / stats.frame_cnt / (LCD_H_RES * LCD_V_RES)));
+    emoji_hist_format(stats.decode_hist, hist, sizeof(hist));
+    ESP_LOGI(TAG, "decode ms: %s", hist);
+    emoji_hist_format(stats.show_hist, hist, sizeof(hist));
+    ESP_LOGI(TAG, "lvgl ms: %s", hist);
+    uint32_t show_avg_us = stats.show_us / stats.frame_cnt;
+    ESP_LOGI(TAG, "lvgl us/frame: %" PRIu32 " (max %" PRIu32 " fps), decode us/frame: %" PRIu32 ", late: %" PRIu32,
+             show_avg_us, 1000000 / (show_avg_us ? show_avg_us : 1),
+             (uint32_t)(stats.decode_us / stats.frame_cnt), stats.late_cnt);
+}
+#endif
+
+// gif每一序列播放完毕回调(LVGL任务中执行)，通知调度任务
+static void gif_playback_complete_cb(lv_event_t * e) {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_READY) {
-        gif_seq_t* gif_seq = (gif_seq_t*)lv_event_get_user_data(e);
-        gif_seq->seq_index++;
-        if (emoji_gif != NULL) {
-            lv_obj_del_async(emoji_gif);
-            emoji_gif = NULL;
-        }
-        play_gif_seq(gif_seq);
+#if !EMOJI_USE_FRAME_PACK
+        emoji_gif_log_stats();
+#endif
+        emoji_done_gen = emoji_clip_gen;
+        xTaskNotify(emoji_sched_task_handle, EMOJI_NOTIFY_DONE, eSetBits);
     }
 }
 
-// 播放GIF序列
-void play_gif_seq(gif_seq_t* gif_seq) {
-    if (gif_seq == NULL) {
-        ESP_LOGW(TAG, "No current emoji sequence set");
+// 在资源分区中查找片段，返回映射的数据指针，没有返回NULL
+static const void* emoji_clip_asset(const char* clip, uint32_t* size) {
+    char name[ASSET_NAME_LEN];
+    snprintf(name, sizeof(name), EMOJI_CLIP_ASSET, clip);
+    return asset_map_get(name, size);
+}
+
+// 播放调度任务请求的片段(LVGL任务中执行)
+static void emoji_play_clip(const emoji_clip_req_t* req) {
+    if (req->emotion == EMOJI_NO_EMOTION) {
+        // 停在最后一帧，停止渲染，空闲久了屏幕睡眠
+        disp_enter_idle();
         return;
     }
-    // 所有序列播放完毕，执行回收代码
-    if (gif_seq->seq_path[gif_seq->seq_index] == NULL) {
-        ESP_LOGI(TAG, "Emoji sequence completed");
-        gif_seq->seq_index = 0;
-        free(gif_seq);
-        // 关闭刷新
-        disp_disable_update();
+    // 恢复渲染，屏幕睡眠时先唤醒
+    disp_exit_idle();
+    const emoji_step_t* step = &emoji_emotions[req->emotion].steps[req->step];
+    char path[48];
+    uint32_t size = 0;
+    const void* data = emoji_clip_asset(step->clip, &size);
+    snprintf(path, sizeof(path), EMOJI_CLIP_PATH, step->clip);
+    ESP_LOGI(TAG, "Playing emoji sequence index: %d, path: %s%s, loops: %d", req->step, path,
+             data ? " (mapped)" : "", step->loops);
+
+    emoji_clip_gen = req->gen;
+    // 多次循环在解码器内回绕到第一帧，不重新打开文件
+#if !EMOJI_USE_FRAME_PACK
+    if (data) {
+        emoji_clip_dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+        emoji_clip_dsc.data = data;
+        emoji_clip_dsc.data_size = size;
+    }
+#endif
+    for (uint32_t i = 0; i < emoji_eye_cnt; i++) {
+#if EMOJI_USE_FRAME_PACK
+        emoji_pack_set_loop_count(emoji_gifs[i], step->loops);
+        if (data) {
+            emoji_pack_set_data(emoji_gifs[i], data, size);
+        } else {
+            emoji_pack_set_src(emoji_gifs[i], path);
+        }
+#else
+        if (data) {
+            emoji_gif_set_src(emoji_gifs[i], &emoji_clip_dsc);
+        } else {
+            emoji_gif_set_src(emoji_gifs[i], path);
+        }
+        emoji_gif_set_loop_count(emoji_gifs[i], step->loops);
+#endif
+    }
+#if EMOJI_USE_FRAME_PACK
+    bool loaded = emoji_pack_is_loaded(emoji_gifs[0]);
+#else
+    bool loaded = emoji_gif_is_loaded(emoji_gifs[0]);
+#endif
+    if (req->time_us) {
+        ESP_LOGI(TAG, "first frame %" PRIu32 " us after request", (uint32_t)(esp_timer_get_time() - req->time_us));
+    }
+    // 片段缺失时当作已播完，不让整个表情卡住
+    if (!loaded) {
+        ESP_LOGW(TAG, "skip clip %s", path);
+        emoji_done_gen = req->gen;
+        xTaskNotify(emoji_sched_task_handle, EMOJI_NOTIFY_DONE, eSetBits);
+    }
+}
+
+// LVGL任务被唤醒后调用: 取出最新的片段请求，LVGL对象只在LVGL任务中操作
+static void emoji_poll(void) {
+    emoji_clip_req_t req;
+    if (xQueueReceive(emoji_clip_mailbox, &req, 0) == pdTRUE) {
+        emoji_play_clip(&req);
+    }
+}
+
+// 把当前段交给LVGL任务，邮箱中还没取走的旧请求直接被覆盖
+static void emoji_sched_post(emoji_sched_t* s, int64_t time_us) {
+    emoji_clip_req_t req = {
+        .emotion = s->emotion ? s->emotion - emoji_emotions : EMOJI_NO_EMOTION,
+        .step = s->step_index,
+        .gen = ++s->gen,
+        .time_us = time_us,
+    };
+    s->holding = false;
+    xQueueOverwrite(emoji_clip_mailbox, &req);
+    lvgl_port_wake();
+}
+
+static void emoji_sched_start(emoji_sched_t* s, const emoji_emotion_t* emotion, int64_t time_us) {
+    s->emotion = emotion;
+    s->step_index = 0;
+    s->exiting = false;
+    emoji_sched_post(s, time_us);
+}
+
+// 当前表情结束，有等待的表情就接着播放
+static void emoji_sched_finish(emoji_sched_t* s) {
+    if (s->pending) {
+        const emoji_emotion_t* next = s->pending;
+        s->pending = NULL;
+        emoji_sched_start(s, next, s->pending_time_us);
         return;
     }
-    // 开启刷新
-    disp_enable_update();
-    ESP_LOGI(TAG, "Playing emoji sequence index: %d, path: %s", gif_seq->seq_index, gif_seq->seq_path[gif_seq->seq_index]);
-    
+    emoji_sched_stats_t* st = &emoji_sched_stats;
+    ESP_LOGI(TAG, "Emoji sequence completed, cmd: %" PRIu32 ", coalesced: %" PRIu32 ", dropped: %" PRIu32 ", overflow: %" PRIu32 ", preempted: %" PRIu32,
+             st->received, st->coalesced, st->dropped,
+             (uint32_t)atomic_load_explicit(&emoji_cmd_overflow, memory_order_relaxed), st->preempted);
+    s->emotion = NULL;
+    emoji_sched_post(s, 0);
+}
+
+// 进入下一段
+static void emoji_sched_next(emoji_sched_t* s) {
+    s->step_index++;
+    if (s->step_index >= s->emotion->step_cnt) {
+        emoji_sched_finish(s);
+    } else {
+        emoji_sched_post(s, 0);
+    }
+}
+
+// 被抢占: 跳过剩余的段直接播放退出段，没有退出段的表情立即结束
+static void emoji_sched_preempt(emoji_sched_t* s) {
+    uint8_t out = s->emotion->step_cnt - 1;
+    emoji_sched_stats.preempted++;
+    s->exiting = true;
+    // 第一段还没被LVGL任务取走，什么都没显示，直接结束
+    bool started = s->step_index > 0 || emoji_clip_gen == s->gen;
+    if (out == 0 || !started || (s->step_index == out && s->holding)) {
+        emoji_sched_finish(s);
+    } else if (s->step_index < out) {
+        s->step_index = out;
+        emoji_sched_post(s, 0);
+    }
+    // 已经在播放退出段，等它播完
+}
+
+static void emoji_sched_request(emoji_sched_t* s, const emoji_cmd_t* cmd) {
+    const emoji_emotion_t* emotion = &emoji_emotions[cmd->emotion];
+    emoji_sched_stats.received++;
+    if (s->emotion == NULL) {
+        emoji_sched_start(s, emotion, cmd->time_us);
+    } else if ((emotion == s->emotion && !s->exiting) || emotion == s->pending) {
+        // 重复的请求合并
+        emoji_sched_stats.coalesced++;
+    } else if (emotion->priority < s->emotion->priority ||
+               (s->pending && emotion->priority < s->pending->priority)) {
+        emoji_sched_stats.dropped++;
+    } else {
+        if (s->pending) {
+            emoji_sched_stats.coalesced++;
+        }
+        s->pending = emotion;
+        s->pending_time_us = cmd->time_us;
+        if (!s->exiting) {
+            emoji_sched_preempt(s);
+        }
+    }
+}
+
+// 表情调度任务: 处理命令、抢占、合并和段间停留，只通过队列与LVGL任务交互
+static void emoji_sched_task(void* arg) {
+    emoji_sched_t s = {0};
+    emoji_cmd_t cmd;
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (s.holding) {
+            TickType_t left = s.hold_until - xTaskGetTickCount();
+            wait = (int32_t)left > 0 ? left : 0;
+        }
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, wait);
+
+        // 当前片段播放完毕，停留或进入下一段
+        if ((bits & EMOJI_NOTIFY_DONE) && s.emotion && !s.holding && emoji_done_gen == s.gen) {
+            uint32_t hold_ms = s.emotion->steps[s.step_index].hold_ms;
+            if (hold_ms > 0) {
+                s.holding = true;
+                s.hold_until = xTaskGetTickCount() + pdMS_TO_TICKS(hold_ms);
+            } else {
+                emoji_sched_next(&s);
+            }
+        }
+        while (xQueueReceive(emoji_cmd_queue, &cmd, 0) == pdTRUE) {
+            emoji_sched_request(&s, &cmd);
+        }
+        if (s.holding && (int32_t)(xTaskGetTickCount() - s.hold_until) >= 0) {
+            emoji_sched_next(&s);
+        }
+    }
+}
+
+// 计算所有表情中最大片段需要的解码内存
+static uint32_t emoji_pool_size(void) {
+    uint32_t max_size = 0;
+    char path[48];
+    for (int i = 0; i < emoji_emotion_cnt; i++) {
+        for (int j = 0; j < emoji_emotions[i].step_cnt; j++) {
+            const char* clip = emoji_emotions[i].steps[j].clip;
+            uint32_t data_size = 0;
+            const void* data = emoji_clip_asset(clip, &data_size);
+            snprintf(path, sizeof(path), EMOJI_CLIP_PATH, clip);
+#if EMOJI_USE_FRAME_PACK
+            uint32_t size = data ? emoji_pack_probe_data(data, data_size) : emoji_pack_probe(path);
+#else
+            uint32_t size = data ? emoji_gif_probe_data(data, LV_COLOR_FORMAT_RGB565_SWAPPED)
+                                 : emoji_gif_probe_file(path, LV_COLOR_FORMAT_RGB565_SWAPPED);
+#endif
+            if (size == 0) {
+                ESP_LOGW(TAG, "emotion %s: missing clip %s", emoji_emotions[i].name, path);
+            }
+            if (size > max_size) {
+                max_size = size;
+            }
+        }
+    }
+    return max_size;
+}
+
+// 每个显示创建一个播放对象，并按最大片段预分配解码内存
+static bool emoji_player_init(void) {
     lv_lock();
-    emoji_gif = lv_gif_create(lv_screen_active());
-    lv_gif_set_src(emoji_gif, gif_seq->seq_path[gif_seq->seq_index]);
-    lv_gif_set_loop_count(emoji_gif, 1); // 设置只播放一次
-    lv_obj_center(emoji_gif);
+    uint32_t pool_size = emoji_pool_size();
+    if (pool_size == 0) {
+        lv_unlock();
+        ESP_LOGE(TAG, "no emoji clip found");
+        return false;
+    }
+    uint32_t eye_cnt = MIN(lvgl_port_get_display_count(), EMOJI_EYE_MAX);
+    for (uint32_t i = 0; i < eye_cnt; i++) {
+        emoji_pools[i] = malloc(pool_size);
+        if (emoji_pools[i] == NULL) {
+            lv_unlock();
+            ESP_LOGE(TAG, "alloc emoji pool %" PRIu32 " fail, size: %" PRIu32, i, pool_size);
+            return false;
+        }
+        lv_obj_t* screen = lv_display_get_screen_active(lvgl_port_get_display(i));
+#if EMOJI_USE_FRAME_PACK
+        emoji_gifs[i] = emoji_pack_create(screen);
+        emoji_pack_set_buffer(emoji_gifs[i], emoji_pools[i], pool_size);
+#else
+        emoji_gifs[i] = emoji_gif_create(screen);
+        // 屏幕按SPI字节序渲染(RGB565_SWAPPED)，画布用同样的格式，绘制时直接拷贝
+        emoji_gif_set_color_format(emoji_gifs[i], LV_COLOR_FORMAT_RGB565_SWAPPED);
+        emoji_gif_set_buffer(emoji_gifs[i], emoji_pools[i], pool_size);
+#endif
+        lv_obj_center(emoji_gifs[i]);
+        // 多个绘制单元时表情图像分条绘制，两个核同时画
+        lvgl_port_split_draw(emoji_gifs[i]);
+    }
+    emoji_eye_cnt = eye_cnt;
+    lv_obj_add_event_cb(emoji_gifs[0], gif_playback_complete_cb, LV_EVENT_READY, NULL);
     lv_unlock();
-    lv_obj_add_event_cb(emoji_gif, gif_playback_complete_cb, LV_EVENT_ALL, gif_seq);
+    ESP_LOGI(TAG, "emoji pool: %" PRIu32 " x %" PRIu32 " bytes", eye_cnt, pool_size);
+    return true;
 }
 
-gif_seq_t* create_gif_seq(char* seq_path[]) {
-    if (seq_path == NULL || seq_path[0] == NULL) {
-        ESP_LOGW(TAG, "No emoji sequence set");
-        return NULL;
+// 创建表情调度任务和它的队列
+static bool emoji_sched_init(void) {
+    emoji_cmd_queue = xQueueCreate(EMOJI_CMD_QUEUE_LEN, sizeof(emoji_cmd_t));
+    emoji_clip_mailbox = xQueueCreate(1, sizeof(emoji_clip_req_t));
+    if (emoji_cmd_queue == NULL || emoji_clip_mailbox == NULL) {
+        ESP_LOGE(TAG, "create emoji queue fail...");
+        return false;
+    }
+    // 邮箱建好后才让LVGL任务在唤醒时去取片段请求
+    lvgl_port_set_wake_cb(emoji_poll);
+    if (xTaskCreate(emoji_sched_task, "emoji_sched", EMOJI_SCHED_TASK_STACK_SIZE, NULL,
+                    EMOJI_SCHED_TASK_PRIORITY, &emoji_sched_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "create emoji sched task fail...");
+        return false;
+    }
+    return true;
+}
+
+void emoji_play_by_name(const char* name) {
+    if (emoji_sched_task_handle == NULL) {
+        ESP_LOGW(TAG, "emoji player not initialized");
+        return;
+    }
+    const emoji_emotion_t* emotion = emoji_find_emotion(name);
+    if (emotion == NULL) {
+        ESP_LOGW(TAG, "Unsupported emotion: %s", name);
+        return;
     }
-    gif_seq_t* gif_seq = malloc(sizeof(gif_seq_t));
-    gif_seq->seq_path = seq_path;
-    gif_seq->seq_index = 0;
-    return gif_seq;
+    // 只投递命令，不等待也不拿lv_lock，任何任务都可以调用
+    emoji_cmd_t cmd = {
+        .emotion = emotion - emoji_emotions,
+        .time_us = esp_timer_get_time(),
+    };
+    // 队列满时丢掉最旧的命令，保证最新的请求一定送达
+    while (xQueueSend(emoji_cmd_queue, &cmd, 0) != pdTRUE) {
+        emoji_cmd_t oldest;
+        if (xQueueReceive(emoji_cmd_queue, &oldest, 0) == pdTRUE) {
+            atomic_fetch_add_explicit(&emoji_cmd_overflow, 1, memory_order_relaxed);
+        }
+    }
+    xTaskNotify(emoji_sched_task_handle, EMOJI_NOTIFY_CMD, eSetBits);
 }
 
 void emoji_play(EMOTE_TYPE type) {
-    // 每次来新表情，删除掉之前的表情
-    lv_obj_clean(lv_scr_act());
-    switch (type) {
-        case EMOTE_NORMAL:
-            play_gif_seq(create_gif_seq(EMOJI_NORMAL_SEQ_PATH));
-            break;
-        case EMOTE_DOUBT:
-            play_gif_seq(create_gif_seq(EMOJI_DOUBT_SEQ_PATH));
-            break;
-        case EMOTE_THINK:
-            play_gif_seq(create_gif_seq(EMOJI_THINK_SEQ_PATH));  
-            break;
-        case EMOTE_PERCEPT:
-            play_gif_seq(create_gif_seq(EMOJI_PERCEPT_SEQ_PATH));
-            break;
-        case EMOTE_PANIC:
-            play_gif_seq(create_gif_seq(EMOJI_PANIC_SEQ_PATH));
-            break;
-        case EMOTE_DISDAIN:
-            play_gif_seq(create_gif_seq(EMOJI_DISDAIN_SEQ_PATH));
-            break;
-        case EMOTE_ANGRY:
-            play_gif_seq(create_gif_seq(EMOJI_ANGRY_SEQ_PATH));
-            break;
-        case EMOTE_EXCITE:
-            play_gif_seq(create_gif_seq(EMOJI_EXCITE_SEQ_PATH));
-            break;
-        case EMOTE_SAD:
-            play_gif_seq(create_gif_seq(EMOJI_SAD_SEQ_PATH));
-            break;
-        default:
-            ESP_LOGW(TAG, "Unsupported emotion type");
-            break;
+    if (type >= sizeof(EMOTE_NAMES) / sizeof(EMOTE_NAMES[0]) || EMOTE_NAMES[type] == NULL) {
+        ESP_LOGW(TAG, "Unsupported emotion type");
+        return;
     }
+    emoji_play_by_name(EMOTE_NAMES[type]);
 }
 
 void emoji_timer_callback(TimerHandle_t xTimer) {
@@ -191,8 +599,11 @@ void emoji_timer_callback(TimerHandle_t xTimer) {
 }
 
 // 表情初始化，默认一段时间，眨一下眼
-// !!! 一定要在menuconfig中配置 TIMER_TASK_STACK_DEPTH >= 4096 防止堆栈溢出
 void emoji_init(void) {
+    emoji_manifest_load(EMOJI_MANIFEST_PATH);
+    if (!emoji_player_init() || !emoji_sched_init()) {
+        return;
+    }
     // 创建定时器
     emoji_timer = xTimerCreate(
         "EmojiTimer",           // 定时器名称
@@ -7,4 +7,7 @@ void emoji_init(void);
 
 void emoji_play(EMOTE_TYPE type);
 
+// 按清单中的表情名播放，用于清单里新增的表情
+void emoji_play_by_name(const char* name);
+
 #endif
\ No newline at end of file
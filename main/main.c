@@ -7,6 +7,9 @@
 #include "lvgl_api.h"
 #include "http_api.h"
 #include "audio_api.h"
+#include "audio_stream.h"
+#include "audio_mixer.h"
+#include "asset_map.h"
 #include "d_lcd.h"
 #include "d_servo.h"
 #include "d_wifi.h"
@@ -29,7 +32,7 @@ void spiffs_init() {
     ESP_ERROR_CHECK(esp_vfs_spiffs_register(&conf));
     size_t total = 0, used = 0;
     if (esp_spiffs_info("storage", &total, &used) == ESP_OK) {
-        ESP_LOGI(TAG, "SPIFFS total: %dKB, used: %dKB", total/1024, used/1024);
+        ESP_LOGI(TAG, "SPIFFS total: %zuKB, used: %zuKB", total/1024, used/1024);
     }
     ESP_LOGI(TAG, "SPIFFS initialized successfully");
 }
@@ -52,6 +55,8 @@ void app_main(void) {
     nvs_init();
     // 初始化spiffs
     spiffs_init();
+    // 映射资源分区，未烧录时表情和音频从spiffs读取
+    asset_map_init();
     // 初始化http
     http_init();
     // 初始化显示相关
@@ -64,6 +69,12 @@ void app_main(void) {
     // set_servo_angle(0);
     // 扬声器初始化
     speak_init();
+    // 混音任务，各声部(音频流、音效、背景循环)混合后写入扬声器
+    audio_mixer_init();
+    // 音频流播放任务，/ws 收到的音频经它写入混音器
+    audio_stream_init();
+    // 本地播放任务，audio_play_start 开始的播放经它写入混音器
+    audio_play_init();
     // audio_play_local("/spiffs/audio/output.pcm");
 
     ESP_LOGI(TAG, "Robot Cilow started successfully");
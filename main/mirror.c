@@ -0,0 +1,373 @@
+#include "mirror.h"
+#include "config.h"
+#include "http_api.h"
+#include "d_lcd.h"
+#include "src/libs/lz4/lz4.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <inttypes.h>
+#include <string.h>
+#include <sys/param.h>
+
+static const char *TAG = "mirror";
+
+// 按20行分带记录变化区域，与 d_lcd.c 部分渲染缓冲的行数相同，整屏最多12个区域
+#define MIRROR_BAND_LINES     20
+#define MIRROR_BANDS          ((LCD_V_RES + MIRROR_BAND_LINES - 1) / MIRROR_BAND_LINES)
+#define MIRROR_BLOCK_PX       (LCD_H_RES * MIRROR_BAND_LINES)
+#define MIRROR_TX_SIZE        (sizeof(mirror_frame_header_t) + \
+                               MIRROR_BANDS * (sizeof(mirror_rect_header_t) + MIRROR_BLOCK_PX * 2))
+#define MIRROR_TASK_STACK     4096
+#define MIRROR_TASK_PRIORITY  1
+
+// 捕获块: LVGL任务拷贝一块刷新区域，编码任务合并到影子帧缓冲后归还
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    uint8_t px[MIRROR_BLOCK_PX * 2];
+} mirror_block_t;
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+} mirror_tx_t;
+
+// 行带中变化的矩形，只在编码任务中访问
+typedef struct {
+    bool dirty;
+    int16_t x1;
+    int16_t x2;
+    int16_t y1;
+    int16_t y2;
+} mirror_band_t;
+
+static volatile bool mirror_on = false;
+static volatile bool mirror_resync = false;
+static volatile mirror_codec_t mirror_codec = MIRROR_CODEC_LZ4;
+static volatile uint32_t mirror_period_us = 1000000 / MIRROR_MAX_FPS;
+
+static QueueHandle_t mirror_free_q;      // 空闲的捕获块
+static QueueHandle_t mirror_ready_q;     // 已捕获的块，NULL为一次刷新结束
+static QueueHandle_t mirror_tx_free_q;   // 空闲的发送缓冲
+static QueueHandle_t mirror_tx_q;        // 待发送的帧
+static uint8_t *mirror_shadow;           // 影子帧缓冲，镜像端看到的画面
+static uint8_t *mirror_scratch;          // 一个区域的连续像素，编码的输入
+static void *mirror_lz4_state;
+static mirror_band_t mirror_bands[MIRROR_BANDS];
+
+// 统计，停止时打印
+static uint32_t mirror_seq;
+static uint32_t mirror_skipped;
+static uint32_t mirror_lost;
+static uint64_t mirror_raw_bytes;
+static uint64_t mirror_sent_bytes;
+
+/* 优先内部RAM，不够再用PSRAM */
+static void *mirror_alloc(size_t size, bool prefer_internal) {
+    void *p = NULL;
+    if (prefer_internal) {
+        p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (p == NULL) {
+        p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (p == NULL) {
+        p = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+    }
+    return p;
+}
+
+void mirror_capture(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *px, uint32_t wait_ms) {
+    if (!mirror_on) {
+        return;
+    }
+    // 一个捕获块放不下时按行拆开
+    int32_t lines = MIRROR_BLOCK_PX / w;
+    for (int32_t i = 0; i < h; i += lines) {
+        mirror_block_t *blk;
+        if (xQueueReceive(mirror_free_q, &blk, pdMS_TO_TICKS(wait_ms)) != pdTRUE) {
+            mirror_lost++;
+            if (!mirror_resync) {
+                mirror_resync = true;
+                lvgl_port_redraw();
+            }
+            return;
+        }
+        blk->x = x;
+        blk->y = y + i;
+        blk->w = w;
+        blk->h = MIN(lines, h - i);
+        memcpy(blk->px, px + i * w * 2, blk->w * blk->h * 2);
+        xQueueSend(mirror_ready_q, &blk, 0);
+    }
+}
+
+void mirror_frame_done(void) {
+    if (mirror_on) {
+        mirror_block_t *marker = NULL;
+        xQueueSend(mirror_ready_q, &marker, 0);
+    }
+}
+
+/* 把捕获块写进影子帧缓冲，并扩大所在行带的变化矩形 */
+static void mirror_apply(const mirror_block_t *blk) {
+    for (int32_t i = 0; i < blk->h; i++) {
+        memcpy(mirror_shadow + ((blk->y + i) * LCD_H_RES + blk->x) * 2, blk->px + i * blk->w * 2, blk->w * 2);
+    }
+    for (int32_t y = blk->y; y < blk->y + blk->h; y = (y / MIRROR_BAND_LINES + 1) * MIRROR_BAND_LINES) {
+        mirror_band_t *band = &mirror_bands[y / MIRROR_BAND_LINES];
+        int16_t y2 = MIN(blk->y + blk->h, (y / MIRROR_BAND_LINES + 1) * MIRROR_BAND_LINES) - 1;
+        if (!band->dirty) {
+            *band = (mirror_band_t){true, blk->x, blk->x + blk->w - 1, y, y2};
+        } else {
+            band->x1 = MIN(band->x1, blk->x);
+            band->x2 = MAX(band->x2, blk->x + blk->w - 1);
+            band->y1 = MIN(band->y1, y);
+            band->y2 = MAX(band->y2, y2);
+        }
+    }
+}
+
+static bool mirror_dirty(void) {
+    for (int i = 0; i < MIRROR_BANDS; i++) {
+        if (mirror_bands[i].dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 按 lv_rle 的格式编码16位像素: 控制字节最高位为1时后面跟 (低7位) 个原样的像素，
+ * 否则后面的一个像素重复 (控制字节) 次
+ * @return 编码后的字节数，超过 size 返回0
+ */
+static uint32_t mirror_rle_encode(const uint16_t *src, uint32_t n, uint8_t *dst, uint32_t size) {
+    uint32_t out = 0;
+    uint32_t i = 0;
+    while (i < n) {
+        uint32_t run = 1;
+        while (i + run < n && run < 127 && src[i + run] == src[i]) {
+            run++;
+        }
+        if (run > 1) {
+            if (out + 3 > size) {
+                return 0;
+            }
+            dst[out++] = run;
+            memcpy(dst + out, &src[i], 2);
+            out += 2;
+            i += run;
+            continue;
+        }
+        // 原样输出到下一段重复之前
+        uint32_t cnt = 1;
+        while (i + cnt < n && cnt < 127 && !(i + cnt + 1 < n && src[i + cnt] == src[i + cnt + 1])) {
+            cnt++;
+        }
+        if (out + 1 + cnt * 2 > size) {
+            return 0;
+        }
+        dst[out++] = 0x80 | cnt;
+        memcpy(dst + out, &src[i], cnt * 2);
+        out += cnt * 2;
+        i += cnt;
+    }
+    return out;
+}
+
+/* 把所有变化的行带编码成一帧，返回帧的字节数 */
+static size_t mirror_encode(uint8_t *tx, uint16_t flags) {
+    mirror_codec_t codec = mirror_codec;
+    size_t len = sizeof(mirror_frame_header_t);
+    uint16_t rect_cnt = 0;
+    for (int b = 0; b < MIRROR_BANDS; b++) {
+        mirror_band_t *band = &mirror_bands[b];
+        if (!band->dirty) {
+            continue;
+        }
+        band->dirty = false;
+        uint32_t w = band->x2 - band->x1 + 1;
+        uint32_t h = band->y2 - band->y1 + 1;
+        uint32_t raw = w * h * 2;
+        for (uint32_t i = 0; i < h; i++) {
+            memcpy(mirror_scratch + i * w * 2, mirror_shadow + ((band->y1 + i) * LCD_H_RES + band->x1) * 2, w * 2);
+        }
+        mirror_rect_header_t rect = {
+            .x = band->x1,
+            .y = band->y1,
+            .w = w,
+            .h = h,
+            .codec = codec,
+        };
+        uint8_t *out = tx + len + sizeof(rect);
+        if (codec == MIRROR_CODEC_LZ4) {
+            rect.size = LZ4_compress_fast_extState(mirror_lz4_state, (const char *)mirror_scratch, (char *)out, raw, raw, 1);
+        } else if (codec == MIRROR_CODEC_RLE) {
+            rect.size = mirror_rle_encode((const uint16_t *)mirror_scratch, w * h, out, raw);
+        }
+        if (rect.size == 0 || codec == MIRROR_CODEC_RAW) {
+            rect.codec = MIRROR_CODEC_RAW;
+            rect.size = raw;
+            memcpy(out, mirror_scratch, raw);
+        }
+        // 区域头不一定4字节对齐，拷贝写入
+        memcpy(tx + len, &rect, sizeof(rect));
+        len += sizeof(rect) + rect.size;
+        rect_cnt++;
+        mirror_raw_bytes += raw;
+    }
+    mirror_frame_header_t header = {
+        .magic = MIRROR_MAGIC,
+        .seq = mirror_seq++,
+        .time_ms = esp_timer_get_time() / 1000,
+        .rect_cnt = rect_cnt,
+        .flags = flags,
+        .skipped = mirror_skipped,
+        .lost = mirror_lost,
+    };
+    memcpy(tx, &header, sizeof(header));
+    mirror_sent_bytes += len;
+    return len;
+}
+
+/**
+ * 编码任务: 合并捕获块，刷新结束且到了发送时间后编码变化的行带。
+ * 发送缓冲都在发送中(连接积压)时不编码，变化留到下次合并发送
+ */
+static void mirror_encode_task(void *arg) {
+    int64_t next_us = 0;
+    bool frame_done = false;
+    uint16_t flags = 0;
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (frame_done && mirror_dirty()) {
+            int64_t now = esp_timer_get_time();
+            wait = now >= next_us ? 0 : pdMS_TO_TICKS((next_us - now + 999) / 1000);
+        }
+        mirror_block_t *blk;
+        if (xQueueReceive(mirror_ready_q, &blk, wait) == pdTRUE) {
+            if (blk) {
+                mirror_apply(blk);
+                xQueueSend(mirror_free_q, &blk, 0);
+                frame_done = false;
+            } else {
+                frame_done = true;
+            }
+            continue;
+        }
+        next_us = esp_timer_get_time() + mirror_period_us;
+        if (!mirror_on) {
+            memset(mirror_bands, 0, sizeof(mirror_bands));
+            flags = 0;
+            continue;
+        }
+        // 丢失区域后的整屏重画已经请求，下一帧标记出来
+        if (mirror_resync) {
+            mirror_resync = false;
+            flags |= MIRROR_FLAG_RESYNC;
+        }
+        if (!frame_done || !mirror_dirty()) {
+            continue;
+        }
+        uint8_t *buf;
+        if (xQueueReceive(mirror_tx_free_q, &buf, 0) != pdTRUE) {
+            mirror_skipped++;
+            continue;
+        }
+        mirror_tx_t tx = {buf, mirror_encode(buf, flags)};
+        flags = 0;
+        xQueueSend(mirror_tx_q, &tx, 0);
+    }
+}
+
+/* 发送任务: 阻塞在套接字上的只有这个任务 */
+static void mirror_send_task(void *arg) {
+    mirror_tx_t tx;
+    while (1) {
+        xQueueReceive(mirror_tx_q, &tx, portMAX_DELAY);
+        if (mirror_on && http_ws_send_bin(tx.buf, tx.len) != ESP_OK) {
+            ESP_LOGW(TAG, "send fail, stop mirror");
+            mirror_stop();
+        }
+        xQueueSend(mirror_tx_free_q, &tx.buf, 0);
+    }
+}
+
+/* 第一次开启时分配缓冲池和任务，之后一直保留 */
+static esp_err_t mirror_init(void) {
+    mirror_shadow = heap_caps_calloc(1, LCD_H_RES * LCD_V_RES * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (mirror_shadow == NULL) {
+        mirror_shadow = heap_caps_calloc(1, LCD_H_RES * LCD_V_RES * 2, MALLOC_CAP_DEFAULT);
+    }
+    mirror_scratch = mirror_alloc(MIRROR_BLOCK_PX * 2, true);
+    mirror_lz4_state = mirror_alloc(LZ4_sizeofState(), true);
+    mirror_free_q = xQueueCreate(MIRROR_POOL_BLOCKS, sizeof(mirror_block_t *));
+    mirror_ready_q = xQueueCreate(MIRROR_POOL_BLOCKS + 4, sizeof(mirror_block_t *));
+    mirror_tx_free_q = xQueueCreate(MIRROR_TX_BUFS, sizeof(uint8_t *));
+    mirror_tx_q = xQueueCreate(MIRROR_TX_BUFS, sizeof(mirror_tx_t));
+    if (!mirror_shadow || !mirror_scratch || !mirror_lz4_state || !mirror_free_q || !mirror_ready_q ||
+        !mirror_tx_free_q || !mirror_tx_q) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < MIRROR_POOL_BLOCKS; i++) {
+        mirror_block_t *blk = mirror_alloc(sizeof(mirror_block_t), true);
+        if (blk == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        xQueueSend(mirror_free_q, &blk, 0);
+    }
+    for (int i = 0; i < MIRROR_TX_BUFS; i++) {
+        uint8_t *buf = mirror_alloc(MIRROR_TX_SIZE, false);
+        if (buf == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        xQueueSend(mirror_tx_free_q, &buf, 0);
+    }
+    if (xTaskCreatePinnedToCore(mirror_encode_task, "mirror_enc", MIRROR_TASK_STACK, NULL, MIRROR_TASK_PRIORITY,
+                                NULL, MIRROR_TASK_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(mirror_send_task, "mirror_tx", MIRROR_TASK_STACK, NULL, MIRROR_TASK_PRIORITY,
+                                NULL, MIRROR_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mirror_start(mirror_codec_t codec, uint32_t fps) {
+    static bool inited = false;
+    if (!inited) {
+        esp_err_t err = mirror_init();
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "init fail: %s", esp_err_to_name(err));
+            return err;
+        }
+        inited = true;
+    }
+    mirror_codec = codec;
+    mirror_period_us = 1000000 / MIN(MAX(fps, 1), MIRROR_MAX_FPS);
+    mirror_seq = 0;
+    mirror_skipped = 0;
+    mirror_lost = 0;
+    mirror_raw_bytes = 0;
+    mirror_sent_bytes = 0;
+    mirror_resync = true;
+    mirror_on = true;
+    lvgl_port_redraw();
+    ESP_LOGI(TAG, "start, codec: %d, period: %" PRIu32 " ms", codec, mirror_period_us / 1000);
+    return ESP_OK;
+}
+
+void mirror_stop(void) {
+    if (!mirror_on) {
+        return;
+    }
+    mirror_on = false;
+    ESP_LOGI(TAG, "stop, frames: %" PRIu32 ", sent: %" PRIu32 " KB (raw %" PRIu32 " KB), skipped: %" PRIu32 ", lost: %" PRIu32, mirror_seq,
+             (uint32_t)(mirror_sent_bytes / 1024), (uint32_t)(mirror_raw_bytes / 1024), mirror_skipped, mirror_lost);
+}
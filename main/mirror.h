@@ -0,0 +1,67 @@
+#ifndef __MIRROR_H__
+#define __MIRROR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// 镜像帧魔数
+#define MIRROR_MAGIC          "MIR1"
+// 帧头标志: 刚开始镜像或有刷新区域因捕获缓冲用完丢失，已请求整屏重画，重画到达前画面不完整
+#define MIRROR_FLAG_RESYNC    0x0001
+
+// 区域数据的编码
+typedef enum {
+    MIRROR_CODEC_RAW = 0,        // 原始像素
+    MIRROR_CODEC_RLE = 1,        // LVGL lv_rle 格式，块大小2字节(lv_rle_decompress(..., 2) 解码)
+    MIRROR_CODEC_LZ4 = 2,        // LZ4 块格式(LZ4_decompress_safe 解码)
+} mirror_codec_t;
+
+// 镜像帧，/ws 上的一个二进制消息(小端): 帧头 + rect_cnt 个(区域头 + size字节数据)，
+// 区域头不按4字节对齐。像素为RGB565高字节在前(与屏幕相同)，按行连续存放
+typedef struct {
+    char     magic[4];
+    uint32_t seq;                // 帧序号
+    uint32_t time_ms;
+    uint16_t rect_cnt;
+    uint16_t flags;
+    uint32_t skipped;            // 累计因发送积压合并掉的次数
+    uint32_t lost;               // 累计因捕获缓冲用完丢失的刷新区域数
+} mirror_frame_header_t;
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint8_t  codec;              // mirror_codec_t，压缩后不比原始数据小时为RAW
+    uint8_t  reserved[3];
+    uint32_t size;               // 数据字节数
+} mirror_rect_header_t;
+
+/**
+ * 开始向当前 /ws 客户端发送屏幕镜像，第一次调用时分配缓冲和任务。
+ * 开始后请求整屏重画(屏幕空闲时也会重画一次)，之后只发送变化的区域
+ * @param codec 区域编码
+ * @param fps   最高帧率，发送积压时多帧合并为一帧
+ */
+esp_err_t mirror_start(mirror_codec_t codec, uint32_t fps);
+
+/**
+ * 停止发送镜像
+ */
+void mirror_stop(void);
+
+/**
+ * 捕获一块发送到屏幕的像素(LVGL任务中调用)，未开启镜像时直接返回。
+ * 只拷贝到捕获缓冲，缓冲用完时最多等待 wait_ms 毫秒，仍没有则丢弃并请求整屏重画。
+ * 正常刷新有SPI传输的节拍，传0不阻塞; 屏幕空闲时的重画不经过SPI，需要等编码任务归还缓冲
+ */
+void mirror_capture(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *px, uint32_t wait_ms);
+
+/**
+ * 一次刷新的所有区域都已捕获(LVGL任务中调用)，镜像只在刷新结束后发送，不会发出画了一半的帧
+ */
+void mirror_frame_done(void);
+
+#endif
@@ -0,0 +1,100 @@
+#include "telemetry.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/param.h>
+
+// 多个生产者(LVGL任务、绘制线程、SPI传输完成中断)各自用原子加法占一个槽位，
+// 槽位的序号最后写入，读取时序号前后一致才算有效，写入中途的槽位序号为0
+typedef struct {
+    atomic_uint seq;
+    uint32_t time_us;
+    uint32_t type_dur;
+    uint32_t aux;
+} telemetry_slot_t;
+
+typedef struct {
+    atomic_uint count;
+    atomic_uint sum_us;
+    atomic_uint max_us;
+    atomic_uint hist[TELEMETRY_HIST_BUCKETS];
+} telemetry_counter_t;
+
+static telemetry_slot_t telemetry_ring[TELEMETRY_RING_LEN];
+static atomic_uint telemetry_head;       // 已分配的事件数，也是最新事件的序号
+static telemetry_counter_t telemetry_counters[TELEMETRY_TYPE_CNT];
+
+static uint32_t telemetry_bucket(uint32_t us) {
+    uint32_t n = us / TELEMETRY_HIST_MIN_US;
+    uint32_t i = n ? 32 - __builtin_clz(n) : 0;
+    return i < TELEMETRY_HIST_BUCKETS ? i : TELEMETRY_HIST_BUCKETS - 1;
+}
+
+void telemetry_record(telemetry_type_t type, int64_t start_us, int64_t end_us, uint32_t aux) {
+    uint32_t us = end_us > start_us ? (uint32_t)MIN(end_us - start_us, 0x0fffffff) : 0;
+    telemetry_counter_t *c = &telemetry_counters[type];
+    atomic_fetch_add_explicit(&c->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->sum_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->hist[telemetry_bucket(us)], 1, memory_order_relaxed);
+    uint32_t max = atomic_load_explicit(&c->max_us, memory_order_relaxed);
+    while (us > max && !atomic_compare_exchange_weak_explicit(&c->max_us, &max, us, memory_order_relaxed,
+                                                              memory_order_relaxed)) {
+    }
+
+    uint32_t seq = atomic_fetch_add_explicit(&telemetry_head, 1, memory_order_relaxed) + 1;
+    telemetry_slot_t *slot = &telemetry_ring[(seq - 1) % TELEMETRY_RING_LEN];
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->time_us = (uint32_t)end_us;
+    slot->type_dur = (uint32_t)type << 28 | us;
+    slot->aux = aux;
+    atomic_store_explicit(&slot->seq, seq, memory_order_release);
+}
+
+size_t telemetry_snapshot(telemetry_snapshot_t *snap, uint32_t since, bool reset_max) {
+    memcpy(snap->magic, TELEMETRY_MAGIC, 4);
+    snap->time_us = (uint32_t)esp_timer_get_time();
+    snap->dropped = 0;
+    snap->event_cnt = 0;
+    for (int i = 0; i < TELEMETRY_TYPE_CNT; i++) {
+        telemetry_counter_t *c = &telemetry_counters[i];
+        telemetry_hist_t *h = &snap->hist[i];
+        h->count = atomic_load_explicit(&c->count, memory_order_relaxed);
+        h->sum_us = atomic_load_explicit(&c->sum_us, memory_order_relaxed);
+        h->max_us = reset_max ? atomic_exchange_explicit(&c->max_us, 0, memory_order_relaxed)
+                              : atomic_load_explicit(&c->max_us, memory_order_relaxed);
+        for (int j = 0; j < TELEMETRY_HIST_BUCKETS; j++) {
+            h->hist[j] = atomic_load_explicit(&c->hist[j], memory_order_relaxed);
+        }
+    }
+
+    uint32_t head = atomic_load_explicit(&telemetry_head, memory_order_acquire);
+    uint32_t oldest = head > TELEMETRY_RING_LEN ? head - TELEMETRY_RING_LEN + 1 : 1;
+    // 序号用差值比较，回绕后也正确
+    if (since == 0 || (int32_t)(since - oldest) < 0) {
+        snap->dropped = since ? oldest - since : 0;
+        since = oldest;
+    } else if ((int32_t)(since - head) > 1) {
+        since = head + 1;
+    }
+    uint32_t seq = since;
+    for (; (int32_t)(head - seq) >= 0; seq++) {
+        telemetry_slot_t *slot = &telemetry_ring[(seq - 1) % TELEMETRY_RING_LEN];
+        uint32_t s1 = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        telemetry_event_t e = {.seq = seq, .time_us = slot->time_us, .type_dur = slot->type_dur, .aux = slot->aux};
+        atomic_thread_fence(memory_order_acquire);
+        uint32_t s2 = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (s1 == seq && s2 == seq) {
+            snap->events[snap->event_cnt++] = e;
+            continue;
+        }
+        // 槽位已被更新的事件覆盖则跳过，否则是还没写完的事件，留到下次查询
+        uint32_t now_head = atomic_load_explicit(&telemetry_head, memory_order_relaxed);
+        if ((int32_t)(now_head - seq) < TELEMETRY_RING_LEN) {
+            break;
+        }
+        snap->dropped++;
+    }
+    snap->next_seq = seq;
+    return offsetof(telemetry_snapshot_t, events) + snap->event_cnt * sizeof(telemetry_event_t);
+}
@@ -0,0 +1,70 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 二进制快照魔数
+#define TELEMETRY_MAGIC         "TLM1"
+// 环形缓冲保留的最近事件数
+#define TELEMETRY_RING_LEN      256
+// 耗时直方图: <128us, <256us, ... <128ms, >=128ms
+#define TELEMETRY_HIST_BUCKETS  12
+#define TELEMETRY_HIST_MIN_US   128
+
+// 事件类型
+typedef enum {
+    TELEMETRY_LVGL = 0,          // LVGL任务一次 lv_timer_handler，aux为到下一个定时器的毫秒数
+    TELEMETRY_REFR,              // 一次有内容发送的刷新(渲染+flush)，aux为其中等待DMA的微秒数
+    TELEMETRY_FLUSH,             // 一次SPI DMA传输，aux为字节数
+    TELEMETRY_FRAME,             // 表情定时器切换一帧(解码或拷贝+失效)，aux为变化的像素数
+    TELEMETRY_TYPE_CNT,
+} telemetry_type_t;
+
+// 环形缓冲中的一个事件
+typedef struct {
+    uint32_t seq;                // 事件序号，从1开始
+    uint32_t time_us;            // 结束时间(esp_timer_get_time 的低32位)
+    uint32_t type_dur;           // 高4位为类型，低28位为耗时(微秒)
+    uint32_t aux;
+} telemetry_event_t;
+
+#define TELEMETRY_EVENT_TYPE(e) ((e)->type_dur >> 28)
+#define TELEMETRY_EVENT_DUR(e)  ((e)->type_dur & 0x0fffffff)
+
+// 每种事件的统计。count/sum_us/hist 开机后一直累加(32位回绕)，两次查询相减得到期间的统计；
+// max_us 为开机或上次带 reset_max 的查询以来的最大值，普通查询不清零，几个客户端同时查询互不影响
+typedef struct {
+    uint32_t count;
+    uint32_t sum_us;
+    uint32_t max_us;
+    uint32_t hist[TELEMETRY_HIST_BUCKETS];
+} telemetry_hist_t;
+
+// 快照，同时也是 /ws 上的二进制格式(小端)，实际只发送前 event_cnt 个事件
+typedef struct {
+    char     magic[4];
+    uint32_t time_us;
+    uint32_t next_seq;           // 下一个事件的序号，下次查询时作为 since 传入
+    uint32_t dropped;            // since 之后已被覆盖、没有取到的事件数
+    uint32_t event_cnt;
+    telemetry_hist_t hist[TELEMETRY_TYPE_CNT];
+    telemetry_event_t events[TELEMETRY_RING_LEN];
+} telemetry_snapshot_t;
+
+/**
+ * 记录一个事件，无锁，可以在任意任务和中断中调用。开销为几次原子操作，不读时钟
+ * @param start_us 开始时间(esp_timer_get_time)
+ * @param end_us   结束时间
+ */
+void telemetry_record(telemetry_type_t type, int64_t start_us, int64_t end_us, uint32_t aux);
+
+/**
+ * 取统计和序号 since 之后的事件(0为缓冲中的全部)
+ * @param reset_max 取出后把各类型的 max_us 清零
+ * @return 快照按二进制格式发送的字节数
+ */
+size_t telemetry_snapshot(telemetry_snapshot_t *snap, uint32_t since, bool reset_max);
+
+#endif
@@ -0,0 +1,453 @@
+/**
+ * 资源镜像查找(asset_map.c)的主机端检查和计时
+ * 镜像由构建时的 asset_pack.py 打包(表情GIF、表情配置和 CMakeLists.txt 生成的边界情况资源)，检查:
+ *   查找:    每个输入文件都能按 "目录名/相对路径" 找到，大小和内容一致，size 传NULL时返回同一个指针
+ *   找不到:  空名字、排在所有名字前/后的名字、现有名字的前缀、加后缀、末字节加减1、超过名字长度的名字
+ *   截断:    镜像截到比完整镜像短的长度(拷贝到刚好大小的堆缓冲)时什么都找不到
+ *   损坏:    魔数错误、count 超出索引表、头部 size 比头部还小、索引项的数据超出镜像或偏移加大小溢出
+ *   分区:    asset_map_init 在分区不存在、镜像无效、镜像有效时的返回值，以及之后 asset_map_get 的结果
+ * 最后统计找到和找不到时每次查找的耗时。越界读取要在 sanitizer 构建中才能发现(见 CMakeLists.txt)。
+ * 用法: asset_bench [镜像文件，默认构建目录下的 assets.bin]
+ * 检查失败时返回1
+ */
+#include "asset_map.h"
+#include "esp_partition.h"
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define BENCH_MAX_FILES     128
+/* 计时的查找轮数，每轮查找全部名字 */
+#define LOOKUP_ROUNDS       20000
+/* 截断检查: 索引表之后的数据部分大约抽查这么多个长度 */
+#define TRUNCATE_SAMPLES    256
+
+typedef struct {
+    char name[ASSET_NAME_LEN];
+    void * data;
+    long size;
+} bench_file_t;
+
+static bench_file_t bench_files[BENCH_MAX_FILES];
+static int bench_file_cnt;
+static int fail;
+
+/* asset_map.c 用到的固件函数 */
+uint32_t esp_log_timestamp(void)
+{
+    return 0;
+}
+
+const char * esp_err_to_name(esp_err_t code)
+{
+    return code == ESP_OK ? "ESP_OK" : "ERROR";
+}
+
+/*=====================
+ * 分区替身: 内存里的一块镜像，映射直接返回它的地址
+ *====================*/
+static const uint8_t * part_data;
+static uint32_t part_size;
+static esp_partition_t part;
+static int part_mapped;
+
+const esp_partition_t * esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                 const char * label)
+{
+    if(part_data == NULL) return NULL;
+    part.type = type;
+    part.subtype = subtype;
+    part.size = part_size;
+    snprintf(part.label, sizeof(part.label), "%s", label ? label : "");
+    return &part;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t * partition, size_t src_offset, void * dst, size_t size)
+{
+    if(partition != &part || src_offset + size > part_size) return ESP_ERR_INVALID_ARG;
+    memcpy(dst, part_data + src_offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t * partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void ** out_ptr,
+                             esp_partition_mmap_handle_t * out_handle)
+{
+    (void)memory;
+    if(partition != &part || offset != 0 || size > part_size) return ESP_ERR_INVALID_ARG;
+    *out_ptr = part_data;
+    *out_handle = 1;
+    part_mapped++;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    (void)handle;
+    part_mapped--;
+}
+
+/*=====================
+ * 输入文件
+ *====================*/
+static void * load_file(const char * path, long * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    /* 空文件也返回非NULL */
+    void * data = malloc(*size ? *size : 1);
+    if(data && fread(data, 1, *size, f) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+/* 与 asset_pack.py 一样，资源名为 "输入目录名/相对路径" */
+static void scan_dir(const char * dir, const char * name)
+{
+    DIR * d = opendir(dir);
+    if(d == NULL) {
+        printf("%s: open failed\n", dir);
+        fail = 1;
+        return;
+    }
+    struct dirent * ent;
+    while((ent = readdir(d)) != NULL) {
+        if(ent->d_name[0] == '.') continue;
+        char path[512];
+        char sub[256];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        snprintf(sub, sizeof(sub), "%s/%s", name, ent->d_name);
+        if(stat(path, &st) != 0) continue;
+        if(S_ISDIR(st.st_mode)) {
+            scan_dir(path, sub);
+            continue;
+        }
+        if(strlen(sub) >= ASSET_NAME_LEN || bench_file_cnt >= BENCH_MAX_FILES) {
+            printf("%s: name too long or too many files\n", sub);
+            fail = 1;
+            continue;
+        }
+        bench_file_t * f = &bench_files[bench_file_cnt];
+        f->data = load_file(path, &f->size);
+        if(f->data == NULL) {
+            printf("%s: read failed\n", path);
+            fail = 1;
+            continue;
+        }
+        strcpy(f->name, sub);
+        bench_file_cnt++;
+    }
+    closedir(d);
+}
+
+static void scan_input(const char * dir)
+{
+    const char * base = strrchr(dir, '/');
+    scan_dir(dir, base ? base + 1 : dir);
+}
+
+static bool is_asset(const char * name)
+{
+    for(int i = 0; i < bench_file_cnt; i++) {
+        if(strcmp(bench_files[i].name, name) == 0) return true;
+    }
+    return false;
+}
+
+/*=====================
+ * 检查
+ *====================*/
+/* 所有文件都能找到，返回的数据与文件相同 */
+static bool check_found(const uint8_t * image, uint32_t image_size, const char * what)
+{
+    bool ok = true;
+    for(int i = 0; i < bench_file_cnt; i++) {
+        const bench_file_t * f = &bench_files[i];
+        uint32_t size = 0;
+        const uint8_t * data = asset_map_find(image, image_size, f->name, &size);
+        if(data == NULL || size != (uint32_t)f->size || memcmp(data, f->data, size) != 0 ||
+           data < image || data + size > image + image_size ||
+           asset_map_find(image, image_size, f->name, NULL) != data) {
+            printf("%s: %s: %s\n", what, f->name, data ? "content differs" : "not found");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/* 所有文件都找不到 */
+static bool check_none(const uint8_t * image, uint32_t image_size, const char * what)
+{
+    for(int i = 0; i < bench_file_cnt; i++) {
+        uint32_t size = 0;
+        if(asset_map_find(image, image_size, bench_files[i].name, &size) != NULL) {
+            printf("%s: %s found\n", what, bench_files[i].name);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 与现有名字相邻但不存在的名字，返回个数 */
+static int missing_names(char names[][ASSET_NAME_LEN + 8], int max)
+{
+    static const char * fixed[] = {"", "0", "~", "gif", "gif/", "missing/asset",
+                                   "gif/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+                                  };
+    int cnt = 0;
+    for(size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]) && cnt < max; i++) {
+        snprintf(names[cnt++], ASSET_NAME_LEN + 8, "%s", fixed[i]);
+    }
+    for(int i = 0; i < bench_file_cnt && cnt + 5 <= max; i++) {
+        const char * name = bench_files[i].name;
+        size_t len = strlen(name);
+        /* 前缀、加后缀(最长的名字加后缀后超过 ASSET_NAME_LEN)、末字节加减1 */
+        snprintf(names[cnt++], ASSET_NAME_LEN + 8, "%.*s", (int)len - 1, name);
+        snprintf(names[cnt++], ASSET_NAME_LEN + 8, "%s_", name);
+        snprintf(names[cnt++], ASSET_NAME_LEN + 8, "%s_tail", name);
+        snprintf(names[cnt], ASSET_NAME_LEN + 8, "%s", name);
+        names[cnt++][len - 1]++;
+        snprintf(names[cnt], ASSET_NAME_LEN + 8, "%s", name);
+        names[cnt++][len - 1]--;
+    }
+    /* 碰巧是现有的名字(如 edge/ab 的前缀 edge/a)的去掉 */
+    int out = 0;
+    for(int i = 0; i < cnt; i++) {
+        if(!is_asset(names[i])) memmove(names[out++], names[i], sizeof(names[0]));
+    }
+    return out;
+}
+
+static bool check_missing(const uint8_t * image, uint32_t image_size, char names[][ASSET_NAME_LEN + 8], int cnt)
+{
+    bool ok = true;
+    for(int i = 0; i < cnt; i++) {
+        uint32_t size = 0xdeadbeef;
+        if(asset_map_find(image, image_size, names[i], &size) != NULL || size != 0xdeadbeef) {
+            printf("missing: \"%s\" found\n", names[i]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/* 截到比完整镜像短的长度: 头和索引表逐字节，数据部分抽查，每次拷贝到刚好大小的缓冲 */
+static int check_truncated(const uint8_t * image, uint32_t image_size)
+{
+    const asset_header_t * header = (const asset_header_t *)image;
+    uint32_t index_end = sizeof(*header) + header->count * sizeof(asset_entry_t);
+    uint32_t step = image_size / TRUNCATE_SAMPLES + 1;
+    int cnt = 0;
+    for(uint32_t len = 0; len < image_size; len = len <= index_end ? len + 1 : len + step) {
+        uint8_t * copy = malloc(len ? len : 1);
+        memcpy(copy, image, len);
+        char what[32];
+        snprintf(what, sizeof(what), "truncated to %u", (unsigned)len);
+        bool ok = check_none(copy, len, what);
+        free(copy);
+        if(!ok) return -1;
+        cnt++;
+    }
+    /* 只差最后一个字节 */
+    uint8_t * copy = malloc(image_size - 1);
+    memcpy(copy, image, image_size - 1);
+    bool ok = check_none(copy, image_size - 1, "truncated by 1 byte");
+    free(copy);
+    return ok ? cnt + 1 : -1;
+}
+
+static bool check_corrupt(const uint8_t * image, uint32_t image_size)
+{
+    bool ok = true;
+    uint8_t * copy = malloc(image_size);
+    asset_header_t * header = (asset_header_t *)copy;
+    asset_entry_t * entries = (asset_entry_t *)&header[1];
+
+    memcpy(copy, image, image_size);
+    copy[0] ^= 0xff;
+    ok &= check_none(copy, image_size, "bad magic");
+
+    memcpy(copy, image, image_size);
+    header->count = (header->size - sizeof(*header)) / sizeof(asset_entry_t) + 1;
+    ok &= check_none(copy, image_size, "count past the index");
+
+    /* 每个索引项分别改坏: 只有它找不到，改回后都能找到 */
+    memcpy(copy, image, image_size);
+    for(uint32_t i = 0; i < header->count; i++) {
+        const struct {
+            uint32_t offset;
+            uint32_t size;
+            const char * what;
+        } bad[] = {
+            {header->size + 4, 0, "offset past the end"},
+            {header->size - 4, 8, "data past the end"},
+            {4, 0xffffffff, "offset + size overflows"},
+        };
+        asset_entry_t saved = entries[i];
+        char name[ASSET_NAME_LEN + 1] = {0};
+        memcpy(name, saved.name, ASSET_NAME_LEN);
+        for(size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); b++) {
+            entries[i].offset = bad[b].offset;
+            entries[i].size = bad[b].size;
+            if(asset_map_find(copy, image_size, name, NULL) != NULL) {
+                printf("%s: %s found\n", bad[b].what, name);
+                ok = false;
+            }
+        }
+        entries[i] = saved;
+    }
+    ok &= check_found(copy, image_size, "restored");
+    free(copy);
+
+    /* 头部声明的镜像比头部还小，后面却跟着一个有效的索引项 */
+    struct {
+        asset_header_t header;
+        asset_entry_t entry;
+    } tiny = {{{'A', 'S', 'T', '1'}, 1, 8, 0}, {"x", 0, 8}};
+    copy = malloc(sizeof(tiny));
+    memcpy(copy, &tiny, sizeof(tiny));
+    if(asset_map_find(copy, sizeof(tiny), "x", NULL) != NULL) {
+        printf("image size smaller than the header: x found\n");
+        ok = false;
+    }
+    free(copy);
+
+    if(asset_map_find(NULL, image_size, bench_files[0].name, NULL) != NULL) {
+        printf("NULL image: found\n");
+        ok = false;
+    }
+    return ok;
+}
+
+/* asset_map_init 在各种分区内容下的结果，最后一次成功映射 */
+static bool check_partition(const uint8_t * image, uint32_t image_size)
+{
+    bool ok = true;
+    uint8_t * copy = malloc(image_size);
+    static const struct {
+        const char * what;
+        esp_err_t ret;
+    } cases[] = {
+        {"no partition", ESP_ERR_NOT_FOUND},
+        {"bad magic", ESP_ERR_INVALID_STATE},
+        {"image larger than the partition", ESP_ERR_INVALID_STATE},
+        {"count past the index", ESP_ERR_INVALID_STATE},
+        {"valid image", ESP_OK},
+    };
+    for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        memcpy(copy, image, image_size);
+        asset_header_t * header = (asset_header_t *)copy;
+        part_data = i == 0 ? NULL : copy;
+        part_size = i == 2 ? image_size - 4 : image_size;
+        if(i == 1) copy[0] ^= 0xff;
+        if(i == 3) header->count = (header->size - sizeof(*header)) / sizeof(asset_entry_t) + 1;
+        esp_err_t ret = asset_map_init();
+        /* 失败时不保留映射，之后什么都找不到 */
+        bool found = asset_map_get(bench_files[0].name, NULL) != NULL;
+        if(ret != cases[i].ret || part_mapped != (ret == ESP_OK) || found != (ret == ESP_OK)) {
+            printf("partition, %s: ret %d, mapped %d, found %d\n", cases[i].what, ret, part_mapped, found);
+            ok = false;
+        }
+    }
+    /* 数据指针直接指向分区映射，不拷贝 */
+    for(int i = 0; i < bench_file_cnt && ok; i++) {
+        uint32_t size = 0;
+        const uint8_t * data = asset_map_get(bench_files[i].name, &size);
+        if(data == NULL || data < copy || data + size > copy + image_size || size != (uint32_t)bench_files[i].size ||
+           memcmp(data, bench_files[i].data, size) != 0) {
+            printf("partition: %s: bad data\n", bench_files[i].name);
+            ok = false;
+        }
+    }
+    /* 映射一直保留，copy 不释放 */
+    return ok;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* 每次查找的平均耗时(纳秒) */
+static double time_lookups(const uint8_t * image, uint32_t image_size, char names[][ASSET_NAME_LEN + 8], int cnt)
+{
+    volatile uintptr_t sink = 0;
+    double start = now_sec();
+    for(int r = 0; r < LOOKUP_ROUNDS; r++) {
+        for(int i = 0; i < cnt; i++) {
+            sink += (uintptr_t)asset_map_find(image, image_size, names[i], NULL);
+        }
+    }
+    (void)sink;
+    return (now_sec() - start) * 1e9 / ((double)LOOKUP_ROUNDS * cnt);
+}
+
+int main(int argc, char ** argv)
+{
+    const char * image_path = argc > 1 ? argv[1] : ASSET_BENCH_IMAGE;
+    scan_input(ASSET_BENCH_GIF_DIR);
+    scan_input(ASSET_BENCH_EMOJI_DIR);
+    scan_input(ASSET_BENCH_EDGE_DIR);
+    long image_size = 0;
+    uint8_t * image = load_file(image_path, &image_size);
+    if(image == NULL || bench_file_cnt == 0) {
+        printf("%s: read failed or no input files\n", image_path);
+        return 1;
+    }
+    const asset_header_t * header = (const asset_header_t *)image;
+    printf("%s: %u assets, %ld bytes\n", image_path, (unsigned)header->count, image_size);
+    if(header->count != (uint32_t)bench_file_cnt) {
+        printf("image has %u assets, %d input files\n", (unsigned)header->count, bench_file_cnt);
+        fail = 1;
+    }
+
+    bool ok = check_found(image, image_size, "lookup");
+    printf("%-10s %s, %d assets\n", "lookup", ok ? "OK" : "FAIL", bench_file_cnt);
+    fail |= !ok;
+
+    static char missing[BENCH_MAX_FILES * 5 + 16][ASSET_NAME_LEN + 8];
+    int missing_cnt = missing_names(missing, sizeof(missing) / sizeof(missing[0]));
+    ok = check_missing(image, image_size, missing, missing_cnt);
+    printf("%-10s %s, %d names\n", "missing", ok ? "OK" : "FAIL", missing_cnt);
+    fail |= !ok;
+
+    int truncated = check_truncated(image, image_size);
+    printf("%-10s %s, %d lengths\n", "truncated", truncated > 0 ? "OK" : "FAIL", truncated);
+    fail |= truncated <= 0;
+
+    ok = check_corrupt(image, image_size);
+    printf("%-10s %s\n", "corrupt", ok ? "OK" : "FAIL");
+    fail |= !ok;
+
+    ok = check_partition(image, image_size);
+    printf("%-10s %s\n", "partition", ok ? "OK" : "FAIL");
+    fail |= !ok;
+
+    char found[BENCH_MAX_FILES][ASSET_NAME_LEN + 8];
+    for(int i = 0; i < bench_file_cnt; i++) {
+        strcpy(found[i], bench_files[i].name);
+    }
+    double hit_ns = time_lookups(image, image_size, found, bench_file_cnt);
+    double miss_ns = time_lookups(image, image_size, missing, missing_cnt);
+    printf("find: %.1f ns per hit, %.1f ns per miss (%u assets)\n", hit_ns, miss_ns, (unsigned)header->count);
+
+    for(int i = 0; i < bench_file_cnt; i++) {
+        free(bench_files[i].data);
+    }
+    free(image);
+    return fail;
+}
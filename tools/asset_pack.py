@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+资源分区打包工具
+
+把若干目录下的文件(GIF、帧包、PCM音频)打成一个镜像烧录到 assets 分区，设备端用
+esp_partition_mmap 只读映射整个镜像，按名字二分查找后直接拿到数据指针，不经过文件系统，
+也不需要拷贝(见 main/asset_map.c)。
+
+镜像格式(小端):
+    头部      16 字节   magic "AST1", u32 count, u32 size(整个镜像字节数), u32 reserved
+    索引      count * 40 字节，按名字升序
+                        char name[32](以0结尾), u32 offset(相对镜像开头), u32 size
+    数据      每个文件按 4 字节对齐依次存放
+
+资源名为 "输入目录名/相对路径"，如 pack/blink_once.epk、gif/blink_once.gif。
+
+    asset_pack.py --output assets.bin spiffs/gif spiffs/pack
+    asset_pack.py --verify assets.bin spiffs/gif spiffs/pack
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+ASSET_MAGIC = b'AST1'
+ASSET_HEADER = struct.Struct('<4sIII')
+ASSET_ENTRY = struct.Struct('<32sII')
+ASSET_NAME_LEN = 32
+ASSET_ALIGN = 4
+
+
+class AssetError(Exception):
+    pass
+
+
+def align(n):
+    return (n + ASSET_ALIGN - 1) // ASSET_ALIGN * ASSET_ALIGN
+
+
+def collect(dirs):
+    """返回 [(资源名, 文件路径)]，按资源名排序"""
+    files = {}
+    for top in dirs:
+        prefix = os.path.basename(os.path.normpath(top))
+        if not os.path.isdir(top):
+            continue
+        for root, _, names in os.walk(top):
+            for name in names:
+                path = os.path.join(root, name)
+                rel = os.path.relpath(path, top).replace(os.sep, '/')
+                asset = prefix + '/' + rel
+                if len(asset.encode()) >= ASSET_NAME_LEN:
+                    raise AssetError('name too long: %s' % asset)
+                if asset in files:
+                    raise AssetError('duplicate asset: %s' % asset)
+                files[asset] = path
+    # 设备端用 strncmp 比较，按字节序排序
+    return sorted(files.items(), key=lambda item: item[0].encode())
+
+
+def build_image(assets):
+    data_start = align(ASSET_HEADER.size + ASSET_ENTRY.size * len(assets))
+    index = []
+    data = bytearray()
+    for name, path in assets:
+        with open(path, 'rb') as f:
+            content = f.read()
+        index.append(ASSET_ENTRY.pack(name.encode(), data_start + len(data), len(content)))
+        data += content
+        data += bytes(align(len(data)) - len(data))
+    size = data_start + len(data)
+    header = ASSET_HEADER.pack(ASSET_MAGIC, len(assets), size, 0)
+    image = header + b''.join(index)
+    return image + bytes(data_start - len(image)) + bytes(data)
+
+
+def read_index(image):
+    """解析镜像并检查格式，返回 [(资源名, offset, size)]"""
+    if len(image) < ASSET_HEADER.size:
+        raise AssetError('image too small')
+    magic, count, size, _ = ASSET_HEADER.unpack_from(image, 0)
+    if magic != ASSET_MAGIC:
+        raise AssetError('bad magic')
+    if size > len(image) or ASSET_HEADER.size + count * ASSET_ENTRY.size > size:
+        raise AssetError('bad image size')
+    entries = []
+    for i in range(count):
+        raw, offset, length = ASSET_ENTRY.unpack_from(image, ASSET_HEADER.size + i * ASSET_ENTRY.size)
+        if b'\0' not in raw:
+            raise AssetError('entry %d: name not terminated' % i)
+        name = raw.split(b'\0', 1)[0]
+        if offset % ASSET_ALIGN or offset + length > size:
+            raise AssetError('%s: bad offset' % name.decode())
+        if entries and entries[-1][0] >= name:
+            raise AssetError('%s: index not sorted' % name.decode())
+        entries.append((name, offset, length))
+    return entries
+
+
+def find(image, entries, name):
+    """与 asset_map_find 相同的二分查找"""
+    key = name.encode()
+    lo, hi = 0, len(entries)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if key == entries[mid][0]:
+            offset, length = entries[mid][1:]
+            return image[offset:offset + length]
+        if key < entries[mid][0]:
+            hi = mid
+        else:
+            lo = mid + 1
+    return None
+
+
+def verify(image_path, assets):
+    with open(image_path, 'rb') as f:
+        image = f.read()
+    entries = read_index(image)
+    if len(entries) != len(assets):
+        raise AssetError('image has %d assets, expected %d' % (len(entries), len(assets)))
+    for name, path in assets:
+        with open(path, 'rb') as f:
+            if find(image, entries, name) != f.read():
+                raise AssetError('%s: content differs' % name)
+    if find(image, entries, 'missing/asset') is not None:
+        raise AssetError('lookup of a missing asset succeeded')
+    return len(entries)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack asset files into a memory-mappable partition image')
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument('--output', help='image file to write')
+    group.add_argument('--verify', help='image file to check against the input directories')
+    parser.add_argument('--max-size', type=lambda s: int(s, 0), default=0, help='partition size limit')
+    parser.add_argument('inputs', nargs='+', help='directories to pack, named by their basename')
+    args = parser.parse_args()
+
+    try:
+        assets = collect(args.inputs)
+        if args.verify:
+            count = verify(args.verify, assets)
+            print('%s: %d assets OK' % (args.verify, count))
+            return 0
+        image = build_image(assets)
+    except (AssetError, OSError) as e:
+        sys.stderr.write('%s\n' % e)
+        return 1
+    if args.max_size and len(image) > args.max_size:
+        sys.stderr.write('image %d bytes exceeds partition size %d\n' % (len(image), args.max_size))
+        return 1
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print('%d assets, %d bytes' % (len(assets), len(image)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,225 @@
+/**
+ * audio_codec 主机端一致性测试和基准测试
+ * 先用 audio_vectors.h 的参考向量(gen_vectors.py 由 audioop 生成)检查 mu-law 和 IMA-ADPCM 解码，
+ * 一次解码整段和随机切开输入、随机限制输出空间(模拟 /ws 分帧和环形缓冲回绕)都必须与参考逐采样一致，
+ * ADPCM 中间随机丢弃一段输入(audio_codec_skip，模拟环形缓冲溢出)后，从下一块起的输出也必须与参考一致;
+ * 再计时解码1秒24kHz音频的耗时，输出每秒音频的解码时间和CPU周期数(x86 用 rdtsc，其他平台只有时间)。
+ * 主机CPU比ESP32-S3快得多，周期数只能看两种格式和PCM拷贝之间的相对值。
+ * 用法: audio_bench [每种格式最少计时毫秒数，默认300]
+ * 与参考不一致时返回1
+ */
+#include "audio_codec.h"
+#include "audio_vectors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC   1
+#endif
+
+#define BENCH_RATE          24000
+/* 与 main/config.h 的 AUDIO_STREAM_CHUNK 相近，解码输出每次最多写这么多 */
+#define BENCH_OUT_CHUNK     2048
+#define SPLIT_ROUNDS        200
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * 按随机的输入长度和输出空间解码，max_in/max_out 为0时不切分
+ * @return 输出的采样数
+ */
+static size_t decode_split(audio_codec_type_t type, uint16_t block_align, const uint8_t * in, size_t in_len,
+                           int16_t * out, size_t out_cap, unsigned max_in, unsigned max_out)
+{
+    audio_codec_t codec;
+    audio_codec_init(&codec, type, block_align);
+    uint8_t * dst = (uint8_t *)out;
+    size_t o = 0;
+    size_t i = 0;
+    while(i < in_len) {
+        size_t in_n = max_in ? 1 + rand() % max_in : in_len;
+        size_t out_n = max_out ? 1 + rand() % max_out : out_cap * 2 - o;
+        in_n = in_n < in_len - i ? in_n : in_len - i;
+        out_n = out_n < out_cap * 2 - o ? out_n : out_cap * 2 - o;
+        size_t used;
+        size_t n = audio_codec_decode(&codec, in + i, in_n, &used, dst + o, out_n);
+        if(n == 0 && used == 0 && out_n >= 2) {
+            break;
+        }
+        i += used;
+        o += n;
+    }
+    /* 输入用完后取出最后一个暂存的采样 */
+    size_t used;
+    o += audio_codec_decode(&codec, NULL, 0, &used, dst + o, out_cap * 2 - o);
+    return o / 2;
+}
+
+/**
+ * ADPCM 解码 skip_at 字节后丢弃 skip_len 字节，再解码剩下的，返回丢弃前输出的采样数
+ */
+static size_t decode_skip(const uint8_t * in, size_t in_len, size_t skip_at, size_t skip_len, int16_t * out,
+                          size_t out_cap, size_t * total)
+{
+    audio_codec_t codec;
+    audio_codec_init(&codec, AUDIO_CODEC_IMA_ADPCM, ADPCM_VECTOR_BLOCK_ALIGN);
+    size_t used;
+    size_t o = audio_codec_decode(&codec, in, skip_at, &used, (uint8_t *)out, out_cap * 2);
+    size_t before = o / 2;
+    audio_codec_skip(&codec, skip_len);
+    size_t i = skip_at + skip_len;
+    o += audio_codec_decode(&codec, in + i, in_len - i, &used, (uint8_t *)out + o, out_cap * 2 - o);
+    *total = o / 2;
+    return before;
+}
+
+static int compare(const char * name, const int16_t * got, size_t got_n, const int16_t * ref, size_t ref_n)
+{
+    if(got_n != ref_n) {
+        printf("%s: %zu samples, expect %zu\n", name, got_n, ref_n);
+        return 1;
+    }
+    for(size_t i = 0; i < ref_n; i++) {
+        if(got[i] != ref[i]) {
+            printf("%s: sample %zu is %d, expect %d\n", name, i, got[i], ref[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int conformance(void)
+{
+    int fail = 0;
+    uint8_t codes[256];
+    for(int i = 0; i < 256; i++) codes[i] = i;
+    int16_t * out = malloc(sizeof(adpcm_ref) + 16);
+
+    size_t n = decode_split(AUDIO_CODEC_MULAW, 0, codes, 256, out, 256, 0, 0);
+    fail |= compare("mulaw", out, n, mulaw_ref, 256);
+    n = decode_split(AUDIO_CODEC_IMA_ADPCM, ADPCM_VECTOR_BLOCK_ALIGN, adpcm_vector, sizeof(adpcm_vector), out,
+                     sizeof(adpcm_ref) / 2 + 8, 0, 0);
+    fail |= compare("adpcm", out, n, adpcm_ref, sizeof(adpcm_ref) / 2);
+
+    srand(1);
+    for(int round = 0; round < SPLIT_ROUNDS && !fail; round++) {
+        unsigned max_in = round % 2 ? 3 : 97;
+        unsigned max_out = round % 3 ? 5 : 301;
+        n = decode_split(AUDIO_CODEC_MULAW, 0, codes, 256, out, 256, max_in, max_out);
+        fail |= compare("mulaw split", out, n, mulaw_ref, 256);
+        n = decode_split(AUDIO_CODEC_IMA_ADPCM, ADPCM_VECTOR_BLOCK_ALIGN, adpcm_vector, sizeof(adpcm_vector), out,
+                         sizeof(adpcm_ref) / 2 + 8, max_in, max_out);
+        fail |= compare("adpcm split", out, n, adpcm_ref, sizeof(adpcm_ref) / 2);
+    }
+    /* 丢弃后从下一个块头开始，前面的输出是参考的前缀，后面是参考从那一块开始的部分 */
+    size_t spb = audio_codec_adpcm_block_samples(ADPCM_VECTOR_BLOCK_ALIGN);
+    size_t ref_n = sizeof(adpcm_ref) / 2;
+    for(int round = 0; round < SPLIT_ROUNDS && !fail; round++) {
+        size_t skip_at = rand() % (sizeof(adpcm_vector) - 1);
+        size_t skip_len = 1 + rand() % (round % 2 ? 7 : 600);
+        skip_len = skip_len < sizeof(adpcm_vector) - skip_at ? skip_len : sizeof(adpcm_vector) - skip_at;
+        size_t total;
+        size_t before = decode_skip(adpcm_vector, sizeof(adpcm_vector), skip_at, skip_len, out, ref_n + 8, &total);
+        size_t block = (skip_at + skip_len + ADPCM_VECTOR_BLOCK_ALIGN - 1) / ADPCM_VECTOR_BLOCK_ALIGN;
+        size_t resume = block * spb < ref_n ? block * spb : ref_n;
+        fail |= compare("adpcm skip prefix", out, before, adpcm_ref, before);
+        fail |= compare("adpcm skip resume", out + before, total - before, adpcm_ref + resume, ref_n - resume);
+        if(fail) {
+            printf("adpcm skip: %zu bytes at %zu\n", skip_len, skip_at);
+        }
+    }
+    free(out);
+    printf("conformance: mulaw %d codes, adpcm %zu bytes -> %zu samples, %d split rounds, %d skip rounds: %s\n",
+           256, sizeof(adpcm_vector), sizeof(adpcm_ref) / 2, SPLIT_ROUNDS, SPLIT_ROUNDS, fail ? "FAIL" : "ok");
+    return fail;
+}
+
+/* 把参考向量重复到1秒音频的长度作为输入 */
+static uint8_t * one_second(audio_codec_type_t type, size_t * len)
+{
+    const uint8_t * src;
+    size_t src_len;
+    if(type == AUDIO_CODEC_IMA_ADPCM) {
+        /* 只用完整的块 */
+        src = adpcm_vector;
+        src_len = sizeof(adpcm_vector) / ADPCM_VECTOR_BLOCK_ALIGN * ADPCM_VECTOR_BLOCK_ALIGN;
+        *len = (BENCH_RATE + audio_codec_adpcm_block_samples(ADPCM_VECTOR_BLOCK_ALIGN) - 1) /
+               audio_codec_adpcm_block_samples(ADPCM_VECTOR_BLOCK_ALIGN) * ADPCM_VECTOR_BLOCK_ALIGN;
+    } else {
+        static uint8_t pcm[512];
+        for(size_t i = 0; i < sizeof(pcm); i++) pcm[i] = (uint8_t)(i * 37);
+        src = pcm;
+        src_len = sizeof(pcm);
+        *len = type == AUDIO_CODEC_MULAW ? BENCH_RATE : BENCH_RATE * 2;
+    }
+    uint8_t * data = malloc(*len);
+    for(size_t i = 0; i < *len; i += src_len) {
+        memcpy(data + i, src, *len - i < src_len ? *len - i : src_len);
+    }
+    return data;
+}
+
+static void bench(const char * name, audio_codec_type_t type, double min_sec)
+{
+    size_t len;
+    uint8_t * in = one_second(type, &len);
+    static uint8_t out[BENCH_OUT_CHUNK];
+    audio_codec_t codec;
+    uint64_t samples = 0;
+    uint32_t runs = 0;
+    volatile uint8_t sink = 0;
+    double start = now_sec();
+    uint64_t start_cycles = cycles();
+    double elapsed;
+    do {
+        audio_codec_init(&codec, type, ADPCM_VECTOR_BLOCK_ALIGN);
+        size_t i = 0;
+        while(i < len) {
+            size_t used;
+            size_t n = audio_codec_decode(&codec, in + i, len - i, &used, out, sizeof(out));
+            sink ^= out[0];
+            samples += n / 2;
+            i += used;
+        }
+        runs++;
+        elapsed = now_sec() - start;
+    } while(elapsed < min_sec);
+    uint64_t total_cycles = cycles() - start_cycles;
+    double audio_sec = (double)samples / BENCH_RATE;
+    printf("%-6s %7.1f us/s of audio", name, elapsed / audio_sec * 1e6);
+    if(total_cycles) {
+        printf(", %8.0f cycles/s of audio", total_cycles / audio_sec);
+    }
+    printf(", %5.0f Msamples/s (%u runs)\n", samples / elapsed / 1e6, runs);
+    (void)sink;
+    free(in);
+}
+
+int main(int argc, char ** argv)
+{
+    double min_sec = (argc > 1 ? atoi(argv[1]) : 300) / 1000.0;
+    if(conformance()) {
+        return 1;
+    }
+    bench("pcm", AUDIO_CODEC_PCM, min_sec);
+    bench("mulaw", AUDIO_CODEC_MULAW, min_sec);
+    bench("adpcm", AUDIO_CODEC_IMA_ADPCM, min_sec);
+    return 0;
+}
@@ -0,0 +1,472 @@
+/* 由 gen_vectors.py 生成，不要手改 */
+#ifndef __AUDIO_VECTORS_H__
+#define __AUDIO_VECTORS_H__
+
+#include <stdint.h>
+
+#define ADPCM_VECTOR_BLOCK_ALIGN  256
+
+/* audioop.ulaw2lin(range(256)) */
+static const int16_t mulaw_ref[256] = {
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956,
+    -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764,
+    -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+    -11900, -11388, -10876, -10364,  -9852,  -9340,  -8828,  -8316,
+     -7932,  -7676,  -7420,  -7164,  -6908,  -6652,  -6396,  -6140,
+     -5884,  -5628,  -5372,  -5116,  -4860,  -4604,  -4348,  -4092,
+     -3900,  -3772,  -3644,  -3516,  -3388,  -3260,  -3132,  -3004,
+     -2876,  -2748,  -2620,  -2492,  -2364,  -2236,  -2108,  -1980,
+     -1884,  -1820,  -1756,  -1692,  -1628,  -1564,  -1500,  -1436,
+     -1372,  -1308,  -1244,  -1180,  -1116,  -1052,   -988,   -924,
+      -876,   -844,   -812,   -780,   -748,   -716,   -684,   -652,
+      -620,   -588,   -556,   -524,   -492,   -460,   -428,   -396,
+      -372,   -356,   -340,   -324,   -308,   -292,   -276,   -260,
+      -244,   -228,   -212,   -196,   -180,   -164,   -148,   -132,
+      -120,   -112,   -104,    -96,    -88,    -80,    -72,    -64,
+       -56,    -48,    -40,    -32,    -24,    -16,     -8,      0,
+     32124,  31100,  30076,  29052,  28028,  27004,  25980,  24956,
+     23932,  22908,  21884,  20860,  19836,  18812,  17788,  16764,
+     15996,  15484,  14972,  14460,  13948,  13436,  12924,  12412,
+     11900,  11388,  10876,  10364,   9852,   9340,   8828,   8316,
+      7932,   7676,   7420,   7164,   6908,   6652,   6396,   6140,
+      5884,   5628,   5372,   5116,   4860,   4604,   4348,   4092,
+      3900,   3772,   3644,   3516,   3388,   3260,   3132,   3004,
+      2876,   2748,   2620,   2492,   2364,   2236,   2108,   1980,
+      1884,   1820,   1756,   1692,   1628,   1564,   1500,   1436,
+      1372,   1308,   1244,   1180,   1116,   1052,    988,    924,
+       876,    844,    812,    780,    748,    716,    684,    652,
+       620,    588,    556,    524,    492,    460,    428,    396,
+       372,    356,    340,    324,    308,    292,    276,    260,
+       244,    228,    212,    196,    180,    164,    148,    132,
+       120,    112,    104,     96,     88,     80,     72,     64,
+        56,     48,     40,     32,     24,     16,      8,      0,
+};
+
+/* 6 块 + 77 字节的不完整块，单声道 */
+static const uint8_t adpcm_vector[1613] = {
+    0x00, 0x00, 0x00, 0x00, 0x77, 0x77, 0x77, 0x77, 0x11, 0x11, 0x21, 0x21, 0x22, 0x23, 0x22, 0x22,
+    0x01, 0xa8, 0xeb, 0xcc, 0xbd, 0xcc, 0xcb, 0xbc, 0xcb, 0xbb, 0xbb, 0xbb, 0x9a, 0x08, 0x53, 0x54,
+    0x34, 0x44, 0x42, 0x22, 0x22, 0x01, 0xa8, 0xdb, 0xcc, 0xcb, 0xbb, 0xbb, 0x8a, 0x20, 0x54, 0x44,
+    0x33, 0x33, 0x12, 0xa8, 0xdc, 0xbc, 0xbc, 0xaa, 0x08, 0x41, 0x44, 0x24, 0x13, 0x81, 0xca, 0xbc,
+    0xad, 0x8a, 0x18, 0x34, 0x44, 0x22, 0x80, 0xca, 0xcc, 0xaa, 0x08, 0x41, 0x34, 0x23, 0x91, 0xeb,
+    0xcb, 0x9a, 0x20, 0x44, 0x33, 0x81, 0xda, 0xbc, 0x9a, 0x21, 0x45, 0x22, 0x98, 0xdb, 0xbb, 0x18,
+    0x63, 0x23, 0x91, 0xdb, 0xbb, 0x19, 0x44, 0x14, 0xa1, 0xcb, 0xab, 0x38, 0x36, 0x12, 0xba, 0xae,
+    0x09, 0x43, 0x23, 0xb8, 0xbd, 0x0b, 0x53, 0x14, 0xa0, 0xcc, 0x09, 0x42, 0x13, 0xb9, 0xad, 0x19,
+    0x44, 0x82, 0xca, 0x9b, 0x41, 0x24, 0xa8, 0xad, 0x29, 0x43, 0x82, 0xcc, 0x0a, 0x52, 0x02, 0xca,
+    0x9a, 0x42, 0x13, 0xca, 0x9c, 0x32, 0x14, 0xca, 0x9b, 0x53, 0x02, 0xca, 0x0b, 0x53, 0x92, 0xdb,
+    0x19, 0x34, 0xa0, 0xad, 0x30, 0x14, 0xc9, 0x0b, 0x43, 0xa2, 0xbc, 0x48, 0x23, 0xda, 0x0a, 0x43,
+    0xa1, 0xad, 0x41, 0x02, 0xcb, 0x29, 0x15, 0xb9, 0x0b, 0x25, 0xb0, 0x9c, 0x43, 0xa1, 0xac, 0x52,
+    0x91, 0xbb, 0x51, 0x82, 0xbc, 0x41, 0x82, 0xac, 0x40, 0x82, 0xbc, 0x51, 0x81, 0x9c, 0x31, 0xb2,
+    0x9c, 0x53, 0xb0, 0x0c, 0x33, 0xd9, 0x19, 0x14, 0xca, 0x38, 0x83, 0xad, 0x42, 0xb1, 0x0c, 0x33,
+    0xda, 0x39, 0x84, 0xac, 0x42, 0xb0, 0x1b, 0x15, 0xbb, 0x50, 0xb2, 0x0c, 0x14, 0xba, 0x40, 0xb2,
+    0x0c, 0x14, 0xca, 0x40, 0xa1, 0x0b, 0x05, 0xba, 0x42, 0xc0, 0x3a, 0x94, 0x8c, 0x23, 0xda, 0x31,
+    0xb4, 0x45, 0x54, 0x00, 0x9c, 0x32, 0xd9, 0x48, 0xa1, 0x1b, 0x85, 0x9b, 0x24, 0xbb, 0x51, 0xb8,
+    0x49, 0xb2, 0x2c, 0x94, 0x8b, 0x05, 0x9b, 0x33, 0xdb, 0x42, 0xc9, 0x30, 0xc0, 0x38, 0xd2, 0x39,
+    0xb2, 0x2c, 0x94, 0x1c, 0x93, 0x1c, 0x83, 0x0d, 0x84, 0x8b, 0x04, 0x9b, 0x05, 0x8b, 0x04, 0x8c,
+    0x03, 0x8c, 0x04, 0x0c, 0x83, 0x0c, 0x84, 0x1c, 0x93, 0x2c, 0xb3, 0x4b, 0xc2, 0x49, 0xb0, 0x59,
+    0xc0, 0x40, 0xb9, 0x32, 0xac, 0x14, 0x8c, 0x84, 0x1c, 0xa3, 0x5b, 0xb0, 0x58, 0xb9, 0x32, 0x9c,
+    0x04, 0x1c, 0xb3, 0x4a, 0xd1, 0x40, 0xaa, 0x13, 0x0d, 0x93, 0x3c, 0xd2, 0x30, 0xba, 0x05, 0x0b,
+    0xa4, 0x4a, 0xc0, 0x31, 0x8c, 0xa4, 0x3a, 0xd1, 0x31, 0x8c, 0x93, 0x4b, 0xd1, 0x31, 0x8c, 0xa4,
+    0x4a, 0xb8, 0x13, 0x1d, 0xc3, 0x48, 0xaa, 0x84, 0x3b, 0xd1, 0x21, 0x0c, 0xb4, 0x59, 0xaa, 0x95,
+    0x4b, 0xb8, 0x04, 0x2c, 0xc1, 0x22, 0x1d, 0xd3, 0x40, 0x0c, 0xb3, 0x58, 0x8b, 0xa4, 0x49, 0x9a,
+    0xa4, 0x59, 0x9b, 0xa5, 0x49, 0x9a, 0xa4, 0x59, 0x8b, 0xb4, 0x48, 0x0b, 0xd3, 0x21, 0x2c, 0xd1,
+    0x03, 0x3c, 0xb8, 0x95, 0x4a, 0x9a, 0xb5, 0x48, 0x1c, 0xd3, 0x12, 0x4d, 0xa9, 0xa5, 0x49, 0x0b,
+    0xd3, 0x02, 0x4c, 0xa9, 0xb5, 0x48, 0x2c, 0xd1, 0x94, 0x5a, 0x0b, 0xe3, 0x03, 0x4c, 0x9a, 0xc5,
+    0x11, 0x4c, 0x9a, 0xc5, 0x21, 0x4d, 0x8a, 0xc4, 0x02, 0x4c, 0x8a, 0xc4, 0x02, 0x5b, 0x1b, 0xd1,
+    0xa4, 0x48, 0x3c, 0xa9, 0xc5, 0x12, 0x4c, 0x0b, 0xd2, 0xa4, 0x38, 0x4d, 0x8a, 0xd3, 0x93, 0x49,
+    0x3c, 0xa9, 0xc5, 0x93, 0x49, 0x3c, 0x99, 0xd4, 0xa4, 0x38, 0x4d, 0x1b, 0xc1, 0xc5, 0x02, 0x5b,
+    0x3c, 0x99, 0xd4, 0xa4, 0x10, 0x5c, 0x3c, 0x99, 0xd4, 0xb4, 0x02, 0x5b, 0x4c, 0x8a, 0xc2, 0xc4,
+    0xda, 0x29, 0x58, 0x00, 0x89, 0xd2, 0xc5, 0x92, 0x38, 0x4d, 0x3c, 0x89, 0xd2, 0xc4, 0xa3, 0x11,
+    0x4c, 0x4c, 0x2b, 0x98, 0xe3, 0xc4, 0xb4, 0x01, 0x5a, 0x4c, 0x3c, 0x1a, 0xa0, 0xd5, 0xd5, 0xa4,
+    0x81, 0x39, 0x4d, 0x4c, 0x3c, 0x1a, 0xa0, 0xd4, 0xc4, 0xb4, 0xb3, 0x82, 0x39, 0x4e, 0x4c, 0x4c,
+    0x3b, 0x1b, 0x90, 0xd3, 0xc4, 0xc4, 0xc4, 0xc4, 0xa3, 0x81, 0x28, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c,
+    0x3c, 0x3b, 0x1a, 0x19, 0xa0, 0xd3, 0xc4, 0xb4, 0xc4, 0xc4, 0xc4, 0xc4, 0xc4, 0xc4, 0xc4, 0xb3,
+    0xb3, 0xb4, 0xb3, 0xa2, 0x92, 0x91, 0x91, 0xf0, 0x0b, 0x88, 0x67, 0x00, 0x00, 0xf0, 0x0b, 0x88,
+    0x80, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37,
+    0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00,
+    0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b,
+    0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08,
+    0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00,
+    0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0,
+    0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80,
+    0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37,
+    0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00,
+    0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b, 0x80, 0x08, 0x37, 0x00, 0x00, 0xf0, 0x8b,
+    0x00, 0x80, 0x56, 0x00, 0x80, 0x78, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00,
+    0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08,
+    0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70,
+    0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00,
+    0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf,
+    0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88,
+    0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03,
+    0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00, 0xbf, 0x08, 0x88, 0x70, 0x03, 0x00, 0x00,
+    0xbf, 0x48, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x00, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x08, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00,
+    0x88, 0x00, 0x88, 0x00, 0x08, 0x08, 0x08, 0x08, 0x88, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x77, 0x77, 0x77, 0x27,
+    0x98, 0x99, 0xa9, 0xaa, 0xbb, 0xcb, 0x4b, 0xaa, 0x9b, 0xaa, 0x89, 0x08, 0x11, 0x53, 0x53, 0x43,
+    0x53, 0x42, 0x72, 0x12, 0x21, 0x11, 0x10, 0x01, 0x08, 0x99, 0xba, 0xcc, 0xbc, 0xbc, 0xd3, 0xbb,
+    0xbc, 0xbb, 0xcb, 0xba, 0xaa, 0xa9, 0x08, 0x10, 0x43, 0x35, 0x77, 0x11, 0x11, 0x21, 0x22, 0x32,
+    0x22, 0x22, 0x11, 0x00, 0xa9, 0x7b, 0xb1, 0xbd, 0xdb, 0xcb, 0xbb, 0xbc, 0xbb, 0xbc, 0xba, 0xaa,
+    0xaa, 0x79, 0x03, 0x11, 0x32, 0x53, 0x43, 0x43, 0x33, 0x34, 0x33, 0x24, 0x32, 0x37, 0x80, 0x90,
+    0xd8, 0x23, 0x33, 0x00, 0xa9, 0xbb, 0xbd, 0xbc, 0xbc, 0xbc, 0xac, 0xbb, 0x4b, 0xaa, 0xaa, 0x99,
+    0x89, 0x11, 0x42, 0x34, 0x45, 0x33, 0x44, 0x42, 0x17, 0x11, 0x11, 0x01, 0x01, 0x00, 0x98, 0xa9,
+    0xcb, 0xbc, 0xcc, 0xcb, 0xc3, 0xba, 0xac, 0xab, 0xbb, 0xaa, 0xaa, 0x89, 0x10, 0x32, 0x45, 0x44,
+    0x47, 0x11, 0x12, 0x22, 0x23, 0x32, 0x22, 0x12, 0x01, 0x98, 0xca, 0x7c, 0xa9, 0xcb, 0xbc, 0xbb,
+    0xad, 0xcb, 0xaa, 0xbb, 0xaa, 0xaa, 0x99, 0x70, 0x14, 0x11, 0x32, 0x43, 0x34, 0x43, 0x43, 0x32,
+    0x33, 0x32, 0x22, 0x47, 0x80, 0x98, 0xb9, 0xca, 0xdb, 0xbb, 0xbc, 0xbc, 0xcb, 0xab, 0xcb, 0x94,
+    0x9a, 0x98, 0x08, 0x10, 0x32, 0x44, 0x34, 0x34, 0x34, 0x43, 0x73, 0x13, 0x12, 0x10, 0x01, 0x80,
+    0x98, 0xba, 0xbc, 0xcd, 0xcb, 0xbb, 0x2d, 0xbb, 0xcb, 0xbb, 0xab, 0xab, 0xaa, 0x88, 0x10, 0x53,
+    0x53, 0x34, 0x67, 0x11, 0x11, 0x12, 0x22, 0x21, 0x12, 0x02, 0x81, 0x98, 0xba, 0xcd, 0xa6, 0xbb,
+    0xdb, 0xbb, 0xbc, 0xcb, 0xba, 0xab, 0xab, 0xaa, 0x89, 0x78, 0x06, 0x11, 0x12, 0x33, 0x34, 0x43,
+    0x33, 0x34, 0x32, 0x23, 0x22, 0x71, 0x84, 0x89, 0xaa, 0xcb, 0xbc, 0xbc, 0xcb, 0xac, 0xcb, 0xba,
+    0xba, 0x6a, 0x99, 0x88, 0x08, 0x10, 0x22, 0x34, 0x44, 0x43, 0x33, 0x34, 0x43, 0x27, 0x11, 0x10,
+    0x00, 0x80, 0x98, 0xba, 0xdb, 0xcb, 0xbc, 0xcb, 0xac, 0xb2, 0xac, 0xbb, 0xab, 0xab, 0xa9, 0x08,
+    0x20, 0x53, 0x44, 0x43, 0x74, 0x23, 0x22, 0x22, 0x32, 0x32, 0x22, 0x11, 0x00, 0xa9, 0xdb, 0xbd,
+    0x5c, 0xbb, 0xbc, 0xbc, 0xcb, 0xbb, 0xbb, 0xcb, 0xaa, 0x99, 0x89, 0x10, 0x77, 0x10, 0x21, 0x22,
+    0x32, 0x34, 0x33, 0x43, 0x23, 0x23, 0x12, 0x01, 0x37, 0x99, 0xbb, 0xbd, 0xcc, 0xbb, 0xcc, 0xba,
+    0x7e, 0xf3, 0x35, 0x00, 0xbb, 0xac, 0xab, 0x96, 0x98, 0x08, 0x00, 0x21, 0x43, 0x53, 0x33, 0x44,
+    0x33, 0x33, 0x34, 0x37, 0x11, 0x00, 0x00, 0x98, 0xa9, 0xbc, 0xdb, 0xdb, 0xca, 0xba, 0x2c, 0xbb,
+    0xbb, 0xcb, 0xaa, 0xa9, 0x88, 0x18, 0x32, 0x45, 0x53, 0x43, 0x73, 0x24, 0x11, 0x12, 0x22, 0x21,
+    0x11, 0x00, 0x98, 0xaa, 0xbd, 0xcc, 0xb4, 0xbc, 0xdb, 0xba, 0xac, 0xbb, 0xba, 0xab, 0xab, 0x89,
+    0x08, 0x32, 0x77, 0x14, 0x21, 0x22, 0x33, 0x43, 0x33, 0x33, 0x33, 0x22, 0x12,
+};
+
+/* audioop.adpcm2lin 逐块解码，块头采样在前 */
+static const int16_t adpcm_ref[3177] = {
+         0,     11,     41,    104,    240,    533,   1164,   2521,   5431,   6677,
+      7811,   8841,   9777,  10629,  11920,  12623,  13689,  14659,  15540,  16661,
+     17389,  18051,  18652,  19199,  19696,  19967,  20049,  19975,  19635,  19204,
+     18475,  17580,  16497,  14895,  13403,  11657,   9545,   7557,   5233,   2422,
+      -224,  -2628,  -5439,  -8085, -10489, -12674, -14662, -16469, -18111, -19177,
+    -19759, -19935, -19775, -18756, -17299, -15553, -12972,  -9880,  -6971,  -3569,
+       548,   3315,   7844,  10887,  13654,  16170,  18457,  19703,  20081,  19738,
+     18177,  16189,  13349,   9947,   5830,   1956,  -2573,  -6833, -10707, -14229,
+    -17431, -19509, -19887, -19544, -17983, -15427, -11648,  -7119,  -1640,   3516,
+      8203,  12463,  16337,  18853,  20225,  19810,  17920,  14828,  10255,   4776,
+      -380,  -6407, -12080, -15763, -19111, -19719, -19166, -17657, -13540,  -8559,
+     -2532,   4762,   9664,  15904,  18335,  20544,  19875,  16832,  11851,   5824,
+       151,  -7952, -13345, -18247, -19138, -19948, -17739, -11712,  -6039,    591,
+      8614,  14007,  18909,  19800,  18990,  15307,   9280,   1986,  -6839, -12771,
+    -18164, -19144, -18253, -15822,  -9192,  -1169,   6381,  13244,  17701,  20132,
+     17923,  13236,   5322,  -2228, -11053, -16985, -20220, -19240, -14783,  -7489,
+      1336,   9641,  17191,  20132,  19241,  15189,   7086,  -2622, -11758, -17690,
+    -20925, -17984, -13527,  -4612,   6067,  13245,  19771,  18585,  15350,   8487,
+     -1319, -10455, -18760, -19838, -16897, -10657,   -121,   9928,  16454,  20013,
+     16778,   9915,    109,  -9027, -17332, -20567, -17626,  -9603,    105,  11852,
+     16589,  20895,  14369,   6064,  -3644, -12780, -18712, -19790, -12927,  -1338,
+      9716,  16894,  20809,  14877,   7327,  -5420, -14106, -18843, -17408,  -8272,
+      2407,  12456,  18982,  17796,  10246,   -540, -10589, -19725, -18539, -10989,
+      -203,  12719,  17930,  19509,  12331,    584, -13630, -19363, -17626,  -9730,
+      3192,  15352,  20089,  15783,   6647,  -6405, -15091, -19828, -15522,  -3775,
+     10439,  19994,  18257,  10361,  -2561, -14721, -19458, -15152,  -3405,  10809,
+     20364,  18627,  10731,  -5062, -15573, -21306, -12620,  -1566,  11356,  20042,
+     18463,   5541, -10095, -20606, -18695, -10009,   7363,  18925,  21027,  11472,
+     -4164, -14675, -20408, -11722,   2492,  15869,  21080,  13184,    262, -15374,
+    -21680, -12125,     35,  14249,  19982,  11296,  -2918, -16295, -21506, -10452,
+      5341,  15852,  17763,   9077,  -5137, -18514, -16777,  -5723,  10070,  20581,
+     14848,   2688, -14684, -21621, -15315,   1885,  18072,  20174,  10619,  -8491,
+    -21209, -18897,  -4182,  13018,  19955,  13649,  -3551, -19738, -17636,  -4259,
+     11377,  21888,  12333,  -3303, -18018, -19929,  -4293,  10422,  19977,  11291,
+     -6081, -17643, -15541,  -2164,  13472,  19778,  10223,  -8887, -21605, -14668,
+      4252,  16970,  19282,   4567, -12633, -19570,  -9059,  11963,  20357,  12727,
+     -3460, -18175, -16264,   2846,  15564,  17876,   3161, -14039, -20976,  -6261,
+     10939,  17876,   7365,  -9835, -21397, -10886,  10136,  18530,  10900,  -5287,
+    -20002, -14269,   4841,  17559,  15247,  -3673, -21478, -14541,   4379,  17097,
+     14785,  -4135, -16853, -14541,   4379,  17097,  14785,  -4135, -21940, -15003,
+      8121,  17353,  14555,  -8338, -17570,  -9176,   8629,  20191,   5476, -11724,
+    -18661,  -3946,  17076,  19874,   2069, -18743, -15945,   1860,  18047,  11741,
+     -9281, -17675, -10045,  10767,  19161,   6443, -14369, -17167,    638,  16825,
+     14723,  -6299, -20289,  -7571,  13241,  21635,   3830, -16982, -14184,   3621,
+     19808,   9297, -11725, -20119,  -2314,  18498,  15700,  -7193, -22581,  -8591,
+     14302,  17379,  -2207, -20012, -13075,  10049,  19281,   -305, -18110, -15798,
+      7326,  22714,   3128, -19765, -16688,   8495,  18651,   3263, -16323, -13780,
+      7032,  21022,   3217, -17595, -14797,   8096,  17328,   3338, -19555, -16478,
+      8705,  18861,   3473, -16113, -13570,  11867,  15252,   -136, -19722,  -7004,
+     13808,  16606,  -6287, -21675,  -2089,  20804,  11572, -13611, -16996,   4547,
+     18537,   5819, -19618,  -9462,  12081,  17844,  -7339, -17495,  -2107,  17479,
+      9849, -15588, -18973,   8727,  19899,   2971, -18572, -10178,  17802,  14078,
+     -9621, -18853,   6330,  23258,   1715, -17871, -10241,  15196,  11811,  -9732,
+    -18126,   4767,  20155,    569, -22324,  -6936,  18247,   8091, -13452, -16250,
+     11730,  15454,  -8245, -17477,   2109,  19914,   3727, -19397,  -4009,  21174,
+     11018, -16682, -12958,  10741,  13818, -11365, -14750,   6793,  20783,  -7197,
+    -18369,   5330,  20718,   1132, -21761,  -6373,  18810,   8654, -19046,  -7874,
+     15825,   6593, -18590,  -8434,  13109,  10311, -17669, -13945,  16526,  12431,
+    -13638, -17023,  10677,  14401,  -9298, -18530,  12249,  16344,  -9725, -13110,
+     14590,  18314, -12157, -16252,   9817,  13202, -14498, -18222,  12249,  16344,
+    -17174, -13079,  12990,   9605, -18095, -14371,  16100,  12005, -21513,  -9227,
+     16842,   6686, -21014,  -2393,  21306,   -237, -19823,   3070,  18458,  -6725,
+    -16881,  10819,  14543,  -9156, -18388,  12391,  16486, -17032, -12937,  20581,
+      8295, -17774,   -846,  20697,  -4486, -21414,   6286,  17458, -13013, -17108,
+     16410,  12315, -21203,  -8917,  17152,    224, -21319,   9460,  13555, -12514,
+    -15899,  17956,   5670, -20399,  -3471,  18072,  -7111, -17267,  10433,  14157,
+    -16314,  -4028,  22041,  -1658, -17046,   8137,  18293, -15562, -11467,  22051,
+      1573, -17048,   6651,  15883, -14896, -10801,  15268,   5112, -22588,   3481,
+     20409, -13446,  -9351,  16718,   -210, -21753,   9026,  13121, -12948,  -9563,
+     18137,   -484, -17412,  10288,  14012, -16459,  -4173,  21896,  -8575, -12670,
+     20848,    370, -18251,   5448,  14680, -16099,  -3813,  22256,  -8215, -12310,
+     13759,   3603, -17940,   7243,  17399, -16456,  -4170,  21899,  -8572, -12667,
+     20851,    373, -18248,  12223,   8128, -17941,   5758,  14990, -15789,  -3503,
+     22566,  -7905, -12000,  21518,   1040, -17581,  12890,   8795, -17274,   6425,
+     15657, -15122,  -2836,  15785, -14686, -10591,  22927,  -5742, -16914,  20328,
+      -150, -18771,  18471,   6185, -19884,  10587,   6492, -19577,  10894,  14989,
+    -18529,   1949,  13121, -17350,   3128,  21749, -15493,  -3207,  22862, -14380,
+    -10285,  23233, -13629,  -9534,  16535,  -7164, -10241,  20538,  -8131, -11855,
+     18616,  -1862, -13034,  17437,  -3041, -14213,  16258,  -4220, -15392,  21850,
+     -6819, -17991,  19251,  -1227, -12399,  18072,  -2406, -13578,  16893,  -3585,
+    -14757,  22485,  -6184,  -9908,  20563,  -8106, -11830,  18641, -10028,  -6304,
+     17395, -16460,  -4174,  14447, -16024,   4454,  15626, -21616,   7053,  10777,
+    -19694,   8975,   5251, -18448,  15407,   3121, -15500,  14971,  -5507, -16679,
+     20563,  -8106, -11830,  18641, -18221,  -5935,  20134, -17108,   3370,  14542,
+    -22700,  14162,   1876, -16745,  20497,     19, -11153,  19318,  -9351,  -5627,
+     18072, -15783,   4695,   8419, -22052,  14810,   2524, -16097,  21145,  -7524,
+    -11248,  19223, -17639,   2839,  14011, -23231,  13631,   1345, -17276,  19966,
+     -8703,  -4979,  18720, -21291,   7378,  11102, -19369,  17493,  -2985, -14157,
+     23085, -13777,  -1491,   9681, -20790,  16072,  -4406, -15578,  21664, -15198,
+     -2912,  15709, -21533,  15329,  -5149,  -8873,  21598, -15264,   5214,   8938,
+    -21533,  15329,  -5149,  -8873,  21598, -15264,   5214,   8938, -14761,  19094,
+     -9575,   1597,  11753, -22102,  14760,  -5718,  -9442,  21029, -15833,  12836,
+      1664, -15264,  18591, -18271,   2207,  13379, -17092,  19770,  -8899,  -5175,
+     11753, -22102,  14760,  -5718,  -9442,  14257, -19598,  17264,  -3214,  -6938,
+     16761, -17094,  11575,    403,  -9753,  17947, -15571,  13098,   1926, -15002,
+     18853, -18009,  10660,   -512, -10668,  17032, -16486,  12183,   1011,  -9145,
+     18555, -22411,  14451,  -6027,  -9751,  13948, -19907,  16955, -11714,   -542,
+      9614, -18086,  22880, -13982,   6496,  10220, -13479,  20376, -16486,  12183,
+      1011,  -9145,  18555, -22411,  14451,  -6027,  -2303,   7853, -19847,  21119,
+    -15743,  12926,   1754,  -8402,  19298, -21668,  15194, -13475,   5146,   8531,
+    -13012,  17767, -19095,  17767,  -2711,  -6435,  10493, -17207,  16311, -20551,
+     10714,  -1572,  -5296,  11632, -22223,  22830, -14032,   6446,  -4726,  -8111,
+     13432, -17347,  19515, -17347,  11322,    150,  -3235,  12153, -18626,  18236,
+    -18626,  10043,  -8578,   1578,  10810, -14373,  16098, -20764,  16098, -12571,
+      6050,   2665,  -6567,  13019, -20049,  16813, -20049,  16813, -11856,   -684,
+      2701, -12687,  18092, -18770,  18092, -18770,   9899,  -8722,   1434,   4511,
+     -9479,  18501, -22465,  22588, -22465,  14397,  -6081,   5091,   1706,  -7526,
+     12060, -15920,  17598, -19264,  17598, -19264,   9405,  -9216,    940,   4017,
+     -9973,  12920, -20935,  15927, -20935,  15927, -12742,  13327, -10372,   5016,
+      2218,  -5412,  10775, -16554,  16964, -19898,  16964, -19898,  16964, -11705,
+     14364,  -9335,   -103,   2695,  -4935,  11252, -11872,  15828, -17690,  19172,
+    -17690,  19172, -17690,  19172, -17690,  10979,  -7642,   2514,   -563,  -3361,
+      9357, -11455,  13728, -16743,  20119, -16743,  20119, -16743,  20119, -16743,
+     20119, -16743,  11926, -14143,   9556,  -5832,   2562,  -5068,   1869,   3971,
+     -5584,   6576, -10796,  10016, -15167,  15304, -13365,  20153, -16709,  20153,
+    -16709,  20153, -16709,  20153, -16709,  20153, -16709,  20153, -16709,  20153,
+    -16709,  11960, -14109,   9590, -11953,  13230, -10469,  11074,  -8512,   4206,
+     -7356,   3155,  -2578,   2633,  -2104,   2202,  -1713,   -527, -16707, -32768,
+    -30666, -32577, -32768,  -9079,  32767,  32767,  32767,  32767,  32767,  32767,
+     -5388, -32768, -29044, -32429, -32768, -29970, -32513,   2174,  30843,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -32768, -29383, -32460, -32768,   5387,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768,
+    -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589,
+    -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,
+     32767,  32767,  -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,
+     32767,  32767,  32767,  32767,  32767,  32767,  -1920, -30589, -32768, -29383,
+    -32460, -32768, -30225,   4462,  32767,  32767,  32767,  32767,  32767,  32767,
+     -1920, -30589, -32768, -29383, -32460, -32768, -30225,   4462,  32767,  32767,
+     32767,  32767,  32767,  32767,  -1920, -30589, -32768,  -2297,   1798,  -1926,
+      1459,  -1618,   1180,  -1363,    949,  -1153,    758,   -979,    600,   -835,
+       470,   -716,    362,   -618,    273,   -537,    199,   -470,    138,   -415,
+        88,   -369,     46,   -332,     11,   -301,    -17,    241,      7,   -206,
+       -12,    164,      4,   -141,     -9,    111,      2,    -97,     -7,     75,
+         1,    -67,     -6,     50,     -1,     45,      3,    -35,     -1,     30,
+         2,    -24,     -1,     20,      1,    -16,      0,     14,      1,    -11,
+         0,     10,      1,     -7,      0,      6,      0,      5,      0,      4,
+         0,      3,      0,      3,      1,     -1,      1,     -1,      1,      0,
+         1,      0,      1,      0,      1,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,     11,     41,    104,    240,
+       533,   1164,   2521,   5431,   7509,   7131,   6101,   5165,   4313,   3539,
+      2366,   1300,    330,   -903,  -2024,  -3043,  -4235,  -5356,  -4045,  -4926,
+     -5727,  -6746,  -7143,  -7744,  -8291,  -8589,  -8679,  -8761,  -8687,  -8483,
+     -8299,  -7907,  -7346,  -6824,  -6076,  -5380,  -4566,  -3800,  -2706,  -1978,
+      -786,     15,   2200,   3761,   4613,   5387,   6560,   7199,   7781,   7957,
+      8437,   8873,   9005,   8885,   8994,   8696,   8425,   8014,   7492,   6880,
+      6140,   5245,   4404,   3419,   2492,   3333,   2129,   1008,    -11,  -1203,
+     -2324,  -3343,  -4270,  -5111,  -6096,  -6758,  -7599,  -8146,  -8643,  -8914,
+     -9325,  -9399,  -9331,  -9270,  -9102,  -8745,  -8328,  -7711,  -7136,  -6016,
+     -3613,  -2583,  -1647,   -795,    -21,    682,   1748,   2718,   3599,   4400,
+      5419,   6081,   6682,   7229,   7726,   7997,   8243,   8317,   8385,   8201,
+      7921,   7564,   8258,   8556,   7923,   7019,   6178,   5412,   4318,   3299,
+      2107,    986,    -33,  -1225,  -2346,  -3365,  -4292,  -5375,  -6394,  -7056,
+     -7897,  -8444,  -8941,  -9393,  -9804, -10027,  -9007,  -7988,  -7856,  -7496,
+     -7168,  -6671,  -6038,  -5463,  -4642,  -3876,  -2981,  -2140,  -1155,   -228,
+       613,   1598,   2525,   3366,   4132,   5027,   5628,   6175,   6871,   8228,
+      9586,   9762,   9602,   9747,   9350,   9176,   8816,   8269,   7573,   6940,
+      6036,   5195,   4210,   3283,   2200,   1181,    -11,  -1132,  -2443,  -3324,
+     -4445,  -5464,  -6391,  -5308,  -6036,  -6698,  -7299,  -7846,  -8144,  -8415,
+     -8661,  -8735,  -8531,  -8347,  -8067,  -7608,  -7053,  -6531,  -5783,  -4888,
+     -4047,  -3281,  -2386,  -1303,   -575,    617,   3020,   4050,   4986,   5838,
+      6612,   7315,   7954,   8148,   8676,   8836,   8981,   9113,   8993,   8665,
+      8367,   7915,   7340,   6668,   5854,   5088,   4193,   3110,   2091,    899,
+      2020,    709,   -172,  -1293,  -2604,  -3485,  -4606,  -5334,  -6261,  -7102,
+     -7649,  -8146,  -8598,  -9009,  -9232,  -9300,  -9239,  -9071,  -8816,  -8493,
+     -8030,  -7475,  -6803,  -5989,  -4347,  -2235,  -1383,   -609,    564,   1203,
+      2173,   3054,   4175,   4903,   5565,   6406,   6953,   7450,   7902,   8148,
+      8371,   8439,   8378,   8210,   7955,   7538,   7033,   8053,   7617,   6955,
+      6114,   5129,   3937,   2816,   1797,    870,   -453,  -1334,  -2455,  -3766,
+     -4647,  -5448,  -6467,  -7394,  -7995,  -8542,  -9039,  -9491,  -9737,  -9960,
+     -9892,  -8967,  -7775,  -7295,  -6859,  -6462,  -5861,  -5095,  -4399,  -3585,
+     -2600,  -1673,   -832,    153,   1080,   2163,   2891,   3818,   4659,   5425,
+      5922,   6555,   6966,   7339,   8359,   9670,   9846,   9686,   9541,   9144,
+      8784,   8018,   7521,   6707,   5941,   4847,   3828,   2901,   1818,    799,
+      -393,  -1514,  -2533,  -3725,  -4846,  -5574,  -6501,  -7584,  -6273,  -6801,
+     -7602,  -8038,  -8170,  -8530,  -8639,  -8540,  -8450,  -8204,  -7831,  -7355,
+     -6800,  -6128,  -5314,  -4548,  -3653,  -2812,  -1827,   -900,    -59,    926,
+      1853,   3657,   5464,   6167,   7233,   7815,   7991,   8471,   8907,   9039,
+      9159,   9050,   8951,   8680,   8269,   7747,   7135,   6560,   5739,   4754,
+      3827,   2744,   1725,    798,   -525,    356,   -765,  -1784,  -2711,  -3794,
+     -4813,  -5740,  -6581,  -7128,  -7824,  -8276,  -8687,  -9060,  -9128,  -9189,
+     -9133,  -8980,  -8657,  -8194,  -7763,  -7146,  -6406,  -5710,  -4353,  -1831,
+      -801,    135,    987,   1761,   2934,   3573,   4543,   5424,   5904,   6632,
+      7294,   7654,   8201,   8300,   8571,   8489,   8415,   8211,   7903,   7511,
+      6950,   6278,   7454,   6653,   5634,   4707,   3866,   2662,   1541,    522,
+      -670,  -1791,  -2810,  -4002,  -4803,  -5822,  -6749,  -7350,  -8116,  -8613,
+     -9065,  -9476,  -9699,  -9767,  -9828,  -8987,  -7423,  -7210,  -6628,  -6100,
+     -5299,  -4863,  -3936,  -3095,  -2110,  -1183,   -342,    643,   1570,   2411,
+      3396,   4323,   4924,   5690,   6386,   6838,   7249,   7622,   7826,   8751,
+      9943,   9783,   9347,   9215,   8614,   8067,   7371,   6557,   5572,   4645,
+      3562,   2543,   1616,    533,   -778,  -1659,  -2780,  -4091,  -4972,  -6093,
+     -6821,  -7748,  -8349,  -6926,  -7508,  -8036,  -8196,  -8341,  -8473,  -8353,
+     -8244,  -7946,  -7494,  -7083,  -6411,  -5778,  -5038,  -4143,  -3302,  -2317,
+     -1390,   -549,    436,   1363,   2204,   3189,   5176,   6596,   7370,   8073,
+      8286,   8868,   9044,   9204,   9349,   9217,   9097,   8769,   8272,   7639,
+      7064,   6243,   5477,   4582,   3499,   2480,   1553,    470,   -841,  -1722,
+      -921,  -1940,  -3132,  -3933,  -4952,  -5879,  -6720,  -7267,  -7963,  -8415,
+     -8661,  -9034,  -9102,  -9041,  -8985,  -8730,  -8407,  -7944,  -7389,  -6717,
+     -6084,  -5344,  -4449,  -2645,   -838,    335,   1401,   2371,   3252,   4053,
+      4781,   5708,   6309,   7075,   7572,   8024,   8270,   8493,   8561,   8622,
+      8454,   8199,   7876,   7413,   6735,   6102,   5362,   6456,   5437,   4510,
+      3427,   2408,   1216,     95,   -924,  -2116,  -3237,  -4256,  -5183,  -6024,
+     -6790,  -7685,  -8286,  -8833,  -9131,  -9402,  -9648,  -9722,  -9654,  -9470,
+     -8629,  -6825,  -6567,  -5864,  -5225,  -4255,  -3374,  -2573,  -1845,   -918,
+       165,   1184,   2111,   2952,   3718,   4613,   5454,   6001,   6697,   7149,
+      7560,   7783,   7987,   8048,   8889,   9730,   9402,   9104,   8471,   7896,
+      7075,   6309,   5414,   4331,   3312,   2385,   1302,     -9,   -890,  -2011,
+     -3202,  -4221,  -5148,  -6231,  -6959,  -7886,  -8487,  -7064,  -7646,  -7822,
+     -8302,  -8447,  -8315,  -8195,  -8086,  -7788,  -7336,  -6761,  -6089,  -5456,
+     -4552,  -3711,  -2945,  -2050,   -967,     52,    979,   1820,   2586,   3481,
+      4322,   5964,   7606,   8245,   8827,   9003,   9163,   9308,   9440,   9320,
+      8992,   8694,   8242,   7502,   6806,   6173,   5269,   4428,   3224,   2423,
+      1112,    231,   -890,  -2201,  -1320,  -2441,  -3460,  -4387,  -5228,  -5994,
+     -6889,  -7490,  -8037,  -8335,  -8787,  -8869,  -8943,  -9011,  -8827,  -8547,
+     -8190,  -7681,  -7069,  -6494,  -5673,  -4907,  -4012,  -3171,  -1529,    583,
+      2003,   2777,   3480,   4546,   5128,   6009,   6810,   7246,   7908,   8268,
+      8596,   8695,   8785,   8703,   8480,   8140,   7832,   7215,   6640,   5968,
+      5154,   6139,   5212,   4129,   3110,   2183,    860,    -21,  -1142,  -2453,
+     -3334,  -4455,  -5474,  -6136,  -6977,  -7743,  -8240,  -8873,  -9284,  -9507,
+     -9575,  -9636,  -9580,  -9325,  -9002,  -8371,  -7014,  -5268,  -4565,  -3926,
+     -2956,  -2075,  -1274,   -255,    672,   1513,   2498,   3425,   4266,   5032,
+      5728,   6361,   6936,   7309,   7649,   7957,   8125,
+};
+
+#endif
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成 audio_bench 的参考向量 audio_vectors.h
+
+参考解码结果来自 Python 标准库的 audioop(CPython 的 C 实现，Python 3.13 起已移除，需用 3.12 及以前的版本运行):
+    mu-law   全部256个码 audioop.ulaw2lin
+    ADPCM    测试信号按 WAV IMA-ADPCM 块格式编码(块头 + 低4位在前)，每块用 audioop.lin2adpcm 编码、
+             audioop.adpcm2lin 解码得到参考输出。信号包含扫频、满幅跳变(预测值钳位)、静音(步长索引降到0)
+             和最后一个不完整的块
+
+用法:
+    gen_vectors.py > audio_vectors.h
+"""
+
+import audioop
+import math
+import struct
+
+BLOCK_ALIGN = 256
+BLOCKS = 6
+PARTIAL = 77
+
+
+def signal(n):
+    out = []
+    for i in range(n):
+        if i < n // 3:
+            # 扫频 100Hz - 6kHz
+            f = 100 + 5900 * i / (n // 3)
+            v = 20000 * math.sin(2 * math.pi * f * i / 24000)
+        elif i < n // 2:
+            # 满幅方波，步长索引升到最大，预测值撞到上下限
+            v = 32767 if (i // 7) % 2 else -32768
+        elif i < n * 2 // 3:
+            v = 0
+        else:
+            v = 9000 * math.sin(2 * math.pi * 440 * i / 24000) + ((i * 7919) % 2001 - 1000)
+        out.append(max(-32768, min(32767, int(v))))
+    return out
+
+
+def swap_nibbles(data):
+    return bytes(((b & 0x0f) << 4) | (b >> 4) for b in data)
+
+
+def adpcm_blocks(samples):
+    spb = (BLOCK_ALIGN - 4) * 2 + 1
+    encoded = b''
+    decoded = []
+    index = 0
+    pos = 0
+    sizes = [BLOCK_ALIGN] * BLOCKS + [PARTIAL]
+    for size in sizes:
+        count = (size - 4) * 2 + 1
+        block = samples[pos:pos + count]
+        pos += count
+        first = block[0]
+        data, (_, next_index) = audioop.lin2adpcm(struct.pack('<%dh' % (count - 1), *block[1:]), 2, (first, index))
+        ref = audioop.adpcm2lin(data, 2, (first, index))[0]
+        encoded += struct.pack('<hBB', first, index, 0) + swap_nibbles(data)
+        decoded += [first] + list(struct.unpack('<%dh' % (count - 1), ref))
+        index = next_index
+    assert pos <= len(samples) and spb * BLOCKS <= pos
+    return encoded, decoded
+
+
+def c_array(ctype, name, values, per_line, fmt):
+    lines = ['static const %s %s[%d] = {' % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(fmt % v for v in values[i:i + per_line]) + ',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def main():
+    mulaw = struct.unpack('<256h', audioop.ulaw2lin(bytes(range(256)), 2))
+    samples = signal((BLOCK_ALIGN - 4) * 2 * (BLOCKS + 1) + BLOCKS + 1)
+    encoded, decoded = adpcm_blocks(samples)
+    print('/* 由 gen_vectors.py 生成，不要手改 */')
+    print('#ifndef __AUDIO_VECTORS_H__')
+    print('#define __AUDIO_VECTORS_H__')
+    print()
+    print('#include <stdint.h>')
+    print()
+    print('#define ADPCM_VECTOR_BLOCK_ALIGN  %d' % BLOCK_ALIGN)
+    print()
+    print('/* audioop.ulaw2lin(range(256)) */')
+    print(c_array('int16_t', 'mulaw_ref', mulaw, 8, '%6d'))
+    print()
+    print('/* %d 块 + %d 字节的不完整块，单声道 */' % (BLOCKS, PARTIAL))
+    print(c_array('uint8_t', 'adpcm_vector', encoded, 16, '0x%02x'))
+    print()
+    print('/* audioop.adpcm2lin 逐块解码，块头采样在前 */')
+    print(c_array('int16_t', 'adpcm_ref', decoded, 10, '%6d'))
+    print()
+    print('#endif')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,174 @@
+/**
+ * audio_mix 主机端正确性测试和基准测试
+ * 先检查混音运算: 增益为1时输出与输入逐采样相同，固定增益和渐变的结果与按定义逐采样计算的相同，
+ * 渐变最后一个采样正好是目标增益，多个满幅声部相加时饱和到16位而不是回绕;
+ * 再按 main/config.h 的 AUDIO_MIXER_BLOCK 分块混合1秒24kHz音频，声部数从1到 MAX_VOICES，
+ * 分别计时固定增益和渐变，输出每块和每个声部每个采样的CPU周期数(x86 用 rdtsc，其他平台只有时间)，
+ * 每增加一个声部的耗时应当基本不变(线性增长)。
+ * 用法: mixer_bench [每种声部数最少计时毫秒数，默认100]
+ * 结果不对时返回1
+ */
+#include "audio_mix.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC   1
+#endif
+
+#define BENCH_RATE      24000
+/* 与 main/config.h 的 AUDIO_MIXER_BLOCK 相同 */
+#define BENCH_BLOCK     256
+#define MAX_VOICES      8
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void noise(int16_t * buf, size_t n)
+{
+    for(size_t i = 0; i < n; i++) buf[i] = (int16_t)(rand() & 0xffff);
+}
+
+static int check(const char * name, const int16_t * got, const int16_t * expect, size_t n)
+{
+    for(size_t i = 0; i < n; i++) {
+        if(got[i] != expect[i]) {
+            printf("%s: sample %zu is %d, expect %d\n", name, i, got[i], expect[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int correctness(void)
+{
+    int fail = 0;
+    int16_t in[BENCH_BLOCK];
+    int16_t out[BENCH_BLOCK];
+    int16_t expect[BENCH_BLOCK];
+    int32_t acc[BENCH_BLOCK];
+    noise(in, BENCH_BLOCK);
+
+    memset(acc, 0, sizeof(acc));
+    audio_mix_add(acc, in, BENCH_BLOCK, AUDIO_MIX_UNITY, AUDIO_MIX_UNITY);
+    audio_mix_out(acc, out, BENCH_BLOCK);
+    fail |= check("unity", out, in, BENCH_BLOCK);
+
+    int32_t gains[] = {0, 1, 12345, AUDIO_MIX_UNITY / 4, AUDIO_MIX_UNITY - 1, AUDIO_MIX_UNITY + 1, AUDIO_MIX_MAX_GAIN};
+    for(size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+        memset(acc, 0, sizeof(acc));
+        audio_mix_add(acc, in, BENCH_BLOCK, gains[g], gains[g]);
+        audio_mix_out(acc, out, BENCH_BLOCK);
+        for(int i = 0; i < BENCH_BLOCK; i++) {
+            int32_t v = (in[i] * gains[g]) >> 15;
+            expect[i] = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+        }
+        fail |= check("gain", out, expect, BENCH_BLOCK);
+    }
+
+    /* 渐变: 增益逐采样单调变化，最后一个采样是目标增益 */
+    int32_t ramps[][2] = {{0, AUDIO_MIX_UNITY}, {AUDIO_MIX_UNITY, 0}, {AUDIO_MIX_UNITY / 4, AUDIO_MIX_UNITY},
+                          {0, AUDIO_MIX_MAX_GAIN}, {AUDIO_MIX_MAX_GAIN, 1}};
+    int16_t ones[BENCH_BLOCK];
+    for(int i = 0; i < BENCH_BLOCK; i++) ones[i] = 16384;
+    for(size_t r = 0; r < sizeof(ramps) / sizeof(ramps[0]); r++) {
+        for(size_t n = 1; n <= BENCH_BLOCK; n += n < 8 ? 1 : 37) {
+            memset(acc, 0, sizeof(acc));
+            audio_mix_add(acc, ones, n, ramps[r][0], ramps[r][1]);
+            int dir = ramps[r][1] > ramps[r][0] ? 1 : -1;
+            for(size_t i = 1; i < n; i++) {
+                if((acc[i] - acc[i - 1]) * dir < 0) {
+                    printf("ramp %d->%d n %zu: not monotonic at %zu\n", ramps[r][0], ramps[r][1], n, i);
+                    fail = 1;
+                    break;
+                }
+            }
+            if(acc[n - 1] != (16384 * ramps[r][1]) >> 15) {
+                printf("ramp %d->%d n %zu: last %d\n", ramps[r][0], ramps[r][1], n, acc[n - 1]);
+                fail = 1;
+            }
+        }
+    }
+
+    /* 两个满幅声部: 饱和 */
+    for(int i = 0; i < BENCH_BLOCK; i++) {
+        in[i] = i & 1 ? INT16_MIN : INT16_MAX;
+        expect[i] = in[i];
+    }
+    memset(acc, 0, sizeof(acc));
+    audio_mix_add(acc, in, BENCH_BLOCK, AUDIO_MIX_UNITY, AUDIO_MIX_UNITY);
+    audio_mix_add(acc, in, BENCH_BLOCK, AUDIO_MIX_MAX_GAIN, AUDIO_MIX_MAX_GAIN);
+    audio_mix_out(acc, out, BENCH_BLOCK);
+    fail |= check("saturate", out, expect, BENCH_BLOCK);
+
+    printf("correctness: unity, %zu gains, %zu ramps, saturation: %s\n", sizeof(gains) / sizeof(gains[0]),
+           sizeof(ramps) / sizeof(ramps[0]), fail ? "FAIL" : "ok");
+    return fail;
+}
+
+/* 和 audio_mixer.c 的混音任务一样: 清零、逐个声部累加、饱和输出，返回每块的周期数(没有 rdtsc 时为纳秒) */
+static double bench(int voices, int ramp, double min_sec)
+{
+    static int16_t in[MAX_VOICES][BENCH_RATE];
+    static int16_t out[BENCH_BLOCK];
+    static int32_t acc[BENCH_BLOCK];
+    for(int v = 0; v < voices; v++) noise(in[v], BENCH_RATE);
+    uint64_t blocks = 0;
+    volatile int16_t sink = 0;
+    double start = now_sec();
+    uint64_t start_cycles = cycles();
+    double elapsed;
+    do {
+        for(size_t pos = 0; pos + BENCH_BLOCK <= BENCH_RATE; pos += BENCH_BLOCK) {
+            memset(acc, 0, sizeof(acc));
+            for(int v = 0; v < voices; v++) {
+                int32_t from = ramp ? (int32_t)((blocks + v) * 97 % AUDIO_MIX_UNITY) : AUDIO_MIX_UNITY / 2;
+                int32_t to = ramp ? (int32_t)((blocks + v + 1) * 97 % AUDIO_MIX_UNITY) : AUDIO_MIX_UNITY / 2;
+                audio_mix_add(acc, in[v] + pos, BENCH_BLOCK, from, to);
+            }
+            audio_mix_out(acc, out, BENCH_BLOCK);
+            sink ^= out[0];
+            blocks++;
+        }
+        elapsed = now_sec() - start;
+    } while(elapsed < min_sec);
+    uint64_t total_cycles = cycles() - start_cycles;
+    (void)sink;
+    return total_cycles ? (double)total_cycles / blocks : elapsed / blocks * 1e9;
+}
+
+int main(int argc, char ** argv)
+{
+    double min_sec = (argc > 1 ? atoi(argv[1]) : 100) / 1000.0;
+    srand(1);
+    if(correctness()) {
+        return 1;
+    }
+    const char * unit = cycles() ? "cycles" : "ns";
+    printf("voices  const %s/block  per voice-sample  ramp %s/block  per voice-sample\n", unit, unit);
+    for(int voices = 1; voices <= MAX_VOICES; voices++) {
+        printf("%6d", voices);
+        for(int ramp = 0; ramp < 2; ramp++) {
+            double per_block = bench(voices, ramp, min_sec);
+            printf("  %17.0f  %16.2f", per_block, per_block / voices / BENCH_BLOCK);
+        }
+        printf("\n");
+    }
+    return 0;
+}
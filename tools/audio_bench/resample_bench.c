@@ -0,0 +1,305 @@
+/**
+ * audio_resample 主机端精度测试和基准测试
+ * 把 8k/16k/22.05k/44.1k/48k 的正弦波转换到24kHz(与 main/config.h 的 SPK_SAMPLE_RATE 相同)，
+ * 对每个输入采样率检查:
+ *   THD+N: 输出减去最小二乘拟合的同频正弦后的残差能量与正弦能量之比，要低于 MAX_THDN_DB;
+ *   与浮点参考的误差: 同样的 Kaiser 窗 sinc 多相滤波器用 double 系数和 double 运算，
+ *   定点实现(Q15系数、32位累加、16位输出)与它的差要低于 MAX_REF_ERR_DB;
+ *   随机切开输入和输出空间(模拟播放任务分块)，输出与一次转换逐采样一致。
+ * 立体声在播放任务中先混成单声道再重采样，精度与单声道相同，端到端由 tools/host/audio_check.py 检查。
+ * 再计时转换1秒音频，输出每个输出采样的CPU周期数(x86 用 rdtsc，其他平台只有时间)，
+ * 主机CPU比ESP32-S3快得多，只能看各采样率之间的相对值。
+ * 用法: resample_bench [每个采样率最少计时毫秒数，默认300]
+ * 超出门限或不一致时返回1
+ */
+#include "audio_resample.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC   1
+#endif
+
+#define OUT_RATE        24000
+#define TEST_SECONDS    1
+#define SPLIT_ROUNDS    50
+#define MAX_THDN_DB     (-70.0)
+#define MAX_REF_ERR_DB  (-80.0)
+/* 与 main/audio_resample.c 的滤波器参数相同 */
+#define REF_ROLLOFF     0.9
+#define REF_BETA        8.0
+/* 正弦幅度 -1dBFS */
+#define TONE_AMPLITUDE  (0.891 * 32767)
+
+static const uint32_t in_rates[] = {8000, 16000, 22050, 24000, 44100, 48000};
+
+/* 主机上不链接 port/esp_system.c，内存分配直接用 malloc */
+void * heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void heap_caps_free(void * ptr)
+{
+    free(ptr);
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static double bessel_i0(double x)
+{
+    double sum = 1;
+    double term = 1;
+    for(int k = 1; k < 100 && term > sum * 1e-17; k++) {
+        term *= (x / 2 / k) * (x / 2 / k);
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * 浮点参考: 直接按定义计算 y[n] = sum_j h[j] * x[(n*M - j) / L]，(n*M - j) 能被 L 整除的项
+ * h 与定点实现一样每个相位归一化到直流增益1
+ */
+static size_t reference(const audio_resample_t * rs, const int16_t * in, size_t in_n, double * out)
+{
+    uint32_t up = rs->up;
+    uint32_t down = rs->down;
+    uint32_t taps = rs->taps;
+    size_t len = (size_t)up * taps;
+    double center = (len - 1) / 2.0;
+    double fc = 0.5 * REF_ROLLOFF / (up > down ? up : down);
+    double * h = malloc(len * sizeof(double));
+    for(size_t j = 0; j < len; j++) {
+        double t = j - center;
+        double x = 2 * fc * t;
+        double sinc = fabs(x) < 1e-12 ? 1 : sin(M_PI * x) / (M_PI * x);
+        double r = 2 * t / (len - 1);
+        h[j] = sinc * bessel_i0(REF_BETA * sqrt(fmax(1 - r * r, 0))) / bessel_i0(REF_BETA);
+    }
+    for(uint32_t p = 0; p < up; p++) {
+        double sum = 0;
+        for(uint32_t k = 0; k < taps; k++) sum += h[p + (size_t)k * up];
+        for(uint32_t k = 0; k < taps; k++) h[p + (size_t)k * up] /= sum;
+    }
+    /* 定点实现移入第 i 个输入后输出 u = i*L + phase，与这里的 n*M 对齐 */
+    size_t out_n = (size_t)((uint64_t)in_n * up / down);
+    for(size_t n = 0; n < out_n; n++) {
+        uint64_t u = (uint64_t)n * down;
+        uint64_t i = u / up;
+        uint32_t p = u % up;
+        double acc = 0;
+        for(uint32_t k = 0; k < taps && k <= i; k++) {
+            acc += h[p + (size_t)k * up] * in[i - k];
+        }
+        out[n] = acc;
+    }
+    free(h);
+    return out_n;
+}
+
+/**
+ * 最小二乘拟合 a*sin + b*cos + c，返回残差与正弦的能量比(dB)
+ */
+static double thdn_db(const int16_t * y, size_t n, double freq)
+{
+    double w = 2 * M_PI * freq / OUT_RATE;
+    double m[3][4] = {{0}};
+    for(size_t i = 0; i < n; i++) {
+        double v[3] = {sin(w * i), cos(w * i), 1};
+        for(int r = 0; r < 3; r++) {
+            for(int c = 0; c < 3; c++) m[r][c] += v[r] * v[c];
+            m[r][3] += v[r] * y[i];
+        }
+    }
+    for(int r = 0; r < 3; r++) {
+        for(int k = r + 1; k < 3; k++) {
+            double f = m[k][r] / m[r][r];
+            for(int c = r; c < 4; c++) m[k][c] -= f * m[r][c];
+        }
+    }
+    double coef[3];
+    for(int r = 2; r >= 0; r--) {
+        double v = m[r][3];
+        for(int c = r + 1; c < 3; c++) v -= m[r][c] * coef[c];
+        coef[r] = v / m[r][r];
+    }
+    double sig = 0;
+    double res = 0;
+    for(size_t i = 0; i < n; i++) {
+        double s = coef[0] * sin(w * i) + coef[1] * cos(w * i);
+        double e = y[i] - s - coef[2];
+        sig += s * s;
+        res += e * e;
+    }
+    return 10 * log10(res / sig);
+}
+
+static size_t convert_split(audio_resample_t * rs, const int16_t * in, size_t in_n, int16_t * out, size_t out_cap,
+                            unsigned max_in, unsigned max_out)
+{
+    audio_resample_reset(rs);
+    size_t i = 0;
+    size_t o = 0;
+    /* 输入用完后最后一个输入对应的输出可能还没取完 */
+    while(o < out_cap) {
+        size_t in_len = max_in ? 1 + rand() % max_in : in_n - i;
+        size_t out_len = max_out ? 1 + rand() % max_out : out_cap - o;
+        in_len = in_len < in_n - i ? in_len : in_n - i;
+        out_len = out_len < out_cap - o ? out_len : out_cap - o;
+        size_t used;
+        size_t n = audio_resample_process(rs, in + i, in_len, &used, out + o, out_len);
+        if(n == 0 && used == 0) {
+            break;
+        }
+        o += n;
+        i += used;
+    }
+    return o;
+}
+
+static int16_t * tone(uint32_t rate, double freq, size_t n)
+{
+    int16_t * in = malloc(n * sizeof(int16_t));
+    for(size_t i = 0; i < n; i++) {
+        in[i] = (int16_t)lrint(TONE_AMPLITUDE * sin(2 * M_PI * freq * i / rate));
+    }
+    return in;
+}
+
+static int accuracy(uint32_t rate)
+{
+    audio_resample_t rs = {0};
+    if(audio_resample_init(&rs, rate, OUT_RATE) != ESP_OK) {
+        printf("%5u Hz: init fail\n", rate);
+        return 1;
+    }
+    int fail = 0;
+    /* 1kHz 和接近通带边缘的频率 */
+    uint32_t low = rate < OUT_RATE ? rate : OUT_RATE;
+    double freqs[] = {1000, 0.35 * low};
+    size_t in_n = rate * TEST_SECONDS;
+    size_t out_cap = (size_t)((uint64_t)in_n * OUT_RATE / rate) + 2;
+    int16_t * out = malloc(out_cap * sizeof(int16_t));
+    int16_t * split = malloc(out_cap * sizeof(int16_t));
+    double * ref = malloc(out_cap * sizeof(double));
+    /* 每个相位 |系数| 和小于2(Q15 的 65536)时32位累加不会溢出 */
+    int32_t max_abs = 0;
+    for(uint32_t p = 0; p < rs.up && rs.taps; p++) {
+        int32_t abs_sum = 0;
+        for(uint32_t k = 0; k < rs.taps; k++) abs_sum += abs(rs.coefs[p * rs.taps + k]);
+        max_abs = abs_sum > max_abs ? abs_sum : max_abs;
+    }
+    fail |= max_abs >= 65536;
+    printf("%5u Hz: L/M %u/%u, %3u taps, |h| %.2f", rate, rs.up, rs.down, rs.taps, max_abs / 32768.0);
+    for(int f = 0; f < 2; f++) {
+        int16_t * in = tone(rate, freqs[f], in_n);
+        size_t n = convert_split(&rs, in, in_n, out, out_cap, 0, 0);
+        /* 跳过开头滤波器填满之前的输出 */
+        size_t skip = rs.taps * OUT_RATE / rate + 1;
+        double thdn = thdn_db(out + skip, n - skip, freqs[f]);
+        double err_db = -INFINITY;
+        if(rs.taps) {
+            size_t ref_n = reference(&rs, in, in_n, ref);
+            double err = 0;
+            double sig = 0;
+            for(size_t i = skip; i < n && i < ref_n; i++) {
+                err += (out[i] - ref[i]) * (out[i] - ref[i]);
+                sig += ref[i] * ref[i];
+            }
+            err_db = 10 * log10(err / sig);
+        }
+        printf(", %5.0f Hz THD+N %6.1f dB ref err %6.1f dB", freqs[f], thdn, err_db);
+        if(thdn > MAX_THDN_DB || err_db > MAX_REF_ERR_DB) {
+            fail = 1;
+        }
+        for(int round = 0; round < SPLIT_ROUNDS && !fail; round++) {
+            size_t m = convert_split(&rs, in, in_n, split, out_cap, round % 2 ? 3 : 997, round % 3 ? 5 : 601);
+            if(m != n || memcmp(split, out, n * sizeof(int16_t)) != 0) {
+                printf(", split round %d differs", round);
+                fail = 1;
+            }
+        }
+        free(in);
+    }
+    printf(": %s\n", fail ? "FAIL" : "ok");
+    free(out);
+    free(split);
+    free(ref);
+    audio_resample_deinit(&rs);
+    return fail;
+}
+
+static void bench(uint32_t rate, double min_sec)
+{
+    audio_resample_t rs = {0};
+    audio_resample_init(&rs, rate, OUT_RATE);
+    size_t in_n = rate;
+    int16_t * in = tone(rate, 1000, in_n);
+    static int16_t out[1024];
+    uint64_t samples = 0;
+    uint32_t runs = 0;
+    volatile int16_t sink = 0;
+    double start = now_sec();
+    uint64_t start_cycles = cycles();
+    double elapsed;
+    do {
+        audio_resample_reset(&rs);
+        size_t i = 0;
+        while(i < in_n) {
+            size_t used;
+            size_t n = audio_resample_process(&rs, in + i, in_n - i, &used, out, sizeof(out) / sizeof(out[0]));
+            sink ^= out[0];
+            samples += n;
+            i += used;
+        }
+        runs++;
+        elapsed = now_sec() - start;
+    } while(elapsed < min_sec);
+    uint64_t total_cycles = cycles() - start_cycles;
+    printf("%5u Hz: %6.1f ns/sample", rate, elapsed / samples * 1e9);
+    if(total_cycles) {
+        printf(", %6.1f cycles/sample, %8.0f cycles/s of audio", (double)total_cycles / samples,
+               (double)total_cycles / samples * OUT_RATE);
+    }
+    printf(" (%u runs)\n", runs);
+    (void)sink;
+    free(in);
+    audio_resample_deinit(&rs);
+}
+
+int main(int argc, char ** argv)
+{
+    double min_sec = (argc > 1 ? atoi(argv[1]) : 300) / 1000.0;
+    int fail = 0;
+    srand(1);
+    for(size_t i = 0; i < sizeof(in_rates) / sizeof(in_rates[0]); i++) {
+        fail |= accuracy(in_rates[i]);
+    }
+    if(fail) {
+        return 1;
+    }
+    for(size_t i = 0; i < sizeof(in_rates) / sizeof(in_rates[0]); i++) {
+        bench(in_rates[i], min_sec);
+    }
+    return 0;
+}
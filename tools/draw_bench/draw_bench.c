@@ -0,0 +1,371 @@
+/**
+ * LVGL 多绘制单元主机端基准测试
+ * 用 pthread 移植和 DRAW_BENCH_UNITS 个绘制线程(见 CMakeLists.txt)播放表情GIF，统计每帧的渲染耗时:
+ *   partial / direct:   d_lcd.c 的两种渲染模式，按屏幕字节序(RGB565_SWAPPED)渲染，表情图像作为一个对象绘制
+ *   partial-s / direct-s: 同上，表情图像按 d_lcd.c 的 lvgl_port_split_draw 竖着切成 LV_DRAW_SW_DRAW_UNIT_CNT 条
+ *            分别提交绘制，多个绘制线程同时画，同一张图像也在多个线程中同时解码
+ * 一个对象只产生一个绘制任务，不切条时多一个绘制单元也快不了，切条后才能比较1个和2个单元的差别。
+ * flush 直接把渲染结果拷贝到假屏显存并马上完成，不模拟SPI，只看渲染; 拷贝的时间不计入。
+ * 每个GIF的第0帧整屏刷新，计入 full 统计，之后每帧像 emoji_gif 一样只标记本帧变化的矩形。
+ * 每次刷新重复几遍取最快的一次，各模式每帧轮流先画。
+ * 每帧把各模式的显存与GIF画布合成到黑色背景上的画面比较，必须逐像素一致。
+ * 输出每帧的墙钟时间(wall)和整个进程的CPU时间(cpu，含所有绘制线程)，最后汇总切条前后的差别。
+ * 主机CPU比ESP32-S3快得多，线程切换的相对开销也不同，只看相对值; 主机只有一个核时多个绘制单元只会多出线程切换的开销。
+ * 用法: draw_bench [gif目录，默认 main/spiffs/gif]
+ * 显存与期望画面不一致时返回1
+ */
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "gif_dec.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LCD_H_RES           240
+#define LCD_V_RES           240
+#define DRAW_BUF_LINES      20
+/* 每个GIF整屏刷新的次数和每帧重复刷新的次数，取最快的一次 */
+#define FULL_REPEAT         8
+#define FRAME_REPEAT        3
+
+#define BENCH_MAX_FILES     64
+#define BENCH_NAME_LEN      64
+
+typedef enum {
+    MODE_PARTIAL,
+    MODE_DIRECT,
+    MODE_PARTIAL_SPLIT,
+    MODE_DIRECT_SPLIT,
+    MODE_CNT,
+} bench_mode_t;
+
+static const char * mode_names[MODE_CNT] = {"partial", "direct", "partial-s", "direct-s"};
+
+typedef struct {
+    double wall_sec;                      /* 渲染的墙钟时间，不含 flush 拷贝 */
+    double cpu_sec;                       /* 进程的CPU时间，不含 flush 拷贝 */
+    uint32_t frames;
+} bench_stats_t;
+
+typedef struct {
+    lv_display_t * disp;
+    lv_obj_t * img;
+    uint8_t * fb[2];
+    uint16_t gram[LCD_H_RES * LCD_V_RES]; /* 假屏显存，与渲染缓冲的字节序相同 */
+    double flush_wall, flush_cpu;         /* 本次刷新中 flush 拷贝的耗时 */
+    bench_stats_t stats;
+    bench_stats_t full;
+} bench_disp_t;
+
+static bench_disp_t bench_disps[MODE_CNT];
+static uint16_t expect[LCD_H_RES * LCD_V_RES];
+
+static double cpu_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void * load_file(const char * path, long * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void * data = malloc(*size);
+    if(data && fread(data, 1, *size, f) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int name_cmp(const void * a, const void * b)
+{
+    return strcmp(a, b);
+}
+
+/* 渲染结果直接拷贝到显存，partial 是连续的区域像素，direct 是整帧缓冲 */
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    double w0 = now_sec(), c0 = cpu_sec();
+    int32_t w = lv_area_get_width(area);
+    bool direct = disp->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT;
+    uint32_t stride = direct ? lv_draw_buf_width_to_stride(LCD_H_RES, LV_COLOR_FORMAT_RGB565_SWAPPED) : w * 2;
+    const uint8_t * px = direct ? px_map + area->y1 * stride + area->x1 * 2 : px_map;
+    for(int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&bd->gram[y * LCD_H_RES + area->x1], px, w * 2);
+        px += stride;
+    }
+    lv_display_flush_ready(disp);
+    bd->flush_wall += now_sec() - w0;
+    bd->flush_cpu += cpu_sec() - c0;
+}
+
+/* 与 d_lcd.c 的 lvgl_split_draw_cb 相同 */
+static void split_draw_cb(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_current_target(e);
+    lv_layer_t * layer = lv_event_get_layer(e);
+    lv_area_t clip = layer->_clip_area;
+    int32_t w = lv_area_get_width(&obj->coords);
+    for(int32_t i = 0; i < LV_DRAW_SW_DRAW_UNIT_CNT; i++) {
+        lv_area_t slice = clip;
+        if(i > 0) slice.x1 = obj->coords.x1 + w * i / LV_DRAW_SW_DRAW_UNIT_CNT;
+        if(i < LV_DRAW_SW_DRAW_UNIT_CNT - 1) slice.x2 = obj->coords.x1 + w * (i + 1) / LV_DRAW_SW_DRAW_UNIT_CNT - 1;
+        if(!lv_area_intersect(&layer->_clip_area, &clip, &slice)) continue;
+        if(lv_obj_event_base(NULL, e) != LV_RESULT_OK) break;
+    }
+    layer->_clip_area = clip;
+    lv_event_stop_processing(e);
+}
+
+static void disp_create(bench_disp_t * bd, bench_mode_t mode)
+{
+    memset(bd, 0, sizeof(*bd));
+    bd->disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    lv_display_set_color_format(bd->disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_user_data(bd->disp, bd);
+    lv_display_set_flush_cb(bd->disp, flush_cb);
+    if(mode == MODE_DIRECT || mode == MODE_DIRECT_SPLIT) {
+        uint32_t fb_size = lv_draw_buf_width_to_stride(LCD_H_RES, LV_COLOR_FORMAT_RGB565_SWAPPED) * LCD_V_RES;
+        bd->fb[0] = malloc(fb_size);
+        bd->fb[1] = malloc(fb_size);
+        lv_display_set_buffers(bd->disp, bd->fb[0], bd->fb[1], fb_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+    }
+    else {
+        uint32_t size = LCD_H_RES * DRAW_BUF_LINES * 2;
+        bd->fb[0] = malloc(size);
+        bd->fb[1] = malloc(size);
+        lv_display_set_buffers(bd->disp, bd->fb[0], bd->fb[1], size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    }
+    /* 与设备一样黑色背景，表情图像居中 */
+    lv_obj_t * scr = lv_display_get_screen_active(bd->disp);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    bd->img = lv_image_create(scr);
+    lv_obj_center(bd->img);
+    if(mode == MODE_PARTIAL_SPLIT || mode == MODE_DIRECT_SPLIT) {
+        lv_obj_add_event_cb(bd->img, split_draw_cb, LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS, NULL);
+    }
+}
+
+/**
+ * 同一个区域重复刷新 repeat 次，只把最快的一次计入 st，减少调度和其它进程的干扰
+ * @param area 表情图像上的区域(绝对坐标)，NULL为整屏
+ */
+static void disp_refresh(bench_disp_t * bd, const lv_area_t * area, int repeat, bench_stats_t * st)
+{
+    double best_wall = 0, best_cpu = 0;
+    for(int i = 0; i < repeat; i++) {
+        if(area) lv_obj_invalidate_area(bd->img, area);
+        else lv_obj_invalidate(lv_display_get_screen_active(bd->disp));
+        bd->flush_wall = bd->flush_cpu = 0;
+        double w0 = now_sec(), c0 = cpu_sec();
+        lv_refr_now(bd->disp);
+        double wall = now_sec() - w0 - bd->flush_wall;
+        double cpu = cpu_sec() - c0 - bd->flush_cpu;
+        if(i == 0 || wall < best_wall) {
+            best_wall = wall;
+            best_cpu = cpu;
+        }
+    }
+    st->wall_sec += best_wall;
+    st->cpu_sec += best_cpu;
+    st->frames++;
+}
+
+/* 画布合成到黑色背景上的期望画面 */
+static void expect_update(const gif_dec_t * gif, lv_obj_t * img)
+{
+    lv_area_t coords;
+    lv_obj_update_layout(img);
+    lv_obj_get_coords(img, &coords);
+    memset(expect, 0, sizeof(expect));
+    const uint16_t * color = (const uint16_t *)gif->canvas;
+    const uint8_t * alpha = gif->canvas + gif->width * gif->height * 2;
+    for(int32_t y = LV_MAX(coords.y1, 0); y <= LV_MIN(coords.y2, LCD_V_RES - 1); y++) {
+        for(int32_t x = LV_MAX(coords.x1, 0); x <= LV_MIN(coords.x2, LCD_H_RES - 1); x++) {
+            uint32_t i = (y - coords.y1) * gif->width + x - coords.x1;
+            uint16_t c = color[i];
+            /* RGB565A8 画布是本机字节序，GIF的透明只有全透明和不透明 */
+            if(gif->cf == LV_COLOR_FORMAT_RGB565A8) c = alpha[i] ? (uint16_t)(c << 8 | c >> 8) : 0;
+            expect[y * LCD_H_RES + x] = c;
+        }
+    }
+}
+
+static void canvas_dsc_init(lv_image_dsc_t * dsc, const gif_dec_t * gif)
+{
+    memset(dsc, 0, sizeof(*dsc));
+    dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc->header.flags = LV_IMAGE_FLAGS_MODIFIABLE;
+    dsc->header.cf = gif->cf;
+    dsc->header.w = gif->width;
+    dsc->header.h = gif->height;
+    dsc->header.stride = gif->width * gif_dec_canvas_bpp(gif);
+    dsc->data_size = gif_dec_canvas_size(gif);
+    dsc->data = gif->canvas;
+}
+
+/**
+ * 各模式同时播放一个GIF，返回帧数，显存与期望画面不一致返回-1
+ */
+static int play(const char * name, const void * data)
+{
+    static lv_image_dsc_t dsc;
+    gif_dec_t * gif = gif_dec_open_data(data, LV_COLOR_FORMAT_RGB565_SWAPPED, NULL, 0);
+    if(gif == NULL) {
+        printf("%s: open failed\n", name);
+        return -1;
+    }
+    canvas_dsc_init(&dsc, gif);
+    for(int m = 0; m < MODE_CNT; m++) {
+        memset(&bench_disps[m].stats, 0, sizeof(bench_stats_t));
+        lv_image_set_src(bench_disps[m].img, &dsc);
+    }
+
+    int frames = 0;
+    while(1) {
+        /* 与 emoji_gif 的 decode_frame 相同: 本帧矩形，上一帧需要恢复背景或恢复到之前时并上上一帧矩形 */
+        lv_area_t prev = {gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1};
+        bool prev_restored = gif->gce.disposal == 2 || gif->gce.disposal == 3;
+        if(gif_dec_get_frame(gif) <= 0) break;
+        gif->loop_count = 1;
+        gif_dec_render_frame(gif, gif->canvas);
+        lv_area_t area = {gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1};
+        if(prev_restored) lv_area_join(&area, &area, &prev);
+        lv_image_cache_drop(&dsc);
+        expect_update(gif, bench_disps[0].img);
+
+        /* 各模式轮流先画，缓存的影响不会都落在同一个模式上 */
+        for(int i = 0; i < MODE_CNT; i++) {
+            bench_disp_t * bd = &bench_disps[(frames + i) % MODE_CNT];
+            if(frames == 0) {
+                disp_refresh(bd, NULL, FULL_REPEAT, &bd->full);
+                continue;
+            }
+            lv_area_t coords, abs_area = area;
+            lv_obj_get_coords(bd->img, &coords);
+            lv_area_move(&abs_area, coords.x1, coords.y1);
+            disp_refresh(bd, &abs_area, FRAME_REPEAT, &bd->stats);
+        }
+        for(int m = 0; m < MODE_CNT; m++) {
+            if(memcmp(bench_disps[m].gram, expect, sizeof(expect)) != 0) {
+                printf("%s: frame %d of %s differs from the canvas\n", name, frames, mode_names[m]);
+                frames = -1;
+                goto out;
+            }
+        }
+        frames++;
+    }
+out:
+    gif_dec_close(gif);
+    for(int m = 0; m < MODE_CNT; m++) lv_image_set_src(bench_disps[m].img, NULL);
+    return frames;
+}
+
+static void print_row(const char * name, bench_mode_t mode, const bench_stats_t * st)
+{
+    printf("%-16s %-10s %6lu %9.1f %9.1f\n", name, mode_names[mode], (unsigned long)st->frames,
+           st->wall_sec * 1e6 / st->frames, st->cpu_sec * 1e6 / st->frames);
+}
+
+static void stats_add(bench_stats_t * dst, const bench_stats_t * src)
+{
+    dst->wall_sec += src->wall_sec;
+    dst->cpu_sec += src->cpu_sec;
+    dst->frames += src->frames;
+}
+
+/* 切条前后每帧的墙钟时间和CPU时间 */
+static void split_summary(const char * what, const bench_stats_t * st)
+{
+    for(int m = MODE_PARTIAL_SPLIT; m <= MODE_DIRECT_SPLIT; m++) {
+        const bench_stats_t * off = &st[m - MODE_PARTIAL_SPLIT];
+        const bench_stats_t * on = &st[m];
+        double off_wall = off->wall_sec * 1e6 / off->frames, on_wall = on->wall_sec * 1e6 / on->frames;
+        double off_cpu = off->cpu_sec * 1e6 / off->frames, on_cpu = on->cpu_sec * 1e6 / on->frames;
+        printf("%s %s: wall %.1f -> %.1f us/frame (%.1f%%), cpu %.1f -> %.1f us/frame (%.1f%%)\n",
+               mode_names[m], what, off_wall, on_wall, (on_wall - off_wall) * 100 / off_wall,
+               off_cpu, on_cpu, (on_cpu - off_cpu) * 100 / off_cpu);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    const char * dir_path = argc > 1 ? argv[1] : "main/spiffs/gif";
+    static char names[BENCH_MAX_FILES][BENCH_NAME_LEN];
+    int name_cnt = 0;
+
+    DIR * dir = opendir(dir_path);
+    if(dir == NULL) {
+        printf("open %s failed\n", dir_path);
+        return 1;
+    }
+    struct dirent * ent;
+    while((ent = readdir(dir)) != NULL && name_cnt < BENCH_MAX_FILES) {
+        size_t len = strlen(ent->d_name);
+        if(len > 4 && len < BENCH_NAME_LEN && strcmp(&ent->d_name[len - 4], ".gif") == 0) {
+            strcpy(names[name_cnt++], ent->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, name_cnt, BENCH_NAME_LEN, name_cmp);
+
+    lv_init();
+    for(int m = 0; m < MODE_CNT; m++) disp_create(&bench_disps[m], m);
+
+    printf("draw units: %d\n", LV_DRAW_SW_DRAW_UNIT_CNT);
+    printf("%-16s %-10s %6s %9s %9s\n", "file", "mode", "frames", "wall us/f", "cpu us/f");
+    bench_stats_t total[MODE_CNT] = {0};
+    int fail = 0;
+    for(int i = 0; i < name_cnt; i++) {
+        char path[512];
+        long size;
+        snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+        void * data = load_file(path, &size);
+        if(data == NULL) {
+            printf("%s: read failed\n", names[i]);
+            fail = 1;
+            continue;
+        }
+        int frames = play(names[i], data);
+        free(data);
+        if(frames <= 1) {
+            fail |= frames < 0;
+            continue;
+        }
+        for(int m = 0; m < MODE_CNT; m++) {
+            print_row(names[i], m, &bench_disps[m].stats);
+            stats_add(&total[m], &bench_disps[m].stats);
+        }
+    }
+    if(total[0].frames > 0) {
+        for(int m = 0; m < MODE_CNT; m++) print_row("total", m, &total[m]);
+        bench_stats_t full[MODE_CNT];
+        for(int m = 0; m < MODE_CNT; m++) {
+            full[m] = bench_disps[m].full;
+            print_row("full", m, &full[m]);
+        }
+        split_summary("animation", total);
+        split_summary("full-screen", full);
+    }
+    printf("%s\n", fail ? "FAIL: panel content differs from the GIF canvas"
+           : "all modes produce the GIF canvas on a black background");
+    lv_deinit();
+    return fail;
+}
@@ -0,0 +1,20 @@
+/**
+ * draw_bench 使用的 LVGL 配置: 与设备一样用操作系统移植(这里是 pthread)，
+ * 软件绘制在 DRAW_BENCH_UNITS 个绘制线程中进行(见 CMakeLists.txt)，其余取默认值
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_USE_OS                   LV_OS_PTHREAD
+#define LV_USE_LOG                  0
+
+#ifndef DRAW_BENCH_UNITS
+#define DRAW_BENCH_UNITS            2
+#endif
+#define LV_DRAW_SW_DRAW_UNIT_CNT    DRAW_BENCH_UNITS
+
+#endif
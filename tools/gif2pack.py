@@ -0,0 +1,333 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+GIF -> RGB565 帧包转换工具
+
+在编译期把 spiffs/gif/*.gif 预先解码成 RGB565 帧包(.epk)，设备端直接把像素拷贝到画布，
+不再运行 LZW 解码。每一帧只保存相对上一帧发生变化的矩形区域。
+
+帧包格式(小端):
+    头部      16 字节   magic "EPK1", u16 width, u16 height, u16 frame_count,
+                        u16 flags, u32 max_frame_size(最大一帧的数据字节数)
+              flags 含 PACK_SWAPPED 时像素为高字节在前(RGB565_SWAPPED)
+    帧表      frame_count * 20 字节
+                        u16 x, u16 y, u16 w, u16 h, u16 delay_ms, u16 flags,
+                        u32 offset(相对文件开头), u32 size
+    像素数据  每帧 w * h 个 RGB565 像素，按行连续存储。默认按 SPI 屏的字节序(高字节在前)保存，
+              设备端画布与屏幕同为 RGB565_SWAPPED，绘制时不再交换；--native 输出 LVGL 原生字节序。
+              flags 含 PACK_FRAME_RLE 时为 RLE 编码:
+                  ctrl(u8) & 0x80  -> 后面 1 个像素重复 (ctrl & 0x7F) + 1 次
+                  否则             -> 后面 ctrl + 1 个像素原样拷贝
+
+第 0 帧总是覆盖整幅画面；之后的帧若与上一帧完全相同，则 w = h = 0，只保留延时。
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+PACK_MAGIC = b'EPK1'
+PACK_HEADER = struct.Struct('<4sHHHHI')
+PACK_FRAME = struct.Struct('<HHHHHHII')
+PACK_FRAME_RLE = 0x0001
+PACK_SWAPPED = 0x0001
+PACK_RUN_MAX = 128
+
+
+class GifError(Exception):
+    pass
+
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        if self.pos >= len(self.data):
+            raise GifError('unexpected end of file')
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def u16(self):
+        return self.u8() | (self.u8() << 8)
+
+    def bytes(self, n):
+        if self.pos + n > len(self.data):
+            raise GifError('unexpected end of file')
+        v = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return v
+
+    def sub_blocks(self):
+        out = bytearray()
+        while True:
+            n = self.u8()
+            if n == 0:
+                return bytes(out)
+            out += self.bytes(n)
+
+
+def lzw_decode(data, min_size, count):
+    """标准 GIF LZW 解码，返回 count 个调色板索引"""
+    clear = 1 << min_size
+    stop = clear + 1
+    size = min_size + 1
+    prefix = [0] * 4096
+    suffix = [0] * 4096
+    first = [0] * 4096
+    for i in range(clear):
+        suffix[i] = i
+        first[i] = i
+    avail = clear + 2
+    old = -1
+    out = bytearray()
+    bits = 0
+    nbits = 0
+    pos = 0
+    while len(out) < count:
+        while nbits < size:
+            if pos >= len(data):
+                return out + bytes(count - len(out))
+            bits |= data[pos] << nbits
+            pos += 1
+            nbits += 8
+        code = bits & ((1 << size) - 1)
+        bits >>= size
+        nbits -= size
+        if code == clear:
+            size = min_size + 1
+            avail = clear + 2
+            old = -1
+            continue
+        if code == stop:
+            break
+        if old < 0:
+            out.append(suffix[code])
+            old = code
+            continue
+        in_code = code
+        stack = bytearray()
+        if code >= avail:
+            stack.append(first[old])
+            code = old
+        while code >= clear:
+            stack.append(suffix[code])
+            code = prefix[code]
+        stack.append(code)
+        stack.reverse()
+        out += stack
+        if avail < 4096:
+            prefix[avail] = old
+            suffix[avail] = code
+            first[avail] = first[old]
+            avail += 1
+            if avail == (1 << size) and size < 12:
+                size += 1
+        old = in_code
+    if len(out) < count:
+        out += bytes(count - len(out))
+    return out[:count]
+
+
+def deinterlace(pixels, w, h):
+    rows = [pixels[i * w:(i + 1) * w] for i in range(h)]
+    order = list(range(0, h, 8)) + list(range(4, h, 8)) + list(range(2, h, 4)) + list(range(1, h, 2))
+    out = [None] * h
+    for src, dst in enumerate(order):
+        out[dst] = rows[src]
+    return b''.join(out)
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def decode_gif(data):
+    """完整合成每一帧画布，返回 (width, height, [(canvas, delay_ms), ...])"""
+    rd = Reader(data)
+    if rd.bytes(6) not in (b'GIF89a', b'GIF87a'):
+        raise GifError('invalid signature')
+    width = rd.u16()
+    height = rd.u16()
+    fdsz = rd.u8()
+    bgindex = rd.u8()
+    rd.u8()
+    gct = None
+    if fdsz & 0x80:
+        gct = rd.bytes(3 * (1 << ((fdsz & 0x07) + 1)))
+
+    def palette565(table):
+        return [rgb565(table[i * 3], table[i * 3 + 1], table[i * 3 + 2]) for i in range(len(table) // 3)]
+
+    gct565 = palette565(gct) if gct else [0] * 256
+    bg = gct565[bgindex] if bgindex < len(gct565) else 0
+    canvas = [bg] * (width * height)
+    frames = []
+    delay = 0
+    disposal = 0
+    transparency = False
+    tindex = 0
+    while True:
+        sep = rd.u8()
+        if sep == 0x3B:
+            break
+        if sep == 0x21:
+            label = rd.u8()
+            if label == 0xF9:
+                block = rd.sub_blocks()
+                disposal = (block[0] >> 2) & 3
+                transparency = bool(block[0] & 1)
+                delay = block[1] | (block[2] << 8)
+                tindex = block[3]
+            else:
+                rd.sub_blocks()
+            continue
+        if sep != 0x2C:
+            raise GifError('unknown block 0x%02X' % sep)
+        fx, fy, fw, fh = rd.u16(), rd.u16(), rd.u16(), rd.u16()
+        if fx + fw > width or fy + fh > height:
+            raise GifError('frame out of image bounds')
+        fisrz = rd.u8()
+        pal = gct565
+        if fisrz & 0x80:
+            pal = palette565(rd.bytes(3 * (1 << ((fisrz & 0x07) + 1))))
+        min_size = rd.u8()
+        index = lzw_decode(rd.sub_blocks(), min_size, fw * fh)
+        if fisrz & 0x40:
+            index = deinterlace(index, fw, fh)
+        saved = list(canvas) if disposal == 3 else None
+        for j in range(fh):
+            row = (fy + j) * width + fx
+            src = j * fw
+            for k in range(fw):
+                idx = index[src + k]
+                if not transparency or idx != tindex:
+                    canvas[row + k] = pal[idx]
+        # GIF 延时单位为 10ms，0 和 1 按浏览器的做法当作 100ms，与设备上 emoji_gif/帧包的规则相同
+        frames.append((list(canvas), delay * 10 if delay > 1 else 100))
+        if disposal == 2:
+            for j in range(fh):
+                row = (fy + j) * width + fx
+                canvas[row:row + fw] = [bg] * fw
+        elif disposal == 3:
+            canvas = saved
+        delay = 0
+        disposal = 0
+        transparency = False
+    if not frames:
+        raise GifError('no frames')
+    return width, height, frames
+
+
+def changed_rect(prev, cur, width, height):
+    if prev is None:
+        return 0, 0, width, height
+    x1, y1, x2, y2 = width, height, -1, -1
+    for y in range(height):
+        row = y * width
+        if prev[row:row + width] == cur[row:row + width]:
+            continue
+        for x in range(width):
+            if prev[row + x] != cur[row + x]:
+                x1 = min(x1, x)
+                x2 = max(x2, x)
+        y1 = min(y1, y)
+        y2 = max(y2, y)
+    if x2 < 0:
+        return 0, 0, 0, 0
+    return x1, y1, x2 - x1 + 1, y2 - y1 + 1
+
+
+def rle_encode(px, order):
+    out = bytearray()
+    i = 0
+    n = len(px)
+    lit_start = 0
+    while i < n:
+        run = 1
+        while i + run < n and run < PACK_RUN_MAX and px[i + run] == px[i]:
+            run += 1
+        if run >= 3:
+            flush_literal(out, px, lit_start, i, order)
+            out += struct.pack(order + 'BH', 0x80 | (run - 1), px[i])
+            i += run
+            lit_start = i
+        else:
+            i += 1
+    flush_literal(out, px, lit_start, n, order)
+    return bytes(out)
+
+
+def flush_literal(out, px, start, end, order):
+    while start < end:
+        cnt = min(end - start, PACK_RUN_MAX)
+        out += struct.pack(order + 'B%dH' % cnt, cnt - 1, *px[start:start + cnt])
+        start += cnt
+
+
+def build_pack(width, height, frames, swapped=True):
+    # 像素字节序: 大端即 RGB565_SWAPPED
+    order = '>' if swapped else '<'
+    table = []
+    data = bytearray()
+    data_start = PACK_HEADER.size + PACK_FRAME.size * len(frames)
+    max_frame_size = 0
+    prev = None
+    for canvas, delay in frames:
+        x, y, w, h = changed_rect(prev, canvas, width, height)
+        px = []
+        for j in range(h):
+            row = (y + j) * width + x
+            px += canvas[row:row + w]
+        raw = struct.pack(order + '%dH' % len(px), *px)
+        rle = rle_encode(px, order)
+        flags = 0
+        if len(rle) < len(raw):
+            raw = rle
+            flags |= PACK_FRAME_RLE
+        table.append(PACK_FRAME.pack(x, y, w, h, min(delay, 0xFFFF), flags, data_start + len(data), len(raw)))
+        data += raw
+        max_frame_size = max(max_frame_size, len(raw))
+        prev = canvas
+    header = PACK_HEADER.pack(PACK_MAGIC, width, height, len(frames), PACK_SWAPPED if swapped else 0, max_frame_size)
+    return header + b''.join(table) + bytes(data)
+
+
+def convert(src, dst, swapped):
+    with open(src, 'rb') as f:
+        width, height, frames = decode_gif(f.read())
+    pack = build_pack(width, height, frames, swapped)
+    with open(dst, 'wb') as f:
+        f.write(pack)
+    return width, height, len(frames), len(pack)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert GIF animations into pre-decoded RGB565 frame packs')
+    parser.add_argument('--output-dir', required=True, help='directory for the generated .epk files')
+    parser.add_argument('--native', action='store_true',
+                        help='store pixels in LVGL native RGB565 byte order instead of the panel order')
+    parser.add_argument('inputs', nargs='+', help='GIF files to convert')
+    args = parser.parse_args()
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    total = 0
+    for src in args.inputs:
+        name = os.path.splitext(os.path.basename(src))[0] + '.epk'
+        dst = os.path.join(args.output_dir, name)
+        try:
+            width, height, count, size = convert(src, dst, not args.native)
+        except GifError as e:
+            sys.stderr.write('%s: %s\n' % (src, e))
+            return 1
+        total += size
+        print('%-24s %dx%d %3d frames %8d bytes' % (name, width, height, count, size))
+    print('total %d bytes' % total)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
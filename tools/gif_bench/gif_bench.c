@@ -0,0 +1,420 @@
+/**
+ * gif_dec 主机端基准测试
+ * 解码目录下的每个GIF，对每种数据来源(内存 / lv_fs 文件，文件按子块读取、补充LZW码流)和每种画布格式
+ * (ARGB8888 / RGB565 / RGB565_SWAPPED / RGB565A8)，先与 LVGL 自带的 gifdec 逐帧比较画布:
+ * gifdec 只输出 ARGB8888，16位画布的参考帧由它按 gif_dec 的规则换算(RGB565A8 另加 alpha 平面)，必须逐字节一致。
+ * 再分别计时两者从同一来源解码全部帧的速度，输出 MB/s(LZW输出的帧像素字节) 和 帧/秒。
+ * 请求 RGB565 / RGB565_SWAPPED 的GIF需要透明时解码器改用 RGB565A8，cf 列是实际的画布格式(total 行是请求的格式)。
+ * 表情GIF都不透明，另外生成一个恢复成透明背景的小GIF(alpha.gif，放在临时目录)，覆盖 RGB565A8 画布。
+ * 用法: gif_bench [gif目录，默认 main/spiffs/gif] [每项最少计时毫秒数，默认200]
+ * 有任何一帧不一致时返回1
+ */
+#include "lvgl.h"
+#include "src/libs/gif/gifdec.h"
+#include "gif_dec.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_MAX_FILES     64
+#define BENCH_NAME_LEN      64
+#define BENCH_PATH_LEN      512
+#define BENCH_FORMAT_CNT    4
+
+/* 生成的透明GIF: 16x16，4色全局调色板，每个像素前都发清除码，码长固定3位，不需要真正的LZW编码 */
+#define ALPHA_GIF_SIZE      16
+#define ALPHA_GIF_CLEAR     4
+#define ALPHA_GIF_END       5
+
+typedef enum {
+    BENCH_SRC_DATA,             // gif_dec_open_data / gd_open_gif_data
+    BENCH_SRC_FILE,             // gif_dec_open_file / gd_open_gif_file，经 lv_fs 读取
+    BENCH_SRC_CNT,
+} bench_src_t;
+
+typedef struct {
+    const void * data;          // 整个文件的内容
+    char path[BENCH_PATH_LEN];  // 带盘符的 lv_fs 路径
+} bench_input_t;
+
+typedef struct {
+    double sec;                 // 计时总时长
+    uint32_t frames;            // 解码的帧数
+    uint64_t px;                // LZW输出的帧像素字节数(fw * fh 之和)
+} bench_result_t;
+
+typedef struct {
+    bench_result_t ref[BENCH_SRC_CNT];
+    bench_result_t dec[BENCH_SRC_CNT][BENCH_FORMAT_CNT];
+    int frames;
+} bench_total_t;
+
+static const char * const src_names[BENCH_SRC_CNT] = {"mem", "file"};
+
+static const lv_color_format_t formats[BENCH_FORMAT_CNT] = {
+    LV_COLOR_FORMAT_ARGB8888,
+    LV_COLOR_FORMAT_RGB565,
+    LV_COLOR_FORMAT_RGB565_SWAPPED,
+    LV_COLOR_FORMAT_RGB565A8,
+};
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void * load_file(const char * path, long * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void * data = malloc(*size);
+    if(data && fread(data, 1, *size, f) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int name_cmp(const void * a, const void * b)
+{
+    return strcmp(a, b);
+}
+
+static const char * cf_name(lv_color_format_t cf)
+{
+    switch(cf) {
+        case LV_COLOR_FORMAT_ARGB8888:
+            return "ARGB8888";
+        case LV_COLOR_FORMAT_RGB565:
+            return "RGB565";
+        case LV_COLOR_FORMAT_RGB565_SWAPPED:
+            return "RGB565_SW";
+        case LV_COLOR_FORMAT_RGB565A8:
+            return "RGB565A8";
+        default:
+            return "?";
+    }
+}
+
+static gd_GIF * ref_open(const bench_input_t * in, bench_src_t src)
+{
+    return src == BENCH_SRC_FILE ? gd_open_gif_file(in->path) : gd_open_gif_data(in->data);
+}
+
+static gif_dec_t * dec_open(const bench_input_t * in, bench_src_t src, lv_color_format_t cf)
+{
+    return src == BENCH_SRC_FILE ? gif_dec_open_file(in->path, cf, NULL, 0) : gif_dec_open_data(in->data, cf, NULL, 0);
+}
+
+/**
+ * 把 gifdec 的 ARGB8888 画布(B G R A)换算成 cf 格式的参考画布，颜色截断与 gif_dec 的 rgb_to_565 相同
+ */
+static void ref_convert(const uint8_t * argb, uint32_t px_cnt, lv_color_format_t cf, uint8_t * out)
+{
+    if(cf == LV_COLOR_FORMAT_ARGB8888) {
+        memcpy(out, argb, px_cnt * 4);
+        return;
+    }
+    uint8_t * alpha = cf == LV_COLOR_FORMAT_RGB565A8 ? &out[2 * px_cnt] : NULL;
+    for(uint32_t i = 0; i < px_cnt; i++) {
+        const uint8_t * p = &argb[i * 4];
+        uint16_t c = ((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3);
+        if(cf == LV_COLOR_FORMAT_RGB565_SWAPPED) {
+            out[i * 2] = c >> 8;
+            out[i * 2 + 1] = c & 0xFF;
+        }
+        else {
+            out[i * 2] = c & 0xFF;
+            out[i * 2 + 1] = c >> 8;
+        }
+        if(alpha) alpha[i] = p[3];
+    }
+}
+
+/**
+ * 逐帧比较 gif_dec 的 cf 画布和 gifdec 换算出的参考画布，返回比较的帧数，不一致返回-1。
+ * 两者都像播放时一样把帧画到自己的画布上(render 只画帧矩形，画布其余部分是之前的内容)。
+ * out_cf 返回解码器实际使用的画布格式
+ */
+static int verify(const char * name, const bench_input_t * in, bench_src_t src, lv_color_format_t cf,
+                  lv_color_format_t * out_cf)
+{
+    gd_GIF * ref = ref_open(in, src);
+    gif_dec_t * dec = dec_open(in, src, cf);
+    int frames = 0;
+    if(ref == NULL || dec == NULL) {
+        printf("%s %s %s: open failed\n", name, src_names[src], cf_name(cf));
+        frames = -1;
+        goto out;
+    }
+    *out_cf = dec->cf;
+    uint32_t px_cnt = ref->width * ref->height;
+    uint32_t size = gif_dec_canvas_size(dec);
+    uint8_t * ref_buf = malloc(size);
+    while(1) {
+        int ref_res = gd_get_frame(ref);
+        int dec_res = gif_dec_get_frame(dec);
+        if(ref_res != dec_res) {
+            printf("%s %s %s: frame %d result %d != %d\n", name, src_names[src], cf_name(dec->cf), frames,
+                   dec_res, ref_res);
+            frames = -1;
+            break;
+        }
+        if(ref_res <= 0) break;
+        ref->loop_count = dec->loop_count = 1;
+        gd_render_frame(ref, ref->canvas);
+        ref_convert(ref->canvas, px_cnt, dec->cf, ref_buf);
+        gif_dec_render_frame(dec, dec->canvas);
+        if(memcmp(ref_buf, dec->canvas, size) != 0) {
+            uint32_t i = 0;
+            while(ref_buf[i] == dec->canvas[i]) i++;
+            printf("%s %s %s: frame %d differs at byte %u\n", name, src_names[src], cf_name(dec->cf), frames,
+                   (unsigned)i);
+            frames = -1;
+            break;
+        }
+        frames++;
+    }
+    free(ref_buf);
+out:
+    if(ref) gd_close_gif(ref);
+    if(dec) gif_dec_close(dec);
+    return frames;
+}
+
+/* 文件中的循环次数多为0(无限循环)，每帧之后改成1，解码到结尾即停止 */
+static void bench_ref(const bench_input_t * in, bench_src_t src, double min_sec, bench_result_t * res)
+{
+    gd_GIF * gif = ref_open(in, src);
+    memset(res, 0, sizeof(*res));
+    double start = now_sec();
+    do {
+        gd_rewind(gif);
+        while(gd_get_frame(gif) > 0) {
+            gif->loop_count = 1;
+            res->frames++;
+            res->px += gif->fw * gif->fh;
+        }
+        res->sec = now_sec() - start;
+    } while(res->sec < min_sec);
+    gd_close_gif(gif);
+}
+
+static void bench_dec(const bench_input_t * in, bench_src_t src, lv_color_format_t cf, double min_sec,
+                      bench_result_t * res)
+{
+    gif_dec_t * gif = dec_open(in, src, cf);
+    memset(res, 0, sizeof(*res));
+    double start = now_sec();
+    do {
+        gif_dec_rewind(gif);
+        while(gif_dec_get_frame(gif) > 0) {
+            gif->loop_count = 1;
+            res->frames++;
+            res->px += gif->fw * gif->fh;
+        }
+        res->sec = now_sec() - start;
+    } while(res->sec < min_sec);
+    gif_dec_close(gif);
+}
+
+static void result_add(bench_result_t * total, const bench_result_t * res)
+{
+    total->sec += res->sec;
+    total->frames += res->frames;
+    total->px += res->px;
+}
+
+static void print_row(const char * name, const char * src, const char * cf, int frames, const bench_result_t * ref,
+                      const bench_result_t * dec)
+{
+    double ref_mbs = ref->px / ref->sec / 1e6, dec_mbs = dec->px / dec->sec / 1e6;
+    printf("%-16s %-4s %-9s %6d %9.2f %9.0f %9.2f %9.0f %7.2fx\n", name, src, cf, frames,
+           ref_mbs, ref->frames / ref->sec, dec_mbs, dec->frames / dec->sec, dec_mbs / ref_mbs);
+}
+
+static void put_u16(FILE * f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+/**
+ * 写一帧: 图形控制扩展(带透明色) + 图像描述符 + 图像数据，像素序号由 (x, y) 按 pattern 算出
+ */
+static void alpha_gif_frame(FILE * f, uint8_t disposal, uint8_t tindex, uint16_t fx, uint16_t fy, uint16_t fw,
+                            uint16_t fh, uint8_t pattern)
+{
+    uint8_t codes[ALPHA_GIF_SIZE * ALPHA_GIF_SIZE * 6 / 8 + 4] = {0};
+    uint32_t bit = 0;
+
+    fputc('!', f);
+    fputc(0xF9, f);
+    fputc(4, f);
+    fputc(disposal << 2 | 1, f);
+    put_u16(f, 10);
+    fputc(tindex, f);
+    fputc(0, f);
+
+    fputc(',', f);
+    put_u16(f, fx);
+    put_u16(f, fy);
+    put_u16(f, fw);
+    put_u16(f, fh);
+    fputc(0, f);
+
+    /* 3位的码按位从低到高排列 */
+    for(uint32_t i = 0; i <= (uint32_t)fw * fh; i++) {
+        uint16_t px = (i % fw + fx) * pattern + (i / fw + fy);
+        uint16_t pair = i < (uint32_t)fw * fh ? (px & 3) << 3 | ALPHA_GIF_CLEAR : ALPHA_GIF_END;
+        int n = i < (uint32_t)fw * fh ? 6 : 3;
+        for(int k = 0; k < n; k++, bit++) {
+            if(pair >> k & 1) codes[bit / 8] |= 1 << (bit % 8);
+        }
+    }
+    uint32_t len = (bit + 7) / 8;
+    fputc(2, f);
+    for(uint32_t pos = 0; pos < len; pos += 255) {
+        uint32_t n = len - pos < 255 ? len - pos : 255;
+        fputc(n, f);
+        fwrite(&codes[pos], 1, n, f);
+    }
+    fputc(0, f);
+}
+
+/**
+ * 生成需要 alpha 通道的GIF: 透明像素叠加、恢复成透明背景、恢复上一帧都有
+ */
+static bool alpha_gif_write(const char * path)
+{
+    static const uint8_t palette[4 * 3] = {0x20, 0x40, 0xC0, 0xF8, 0x10, 0x08, 0x18, 0xE4, 0x3C, 0xFF, 0xFF, 0xFF};
+    FILE * f = fopen(path, "wb");
+    if(f == NULL) return false;
+
+    fwrite("GIF89a", 1, 6, f);
+    put_u16(f, ALPHA_GIF_SIZE);
+    put_u16(f, ALPHA_GIF_SIZE);
+    fputc(0x81, f);             /* 全局调色板，4色 */
+    fputc(0, f);
+    fputc(0, f);
+    fwrite(palette, 1, sizeof(palette), f);
+
+    alpha_gif_frame(f, 2, 3, 0, 0, ALPHA_GIF_SIZE, ALPHA_GIF_SIZE, 1);
+    alpha_gif_frame(f, 3, 3, 4, 4, 8, 8, 3);
+    alpha_gif_frame(f, 1, 0, 2, 6, 10, 5, 2);
+    alpha_gif_frame(f, 2, 1, 8, 0, 8, ALPHA_GIF_SIZE, 5);
+    alpha_gif_frame(f, 0, 2, 3, 3, 6, 6, 7);
+    fputc(';', f);
+    return fclose(f) == 0;
+}
+
+/**
+ * 比较并计时一个文件的所有来源和画布格式，结果累加到 total，有不一致返回 false
+ */
+static bool bench_file(const char * name, const char * path, double min_sec, bench_total_t * total)
+{
+    bench_input_t in;
+    long size;
+    bool pass = true;
+    int frames = 0;
+
+    snprintf(in.path, sizeof(in.path), "%c:%s", LV_FS_STDIO_LETTER, path);
+    in.data = load_file(path, &size);
+    if(in.data == NULL) {
+        printf("%s: read failed\n", name);
+        return false;
+    }
+    for(int s = 0; s < BENCH_SRC_CNT; s++) {
+        lv_color_format_t out_cf[BENCH_FORMAT_CNT];
+        bool ok = true;
+        for(int f = 0; f < BENCH_FORMAT_CNT; f++) {
+            frames = verify(name, &in, s, formats[f], &out_cf[f]);
+            if(frames < 0) ok = false;
+        }
+        if(!ok) {
+            pass = false;
+            continue;
+        }
+        bench_result_t ref, dec;
+        bench_ref(&in, s, min_sec, &ref);
+        result_add(&total->ref[s], &ref);
+        for(int f = 0; f < BENCH_FORMAT_CNT; f++) {
+            bench_dec(&in, s, formats[f], min_sec, &dec);
+            result_add(&total->dec[s][f], &dec);
+            print_row(name, src_names[s], cf_name(out_cf[f]), frames, &ref, &dec);
+        }
+    }
+    if(pass) total->frames += frames;
+    free((void *)in.data);
+    return pass;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * dir_path = argc > 1 ? argv[1] : "main/spiffs/gif";
+    double min_sec = (argc > 2 ? atoi(argv[2]) : 200) / 1000.0;
+    static char names[BENCH_MAX_FILES][BENCH_NAME_LEN];
+    int name_cnt = 0;
+
+    DIR * dir = opendir(dir_path);
+    if(dir == NULL) {
+        printf("open %s failed\n", dir_path);
+        return 1;
+    }
+    struct dirent * ent;
+    while((ent = readdir(dir)) != NULL && name_cnt < BENCH_MAX_FILES) {
+        size_t len = strlen(ent->d_name);
+        if(len > 4 && len < BENCH_NAME_LEN && strcmp(&ent->d_name[len - 4], ".gif") == 0) {
+            strcpy(names[name_cnt++], ent->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, name_cnt, BENCH_NAME_LEN, name_cmp);
+
+    lv_init();
+    printf("%-16s %-4s %-9s %6s %9s %9s %9s %9s %8s\n", "file", "src", "cf", "frames", "ref MB/s", "ref fps",
+           "new MB/s", "new fps", "speedup");
+    /* 参考解码器只有 ARGB8888，同一来源的计时与各画布格式比较 */
+    static bench_total_t total;
+    int fail = 0;
+    for(int i = 0; i < name_cnt; i++) {
+        char path[BENCH_PATH_LEN];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+        if(!bench_file(names[i], path, min_sec, &total)) fail = 1;
+    }
+    for(int s = 0; s < BENCH_SRC_CNT && total.frames > 0; s++) {
+        for(int f = 0; f < BENCH_FORMAT_CNT; f++) {
+            print_row("total", src_names[s], cf_name(formats[f]), total.frames, &total.ref[s], &total.dec[s][f]);
+        }
+    }
+
+    /* 不计入合计，只为覆盖 RGB565A8 画布 */
+    static bench_total_t alpha_total;
+    char alpha_path[] = "/tmp/gif_bench_alpha_XXXXXX";
+    int fd = mkstemp(alpha_path);
+    if(fd < 0 || !alpha_gif_write(alpha_path)) {
+        printf("alpha.gif: write failed\n");
+        fail = 1;
+    }
+    else if(!bench_file("alpha.gif", alpha_path, min_sec, &alpha_total)) {
+        fail = 1;
+    }
+    if(fd >= 0) {
+        close(fd);
+        unlink(alpha_path);
+    }
+
+    printf("%s\n", fail ? "FAIL: output differs from gifdec" : "all frames of every source and format bit-exact with gifdec");
+    lv_deinit();
+    return fail;
+}
@@ -0,0 +1,24 @@
+/**
+ * gif_bench 使用的 LVGL 配置，只打开 GIF 解码需要的部分，其余取默认值
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_USE_OS                   LV_OS_NONE
+#define LV_USE_LOG                  0
+
+/* 参考解码器(LVGL 自带的 gifdec)，与设备上 LV_GIF_CACHE_DECODE_DATA 的默认值一致 */
+#define LV_USE_GIF                  1
+#define LV_GIF_CACHE_DECODE_DATA    0
+
+/* 文件来源经 lv_fs 读取，路径直接交给 fopen，不加缓存(与设备上每次读取都进 VFS 相同) */
+#define LV_USE_FS_STDIO             1
+#define LV_FS_STDIO_LETTER          'A'
+#define LV_FS_STDIO_PATH            ""
+#define LV_FS_STDIO_CACHE_SIZE      0
+
+#endif
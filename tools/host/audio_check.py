@@ -0,0 +1,548 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+音频流检查工具
+
+启动固件的主机构建(robot_host)，通过 /ws 发送一个 WAV 头和成突发到达的合成 PCM 帧，
+等播放任务播完后用 audio 事件取音频流统计，程序退出后把 I2S 替身写出的文件(-o)和发送的数据逐字节比较。
+每个场景运行一次:
+    smooth  抖动小于目标延迟，不能有欠载/溢出，输出和输入完全一致
+    late    流中途停顿超过目标延迟，应计到欠载，数据仍然一个不少
+    flood   一次写入超过环形缓冲的数据，应计到溢出，丢弃的字节数与输出长度对得上，
+            缓冲空出一半后再发剩下的数据，输出是丢弃前的部分接上剩下数据的解码
+压缩格式(--codec mulaw adpcm)只运行 smooth 和 flood: 发送前编码，输出与本工具的参考解码逐字节比较，
+ADPCM 溢出后丢弃到下一块开头，剩下的数据从那一块开始与参考一致。
+其他采样率、立体声和24位(--format 8000/1 44100/2 48000/2/24 ...)的PCM运行 smooth 和 flood: 播放任务重采样到
+24kHz单声道，输出不能逐字节比较，检查输出长度(包括流结束时推出的滤波器延迟)、I2S没有重新配置、正弦的 THD+N 和左右声道混合后的幅度;
+flood 分别检查溢出前和再发送后的两段，帧(如24位立体声6字节)错开一个字节或者左右声道对调时 THD+N 和幅度都不对。
+本地播放(--local，把文件放进主机构建的 spiffs_image 后用 play 事件播放):
+    pcm   长度是奇数、不是读取缓冲整数倍的裸PCM，输出是去掉最后一个字节的文件内容
+    wav   data 块后还有其他块的WAV，输出正好是 data 块
+    mix   音频流播放时在音效声部播放直流，输出减去流应当正好是压低后的直流，其他位置为0
+    loop  在循环声部循环播放，play_stop 后淡出，收到 stopped，输出以接近0的采样结束
+    replace  循环播放时在同一声部开始另一次播放，前一个淡出后收到 stopped，输出以完整的后一个结束
+
+用法:
+    audio_check.py --robot-host _build/robot_host [--scenario smooth late flood] [--codec pcm mulaw adpcm]
+                   [--format 8000/1 16000/1 22050/2 44100/2 48000/1 44100/2/24] [--local pcm wav mix loop replace]
+"""
+
+import argparse
+import json
+import math
+import os
+import random
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+from mirror_check import MirrorError, ws_connect, ws_frame, ws_recv
+
+SAMPLE_RATE = 24000
+TONE_FREQ = 1000
+TONE_AMPLITUDE = 16000
+MAX_THDN_DB = -60
+FRAME_MS = 20
+FRAME_BYTES = SAMPLE_RATE * 2 * FRAME_MS // 1000
+# main/config.h 的 AUDIO_PLAY_BUF_SIZE，本地文件的长度故意不是它的整数倍
+PLAY_BUF_SIZE = 2048
+# main/config.h 的 AUDIO_STREAM_RING_SIZE
+STREAM_RING_SIZE = 131072
+# 音效声部的默认 duck_gain(Q15)
+DUCK_GAIN = 8192
+EFFECT_DC = 4000
+ADPCM_BLOCK_ALIGN = 256
+ADPCM_STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+    5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767]
+ADPCM_INDEX = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def wav_header(codec, length, rate=SAMPLE_RATE, channels=1, bits=16):
+    """codec 0x0001 PCM, 0x0007 mu-law, 0x0011 IMA-ADPCM(fmt 块多2字节 cbSize + 2字节每块采样数)"""
+    if codec == 'pcm':
+        frame = bits // 8 * channels
+        fmt = struct.pack('<HHIIHH', 1, channels, rate, rate * frame, frame, bits)
+    elif codec == 'mulaw':
+        fmt = struct.pack('<HHIIHH', 7, 1, SAMPLE_RATE, SAMPLE_RATE, 1, 8)
+    else:
+        spb = (ADPCM_BLOCK_ALIGN - 4) * 2 + 1
+        fmt = struct.pack('<HHIIHHHH', 0x11, 1, SAMPLE_RATE, SAMPLE_RATE * ADPCM_BLOCK_ALIGN // spb,
+                          ADPCM_BLOCK_ALIGN, 4, 2, spb)
+    return (b'RIFF' + struct.pack('<I', 4 + 8 + len(fmt) + 8 + length) + b'WAVE' +
+            b'fmt ' + struct.pack('<I', len(fmt)) + fmt + b'data' + struct.pack('<I', length))
+
+
+def mulaw_encode(pcm):
+    out = bytearray()
+    for (v,) in struct.iter_unpack('<h', pcm):
+        sign = 0x80 if v >= 0 else 0
+        v = min(abs(v), 32635) + 0x84
+        exp = v.bit_length() - 8
+        out.append(~(sign | exp << 4 | (v >> (exp + 3)) & 0x0f) & 0xff)
+    return bytes(out)
+
+
+def mulaw_decode(data):
+    out = []
+    for c in data:
+        u = ~c & 0xff
+        t = ((((u & 0x0f) << 3) + 0x84) << ((u >> 4) & 7)) - 0x84
+        out.append(-t if u & 0x80 else t)
+    return struct.pack('<%dh' % len(out), *out)
+
+
+def adpcm_step(pred, index, code):
+    step = ADPCM_STEPS[index]
+    diff = step >> 3
+    if code & 4:
+        diff += step
+    if code & 2:
+        diff += step >> 1
+    if code & 1:
+        diff += step >> 2
+    pred = max(-32768, min(32767, pred - diff if code & 8 else pred + diff))
+    return pred, max(0, min(88, index + ADPCM_INDEX[code & 7]))
+
+
+def adpcm_encode(pcm):
+    """WAV IMA-ADPCM 块格式，单声道: 块头(第一个采样、步长索引)后每字节两个采样，低4位在前"""
+    samples = [v for (v,) in struct.iter_unpack('<h', pcm)]
+    spb = (ADPCM_BLOCK_ALIGN - 4) * 2 + 1
+    out = bytearray()
+    index = 0
+    for start in range(0, len(samples), spb):
+        block = samples[start:start + spb]
+        pred = block[0]
+        out += struct.pack('<hBB', pred, index, 0)
+        codes = []
+        for v in block[1:]:
+            diff = v - pred
+            code = 8 if diff < 0 else 0
+            diff = abs(diff)
+            step = ADPCM_STEPS[index]
+            for bit in (4, 2, 1):
+                if diff >= step:
+                    code |= bit
+                    diff -= step
+                step >>= 1
+            codes.append(code)
+            pred, index = adpcm_step(pred, index, code)
+        if len(codes) % 2:
+            codes.append(0)
+        out += bytes(codes[i] | codes[i + 1] << 4 for i in range(0, len(codes), 2))
+    return bytes(out)
+
+
+def adpcm_decode(data):
+    out = []
+    for start in range(0, len(data), ADPCM_BLOCK_ALIGN):
+        block = data[start:start + ADPCM_BLOCK_ALIGN]
+        pred, index = struct.unpack_from('<hB', block)
+        out.append(pred)
+        for b in block[4:]:
+            for code in (b & 0x0f, b >> 4):
+                pred, index = adpcm_step(pred, index, code)
+                out.append(pred)
+    return struct.pack('<%dh' % len(out), *out)
+
+
+def encode(codec, pcm):
+    """返回发送的数据和期望的扬声器输出"""
+    if codec == 'mulaw':
+        data = mulaw_encode(pcm)
+        return data, mulaw_decode(data)
+    if codec == 'adpcm':
+        data = adpcm_encode(pcm)
+        return data, adpcm_decode(data)
+    return pcm, pcm
+
+
+def synth(frames):
+    """440Hz 正弦，每帧的第一个采样换成帧号，丢帧或错位都能看出来"""
+    data = bytearray()
+    n = 0
+    for i in range(frames):
+        samples = [int(8000 * math.sin(2 * math.pi * 440 * (n + k) / SAMPLE_RATE)) for k in range(FRAME_BYTES // 2)]
+        samples[0] = i
+        n += len(samples)
+        data += struct.pack('<%dh' % len(samples), *samples)
+    return bytes(data)
+
+
+def tone(rate, channels, seconds, bits=16):
+    """1kHz 正弦，立体声时右声道幅度是左声道的一半，混合后幅度为 TONE_AMPLITUDE * 3/4"""
+    samples = []
+    for n in range(rate * seconds):
+        s = TONE_AMPLITUDE * math.sin(2 * math.pi * TONE_FREQ * n / rate)
+        samples += [round(s), round(s / 2)][:channels]
+    if bits == 24:
+        # 低8位放一个不为0的值，错开字节时能看出来
+        return b''.join(struct.pack('<i', v * 256 + 0x5a)[:3] for v in samples)
+    return struct.pack('<%dh' % len(samples), *samples)
+
+
+def resample_tail(rate):
+    """流结束时推出重采样滤波器延迟的输出采样数，阶数与 main/audio_resample.c 的 audio_resample_init 相同"""
+    g = math.gcd(rate, SAMPLE_RATE)
+    up, down = SAMPLE_RATE // g, rate // g
+    if up == down:
+        return 0
+    taps = max(-(-32 * down // up), 32)
+    return taps // 2 * SAMPLE_RATE // rate
+
+
+def fit_tone(pcm, freq):
+    """最小二乘拟合 a*sin + b*cos，返回幅度和残差与正弦的能量比(dB)"""
+    y = struct.unpack('<%dh' % (len(pcm) // 2), pcm)
+    w = 2 * math.pi * freq / SAMPLE_RATE
+    ss = sc = cc = ys = yc = 0.0
+    for i, v in enumerate(y):
+        sn, cs = math.sin(w * i), math.cos(w * i)
+        ss += sn * sn
+        sc += sn * cs
+        cc += cs * cs
+        ys += v * sn
+        yc += v * cs
+    det = ss * cc - sc * sc
+    a = (ys * cc - yc * sc) / det
+    b = (yc * ss - ys * sc) / det
+    sig = res = 0.0
+    for i, v in enumerate(y):
+        s = a * math.sin(w * i) + b * math.cos(w * i)
+        sig += s * s
+        res += (v - s) ** 2
+    return math.hypot(a, b), 10 * math.log10(max(res, 1e-9) / sig)
+
+
+def audio_stats(sock, latency=None):
+    req = {'event': 'audio'}
+    if latency is not None:
+        req['data'] = {'latency': latency}
+    sock.send(ws_frame(1, json.dumps(req).encode()))
+    while True:
+        opcode, data = ws_recv(sock)
+        if opcode == 1:
+            reply = json.loads(data)
+            if reply.get('event') == 'audio_ret':
+                return reply
+
+
+def send_stream(sock, codec, data, scenario, latency_ms, rng, rate=SAMPLE_RATE, channels=1, bits=16):
+    """按实时速率发送，成组突发: 攒够一组帧再一起发，组内最早的帧晚到不超过目标延迟的 3/4。
+    flood 返回溢出后再发送的数据在 data 中的起点"""
+    # 每帧 FRAME_MS 毫秒的数据
+    frame_bytes = {'pcm': rate * bits // 8 * channels * FRAME_MS // 1000,
+                   'mulaw': FRAME_BYTES // 2}.get(codec, ADPCM_BLOCK_ALIGN * FRAME_BYTES // 2 // 505)
+    frames = [data[i:i + frame_bytes] for i in range(frame_bytes, len(data), frame_bytes)]
+    if scenario == 'flood':
+        # 最后解码后不超过缓冲 1/4 的数据等缓冲空出一半后再发，一定放得下。
+        # 大帧加掩码很慢，先准备好再发WAV头，否则流在等它时已经放空
+        size = audio_stats(sock)['size']
+        expand = {'mulaw': 2, 'adpcm': 4}.get(codec, 1)
+        cut = len(frames)
+        while cut > 1 and sum(len(f) for f in frames[cut - 1:]) * expand <= size // 4:
+            cut -= 1
+        flood = ws_frame(2, b''.join(frames[:cut]))
+        rest = ws_frame(2, b''.join(frames[cut:]))
+        sock.send(ws_frame(2, wav_header(codec, len(data), rate, channels, bits) + data[:frame_bytes]))
+        sock.send(flood)
+        while audio_stats(sock)['fill'] > size // 2:
+            time.sleep(0.05)
+        sock.send(rest)
+        return frame_bytes * (cut + 1)
+    sock.send(ws_frame(2, wav_header(codec, len(data), rate, channels, bits) + data[:frame_bytes]))
+    start = time.time()
+    i = 0
+    stalled = False
+    while i < len(frames):
+        burst = rng.randint(1, max(1, latency_ms * 3 // 4 // FRAME_MS))
+        due = start + (i + burst) * FRAME_MS / 1000
+        if scenario == 'late' and not stalled and i > len(frames) // 2:
+            due += 2 * latency_ms / 1000
+            start += 2 * latency_ms / 1000
+            stalled = True
+        time.sleep(max(0, due - time.time()))
+        for frame in frames[i:i + burst]:
+            sock.send(ws_frame(2, frame))
+        i += burst
+
+
+def check(robot_host, codec, scenario, seconds, latency_ms, port, seed, rate=SAMPLE_RATE, channels=1, bits=16):
+    rng = random.Random(seed)
+    resampled = rate != SAMPLE_RATE or channels != 1 or bits != 16
+    if resampled:
+        data = tone(rate, channels, seconds, bits)
+    else:
+        data, pcm = encode(codec, synth(seconds * 1000 // FRAME_MS))
+    # 先发送的部分(缓冲中是解码后的数据)要超过环形缓冲才会溢出
+    if scenario == 'flood' and len(data if resampled else pcm) < STREAM_RING_SIZE * 5 // 4:
+        print('%s %d/%d/%d flood: skipped, too short to overflow the ring (use --seconds)' % (codec, rate, channels,
+                                                                                             bits))
+        return True
+    out = tempfile.NamedTemporaryFile(suffix='.pcm', delete=False).name
+    log = tempfile.TemporaryFile()
+    cmd = [robot_host, '-t', str(seconds + 3), '-p', str(port), '-o', out]
+    proc = subprocess.Popen(cmd, cwd=os.path.dirname(os.path.abspath(robot_host)), stdout=log,
+                            stderr=subprocess.STDOUT)
+    try:
+        sock = ws_connect(port, 5)
+        stats = audio_stats(sock, latency_ms)
+        resume = send_stream(sock, codec, data, scenario, latency_ms, rng, rate, channels, bits)
+        deadline = time.time() + seconds + 2
+        while True:
+            stats = audio_stats(sock)
+            if stats['fill'] == 0 and stats['played'] == stats['written'] or time.time() > deadline:
+                break
+            time.sleep(0.1)
+        sock.close()
+        proc.wait(seconds + 10)
+        if proc.returncode != 0:
+            raise MirrorError('robot_host exit %d' % proc.returncode)
+        with open(out, 'rb') as f:
+            got = f.read()
+        log.seek(0)
+        m = re.search(rb'speaker: .*underruns (\d+).*reconfigs (\d+)', log.read())
+        i2s_underruns = int(m.group(1)) if m else -1
+        i2s_reconfigs = int(m.group(2)) if m else -1
+    finally:
+        if proc.poll() is None:
+            proc.kill()
+        os.unlink(out)
+    name = '%s %d/%d%s' % (codec, rate, channels, '/24' if bits == 24 else '') if resampled else codec
+    print('%-5s %-6s sent %d KB, played %d KB, max fill %d KB, starts %d, underruns %d, overruns %d (dropped %d B), '
+          'i2s underruns %d' % (name, scenario, len(data) // 1024, len(got) // 1024, stats['max_fill'] // 1024,
+                                stats['starts'], stats['underruns'], stats['overruns'], stats['dropped'],
+                                i2s_underruns))
+    if stats['streams'] != 1:
+        raise MirrorError('%d streams, expect 1' % stats['streams'])
+    # I2S 固定在 SPK_SAMPLE_RATE，任何格式都不重新配置
+    if i2s_reconfigs != 0:
+        raise MirrorError('i2s reconfigured %d times' % i2s_reconfigs)
+    if resampled:
+        frame = bits // 8 * channels
+        if scenario == 'flood':
+            # 溢出前接收的和再发送的两段，丢弃处相位不连续，分开拟合，各自跳过滤波器的过渡
+            if stats['overruns'] == 0 or stats['dropped'] % frame or stats['written'] + stats['dropped'] != len(data):
+                raise MirrorError('flood: overrun not accounted')
+            tail = (len(data) - resume) // frame * SAMPLE_RATE // rate
+            head = len(got) // 2 - tail
+            segments = [got[800:(head - 400) * 2], got[(head + 400) * 2:-800]]
+        else:
+            # 流结束后送入的0把滤波器延迟中的最后一段正弦推出来
+            expect = SAMPLE_RATE * seconds
+            tail = resample_tail(rate)
+            if abs(len(got) // 2 - expect - tail) > 2:
+                raise MirrorError('i2s got %d samples, expect %d + %d flushed' % (len(got) // 2, expect, tail))
+            # 跳过开头滤波器填满之前的输出，结尾拟合到正弦的最后一个采样，之后是滤波器的衰减
+            segments = [got[400:expect * 2]]
+        amplitude_expect = TONE_AMPLITUDE * (3 / 4 if channels == 2 else 1)
+        ok = stats['underruns'] == 0 and i2s_underruns == 0 and (scenario == 'flood' or stats['overruns'] == 0)
+        for segment in segments:
+            amplitude, thdn = fit_tone(segment, TONE_FREQ)
+            print('%-5s %-6s 1kHz amplitude %.0f (expect %.0f), THD+N %.1f dB over %d samples' % (
+                name, scenario, amplitude, amplitude_expect, thdn, len(segment) // 2))
+            ok &= thdn < MAX_THDN_DB and abs(amplitude - amplitude_expect) < amplitude_expect * 0.01
+        return ok
+    if len(got) != stats['written']:
+        raise MirrorError('i2s got %d bytes, stream accepted %d' % (len(got), stats['written']))
+    if scenario == 'flood':
+        # 压缩格式丢弃的是编码后的字节，不能和输出长度对比
+        if stats['overruns'] == 0 or codec == 'pcm' and stats['written'] + stats['dropped'] != len(pcm):
+            raise MirrorError('flood: overrun not accounted')
+        # 溢出前接收的部分是参考的前缀，之后是从 resume(ADPCM 为下一块开头)开始的参考
+        if codec == 'adpcm':
+            block = -(-resume // ADPCM_BLOCK_ALIGN)
+            resume = block * ((ADPCM_BLOCK_ALIGN - 4) * 2 + 1) * 2
+        elif codec == 'mulaw':
+            resume *= 2
+        tail = pcm[resume:]
+        head = len(got) - len(tail)
+        if head < 0 or got[head:] != tail:
+            raise MirrorError('flood: output does not resume at byte %d of the decoded input' % resume)
+        return got[:head] == pcm[:head]
+    if got != pcm:
+        diff = next(i for i in range(min(len(got), len(pcm))) if got[i] != pcm[i]) if got[:1] else 0
+        raise MirrorError('output differs from input at byte %d' % diff)
+    if scenario == 'smooth':
+        return stats['underruns'] == 0 and stats['overruns'] == 0 and i2s_underruns == 0
+    return stats['underruns'] >= 1 and stats['overruns'] == 0
+
+
+def ws_event(sock, name, deadline):
+    """读到指定事件为止，超时抛出 MirrorError"""
+    while time.time() < deadline:
+        opcode, data = ws_recv(sock)
+        if opcode == 1:
+            reply = json.loads(data)
+            if reply.get('event') == name:
+                return reply
+    raise MirrorError('no %s event' % name)
+
+
+def play(sock, path, voice=None, loop=False):
+    data = {'path': path, 'loop': loop}
+    if voice is not None:
+        data['voice'] = voice
+    sock.send(ws_frame(1, json.dumps({'event': 'play', 'data': data}).encode()))
+    reply = ws_event(sock, 'play_ret', time.time() + 5)
+    if not reply['ret']:
+        raise MirrorError('play %s failed' % path)
+    return reply['handle']
+
+
+def check_local(robot_host, scenario, port):
+    seconds = 3
+    out = tempfile.NamedTemporaryFile(suffix='.pcm', delete=False).name
+    log = tempfile.TemporaryFile()
+    cwd = os.path.dirname(os.path.abspath(robot_host))
+    audio_dir = os.path.join(cwd, 'spiffs_image', 'audio')
+    os.makedirs(audio_dir, exist_ok=True)
+    name = 'audio_check_%s.%s' % (scenario, 'wav' if scenario == 'wav' else 'pcm')
+    local = os.path.join(audio_dir, name)
+    path = '/spiffs/audio/' + name
+    if scenario == 'mix':
+        pcm = struct.pack('<h', EFFECT_DC) * (SAMPLE_RATE // 2 + 123)
+        content = pcm
+    else:
+        # 不是缓冲整数倍的采样数，pcm 再多一个奇数字节
+        pcm = synth(50)[:PLAY_BUF_SIZE * 23 + 778]
+        if scenario == 'wav':
+            content = wav_header('pcm', len(pcm)) + pcm + b'LIST' + struct.pack('<I', 6) + b'robot\0'
+        else:
+            content = pcm + b'\x7f'
+    with open(local, 'wb') as f:
+        f.write(content)
+    cmd = [robot_host, '-t', str(seconds + 2), '-p', str(port), '-o', out]
+    proc = subprocess.Popen(cmd, cwd=cwd, stdout=log, stderr=subprocess.STDOUT)
+    stream = synth(seconds * 1000 // FRAME_MS // 2) if scenario == 'mix' else b''
+    try:
+        sock = ws_connect(port, 5)
+        deadline = time.time() + seconds
+        # http 比音频任务先启动，播放不存在的文件，不再是 ESP_ERR_INVALID_STATE 时本地播放任务已经起来
+        while time.time() < deadline:
+            sock.send(ws_frame(1, json.dumps({'event': 'play', 'data': {'path': '/spiffs/none.pcm'}}).encode()))
+            if ws_event(sock, 'play_ret', deadline)['err'] != 'ESP_ERR_INVALID_STATE':
+                break
+            time.sleep(0.05)
+        if scenario == 'mix':
+            # 一次发完，等流开始播放(压低其他声部)后再播放音效
+            send_stream(sock, 'pcm', stream, 'flood', 0, None)
+            while audio_stats(sock)['played'] == 0:
+                time.sleep(0.01)
+        looping = scenario in ('loop', 'replace')
+        handle = play(sock, path, 2 if looping else None, looping)
+        if looping:
+            time.sleep(1)
+        if scenario == 'loop':
+            sock.send(ws_frame(1, json.dumps({'event': 'play_stop', 'data': {'handle': handle}}).encode()))
+        if scenario == 'replace':
+            second = play(sock, path, 2)
+            first = ws_event(sock, 'play_done', deadline)
+            if first['handle'] != handle or first['result'] != 'stopped':
+                raise MirrorError('replace: first play %s' % first)
+            handle = second
+        done = ws_event(sock, 'play_done', deadline)
+        while scenario == 'mix' and time.time() < deadline:
+            stats = audio_stats(sock)
+            if stats['fill'] == 0 and stats['played'] == stats['written']:
+                break
+            time.sleep(0.1)
+        sock.send(ws_frame(1, json.dumps({'event': 'mixer'}).encode()))
+        mixer = ws_event(sock, 'mixer_ret', deadline)
+        sock.close()
+        proc.wait(seconds + 10)
+        if proc.returncode != 0:
+            raise MirrorError('robot_host exit %d' % proc.returncode)
+        with open(out, 'rb') as f:
+            got = f.read()
+    finally:
+        if proc.poll() is None:
+            proc.kill()
+        os.unlink(out)
+        os.unlink(local)
+    print('local %-5s %s: %s, played %d B, mixer max voices %d' % (scenario, name, done['result'], len(got),
+                                                                  mixer['max_voices']))
+    if done['handle'] != handle:
+        raise MirrorError('play_done for handle %d, expect %d' % (done['handle'], handle))
+    if scenario == 'loop':
+        samples = struct.unpack('<%dh' % (len(got) // 2), got)
+        # 停止前至少循环了一遍，停止后按循环声部的 200ms 渐变淡出
+        if done['result'] != 'stopped' or len(got) <= len(pcm) or len(got) > SAMPLE_RATE * 2 * 2:
+            raise MirrorError('loop: %s after %d bytes' % (done['result'], len(got)))
+        return max(abs(v) for v in samples[-32:]) < 800
+    if done['result'] != 'done':
+        raise MirrorError('%s: %s' % (scenario, done['result']))
+    if scenario == 'replace':
+        # 输出以第二次播放结束，循环声部 200ms 淡入(再留一块余量)之后与文件内容相同
+        expect = pcm[:len(pcm) & ~1]
+        fade = (SAMPLE_RATE * 200 // 1000 + 256) * 2
+        return len(got) > len(expect) * 2 and got[-len(expect) + fade:] == expect[fade:]
+    if scenario != 'mix':
+        expect = pcm[:len(pcm) & ~1]
+        if got != expect:
+            diff = next((i for i in range(min(len(got), len(expect))) if got[i] != expect[i]), min(len(got), len(expect)))
+            raise MirrorError('%s: %d bytes, expect %d, differs at byte %d' % (scenario, len(got), len(expect), diff))
+        return True
+    # 流一直有数据，输出的第 i 个采样就是流的第 i 个采样加上音效
+    if len(got) != len(stream):
+        raise MirrorError('mix: %d bytes, expect %d' % (len(got), len(stream)))
+    a = struct.unpack('<%dh' % (len(got) // 2), got)
+    b = struct.unpack('<%dh' % (len(stream) // 2), stream)
+    diffs = [x - y for x, y in zip(a, b)]
+    ducked = EFFECT_DC * DUCK_GAIN >> 15
+    effect = [i for i, d in enumerate(diffs) if d]
+    if not effect or any(d not in (0, ducked) for d in diffs):
+        raise MirrorError('mix: output minus stream is not 0 or %d' % ducked)
+    print('local %-5s effect at samples %d..%d, expect %d samples' % (scenario, effect[0], effect[-1], len(pcm) // 2))
+    return len(effect) == len(pcm) // 2 and effect[-1] - effect[0] + 1 == len(effect) and mixer['max_voices'] >= 2
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Stream bursty PCM over /ws and check the speaker output')
+    parser.add_argument('--robot-host', required=True, help='robot_host executable of the host build')
+    parser.add_argument('--scenario', nargs='*', choices=['smooth', 'late', 'flood'],
+                        default=['smooth', 'late', 'flood'])
+    parser.add_argument('--codec', nargs='*', choices=['pcm', 'mulaw', 'adpcm'], default=['pcm', 'mulaw', 'adpcm'])
+    parser.add_argument('--format', nargs='*', default=[], metavar='RATE/CHANNELS[/BITS]',
+                        help='extra PCM formats (16 or 24 bits) to stream and check after resampling, e.g. 44100/2/24')
+    parser.add_argument('--local', nargs='*', choices=['pcm', 'wav', 'mix', 'loop', 'replace'],
+                        default=['pcm', 'wav', 'mix', 'loop', 'replace'],
+                        help='local playback scenarios to check')
+    parser.add_argument('--seconds', type=int, default=4, help='length of the streamed audio')
+    parser.add_argument('--latency', type=int, default=200, help='target latency (ms) to configure')
+    parser.add_argument('--port', type=int, default=18190)
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    runs = [(codec, scenario, SAMPLE_RATE, 1, 16) for codec in args.codec for scenario in args.scenario
+            if codec == 'pcm' or scenario in ('smooth', 'flood')]
+    for fmt in args.format:
+        rate, channels, bits = ([int(v) for v in fmt.split('/')] + [16])[:3]
+        runs += [('pcm', scenario, rate, channels, bits) for scenario in args.scenario
+                 if scenario in ('smooth', 'flood')]
+    ok = True
+    for i, (codec, scenario, rate, channels, bits) in enumerate(runs):
+        try:
+            ok &= check(args.robot_host, codec, scenario, args.seconds, args.latency, args.port + i, args.seed,
+                        rate, channels, bits)
+        except (MirrorError, OSError, EOFError, subprocess.TimeoutExpired) as e:
+            print('%s %s %d/%d/%d: %s' % (codec, scenario, rate, channels, bits, e), file=sys.stderr)
+            ok = False
+    for i, scenario in enumerate(args.local):
+        try:
+            ok &= check_local(args.robot_host, scenario, args.port + len(runs) + i)
+        except (MirrorError, OSError, subprocess.TimeoutExpired) as e:
+            print('local %s: %s' % (scenario, e), file=sys.stderr)
+            ok = False
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
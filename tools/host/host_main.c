@@ -0,0 +1,227 @@
+/**
+ * 固件主机构建的入口: 解析命令行、配置移植层，然后像设备一样在 "main" 任务中运行 app_main。
+ * 可以按间隔依次播放若干表情，运行指定时间(或直到 Ctrl-C)后打印屏幕、I2S 和舵机替身的统计。
+ * 浸泡模式(-m)循环播放表情若干分钟，每轮记录 LVGL 堆的空闲和碎片率，相对第一轮漂移则以1退出
+ */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_http_server.h"
+#include "host_port.h"
+#include "lvgl.h"
+#include "lvgl_api.h"
+
+#ifndef HOST_SPIFFS_DIR
+#define HOST_SPIFFS_DIR     "spiffs_image"
+#endif
+#ifndef HOST_ASSET_IMAGE
+#define HOST_ASSET_IMAGE    "assets.bin"
+#endif
+
+// 浸泡测试允许的漂移: 空闲字节数减少和碎片率(百分点)增加
+#define SOAK_FREE_DRIFT     1024
+#define SOAK_FRAG_DRIFT     5
+
+void app_main(void);
+
+static volatile sig_atomic_t stop_requested;
+static char *emotions;
+static uint32_t emotion_interval_ms = 3000;
+static bool soak;
+// 浸泡模式第一轮(热身)后的基准和之后出现过的最差值
+static lv_mem_monitor_t soak_base, soak_worst;
+static uint32_t soak_rounds;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -s DIR     spiffs directory (default %s)\n"
+            "  -a FILE    asset partition image, '-' for none (default %s)\n"
+            "  -p PORT    HTTP/WebSocket port on 127.0.0.1 (default %u)\n"
+            "  -t SEC     run time in seconds, 0 until Ctrl-C (default 0)\n"
+            "  -e LIST    comma separated emotions to play in turn\n"
+            "  -i MS      interval between emotions (default %lu)\n"
+            "  -o FILE    write I2S output (raw PCM) to FILE\n"
+            "  -r FILE    write servo duty changes (CSV) to FILE\n"
+            "  -f FILE    save the panel content as PPM on exit (FILE_1.ppm ... for more panels)\n"
+            "  -n         complete SPI transfers immediately instead of at the pixel clock\n"
+            "  -m MIN     soak: loop -e for MIN minutes, exit 1 if the LVGL heap free size or\n"
+            "             fragmentation drifts from the first round\n",
+            prog, HOST_SPIFFS_DIR, HOST_ASSET_IMAGE, host_httpd_port, (unsigned long)emotion_interval_ms);
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static void main_task(void *arg)
+{
+    (void)arg;
+    app_main();
+    vTaskDelete(NULL);
+}
+
+/**
+ * 浸泡模式每轮表情播完后在同一时刻采样 LVGL 堆，第一轮的结果作为基准
+ */
+static void soak_sample(void)
+{
+    lv_mem_monitor_t mon;
+    lv_lock();
+    lv_mem_monitor(&mon);
+    lv_unlock();
+    if(soak_rounds++ == 0) {
+        soak_base = mon;
+        soak_worst = mon;
+    }
+    if(mon.free_size < soak_worst.free_size) {
+        soak_worst.free_size = mon.free_size;
+    }
+    if(mon.frag_pct > soak_worst.frag_pct) {
+        soak_worst.frag_pct = mon.frag_pct;
+    }
+    printf("host: soak round %u: free %zu, biggest %zu, frag %u%%\n", (unsigned)soak_rounds, mon.free_size,
+           mon.free_biggest_size, (unsigned)mon.frag_pct);
+}
+
+/**
+ * 打印浸泡结果，有漂移返回false
+ */
+static bool soak_report(void)
+{
+    if(soak_rounds < 2) {
+        printf("soak: only %u rounds, increase -m or reduce -i\n", (unsigned)soak_rounds);
+        return false;
+    }
+    size_t free_drop = soak_base.free_size > soak_worst.free_size ? soak_base.free_size - soak_worst.free_size : 0;
+    int frag_rise = (int)soak_worst.frag_pct - (int)soak_base.frag_pct;
+    bool ok = free_drop <= SOAK_FREE_DRIFT && frag_rise <= SOAK_FRAG_DRIFT;
+    printf("soak: %u rounds, free %zu -> min %zu (-%zu B), frag %u%% -> max %u%% (%+d), %s\n",
+           (unsigned)soak_rounds, soak_base.free_size, soak_worst.free_size, free_drop,
+           (unsigned)soak_base.frag_pct, (unsigned)soak_worst.frag_pct, frag_rise, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static void emotion_task(void *arg)
+{
+    (void)arg;
+    // 等 app_main 完成初始化
+    vTaskDelay(pdMS_TO_TICKS(500));
+    while(1) {
+        char *list = strdup(emotions);
+        for(char *save = NULL, *name = strtok_r(list, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+            printf("host: play %s\n", name);
+            emoji_play_by_name(name);
+            vTaskDelay(pdMS_TO_TICKS(emotion_interval_ms));
+        }
+        free(list);
+        if(soak) {
+            soak_sample();
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *ppm = NULL;
+    unsigned run_s = 0;
+    int opt;
+
+    host_port.spiffs_dir = HOST_SPIFFS_DIR;
+    host_port.asset_image = HOST_ASSET_IMAGE;
+    while((opt = getopt(argc, argv, "s:a:p:t:e:i:o:r:f:nm:h")) != -1) {
+        switch(opt) {
+            case 's':
+                host_port.spiffs_dir = optarg;
+                break;
+            case 'a':
+                host_port.asset_image = strcmp(optarg, "-") == 0 ? NULL : optarg;
+                break;
+            case 'p':
+                host_httpd_port = atoi(optarg);
+                break;
+            case 't':
+                run_s = atoi(optarg);
+                break;
+            case 'e':
+                emotions = optarg;
+                break;
+            case 'i':
+                emotion_interval_ms = atoi(optarg);
+                break;
+            case 'o':
+                host_port.pcm_out = optarg;
+                break;
+            case 'r':
+                host_port.servo_log = optarg;
+                break;
+            case 'f':
+                ppm = optarg;
+                break;
+            case 'n':
+                host_port.spi_realtime = false;
+                break;
+            case 'm':
+                soak = true;
+                run_s = atoi(optarg) * 60;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if(soak && (emotions == NULL || run_s == 0)) {
+        fprintf(stderr, "%s: -m needs -e and at least one minute\n", argv[0]);
+        return 1;
+    }
+#if LV_USE_STDLIB_MALLOC != LV_STDLIB_BUILTIN
+    if(soak) {
+        fprintf(stderr, "%s: -m needs LVGL's own heap, build with -DCLIB_MALLOC=OFF\n", argv[0]);
+        return 1;
+    }
+#endif
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    xTaskCreate(main_task, "main", 8192, NULL, 1, NULL);
+    if(emotions) {
+        xTaskCreate(emotion_task, "emotion", 4096, NULL, 1, NULL);
+    }
+    for(unsigned ms = 0; !stop_requested && (run_s == 0 || ms < run_s * 1000); ms += 100) {
+        usleep(100 * 1000);
+    }
+
+    printf("\n");
+    host_lcd_report();
+    host_i2s_report();
+    host_ledc_report();
+    // 第一块屏存到 -f 指定的文件，其余的在文件名后加 _序号
+    for(int i = 0; ppm && i < host_lcd_panel_count(); i++) {
+        char path[256];
+        const char *ext = strrchr(ppm, '.');
+        int base_len = ext ? (int)(ext - ppm) : (int)strlen(ppm);
+        if(i == 0) {
+            snprintf(path, sizeof(path), "%s", ppm);
+        } else {
+            snprintf(path, sizeof(path), "%.*s_%d%s", base_len, ppm, i, ext ? ext : "");
+        }
+        if(!host_lcd_save_ppm(i, path)) {
+            fprintf(stderr, "host: save %s fail\n", path);
+        }
+    }
+    bool ok = !soak || soak_report();
+    fflush(NULL);
+    // 固件任务不会退出，直接结束进程
+    _exit(ok ? 0 : 1);
+}
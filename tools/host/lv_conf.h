@@ -0,0 +1,33 @@
+/**
+ * 主机构建使用的 LVGL 配置: 与设备一样用操作系统移植(这里是 pthread)，
+ * "S:" 盘符映射到 /spiffs(再由移植层映射到本机目录)，绘制单元数和堆见 CMakeLists.txt 的 DRAW_UNITS、CLIB_MALLOC
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+
+/* 默认与设备一样用 LVGL 自带的堆(Kconfig 默认 64KB)，lv_mem_monitor 才有数据(泄漏测试用);
+ * HOST_CLIB_MALLOC 改用 malloc，sanitizer 能检查 LVGL 申请的内存 */
+#ifdef HOST_CLIB_MALLOC
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#else
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE                 (64 * 1024U)
+#endif
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+
+#define LV_USE_OS                   LV_OS_PTHREAD
+#define LV_USE_LOG                  0
+
+#ifndef HOST_DRAW_UNITS
+#define HOST_DRAW_UNITS             1
+#endif
+#define LV_DRAW_SW_DRAW_UNIT_CNT    HOST_DRAW_UNITS
+
+#define LV_USE_FS_STDIO             1
+#define LV_FS_STDIO_LETTER          'S'
+#define LV_FS_STDIO_PATH            "/spiffs"
+
+#endif
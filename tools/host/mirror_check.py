@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+屏幕镜像检查工具
+
+启动固件的主机构建(robot_host)，通过 /ws 订阅屏幕镜像，把收到的变化区域解码到 240x240 的帧缓冲，
+程序退出后和它保存的屏幕显存(PPM)逐像素比较。每种编码各运行一次。
+圆屏(LCD_ROUND_DISPLAY)的四角看不到，开始镜像时的整屏重画也不会发送，只比较可见圆内的像素(--square 比较整屏)。
+
+镜像帧格式见 main/mirror.h (小端):
+    帧头      24 字节   magic "MIR1", u32 seq, u32 time_ms, u16 rect_cnt, u16 flags,
+                        u32 skipped, u32 lost
+    区域      rect_cnt 个，每个 16 字节头 u16 x, u16 y, u16 w, u16 h, u8 codec, 3 字节保留, u32 size
+              后面跟 size 字节数据，解码后为 w * h 个高字节在前的 RGB565 像素
+              codec 0: 原样  1: lv_rle(2 字节一块)  2: LZ4 块格式
+
+用法:
+    mirror_check.py --robot-host _build/robot_host [--codec lz4 rle raw] [--seconds 6]
+"""
+
+import argparse
+import base64
+import json
+import os
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+MIRROR_MAGIC = b'MIR1'
+MIRROR_FRAME = struct.Struct('<4sIIHHII')
+MIRROR_RECT = struct.Struct('<HHHHB3xI')
+MIRROR_FLAG_RESYNC = 0x0001
+CODECS = {'raw': 0, 'rle': 1, 'lz4': 2}
+WIDTH = 240
+HEIGHT = 240
+# 与 d_lcd.c 的 LCD_ROUND_MARGIN 相同
+ROUND_MARGIN = 1
+
+
+class MirrorError(Exception):
+    pass
+
+
+def ws_frame(opcode, data):
+    """客户端发出的帧必须加掩码"""
+    mask = os.urandom(4)
+    n = len(data)
+    head = bytes([0x80 | opcode])
+    if n < 126:
+        head += bytes([0x80 | n])
+    elif n < 65536:
+        head += bytes([0x80 | 126]) + struct.pack('>H', n)
+    else:
+        head += bytes([0x80 | 127]) + struct.pack('>Q', n)
+    # 整段当作一个大整数异或，比逐字节快得多(音频流测试一帧有几百KB)
+    masked = int.from_bytes(data, 'little') ^ int.from_bytes((mask * (n // 4 + 1))[:n], 'little')
+    return head + mask + masked.to_bytes(n, 'little')
+
+
+def ws_recv(sock):
+    def read(n):
+        buf = b''
+        while len(buf) < n:
+            chunk = sock.recv(n - len(buf))
+            if not chunk:
+                raise EOFError
+            buf += chunk
+        return buf
+
+    head = read(2)
+    n = head[1] & 0x7f
+    if n == 126:
+        n = struct.unpack('>H', read(2))[0]
+    elif n == 127:
+        n = struct.unpack('>Q', read(8))[0]
+    return head[0] & 0x0f, read(n)
+
+
+def ws_connect(port, timeout):
+    deadline = time.time() + timeout
+    while True:
+        try:
+            sock = socket.create_connection(('127.0.0.1', port))
+        except OSError:
+            if time.time() > deadline:
+                raise MirrorError('cannot connect to port %d' % port)
+            time.sleep(0.1)
+            continue
+        key = base64.b64encode(os.urandom(16)).decode()
+        sock.send(('GET /ws HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n'
+                   'Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n' % key).encode())
+        resp = b''
+        while b'\r\n\r\n' not in resp:
+            chunk = sock.recv(1)
+            if not chunk:
+                raise MirrorError('handshake failed')
+            resp += chunk
+        status = resp.split(b'\r\n', 1)[0]
+        if b' 101 ' in status:
+            return sock
+        sock.close()
+        # 服务器先启动，/ws 稍后才注册
+        if b' 404 ' not in status or time.time() > deadline:
+            raise MirrorError('handshake failed: %r' % status)
+        time.sleep(0.1)
+
+
+def lz4_decode(src, size):
+    """LZ4 块格式解码"""
+    out = bytearray()
+    i = 0
+    while i < len(src):
+        token = src[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = src[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        out += src[i:i + lit]
+        i += lit
+        if i >= len(src):
+            break
+        offset = src[i] | src[i + 1] << 8
+        i += 2
+        if offset == 0 or offset > len(out):
+            raise MirrorError('lz4: bad offset %d' % offset)
+        match = token & 0x0f
+        if match == 15:
+            while True:
+                b = src[i]
+                i += 1
+                match += b
+                if b != 255:
+                    break
+        match += 4
+        start = len(out) - offset
+        for k in range(match):
+            out.append(out[start + k])
+    if len(out) != size:
+        raise MirrorError('lz4: decoded %d bytes, expect %d' % (len(out), size))
+    return bytes(out)
+
+
+def rle_decode(src, size):
+    """lv_rle 解码，块大小 2 字节"""
+    out = bytearray()
+    i = 0
+    while i < len(src):
+        ctrl = src[i]
+        i += 1
+        if ctrl & 0x80:
+            n = (ctrl & 0x7f) * 2
+            out += src[i:i + n]
+            i += n
+        else:
+            out += src[i:i + 2] * ctrl
+            i += 2
+    if len(out) != size:
+        raise MirrorError('rle: decoded %d bytes, expect %d' % (len(out), size))
+    return bytes(out)
+
+
+def apply_frame(fb, data, stats):
+    magic, seq, _, rect_cnt, flags, skipped, lost = MIRROR_FRAME.unpack_from(data)
+    if magic != MIRROR_MAGIC:
+        raise MirrorError('bad magic %r' % magic)
+    if seq != stats['frames']:
+        raise MirrorError('seq %d, expect %d' % (seq, stats['frames']))
+    stats['frames'] += 1
+    stats['skipped'] = skipped
+    stats['lost'] = lost
+    stats['resync'] += bool(flags & MIRROR_FLAG_RESYNC)
+    stats['bytes'] += len(data)
+    pos = MIRROR_FRAME.size
+    for _ in range(rect_cnt):
+        x, y, w, h, codec, size = MIRROR_RECT.unpack_from(data, pos)
+        pos += MIRROR_RECT.size
+        payload = data[pos:pos + size]
+        pos += size
+        raw = w * h * 2
+        if x + w > WIDTH or y + h > HEIGHT:
+            raise MirrorError('rect %d,%d %dx%d out of screen' % (x, y, w, h))
+        if codec == CODECS['lz4']:
+            px = lz4_decode(payload, raw)
+        elif codec == CODECS['rle']:
+            px = rle_decode(payload, raw)
+        elif codec == CODECS['raw'] and size == raw:
+            px = payload
+        else:
+            raise MirrorError('bad rect codec %d size %d' % (codec, size))
+        for row in range(h):
+            off = ((y + row) * WIDTH + x) * 2
+            fb[off:off + w * 2] = px[row * w * 2:(row + 1) * w * 2]
+        stats['rects'] += 1
+        stats['raw'] += raw
+    if pos != len(data):
+        raise MirrorError('frame %d: %d trailing bytes' % (seq, len(data) - pos))
+
+
+def fb_to_rgb(fb):
+    """与主机构建保存 PPM 相同的换算"""
+    rgb = bytearray()
+    for i in range(0, len(fb), 2):
+        px = fb[i] << 8 | fb[i + 1]
+        rgb += bytes(((px >> 11) * 255 // 31, ((px >> 5) & 0x3f) * 255 // 63, (px & 0x1f) * 255 // 31))
+    return bytes(rgb)
+
+
+def visible(x, y, square):
+    """与 d_lcd.c 的 lcd_round_init 相同: 坐标乘2后像素中心在放大了边距的内切圆内即可见"""
+    if square:
+        return True
+    dx = 2 * x + 1 - WIDTH
+    dy = 2 * y + 1 - HEIGHT
+    r = WIDTH + 2 * ROUND_MARGIN
+    return dx * dx + dy * dy <= r * r
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    header = data.split(b'\n', 3)
+    if header[0] != b'P6' or header[1] != b'%d %d' % (WIDTH, HEIGHT):
+        raise MirrorError('%s: unexpected PPM header' % path)
+    return header[3]
+
+
+def check(robot_host, codec, seconds, emotion, port, fps, square):
+    ppm = tempfile.NamedTemporaryFile(suffix='.ppm', delete=False).name
+    # 表情间隔比运行时间长: 播放一次后屏幕空闲，退出时显存与最后一帧镜像相同
+    cmd = [robot_host, '-t', str(seconds), '-p', str(port), '-e', emotion, '-i', str(seconds * 1000 * 10),
+           '-f', ppm]
+    proc = subprocess.Popen(cmd, cwd=os.path.dirname(os.path.abspath(robot_host)),
+                            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    fb = bytearray(WIDTH * HEIGHT * 2)
+    stats = dict(frames=0, rects=0, bytes=0, raw=0, skipped=0, lost=0, resync=0)
+    try:
+        sock = ws_connect(port, 5)
+        sock.send(ws_frame(1, json.dumps({'event': 'mirror',
+                                          'data': {'on': True, 'codec': codec, 'fps': fps}}).encode()))
+        try:
+            while True:
+                opcode, data = ws_recv(sock)
+                if opcode == 1:
+                    reply = json.loads(data)
+                    if reply.get('event') == 'mirror_ret' and not reply.get('ret'):
+                        raise MirrorError('mirror start failed')
+                elif opcode == 2:
+                    apply_frame(fb, data, stats)
+        except (EOFError, ConnectionResetError):
+            pass
+        proc.wait(10)
+        if proc.returncode != 0:
+            raise MirrorError('robot_host exit %d' % proc.returncode)
+        expect = read_ppm(ppm)
+    finally:
+        if proc.poll() is None:
+            proc.kill()
+        os.unlink(ppm)
+    got = fb_to_rgb(fb)
+    diff = sum(1 for i in range(0, len(got), 3)
+               if got[i:i + 3] != expect[i:i + 3] and visible(i // 3 % WIDTH, i // 3 // WIDTH, square))
+    ratio = stats['bytes'] * 100 // max(stats['raw'], 1)
+    print('%-4s frames %d, rects %d, sent %d KB (%d%% of raw), skipped %d, lost %d, resync %d, diff %d px'
+          % (codec, stats['frames'], stats['rects'], stats['bytes'] // 1024, ratio, stats['skipped'],
+             stats['lost'], stats['resync'], diff))
+    if stats['frames'] == 0:
+        raise MirrorError('no mirror frame received')
+    if stats['resync'] == 0:
+        raise MirrorError('first frame is not marked resync')
+    return diff == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check the WebSocket screen mirror against the host panel content')
+    parser.add_argument('--robot-host', required=True, help='robot_host executable of the host build')
+    parser.add_argument('--codec', nargs='+', choices=sorted(CODECS), default=['lz4', 'rle', 'raw'])
+    parser.add_argument('--seconds', type=int, default=6, help='run time of each check')
+    parser.add_argument('--emotion', default='normal', help='emotion to play during the check')
+    parser.add_argument('--fps', type=int, default=30, help='mirror frame rate to request')
+    parser.add_argument('--port', type=int, default=18090)
+    parser.add_argument('--square', action='store_true', help='compare the corners too (LCD_ROUND_DISPLAY off)')
+    args = parser.parse_args()
+
+    ok = True
+    for i, codec in enumerate(args.codec):
+        try:
+            ok &= check(args.robot_host, codec, args.seconds, args.emotion, args.port + i, args.fps, args.square)
+        except (MirrorError, OSError, subprocess.TimeoutExpired) as e:
+            print('%s: %s' % (codec, e), file=sys.stderr)
+            ok = False
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
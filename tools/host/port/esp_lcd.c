@@ -0,0 +1,428 @@
+/**
+ * 屏幕替身: 一条 SPI 总线上的若干块 GC9A01 模型(每个片选一块)，像素写进各自 240x240 的显存。
+ * 与 esp_lcd 的 SPI 面板IO一样，每次 draw_bitmap 先用轮询方式发 CASET/RASET，
+ * 轮询要占用总线，发命令前要等总线上在途的像素传输(包括发给其它屏的)全部完成，再把像素数据排队交给"DMA"线程。
+ * 总线上只有一个 DMA 线程，按排队顺序逐个传输，按 pclk_hz 计算传输耗时，到时才从缓冲读出像素写进显存
+ * 并调用该屏的 on_color_trans_done，排队时和完成时缓冲内容不一致说明固件提前改写了正在发送的缓冲，计入 corrupt
+ */
+#include "esp_lcd_gc9a01.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_port.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PANEL_H_RES         240
+#define PANEL_V_RES         240
+#define PANEL_BPP           2
+/* CASET/RASET 各4字节参数，加上三条命令 */
+#define PANEL_CMD_BYTES     11
+#define IO_QUEUE_MAX        16
+#define PANEL_MAX           4
+
+static const char *TAG = "host_lcd";
+
+struct host_lcd_panel_io;
+
+typedef struct {
+    struct host_lcd_panel_io *io;
+    const uint8_t *data;
+    size_t size;
+    int x1, y1, x2, y2;
+    uint32_t sum;
+} lcd_trans_t;
+
+typedef struct {
+    uint32_t trans;
+    uint64_t bytes;
+    uint64_t cmd_bytes;
+    uint64_t busy_us;
+    uint32_t corrupt;
+    uint32_t slpin;
+    uint32_t slpout;
+    uint32_t px_while_off;
+} lcd_stats_t;
+
+struct host_lcd_panel;
+
+struct host_lcd_panel_io {
+    unsigned int pclk_hz;
+    int cs_gpio_num;
+    size_t queue_depth;
+    size_t count;               // 本设备在途的传输数
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+    struct host_lcd_panel *panel;
+};
+
+struct host_lcd_panel {
+    struct host_lcd_panel_io *io;
+    uint8_t gram[PANEL_H_RES * PANEL_V_RES * PANEL_BPP];
+    bool on;
+    bool sleeping;
+    bool mirror_x;
+    bool mirror_y;
+    lcd_stats_t stats;
+};
+
+/* 整个进程只有一条总线，所有设备的传输在这里排队 */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t dma_thread;
+    bool started;
+    lcd_trans_t queue[IO_QUEUE_MAX];
+    size_t head;
+    size_t count;
+    int64_t busy_until_us;
+    uint64_t busy_us;
+} lcd_bus = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static struct host_lcd_panel *lcd_panels[PANEL_MAX];
+static int lcd_panel_cnt;
+
+static uint32_t checksum(const uint8_t *data, size_t size)
+{
+    uint32_t sum = 2166136261u;
+    for(size_t i = 0; i < size; i++) {
+        sum = (sum ^ data[i]) * 16777619u;
+    }
+    return sum;
+}
+
+static void sleep_until(int64_t until_us)
+{
+    int64_t left_us = until_us - esp_timer_get_time();
+    if(left_us > 0) {
+        struct timespec ts = {.tv_sec = left_us / 1000000, .tv_nsec = (left_us % 1000000) * 1000};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void *lcd_dma_thread(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&lcd_bus.lock);
+    while(1) {
+        while(lcd_bus.count == 0) {
+            pthread_cond_wait(&lcd_bus.cond, &lcd_bus.lock);
+        }
+        lcd_trans_t trans = lcd_bus.queue[lcd_bus.head];
+        struct host_lcd_panel_io *io = trans.io;
+        int64_t start_us = esp_timer_get_time();
+        if(lcd_bus.busy_until_us > start_us) {
+            start_us = lcd_bus.busy_until_us;
+        }
+        int64_t time_us = (int64_t)trans.size * 8 * 1000000 / io->pclk_hz;
+        lcd_bus.busy_until_us = start_us + time_us;
+        pthread_mutex_unlock(&lcd_bus.lock);
+
+        if(host_port.spi_realtime) {
+            sleep_until(start_us + time_us);
+        }
+        struct host_lcd_panel *panel = io->panel;
+        bool corrupt = checksum(trans.data, trans.size) != trans.sum;
+        if(panel) {
+            const uint8_t *src = trans.data;
+            size_t line = (size_t)(trans.x2 - trans.x1) * PANEL_BPP;
+            for(int y = trans.y1; y < trans.y2; y++) {
+                memcpy(&panel->gram[(y * PANEL_H_RES + trans.x1) * PANEL_BPP], src, line);
+                src += line;
+            }
+        }
+
+        pthread_mutex_lock(&lcd_bus.lock);
+        lcd_bus.busy_us += time_us;
+        if(panel) {
+            panel->stats.trans++;
+            panel->stats.bytes += trans.size;
+            panel->stats.busy_us += time_us;
+            panel->stats.corrupt += corrupt;
+            if(panel->sleeping || !panel->on) {
+                panel->stats.px_while_off++;
+            }
+        }
+        pthread_mutex_unlock(&lcd_bus.lock);
+        /* 先回调再出队: 回调里归还的缓冲可能马上被再次排队 */
+        if(io->on_color_trans_done) {
+            io->on_color_trans_done(io, NULL, io->user_ctx);
+        }
+        pthread_mutex_lock(&lcd_bus.lock);
+        lcd_bus.head = (lcd_bus.head + 1) % IO_QUEUE_MAX;
+        lcd_bus.count--;
+        io->count--;
+        pthread_cond_broadcast(&lcd_bus.cond);
+    }
+    return NULL;
+}
+
+/* 轮询方式发命令要占用总线，先等总线上在途的像素传输全部完成。调用时持有 lcd_bus.lock */
+static void lcd_bus_wait_idle(void)
+{
+    while(lcd_bus.count) {
+        pthread_cond_wait(&lcd_bus.cond, &lcd_bus.lock);
+    }
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus_config, spi_dma_chan_t dma_chan)
+{
+    (void)host;
+    (void)bus_config;
+    (void)dma_chan;
+    pthread_mutex_lock(&lcd_bus.lock);
+    if(!lcd_bus.started) {
+        pthread_create(&lcd_bus.dma_thread, NULL, lcd_dma_thread, NULL);
+        pthread_detach(lcd_bus.dma_thread);
+        lcd_bus.started = true;
+    }
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *io_config,
+                                   esp_lcd_panel_io_handle_t *ret_io)
+{
+    (void)bus;
+    if(!lcd_bus.started) {
+        ESP_LOGE(TAG, "spi bus not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    struct host_lcd_panel_io *io = calloc(1, sizeof(*io));
+    if(io == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    io->pclk_hz = io_config->pclk_hz;
+    io->cs_gpio_num = io_config->cs_gpio_num;
+    io->queue_depth = io_config->trans_queue_depth;
+    if(io->queue_depth == 0 || io->queue_depth > IO_QUEUE_MAX) {
+        io->queue_depth = IO_QUEUE_MAX;
+    }
+    io->on_color_trans_done = io_config->on_color_trans_done;
+    io->user_ctx = io_config->user_ctx;
+    *ret_io = io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    pthread_mutex_lock(&lcd_bus.lock);
+    io->on_color_trans_done = cbs->on_color_trans_done;
+    io->user_ctx = user_ctx;
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    (void)param;
+    pthread_mutex_lock(&lcd_bus.lock);
+    lcd_bus_wait_idle();
+    struct host_lcd_panel *panel = io->panel;
+    if(panel) {
+        panel->stats.cmd_bytes += 1 + param_size;
+        switch(lcd_cmd) {
+            case LCD_CMD_SLPIN:
+                panel->sleeping = true;
+                panel->stats.slpin++;
+                break;
+            case LCD_CMD_SLPOUT:
+                panel->sleeping = false;
+                panel->stats.slpout++;
+                break;
+            case LCD_CMD_DISPON:
+                panel->on = true;
+                break;
+            case LCD_CMD_DISPOFF:
+                panel->on = false;
+                break;
+        }
+    }
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    (void)io;
+    (void)lcd_cmd;
+    (void)color;
+    (void)color_size;
+    ESP_LOGE(TAG, "tx_color without a window is not modelled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    (void)io;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_new_panel_gc9a01(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
+                                   esp_lcd_panel_handle_t *ret_panel)
+{
+    (void)panel_dev_config;
+    if(lcd_panel_cnt >= PANEL_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    struct host_lcd_panel *panel = calloc(1, sizeof(*panel));
+    if(panel == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    panel->io = io;
+    pthread_mutex_lock(&lcd_bus.lock);
+    io->panel = panel;
+    lcd_panels[lcd_panel_cnt++] = panel;
+    pthread_mutex_unlock(&lcd_bus.lock);
+    *ret_panel = panel;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    pthread_mutex_lock(&lcd_bus.lock);
+    lcd_bus_wait_idle();
+    panel->on = false;
+    panel->sleeping = true;
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+/* 与 GC9A01 驱动的初始化序列一样，最后退出睡眠 */
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return esp_lcd_panel_io_tx_param(panel->io, LCD_CMD_SLPOUT, NULL, 0);
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    (void)panel;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data)
+{
+    if(x_start < 0 || y_start < 0 || x_end > PANEL_H_RES || y_end > PANEL_V_RES || x_start >= x_end ||
+       y_start >= y_end) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct host_lcd_panel_io *io = panel->io;
+    size_t size = (size_t)(x_end - x_start) * (y_end - y_start) * PANEL_BPP;
+    lcd_trans_t trans = {
+        .io = io,
+        .data = color_data,
+        .size = size,
+        .x1 = x_start,
+        .y1 = y_start,
+        .x2 = x_end,
+        .y2 = y_end,
+        .sum = checksum(color_data, size),
+    };
+    pthread_mutex_lock(&lcd_bus.lock);
+    /* CASET/RASET 是轮询发送的，先等总线上前面的像素发完 */
+    lcd_bus_wait_idle();
+    while(io->count >= io->queue_depth || lcd_bus.count >= IO_QUEUE_MAX) {
+        pthread_cond_wait(&lcd_bus.cond, &lcd_bus.lock);
+    }
+    panel->stats.cmd_bytes += PANEL_CMD_BYTES;
+    lcd_bus.queue[(lcd_bus.head + lcd_bus.count) % IO_QUEUE_MAX] = trans;
+    lcd_bus.count++;
+    io->count++;
+    pthread_cond_broadcast(&lcd_bus.cond);
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    pthread_mutex_lock(&lcd_bus.lock);
+    panel->mirror_x = mirror_x;
+    panel->mirror_y = mirror_y;
+    pthread_mutex_unlock(&lcd_bus.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    (void)panel;
+    (void)swap_axes;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data)
+{
+    (void)panel;
+    (void)invert_color_data;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    return esp_lcd_panel_io_tx_param(panel->io, on_off ? LCD_CMD_DISPON : LCD_CMD_DISPOFF, NULL, 0);
+}
+
+void host_lcd_report(void)
+{
+    pthread_mutex_lock(&lcd_bus.lock);
+    int64_t now = esp_timer_get_time();
+    for(int i = 0; i < lcd_panel_cnt; i++) {
+        const lcd_stats_t *s = &lcd_panels[i]->stats;
+        ESP_LOGI(TAG, "panel %d (cs %d): %lu transfers, %llu KB pixels, %llu B commands, spi busy %llu ms, "
+                 "corrupt %lu, slpin %lu, slpout %lu, transfers while off %lu",
+                 i, lcd_panels[i]->io->cs_gpio_num, (unsigned long)s->trans, (unsigned long long)s->bytes / 1024,
+                 (unsigned long long)s->cmd_bytes, (unsigned long long)s->busy_us / 1000, (unsigned long)s->corrupt,
+                 (unsigned long)s->slpin, (unsigned long)s->slpout, (unsigned long)s->px_while_off);
+    }
+    if(lcd_panel_cnt) {
+        ESP_LOGI(TAG, "bus: busy %llu ms (%llu%% of %llu ms)", (unsigned long long)lcd_bus.busy_us / 1000,
+                 (unsigned long long)(now ? lcd_bus.busy_us * 100 / now : 0), (unsigned long long)now / 1000);
+    }
+    pthread_mutex_unlock(&lcd_bus.lock);
+}
+
+int host_lcd_panel_count(void)
+{
+    return lcd_panel_cnt;
+}
+
+/* 这块屏的扫描方向是水平镜像的: 固件设置 mirror_x 时画面与 LVGL 坐标一致，不设置时左右翻转 */
+bool host_lcd_save_ppm(int index, const char *path)
+{
+    if(index < 0 || index >= lcd_panel_cnt) {
+        return false;
+    }
+    const struct host_lcd_panel *panel = lcd_panels[index];
+    FILE *fp = fopen(path, "wb");
+    if(fp == NULL) {
+        return false;
+    }
+    fprintf(fp, "P6\n%d %d\n255\n", PANEL_H_RES, PANEL_V_RES);
+    /* 显存是 SPI 字节序(高字节在前)的 RGB565 */
+    for(int y = 0; y < PANEL_V_RES; y++) {
+        int gy = panel->mirror_y ? PANEL_V_RES - 1 - y : y;
+        for(int x = 0; x < PANEL_H_RES; x++) {
+            int gx = panel->mirror_x ? x : PANEL_H_RES - 1 - x;
+            const uint8_t *p = &panel->gram[(gy * PANEL_H_RES + gx) * PANEL_BPP];
+            uint16_t px = p[0] << 8 | p[1];
+            uint8_t rgb[3] = {
+                (uint8_t)((px >> 11) * 255 / 31),
+                (uint8_t)(((px >> 5) & 0x3f) * 255 / 63),
+                (uint8_t)((px & 0x1f) * 255 / 31),
+            };
+            fwrite(rgb, 1, 3, fp);
+        }
+    }
+    fclose(fp);
+    return true;
+}
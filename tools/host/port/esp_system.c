@@ -0,0 +1,281 @@
+/**
+ * 主机端的 ESP-IDF 系统服务: 时间、日志时间戳、错误名、堆、NVS、资源分区和 spiffs。
+ * spiffs 挂载点下的路径在 fopen/stat 时映射到本机目录(链接时用 --wrap 接管)，
+ * 固件和 LVGL 的 stdio 文件系统驱动不用改
+ */
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+#include "host_port.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *TAG = "host";
+
+host_port_config_t host_port = {
+    .spi_realtime = true,
+};
+
+static int64_t start_us;
+
+/* 第一个构造函数之前没有人取时间 */
+__attribute__((constructor)) static void time_init(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    start_us = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 - start_us;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if(size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch(code) {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_FAIL:
+            return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:
+            return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:
+            return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:
+            return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        default:
+            return "UNKNOWN ERROR";
+    }
+}
+
+/*=====================
+ * 堆
+ *====================*/
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return calloc(n, size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    (void)caps;
+    /* aligned_alloc 要求大小是对齐的整数倍 */
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+/*=====================
+ * NVS
+ *====================*/
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    return ESP_OK;
+}
+
+/*=====================
+ * 资源分区: 镜像文件
+ *====================*/
+
+static esp_partition_t asset_partition;
+static int asset_fd = -1;
+static void *asset_map_ptr;
+static size_t asset_map_size;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    (void)type;
+    (void)subtype;
+    if(host_port.asset_image == NULL) {
+        return NULL;
+    }
+    if(asset_fd < 0) {
+        asset_fd = open(host_port.asset_image, O_RDONLY);
+        struct stat st;
+        if(asset_fd < 0 || fstat(asset_fd, &st) != 0) {
+            ESP_LOGW(TAG, "asset image %s: open fail", host_port.asset_image);
+            return NULL;
+        }
+        asset_partition.type = type;
+        asset_partition.subtype = subtype;
+        asset_partition.size = st.st_size;
+        snprintf(asset_partition.label, sizeof(asset_partition.label), "%s", label ? label : "");
+    }
+    return &asset_partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if(partition != &asset_partition || src_offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return pread(asset_fd, dst, size, src_offset) == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle)
+{
+    (void)memory;
+    if(partition != &asset_partition || offset != 0 || size > partition->size || asset_map_ptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    void *ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, asset_fd, 0);
+    if(ptr == MAP_FAILED) {
+        return ESP_ERR_NO_MEM;
+    }
+    asset_map_ptr = ptr;
+    asset_map_size = size;
+    *out_ptr = ptr;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    (void)handle;
+    if(asset_map_ptr) {
+        munmap(asset_map_ptr, asset_map_size);
+        asset_map_ptr = NULL;
+    }
+}
+
+/*=====================
+ * spiffs: 挂载点映射到本机目录
+ *====================*/
+
+static char spiffs_base[32];
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    struct stat st;
+    if(host_port.spiffs_dir == NULL || stat(host_port.spiffs_dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        ESP_LOGE(TAG, "spiffs dir %s not found", host_port.spiffs_dir ? host_port.spiffs_dir : "(none)");
+        return ESP_ERR_NOT_FOUND;
+    }
+    snprintf(spiffs_base, sizeof(spiffs_base), "%s", conf->base_path);
+    ESP_LOGI(TAG, "%s -> %s", spiffs_base, host_port.spiffs_dir);
+    return ESP_OK;
+}
+
+/* 累计目录下所有文件的大小 */
+static size_t dir_size(const char *path)
+{
+    size_t total = 0;
+    DIR *dir = opendir(path);
+    if(dir == NULL) {
+        return 0;
+    }
+    struct dirent *ent;
+    while((ent = readdir(dir)) != NULL) {
+        if(ent->d_name[0] == '.') {
+            continue;
+        }
+        char child[PATH_MAX];
+        struct stat st;
+        snprintf(child, sizeof(child), "%s/%s", path, ent->d_name);
+        if(stat(child, &st) != 0) {
+            continue;
+        }
+        total += S_ISDIR(st.st_mode) ? dir_size(child) : (size_t)st.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    (void)partition_label;
+    if(spiffs_base[0] == '\0') {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *used_bytes = dir_size(host_port.spiffs_dir);
+    *total_bytes = *used_bytes;
+    return ESP_OK;
+}
+
+/* 挂载点下的路径换成本机目录下的路径，其它路径原样返回 */
+static const char *spiffs_path(const char *path, char *buf, size_t size)
+{
+    size_t len = strlen(spiffs_base);
+    if(len == 0 || strncmp(path, spiffs_base, len) != 0 || (path[len] != '/' && path[len] != '\0')) {
+        return path;
+    }
+    snprintf(buf, size, "%s%s", host_port.spiffs_dir, path + len);
+    return buf;
+}
+
+FILE *__real_fopen(const char *path, const char *mode);
+int __real_stat(const char *path, struct stat *st);
+
+FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    char buf[PATH_MAX];
+    return __real_fopen(spiffs_path(path, buf, sizeof(buf)), mode);
+}
+
+int __wrap_stat(const char *path, struct stat *st)
+{
+    char buf[PATH_MAX];
+    return __real_stat(spiffs_path(path, buf, sizeof(buf)), st);
+}
@@ -0,0 +1,536 @@
+/**
+ * FreeRTOS 接口的 pthread 实现: 任务是线程，队列和信号量是互斥锁加条件变量，
+ * 定时器在一个定时器线程中执行。只保证固件用到的语义，不模拟优先级和抢占
+ */
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    char name[16];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_value;
+    bool notify_pending;
+};
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+    uint8_t *items;
+};
+
+struct host_timer {
+    struct host_timer *next;
+    char name[16];
+    TickType_t period;
+    bool auto_reload;
+    bool active;
+    int64_t expiry_us;
+    void *id;
+    TimerCallbackFunction_t cb;
+};
+
+static __thread struct host_task *current_task;
+
+/* timeout 个tick之后的绝对时间，用于 pthread_cond_timedwait */
+static void deadline_after(struct timespec *ts, TickType_t timeout)
+{
+    uint64_t ms = pdTICKS_TO_MS(timeout);
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * 1000000L;
+    if(ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/* 等待条件变量，超时返回 false。timeout 为0时不等待 */
+static bool cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t timeout, const struct timespec *deadline)
+{
+    if(timeout == 0) {
+        return false;
+    }
+    if(timeout == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/*=====================
+ * 任务
+ *====================*/
+
+static struct host_task *task_new(const char *name)
+{
+    struct host_task *task = calloc(1, sizeof(*task));
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    pthread_mutex_init(&task->lock, NULL);
+    cond_init(&task->cond);
+    return task;
+}
+
+/* 不是由 xTaskCreate 创建的线程(主线程、LVGL 的绘制线程)第一次用到任务接口时补建任务对象 */
+static struct host_task *task_self(void)
+{
+    if(current_task == NULL) {
+        current_task = task_new("ext");
+        current_task->thread = pthread_self();
+    }
+    return current_task;
+}
+
+static void *task_entry(void *arg)
+{
+    struct host_task *task = arg;
+    current_task = task;
+    pthread_setname_np(pthread_self(), task->name);
+    task->fn(task->arg);
+    /* FreeRTOS 的任务函数不能返回，必须自己删除 */
+    fprintf(stderr, "task %s returned without vTaskDelete\n", task->name);
+    abort();
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)stack_depth;
+    (void)priority;
+    (void)core;
+    struct host_task *task = task_new(name);
+    task->fn = fn;
+    task->arg = arg;
+    if(handle) {
+        *handle = task;
+    }
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int ret = pthread_create(&task->thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+    return ret == 0 ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    if(handle == NULL || handle == current_task) {
+        /* 任务对象不释放，别的任务可能还拿着句柄 */
+        pthread_exit(NULL);
+    }
+    pthread_cancel(handle->thread);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    uint64_t us = (uint64_t)pdTICKS_TO_MS(ticks) * 1000;
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000};
+    while(nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return task_self();
+}
+
+const char *pcTaskGetName(TaskHandle_t handle)
+{
+    return (handle ? handle : task_self())->name;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t handle, uint32_t value, eNotifyAction action)
+{
+    BaseType_t ret = pdPASS;
+    pthread_mutex_lock(&handle->lock);
+    switch(action) {
+        case eSetBits:
+            handle->notify_value |= value;
+            break;
+        case eIncrement:
+            handle->notify_value++;
+            break;
+        case eSetValueWithOverwrite:
+            handle->notify_value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if(handle->notify_pending) {
+                ret = pdFAIL;
+            } else {
+                handle->notify_value = value;
+            }
+            break;
+        case eNoAction:
+            break;
+    }
+    handle->notify_pending = true;
+    pthread_cond_broadcast(&handle->cond);
+    pthread_mutex_unlock(&handle->lock);
+    return ret;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t handle, uint32_t value, eNotifyAction action, BaseType_t *woken)
+{
+    if(woken) {
+        *woken = pdFALSE;
+    }
+    return xTaskNotify(handle, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t timeout)
+{
+    struct host_task *task = task_self();
+    struct timespec deadline;
+    deadline_after(&deadline, timeout);
+    pthread_mutex_lock(&task->lock);
+    if(!task->notify_pending) {
+        task->notify_value &= ~clear_on_entry;
+    }
+    while(!task->notify_pending && cond_wait(&task->cond, &task->lock, timeout, &deadline)) {
+    }
+    if(value) {
+        *value = task->notify_value;
+    }
+    BaseType_t ret = task->notify_pending ? pdTRUE : pdFALSE;
+    if(ret) {
+        task->notify_value &= ~clear_on_exit;
+        task->notify_pending = false;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return ret;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+    return xTaskNotify(handle, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t *woken)
+{
+    xTaskNotifyFromISR(handle, 0, eIncrement, woken);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t timeout)
+{
+    struct host_task *task = task_self();
+    struct timespec deadline;
+    deadline_after(&deadline, timeout);
+    pthread_mutex_lock(&task->lock);
+    while(task->notify_value == 0 && cond_wait(&task->cond, &task->lock, timeout, &deadline)) {
+    }
+    uint32_t value = task->notify_value;
+    if(value) {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    task->notify_pending = false;
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+/*=====================
+ * 队列和信号量
+ *====================*/
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *queue = calloc(1, sizeof(*queue));
+    if(queue == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    cond_init(&queue->cond);
+    queue->length = length;
+    queue->item_size = item_size;
+    if(item_size) {
+        queue->items = calloc(length, item_size);
+        if(queue->items == NULL) {
+            free(queue);
+            return NULL;
+        }
+    }
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+    free(queue->items);
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    struct timespec deadline;
+    deadline_after(&deadline, timeout);
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == queue->length && cond_wait(&queue->cond, &queue->lock, timeout, &deadline)) {
+    }
+    BaseType_t ret = queue->count < queue->length ? pdPASS : pdFAIL;
+    if(ret) {
+        if(queue->item_size) {
+            UBaseType_t tail = (queue->head + queue->count) % queue->length;
+            memcpy(queue->items + tail * queue->item_size, item, queue->item_size);
+        }
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return ret;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if(woken) {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item)
+{
+    pthread_mutex_lock(&queue->lock);
+    if(queue->item_size) {
+        memcpy(queue->items, item, queue->item_size);
+    }
+    queue->head = 0;
+    queue->count = 1;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t timeout)
+{
+    struct timespec deadline;
+    deadline_after(&deadline, timeout);
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == 0 && cond_wait(&queue->cond, &queue->lock, timeout, &deadline)) {
+    }
+    BaseType_t ret = queue->count ? pdPASS : pdFAIL;
+    if(ret) {
+        if(queue->item_size && item) {
+            memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+        }
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return ret;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->head = 0;
+    queue->count = 0;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    struct host_queue *sem = xQueueCreate(max_count, 0);
+    if(sem) {
+        sem->count = initial_count;
+    }
+    return sem;
+}
+
+/* 不支持优先级继承和递归，固件里的互斥量只用来串行化 */
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    return xQueueSend(sem, NULL, 0);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    if(woken) {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(sem, NULL, 0);
+}
+
+/*=====================
+ * 软件定时器
+ *====================*/
+
+static pthread_mutex_t timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timer_cond;
+static pthread_once_t timer_once = PTHREAD_ONCE_INIT;
+static struct host_timer *timer_list;
+
+static void *timer_thread(void *arg)
+{
+    (void)arg;
+    current_task = task_new("Tmr Svc");
+    pthread_mutex_lock(&timer_lock);
+    while(1) {
+        int64_t now = esp_timer_get_time();
+        int64_t next_us = INT64_MAX;
+        struct host_timer *due = NULL;
+        for(struct host_timer *t = timer_list; t; t = t->next) {
+            if(t->active && t->expiry_us <= now) {
+                due = t;
+                break;
+            }
+            if(t->active && t->expiry_us < next_us) {
+                next_us = t->expiry_us;
+            }
+        }
+        if(due) {
+            if(due->auto_reload) {
+                due->expiry_us += (int64_t)pdTICKS_TO_MS(due->period) * 1000;
+            } else {
+                due->active = false;
+            }
+            /* 回调里可以再操作定时器 */
+            pthread_mutex_unlock(&timer_lock);
+            due->cb(due);
+            pthread_mutex_lock(&timer_lock);
+            continue;
+        }
+        if(next_us == INT64_MAX) {
+            pthread_cond_wait(&timer_cond, &timer_lock);
+        } else {
+            TickType_t ticks = pdMS_TO_TICKS((next_us - now + 999) / 1000);
+            struct timespec deadline;
+            deadline_after(&deadline, ticks);
+            pthread_cond_timedwait(&timer_cond, &timer_lock, &deadline);
+        }
+    }
+    return NULL;
+}
+
+static void timer_service_start(void)
+{
+    cond_init(&timer_cond);
+    pthread_t thread;
+    pthread_create(&thread, NULL, timer_thread, NULL);
+    pthread_detach(thread);
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                           TimerCallbackFunction_t cb)
+{
+    pthread_once(&timer_once, timer_service_start);
+    struct host_timer *timer = calloc(1, sizeof(*timer));
+    if(timer == NULL) {
+        return NULL;
+    }
+    snprintf(timer->name, sizeof(timer->name), "%s", name ? name : "");
+    timer->period = period;
+    timer->auto_reload = auto_reload;
+    timer->id = id;
+    timer->cb = cb;
+    pthread_mutex_lock(&timer_lock);
+    timer->next = timer_list;
+    timer_list = timer;
+    pthread_mutex_unlock(&timer_lock);
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t timeout)
+{
+    (void)timeout;
+    pthread_mutex_lock(&timer_lock);
+    timer->expiry_us = esp_timer_get_time() + (int64_t)pdTICKS_TO_MS(timer->period) * 1000;
+    timer->active = true;
+    pthread_cond_broadcast(&timer_cond);
+    pthread_mutex_unlock(&timer_lock);
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t timeout)
+{
+    return xTimerStart(timer, timeout);
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t timeout)
+{
+    (void)timeout;
+    pthread_mutex_lock(&timer_lock);
+    timer->active = false;
+    pthread_mutex_unlock(&timer_lock);
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t timeout)
+{
+    pthread_mutex_lock(&timer_lock);
+    timer->period = period;
+    pthread_mutex_unlock(&timer_lock);
+    return xTimerStart(timer, timeout);
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t timeout)
+{
+    (void)timeout;
+    pthread_mutex_lock(&timer_lock);
+    for(struct host_timer ** p = &timer_list; *p; p = &(*p)->next) {
+        if(*p == timer) {
+            *p = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&timer_lock);
+    free(timer);
+    return pdPASS;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer->id;
+}
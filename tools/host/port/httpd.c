@@ -0,0 +1,716 @@
+/**
+ * esp_http_server 替身: 监听 127.0.0.1 的最小 HTTP/1.1 + WebSocket 服务器。
+ * 与 esp_http_server 一样，所有连接由一个服务器线程用 select 轮询，处理函数都在这个线程中执行;
+ * WebSocket 握手后先用 HTTP_GET 调一次处理函数，之后每个数据帧调一次，
+ * ping/close 控制帧由服务器自己处理。普通 HTTP 请求发完响应就关闭连接。
+ * httpd_queue_work 与 esp_http_server 的控制套接字一样，通过管道把工作交给服务器线程
+ */
+#include "esp_http_server.h"
+#include "esp_log.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define HTTPD_HEADER_MAX        4096
+#define HTTPD_RESP_HDR_MAX      512
+#define HTTPD_WS_PAYLOAD_MAX    (16 * 1024 * 1024)
+#define HTTPD_WS_GUID           "258EAFA5-E914-47DA-95CA-C5AB0DC11B85"
+
+static const char *TAG = "host_httpd";
+
+uint16_t host_httpd_port = 8080;
+
+typedef struct {
+    int fd;
+    bool ws;
+    const httpd_uri_t *ws_uri;
+    uint8_t rx[HTTPD_HEADER_MAX];   // 读HTTP头时多读到的数据
+    size_t rx_len;
+    size_t rx_pos;
+    int64_t last_use;
+} httpd_client_t;
+
+typedef struct {
+    int listen_fd;
+    pthread_t thread;
+    volatile bool stop;
+    httpd_config_t config;
+    httpd_uri_t *uris;
+    size_t uri_cnt;
+    httpd_client_t *clients;
+    int64_t use_cnt;
+    pthread_mutex_t send_lock;
+    int work_pipe[2];               // httpd_queue_work 写入 httpd_work_t，服务器线程读出执行
+} httpd_server_t;
+
+typedef struct {
+    httpd_work_fn_t fn;
+    void *arg;
+} httpd_work_t;
+
+/* 一次请求的上下文，挂在 httpd_req_t::aux 上 */
+typedef struct {
+    httpd_server_t *server;
+    httpd_client_t *client;
+    char status[32];
+    char type[64];
+    char hdr[HTTPD_RESP_HDR_MAX];
+    size_t hdr_len;
+    // 当前 WebSocket 帧
+    bool ws_frame;
+    bool ws_final;
+    httpd_ws_type_t ws_type;
+    uint64_t ws_len;
+    uint8_t ws_mask[4];
+    bool ws_payload_read;
+} httpd_req_aux_t;
+
+/*=====================
+ * SHA-1 和 Base64，只用于计算 Sec-WebSocket-Accept
+ *====================*/
+
+static uint32_t rol(uint32_t v, int n)
+{
+    return v << n | v >> (32 - n);
+}
+
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20])
+{
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t total = (len + 9 + 63) / 64 * 64;
+    uint8_t *msg = calloc(1, total);
+    memcpy(msg, data, len);
+    msg[len] = 0x80;
+    uint64_t bits = (uint64_t)len * 8;
+    for(int i = 0; i < 8; i++) {
+        msg[total - 1 - i] = bits >> (i * 8);
+    }
+    for(size_t off = 0; off < total; off += 64) {
+        uint32_t w[80];
+        for(int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)msg[off + i * 4] << 24 | msg[off + i * 4 + 1] << 16 | msg[off + i * 4 + 2] << 8 |
+                   msg[off + i * 4 + 3];
+        }
+        for(int i = 16; i < 80; i++) {
+            w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for(int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if(i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if(i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if(i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rol(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    free(msg);
+    for(int i = 0; i < 20; i++) {
+        out[i] = h[i / 4] >> (24 - i % 4 * 8);
+    }
+}
+
+static void base64(const uint8_t *data, size_t len, char *out)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for(size_t i = 0; i < len; i += 3) {
+        uint32_t v = data[i] << 16 | (i + 1 < len ? data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+        *out++ = table[v >> 18 & 0x3f];
+        *out++ = table[v >> 12 & 0x3f];
+        *out++ = i + 1 < len ? table[v >> 6 & 0x3f] : '=';
+        *out++ = i + 2 < len ? table[v & 0x3f] : '=';
+    }
+    *out = '\0';
+}
+
+/*=====================
+ * 套接字读写
+ *====================*/
+
+static bool send_all(int fd, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    while(len) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if(n < 0 && errno == EINTR) {
+            continue;
+        }
+        if(n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+/* 先取读HTTP头时剩下的数据，再从套接字读满 len 字节 */
+static bool client_read(httpd_client_t *client, void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    size_t cached = client->rx_len - client->rx_pos;
+    if(cached) {
+        size_t n = cached < len ? cached : len;
+        memcpy(p, client->rx + client->rx_pos, n);
+        client->rx_pos += n;
+        p += n;
+        len -= n;
+    }
+    while(len) {
+        ssize_t n = recv(client->fd, p, len, 0);
+        if(n < 0 && errno == EINTR) {
+            continue;
+        }
+        if(n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool client_skip(httpd_client_t *client, uint64_t len)
+{
+    uint8_t buf[256];
+    while(len) {
+        size_t n = len < sizeof(buf) ? len : sizeof(buf);
+        if(!client_read(client, buf, n)) {
+            return false;
+        }
+        len -= n;
+    }
+    return true;
+}
+
+static void client_close(httpd_client_t *client)
+{
+    if(client->fd >= 0) {
+        close(client->fd);
+    }
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+}
+
+/*=====================
+ * WebSocket
+ *====================*/
+
+static bool ws_send(httpd_server_t *server, int fd, httpd_ws_type_t type, bool final, const uint8_t *payload,
+                    size_t len)
+{
+    uint8_t hdr[10];
+    size_t hdr_len = 2;
+    hdr[0] = (final ? 0x80 : 0) | type;
+    if(len < 126) {
+        hdr[1] = len;
+    } else if(len <= 0xffff) {
+        hdr[1] = 126;
+        hdr[2] = len >> 8;
+        hdr[3] = len;
+        hdr_len = 4;
+    } else {
+        hdr[1] = 127;
+        for(int i = 0; i < 8; i++) {
+            hdr[2 + i] = (uint64_t)len >> (56 - i * 8);
+        }
+        hdr_len = 10;
+    }
+    pthread_mutex_lock(&server->send_lock);
+    bool ok = send_all(fd, hdr, hdr_len) && (len == 0 || send_all(fd, payload, len));
+    pthread_mutex_unlock(&server->send_lock);
+    return ok;
+}
+
+/* 读一个帧头到 aux，客户端发来的帧必须带掩码 */
+static bool ws_read_header(httpd_client_t *client, httpd_req_aux_t *aux)
+{
+    uint8_t hdr[2];
+    if(!client_read(client, hdr, 2) || !(hdr[1] & 0x80)) {
+        return false;
+    }
+    aux->ws_final = hdr[0] & 0x80;
+    aux->ws_type = hdr[0] & 0x0f;
+    aux->ws_len = hdr[1] & 0x7f;
+    if(aux->ws_len == 126) {
+        uint8_t ext[2];
+        if(!client_read(client, ext, 2)) {
+            return false;
+        }
+        aux->ws_len = ext[0] << 8 | ext[1];
+    } else if(aux->ws_len == 127) {
+        uint8_t ext[8];
+        if(!client_read(client, ext, 8)) {
+            return false;
+        }
+        aux->ws_len = 0;
+        for(int i = 0; i < 8; i++) {
+            aux->ws_len = aux->ws_len << 8 | ext[i];
+        }
+    }
+    aux->ws_frame = true;
+    aux->ws_payload_read = false;
+    return aux->ws_len <= HTTPD_WS_PAYLOAD_MAX && client_read(client, aux->ws_mask, 4);
+}
+
+static bool ws_read_payload(httpd_client_t *client, httpd_req_aux_t *aux, uint8_t *buf, size_t len)
+{
+    if(!client_read(client, buf, len)) {
+        return false;
+    }
+    for(size_t i = 0; i < len; i++) {
+        buf[i] ^= aux->ws_mask[i % 4];
+    }
+    aux->ws_payload_read = true;
+    return true;
+}
+
+/* 处理一个 WebSocket 帧，连接断开或出错返回 false */
+static bool ws_handle_frame(httpd_server_t *server, httpd_client_t *client)
+{
+    httpd_req_aux_t aux = {.server = server, .client = client};
+    if(!ws_read_header(client, &aux)) {
+        return false;
+    }
+    if(aux.ws_type == HTTPD_WS_TYPE_PING || aux.ws_type == HTTPD_WS_TYPE_CLOSE ||
+       aux.ws_type == HTTPD_WS_TYPE_PONG) {
+        uint8_t payload[125];
+        if(aux.ws_len > sizeof(payload) || !ws_read_payload(client, &aux, payload, aux.ws_len)) {
+            return false;
+        }
+        if(aux.ws_type == HTTPD_WS_TYPE_PING) {
+            return ws_send(server, client->fd, HTTPD_WS_TYPE_PONG, true, payload, aux.ws_len);
+        }
+        if(aux.ws_type == HTTPD_WS_TYPE_CLOSE) {
+            ws_send(server, client->fd, HTTPD_WS_TYPE_CLOSE, true, payload, aux.ws_len);
+            return false;
+        }
+        return true;
+    }
+    httpd_req_t req = {
+        .handle = server,
+        .method = 0,
+        .user_ctx = client->ws_uri->user_ctx,
+        .aux = &aux,
+    };
+    snprintf(req.uri, sizeof(req.uri), "%s", client->ws_uri->uri);
+    client->ws_uri->handler(&req);
+    // 处理函数没有读走的数据丢掉
+    return aux.ws_payload_read || client_skip(client, aux.ws_len);
+}
+
+/*=====================
+ * HTTP
+ *====================*/
+
+/* 取请求头中某个字段的值，不区分大小写 */
+static bool header_get(const char *headers, const char *field, char *value, size_t size)
+{
+    size_t field_len = strlen(field);
+    for(const char *line = headers; line && *line; line = strstr(line, "\r\n")) {
+        if(line[0] == '\r') {
+            line += 2;
+        }
+        if(strncasecmp(line, field, field_len) == 0 && line[field_len] == ':') {
+            const char *v = line + field_len + 1;
+            while(*v == ' ') {
+                v++;
+            }
+            const char *end = strstr(v, "\r\n");
+            size_t len = end ? (size_t)(end - v) : strlen(v);
+            if(len >= size) {
+                len = size - 1;
+            }
+            memcpy(value, v, len);
+            value[len] = '\0';
+            return true;
+        }
+    }
+    return false;
+}
+
+static const httpd_uri_t *uri_find(httpd_server_t *server, const char *uri, int method)
+{
+    for(size_t i = 0; i < server->uri_cnt; i++) {
+        if(server->uris[i].method == method && strcmp(server->uris[i].uri, uri) == 0) {
+            return &server->uris[i];
+        }
+    }
+    return NULL;
+}
+
+static void http_send_simple(int fd, const char *status)
+{
+    char resp[128];
+    int len = snprintf(resp, sizeof(resp), "HTTP/1.1 %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", status);
+    send_all(fd, resp, len);
+}
+
+/* 读一个HTTP请求并处理，处理完要关闭连接时返回 false */
+static bool http_handle_request(httpd_server_t *server, httpd_client_t *client)
+{
+    char *buf = (char *)client->rx;
+    size_t len = 0;
+    char *end = NULL;
+    while(end == NULL) {
+        if(len == sizeof(client->rx) - 1) {
+            http_send_simple(client->fd, "431 Request Header Fields Too Large");
+            return false;
+        }
+        ssize_t n = recv(client->fd, buf + len, sizeof(client->rx) - 1 - len, 0);
+        if(n <= 0) {
+            return false;
+        }
+        len += n;
+        buf[len] = '\0';
+        end = strstr(buf, "\r\n\r\n");
+    }
+    char method_str[8], uri[512];
+    if(sscanf(buf, "%7s %511s", method_str, uri) != 2) {
+        http_send_simple(client->fd, "400 Bad Request");
+        return false;
+    }
+    char *query = strchr(uri, '?');
+    if(query) {
+        *query = '\0';
+    }
+    int method = strcmp(method_str, "GET") == 0 ? HTTP_GET : strcmp(method_str, "POST") == 0 ? HTTP_POST :
+                 strcmp(method_str, "PUT") == 0 ? HTTP_PUT : strcmp(method_str, "HEAD") == 0 ? HTTP_HEAD :
+                 strcmp(method_str, "DELETE") == 0 ? HTTP_DELETE : -1;
+    const httpd_uri_t *handler = uri_find(server, uri, method);
+    if(handler == NULL) {
+        http_send_simple(client->fd, "404 Not Found");
+        return false;
+    }
+    // 请求头之后多读到的数据留给后面的读取
+    *end = '\0';
+    client->rx_pos = end + 4 - buf;
+    client->rx_len = len;
+
+    httpd_req_aux_t aux = {.server = server, .client = client};
+    httpd_req_t req = {
+        .handle = server,
+        .method = method,
+        .user_ctx = handler->user_ctx,
+        .aux = &aux,
+    };
+    snprintf(req.uri, sizeof(req.uri), "%s", uri);
+    char value[128];
+    if(handler->is_websocket) {
+        if(!header_get(buf, "Sec-WebSocket-Key", value, sizeof(value))) {
+            http_send_simple(client->fd, "400 Bad Request");
+            return false;
+        }
+        char key[192], accept[32];
+        uint8_t digest[20];
+        snprintf(key, sizeof(key), "%s%s", value, HTTPD_WS_GUID);
+        sha1((const uint8_t *)key, strlen(key), digest);
+        base64(digest, sizeof(digest), accept);
+        char resp[256];
+        int resp_len = snprintf(resp, sizeof(resp),
+                                "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                                "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+        if(!send_all(client->fd, resp, resp_len)) {
+            return false;
+        }
+        client->ws = true;
+        client->ws_uri = handler;
+        handler->handler(&req);
+        return true;
+    }
+    // 请求体交给处理函数前先丢掉，固件没有带请求体的接口
+    if(header_get(buf, "Content-Length", value, sizeof(value))) {
+        req.content_len = strtoul(value, NULL, 10);
+    }
+    if(handler->handler(&req) != ESP_OK) {
+        http_send_simple(client->fd, "500 Internal Server Error");
+    }
+    return false;
+}
+
+/*=====================
+ * 服务器线程
+ *====================*/
+
+static httpd_client_t *client_slot(httpd_server_t *server)
+{
+    httpd_client_t *oldest = NULL;
+    for(size_t i = 0; i < server->config.max_open_sockets; i++) {
+        httpd_client_t *c = &server->clients[i];
+        if(c->fd < 0) {
+            return c;
+        }
+        if(oldest == NULL || c->last_use < oldest->last_use) {
+            oldest = c;
+        }
+    }
+    if(server->config.lru_purge_enable && oldest) {
+        ESP_LOGW(TAG, "purge least recently used socket %d", oldest->fd);
+        client_close(oldest);
+        return oldest;
+    }
+    return NULL;
+}
+
+static void *httpd_thread(void *arg)
+{
+    httpd_server_t *server = arg;
+    pthread_setname_np(pthread_self(), "httpd");
+    while(!server->stop) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(server->listen_fd, &fds);
+        FD_SET(server->work_pipe[0], &fds);
+        int max_fd = server->listen_fd > server->work_pipe[0] ? server->listen_fd : server->work_pipe[0];
+        for(size_t i = 0; i < server->config.max_open_sockets; i++) {
+            httpd_client_t *c = &server->clients[i];
+            if(c->fd >= 0) {
+                FD_SET(c->fd, &fds);
+                max_fd = c->fd > max_fd ? c->fd : max_fd;
+            }
+        }
+        struct timeval tv = {.tv_sec = 0, .tv_usec = 100 * 1000};
+        if(select(max_fd + 1, &fds, NULL, NULL, &tv) <= 0) {
+            continue;
+        }
+        if(FD_ISSET(server->work_pipe[0], &fds)) {
+            httpd_work_t work;
+            if(read(server->work_pipe[0], &work, sizeof(work)) == sizeof(work)) {
+                work.fn(work.arg);
+            }
+        }
+        if(FD_ISSET(server->listen_fd, &fds)) {
+            int fd = accept(server->listen_fd, NULL, NULL);
+            if(fd >= 0) {
+                httpd_client_t *c = client_slot(server);
+                if(c == NULL) {
+                    close(fd);
+                } else {
+                    c->fd = fd;
+                    c->last_use = ++server->use_cnt;
+                }
+            }
+        }
+        for(size_t i = 0; i < server->config.max_open_sockets; i++) {
+            httpd_client_t *c = &server->clients[i];
+            if(c->fd < 0 || !FD_ISSET(c->fd, &fds)) {
+                continue;
+            }
+            c->last_use = ++server->use_cnt;
+            bool keep = c->ws ? ws_handle_frame(server, c) : http_handle_request(server, c);
+            if(!keep) {
+                client_close(c);
+            }
+        }
+    }
+    return NULL;
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    httpd_server_t *server = calloc(1, sizeof(*server));
+    if(server == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    server->config = *config;
+    server->uris = calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+    server->clients = calloc(config->max_open_sockets, sizeof(httpd_client_t));
+    if(server->uris == NULL || server->clients == NULL) {
+        free(server->uris);
+        free(server->clients);
+        free(server);
+        return ESP_ERR_NO_MEM;
+    }
+    for(size_t i = 0; i < config->max_open_sockets; i++) {
+        server->clients[i].fd = -1;
+    }
+    pthread_mutex_init(&server->send_lock, NULL);
+    if(pipe(server->work_pipe) != 0) {
+        free(server->uris);
+        free(server->clients);
+        free(server);
+        return ESP_FAIL;
+    }
+
+    server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(config->server_port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    if(server->listen_fd < 0 || bind(server->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+       listen(server->listen_fd, 4) != 0) {
+        ESP_LOGE(TAG, "listen on 127.0.0.1:%u fail: %s", config->server_port, strerror(errno));
+        if(server->listen_fd >= 0) {
+            close(server->listen_fd);
+        }
+        close(server->work_pipe[0]);
+        close(server->work_pipe[1]);
+        free(server->uris);
+        free(server->clients);
+        free(server);
+        return ESP_FAIL;
+    }
+    pthread_create(&server->thread, NULL, httpd_thread, server);
+    ESP_LOGI(TAG, "listening on http://127.0.0.1:%u", config->server_port);
+    *handle = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    httpd_server_t *server = handle;
+    server->stop = true;
+    pthread_join(server->thread, NULL);
+    for(size_t i = 0; i < server->config.max_open_sockets; i++) {
+        client_close(&server->clients[i]);
+    }
+    close(server->listen_fd);
+    close(server->work_pipe[0]);
+    close(server->work_pipe[1]);
+    pthread_mutex_destroy(&server->send_lock);
+    free(server->uris);
+    free(server->clients);
+    free(server);
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    httpd_server_t *server = handle;
+    if(uri_find(server, uri_handler->uri, uri_handler->method)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(server->uri_cnt == server->config.max_uri_handlers) {
+        return ESP_ERR_NO_MEM;
+    }
+    server->uris[server->uri_cnt++] = *uri_handler;
+    return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+    return ((httpd_req_aux_t *)r->aux)->client->fd;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+    httpd_req_aux_t *aux = r->aux;
+    snprintf(aux->status, sizeof(aux->status), "%s", status);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    httpd_req_aux_t *aux = r->aux;
+    snprintf(aux->type, sizeof(aux->type), "%s", type);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+    httpd_req_aux_t *aux = r->aux;
+    int n = snprintf(aux->hdr + aux->hdr_len, sizeof(aux->hdr) - aux->hdr_len, "%s: %s\r\n", field, value);
+    if(n < 0 || (size_t)n >= sizeof(aux->hdr) - aux->hdr_len) {
+        return ESP_ERR_NO_MEM;
+    }
+    aux->hdr_len += n;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    httpd_req_aux_t *aux = r->aux;
+    if(buf_len == HTTPD_RESP_USE_STRLEN) {
+        buf_len = buf ? strlen(buf) : 0;
+    }
+    char head[HTTPD_RESP_HDR_MAX + 256];
+    int head_len = snprintf(head, sizeof(head),
+                            "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zd\r\n%sConnection: close\r\n\r\n",
+                            aux->status[0] ? aux->status : "200 OK", aux->type[0] ? aux->type : "text/html",
+                            buf_len, aux->hdr);
+    if(!send_all(aux->client->fd, head, head_len) || (buf_len && !send_all(aux->client->fd, buf, buf_len))) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
+{
+    httpd_req_aux_t *aux = req->aux;
+    if(!aux->ws_frame) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pkt->final = aux->ws_final;
+    pkt->fragmented = !aux->ws_final;
+    pkt->type = aux->ws_type;
+    pkt->len = aux->ws_len;
+    // max_len 为0时只取帧长度和类型
+    if(max_len == 0) {
+        return ESP_OK;
+    }
+    if(aux->ws_payload_read || pkt->payload == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if(max_len < aux->ws_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ws_read_payload(aux->client, aux, pkt->payload, aux->ws_len) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt)
+{
+    httpd_req_aux_t *aux = req->aux;
+    return httpd_ws_send_data(aux->server, aux->client->fd, pkt);
+}
+
+esp_err_t httpd_ws_send_data(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame)
+{
+    httpd_server_t *server = hd;
+    if(server == NULL || fd < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool final = frame->fragmented ? frame->final : true;
+    return ws_send(server, fd, frame->type, final, frame->payload, frame->len) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg)
+{
+    httpd_server_t *server = handle;
+    if(server == NULL || work == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 小于 PIPE_BUF 的写入是原子的，多个线程同时提交不会交错
+    httpd_work_t item = {.fn = work, .arg = arg};
+    return write(server->work_pipe[1], &item, sizeof(item)) == sizeof(item) ? ESP_OK : ESP_FAIL;
+}
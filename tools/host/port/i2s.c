@@ -0,0 +1,182 @@
+/**
+ * I2S 替身: 发送通道按采样率消耗数据，写入的数据追加到文件(host_main 的 -o 参数)。
+ * DMA 缓冲与设备相同(dma_desc_num * dma_frame_num 帧)，缓冲满时 i2s_channel_write 阻塞到放得下为止，
+ * 缓冲放空后才写入的数据计一次欠载(设备上会播出静音或重复的数据)
+ */
+#include "driver/i2s_std.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_port.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const char *TAG = "host_i2s";
+
+struct host_i2s_chan {
+    i2s_chan_config_t chan_cfg;
+    i2s_std_config_t std_cfg;
+    bool enabled;
+    bool started;               // 使能后写过数据，之后缓冲放空才算欠载
+    int64_t drained_us;         // 已写入的数据全部播完的时间
+};
+
+static pthread_mutex_t i2s_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *i2s_out;
+static struct {
+    uint64_t bytes;
+    uint64_t play_us;
+    uint32_t writes;
+    uint32_t underruns;
+    uint64_t block_us;
+    uint32_t reconfigs;
+} i2s_stats;
+
+/* 每秒消耗的字节数 */
+static uint32_t i2s_byte_rate(const struct host_i2s_chan *chan)
+{
+    const i2s_std_config_t *cfg = &chan->std_cfg;
+    uint32_t bytes = cfg->slot_cfg.data_bit_width / 8 * (cfg->slot_cfg.slot_mode == I2S_SLOT_MODE_MONO ? 1 : 2);
+    return cfg->clk_cfg.sample_rate_hz * bytes;
+}
+
+/* DMA 缓冲能放下的播放时长 */
+static int64_t i2s_buffer_us(const struct host_i2s_chan *chan)
+{
+    const i2s_std_config_t *cfg = &chan->std_cfg;
+    return (int64_t)chan->chan_cfg.dma_desc_num * chan->chan_cfg.dma_frame_num * 1000000 /
+           cfg->clk_cfg.sample_rate_hz;
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *chan_cfg, i2s_chan_handle_t *ret_tx_handle,
+                          i2s_chan_handle_t *ret_rx_handle)
+{
+    if(ret_rx_handle) {
+        *ret_rx_handle = NULL;
+    }
+    struct host_i2s_chan *chan = calloc(1, sizeof(*chan));
+    if(chan == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    chan->chan_cfg = *chan_cfg;
+    pthread_mutex_lock(&i2s_lock);
+    if(i2s_out == NULL && host_port.pcm_out) {
+        i2s_out = fopen(host_port.pcm_out, "wb");
+        if(i2s_out == NULL) {
+            ESP_LOGE(TAG, "open %s fail", host_port.pcm_out);
+        }
+    }
+    pthread_mutex_unlock(&i2s_lock);
+    *ret_tx_handle = chan;
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t *std_cfg)
+{
+    handle->std_cfg = *std_cfg;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_reconfig_std_clock(i2s_chan_handle_t handle, const i2s_std_clk_config_t *clk_cfg)
+{
+    if(handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->std_cfg.clk_cfg = *clk_cfg;
+    i2s_stats.reconfigs++;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_reconfig_std_slot(i2s_chan_handle_t handle, const i2s_std_slot_config_t *slot_cfg)
+{
+    if(handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->std_cfg.slot_cfg = *slot_cfg;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle)
+{
+    if(handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->enabled = true;
+    handle->started = false;
+    handle->drained_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle)
+{
+    if(!handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void *src, size_t size, size_t *bytes_written,
+                            uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    if(bytes_written) {
+        *bytes_written = 0;
+    }
+    if(!handle->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t byte_rate = i2s_byte_rate(handle);
+    int64_t size_us = (int64_t)size * 1000000 / byte_rate;
+    int64_t now = esp_timer_get_time();
+    if(handle->drained_us < now) {
+        if(handle->started) {
+            i2s_stats.underruns++;
+        }
+        handle->drained_us = now;
+    }
+    handle->started = true;
+    /* 缓冲里放不下时等到放得下，和 DMA 描述符被消耗后才能写入一样 */
+    int64_t wait_us = handle->drained_us + size_us - now - i2s_buffer_us(handle);
+    if(wait_us > 0) {
+        struct timespec ts = {.tv_sec = wait_us / 1000000, .tv_nsec = (wait_us % 1000000) * 1000};
+        nanosleep(&ts, NULL);
+    }
+    handle->drained_us += size_us;
+
+    pthread_mutex_lock(&i2s_lock);
+    if(i2s_out) {
+        fwrite(src, 1, size, i2s_out);
+    }
+    i2s_stats.bytes += size;
+    i2s_stats.play_us += size_us;
+    i2s_stats.writes++;
+    i2s_stats.block_us += wait_us > 0 ? wait_us : 0;
+    pthread_mutex_unlock(&i2s_lock);
+    if(bytes_written) {
+        *bytes_written = size;
+    }
+    return ESP_OK;
+}
+
+void host_i2s_report(void)
+{
+    pthread_mutex_lock(&i2s_lock);
+    if(i2s_out) {
+        fflush(i2s_out);
+    }
+    ESP_LOGI(TAG, "speaker: %llu bytes in %lu writes, %llu ms of audio, underruns %lu, writer blocked %llu ms, "
+             "reconfigs %lu",
+             (unsigned long long)i2s_stats.bytes, (unsigned long)i2s_stats.writes,
+             (unsigned long long)i2s_stats.play_us / 1000, (unsigned long)i2s_stats.underruns,
+             (unsigned long long)i2s_stats.block_us / 1000, (unsigned long)i2s_stats.reconfigs);
+    pthread_mutex_unlock(&i2s_lock);
+}
@@ -0,0 +1,121 @@
+#ifndef __HOST_DRIVER_I2S_STD_H__
+#define __HOST_DRIVER_I2S_STD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+
+/* 主机上的 I2S 发送通道按采样率消耗数据并写入文件(见 port/i2s.c)，DMA 缓冲大小与设备相同 */
+typedef struct host_i2s_chan *i2s_chan_handle_t;
+
+typedef enum {
+    I2S_NUM_0 = 0,
+    I2S_NUM_1,
+    I2S_NUM_AUTO,
+} i2s_port_t;
+
+typedef enum {
+    I2S_ROLE_MASTER,
+    I2S_ROLE_SLAVE,
+} i2s_role_t;
+
+typedef enum {
+    I2S_DATA_BIT_WIDTH_8BIT = 8,
+    I2S_DATA_BIT_WIDTH_16BIT = 16,
+    I2S_DATA_BIT_WIDTH_24BIT = 24,
+    I2S_DATA_BIT_WIDTH_32BIT = 32,
+} i2s_data_bit_width_t;
+
+typedef enum {
+    I2S_SLOT_MODE_MONO = 1,
+    I2S_SLOT_MODE_STEREO = 2,
+} i2s_slot_mode_t;
+
+#define I2S_GPIO_UNUSED     GPIO_NUM_NC
+
+typedef struct {
+    i2s_port_t id;
+    i2s_role_t role;
+    uint32_t dma_desc_num;
+    uint32_t dma_frame_num;
+    bool auto_clear_after_cb;
+    bool auto_clear_before_cb;
+    int intr_priority;
+} i2s_chan_config_t;
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(i2s_num, i2s_role) { \
+    .id = i2s_num, \
+    .role = i2s_role, \
+    .dma_desc_num = 6, \
+    .dma_frame_num = 240, \
+    .auto_clear_after_cb = false, \
+    .auto_clear_before_cb = false, \
+    .intr_priority = 0, \
+}
+
+typedef struct {
+    uint32_t sample_rate_hz;
+    int clk_src;
+    uint32_t mclk_multiple;
+} i2s_std_clk_config_t;
+
+typedef struct {
+    i2s_data_bit_width_t data_bit_width;
+    int slot_bit_width;
+    i2s_slot_mode_t slot_mode;
+    int slot_mask;
+    uint32_t ws_width;
+    bool ws_pol;
+    bool bit_shift;
+} i2s_std_slot_config_t;
+
+typedef struct {
+    gpio_num_t mclk;
+    gpio_num_t bclk;
+    gpio_num_t ws;
+    gpio_num_t dout;
+    gpio_num_t din;
+    struct {
+        uint32_t mclk_inv : 1;
+        uint32_t bclk_inv : 1;
+        uint32_t ws_inv : 1;
+    } invert_flags;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+    i2s_std_clk_config_t clk_cfg;
+    i2s_std_slot_config_t slot_cfg;
+    i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) { \
+    .sample_rate_hz = rate, \
+    .clk_src = 0, \
+    .mclk_multiple = 256, \
+}
+
+#define I2S_STD_PHILIP_SLOT_DEFAULT_CONFIG(bits_per_sample, mono_or_stereo) { \
+    .data_bit_width = (i2s_data_bit_width_t)(bits_per_sample), \
+    .slot_bit_width = 0, \
+    .slot_mode = mono_or_stereo, \
+    .slot_mask = 3, \
+    .ws_width = bits_per_sample, \
+    .ws_pol = false, \
+    .bit_shift = true, \
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *chan_cfg, i2s_chan_handle_t *ret_tx_handle,
+                          i2s_chan_handle_t *ret_rx_handle);
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t *std_cfg);
+esp_err_t i2s_channel_reconfig_std_clock(i2s_chan_handle_t handle, const i2s_std_clk_config_t *clk_cfg);
+esp_err_t i2s_channel_reconfig_std_slot(i2s_chan_handle_t handle, const i2s_std_slot_config_t *slot_cfg);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void *src, size_t size, size_t *bytes_written,
+                            uint32_t timeout_ms);
+
+#endif
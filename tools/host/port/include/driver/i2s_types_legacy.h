@@ -0,0 +1,11 @@
+#ifndef __HOST_DRIVER_I2S_TYPES_LEGACY_H__
+#define __HOST_DRIVER_I2S_TYPES_LEGACY_H__
+
+typedef enum {
+    I2S_BITS_PER_SAMPLE_8BIT = 8,
+    I2S_BITS_PER_SAMPLE_16BIT = 16,
+    I2S_BITS_PER_SAMPLE_24BIT = 24,
+    I2S_BITS_PER_SAMPLE_32BIT = 32,
+} i2s_bits_per_sample_t;
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef __HOST_ESP_HTTP_SERVER_H__
+#define __HOST_ESP_HTTP_SERVER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "esp_err.h"
+
+/* 主机上的 HTTP/WebSocket 服务器监听本机回环地址(见 port/httpd.c)，
+ * 与 esp_http_server 一样所有处理函数都在同一个服务器线程中执行 */
+typedef void *httpd_handle_t;
+
+typedef enum {
+    HTTP_DELETE = 0,
+    HTTP_GET = 1,
+    HTTP_HEAD = 2,
+    HTTP_POST = 3,
+    HTTP_PUT = 4,
+} httpd_method_t;
+
+typedef struct httpd_req {
+    httpd_handle_t handle;
+    int method;
+    char uri[512];
+    size_t content_len;
+    void *user_ctx;
+    void *aux;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *r);
+    void *user_ctx;
+    bool is_websocket;
+    bool handle_ws_control_frames;
+    const char *supported_subprotocol;
+} httpd_uri_t;
+
+typedef struct {
+    unsigned task_priority;
+    size_t stack_size;
+    int core_id;
+    uint16_t server_port;
+    uint16_t max_open_sockets;
+    uint16_t max_uri_handlers;
+    bool lru_purge_enable;
+} httpd_config_t;
+
+/* 端口由 host_main 的 -p 参数决定 */
+extern uint16_t host_httpd_port;
+
+#define HTTPD_DEFAULT_CONFIG() { \
+    .task_priority = 5, \
+    .stack_size = 4096, \
+    .core_id = 0x7fffffff, \
+    .server_port = host_httpd_port, \
+    .max_open_sockets = 7, \
+    .max_uri_handlers = 8, \
+    .lru_purge_enable = false, \
+}
+
+#define HTTPD_RESP_USE_STRLEN   -1
+
+typedef enum {
+    HTTPD_WS_TYPE_CONTINUE = 0x0,
+    HTTPD_WS_TYPE_TEXT = 0x1,
+    HTTPD_WS_TYPE_BINARY = 0x2,
+    HTTPD_WS_TYPE_CLOSE = 0x8,
+    HTTPD_WS_TYPE_PING = 0x9,
+    HTTPD_WS_TYPE_PONG = 0xA,
+} httpd_ws_type_t;
+
+typedef struct httpd_ws_frame {
+    bool final;
+    bool fragmented;
+    httpd_ws_type_t type;
+    uint8_t *payload;
+    size_t len;
+} httpd_ws_frame_t;
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler);
+int httpd_req_to_sockfd(httpd_req_t *r);
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status);
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value);
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len);
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt);
+esp_err_t httpd_ws_send_data(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame);
+
+typedef void (*httpd_work_fn_t)(void *arg);
+/* 让 work 在服务器线程中执行，可以在任何线程调用 */
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg);
+
+#endif
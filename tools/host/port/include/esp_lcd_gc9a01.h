@@ -0,0 +1,10 @@
+#ifndef __HOST_ESP_LCD_GC9A01_H__
+#define __HOST_ESP_LCD_GC9A01_H__
+
+#include "esp_lcd_panel_dev.h"
+#include "esp_lcd_panel_io.h"
+
+esp_err_t esp_lcd_new_panel_gc9a01(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
+                                   esp_lcd_panel_handle_t *ret_panel);
+
+#endif
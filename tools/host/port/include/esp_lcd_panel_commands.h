@@ -0,0 +1,17 @@
+#ifndef __HOST_ESP_LCD_PANEL_COMMANDS_H__
+#define __HOST_ESP_LCD_PANEL_COMMANDS_H__
+
+#define LCD_CMD_NOP         0x00
+#define LCD_CMD_SWRESET     0x01
+#define LCD_CMD_SLPIN       0x10
+#define LCD_CMD_SLPOUT      0x11
+#define LCD_CMD_INVOFF      0x20
+#define LCD_CMD_INVON       0x21
+#define LCD_CMD_DISPOFF     0x28
+#define LCD_CMD_DISPON      0x29
+#define LCD_CMD_CASET       0x2A
+#define LCD_CMD_RASET       0x2B
+#define LCD_CMD_RAMWR       0x2C
+#define LCD_CMD_MADCTL      0x36
+
+#endif
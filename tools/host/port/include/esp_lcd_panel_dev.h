@@ -0,0 +1,13 @@
+#ifndef __HOST_ESP_LCD_PANEL_DEV_H__
+#define __HOST_ESP_LCD_PANEL_DEV_H__
+
+#include "esp_lcd_types.h"
+
+typedef struct {
+    int reset_gpio_num;
+    lcd_rgb_element_order_t rgb_ele_order;
+    uint32_t bits_per_pixel;
+    void *vendor_config;
+} esp_lcd_panel_dev_config_t;
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef __HOST_ESP_LCD_TYPES_H__
+#define __HOST_ESP_LCD_TYPES_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct host_lcd_panel_io *esp_lcd_panel_io_handle_t;
+typedef struct host_lcd_panel *esp_lcd_panel_handle_t;
+typedef uint32_t esp_lcd_spi_bus_handle_t;
+
+typedef enum {
+    LCD_RGB_ELEMENT_ORDER_RGB,
+    LCD_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
+
+typedef struct {
+    int reserved;
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t panel_io,
+                                                       esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+
+#endif
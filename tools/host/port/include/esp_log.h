@@ -0,0 +1,19 @@
+#ifndef __HOST_ESP_LOG_H__
+#define __HOST_ESP_LOG_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* 与设备日志格式相同: 级别 (毫秒时间戳) TAG: 内容 */
+uint32_t esp_log_timestamp(void);
+
+#define ESP_LOG_HOST(letter, tag, format, ...) \
+    printf(#letter " (%u) %s: " format "\n", (unsigned)esp_log_timestamp(), tag, ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...)  ESP_LOG_HOST(E, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_LOG_HOST(W, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_LOG_HOST(I, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  do { } while (0)
+#define ESP_LOGV(tag, format, ...)  do { } while (0)
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __HOST_ESP_SPIFFS_H__
+#define __HOST_ESP_SPIFFS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/* 主机上 base_path 下的路径映射到本机目录(host_main 的 -s 参数)，见 port/esp_system.c */
+typedef struct {
+    const char *base_path;
+    const char *partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf);
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes);
+
+#endif
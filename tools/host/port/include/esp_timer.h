@@ -0,0 +1,9 @@
+#ifndef __HOST_ESP_TIMER_H__
+#define __HOST_ESP_TIMER_H__
+
+#include <stdint.h>
+
+/* 程序启动以来的微秒数 */
+int64_t esp_timer_get_time(void);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __HOST_ESP_WIFI_H__
+#define __HOST_ESP_WIFI_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/* 主机上没有Wi-Fi，d_wifi.h 的接口由 port/wifi.c 实现，网络走本机回环 */
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+} wifi_auth_mode_t;
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int8_t rssi;
+    wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+#endif
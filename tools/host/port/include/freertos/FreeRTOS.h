@@ -0,0 +1,55 @@
+/**
+ * 主机端 FreeRTOS 接口，用 pthread 实现(见 port/freertos.c)，只提供固件用到的部分。
+ * 任务优先级和绑核在主机上不生效，tick 固定为1ms
+ */
+#ifndef __HOST_FREERTOS_H__
+#define __HOST_FREERTOS_H__
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ESP-IDF 的 newlib 有 strlcpy，glibc 2.38 之前没有，由 port/esp_system.c 提供 */
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char *dst, const char *src, size_t size);
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+typedef uint32_t configRUN_TIME_COUNTER_TYPE;
+
+#define configTICK_RATE_HZ          1000
+#define portTICK_PERIOD_MS          ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define portNUM_PROCESSORS          2
+#define pdMS_TO_TICKS(ms)           ((TickType_t)((uint64_t)(ms) * configTICK_RATE_HZ / 1000))
+#define pdTICKS_TO_MS(t)            ((uint32_t)((uint64_t)(t) * 1000 / configTICK_RATE_HZ))
+#define pdTRUE                      1
+#define pdFALSE                     0
+#define pdPASS                      pdTRUE
+#define pdFAIL                      pdFALSE
+#define tskIDLE_PRIORITY            0
+#define tskNO_AFFINITY              0x7fffffff
+
+/* 临界区用递归互斥锁代替自旋锁，"中断"(传输完成回调等)在主机上是普通线程 */
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+#define portENTER_CRITICAL(mux)         pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL(mux)          pthread_mutex_unlock(mux)
+#define portENTER_CRITICAL_ISR(mux)     pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL_ISR(mux)      pthread_mutex_unlock(mux)
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+/* 与 ESP-IDF 一样，包含 FreeRTOS.h 就能用任务、队列、信号量和定时器 */
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+
+#endif
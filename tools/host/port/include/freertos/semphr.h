@@ -0,0 +1,19 @@
+#ifndef __HOST_FREERTOS_SEMPHR_H__
+#define __HOST_FREERTOS_SEMPHR_H__
+
+#include "freertos/queue.h"
+
+/* 信号量就是长度为最大计数、元素大小为0的队列，与 FreeRTOS 的实现一样 */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken);
+
+#define xSemaphoreTake(sem, timeout)    xQueueReceive(sem, NULL, timeout)
+#define vSemaphoreDelete(sem)           vQueueDelete(sem)
+#define uxSemaphoreGetCount(sem)        uxQueueMessagesWaiting(sem)
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __HOST_FREERTOS_TIMERS_H__
+#define __HOST_FREERTOS_TIMERS_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_timer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+/* 回调在单独的定时器线程中执行，与 FreeRTOS 的定时器服务任务一样 */
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                           TimerCallbackFunction_t cb);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t timeout);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t timeout);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t timeout);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t timeout);
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t timeout);
+void *pvTimerGetTimerID(TimerHandle_t timer);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef __HOST_HAL_SPI_TYPES_H__
+#define __HOST_HAL_SPI_TYPES_H__
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+} spi_host_device_t;
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * 主机端移植层的配置和统计输出，由 host_main.c 在启动固件之前根据命令行填好
+ */
+#ifndef __HOST_PORT_H__
+#define __HOST_PORT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *spiffs_dir;     // spiffs 挂载点映射到的本机目录
+    const char *asset_image;    // 资源分区镜像文件，NULL 表示没有烧录资源分区
+    const char *pcm_out;        // I2S 输出写入的文件，NULL 只计数
+    const char *servo_log;      // 舵机占空比变化记录(CSV)，NULL 只计数
+    bool spi_realtime;          // 屏幕传输按 SPI 时钟计时，false 时立即完成
+} host_port_config_t;
+
+extern host_port_config_t host_port;
+
+/* 各个替身的统计，退出前打印 */
+void host_lcd_report(void);
+void host_i2s_report(void);
+void host_ledc_report(void);
+
+/* 把屏幕显存(按面板实际显示的方向)保存成 PPM 图片 */
+int host_lcd_panel_count(void);
+
+/* 保存第 index 块屏(按片选创建顺序)的显存为 PPM，按该屏的镜像设置换算回 LVGL 坐标 */
+bool host_lcd_save_ppm(int index, const char *path);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * LEDC 替身: 记录每次 ledc_update_duty 生效的占空比和对应的脉宽，
+ * 写成 CSV(host_main 的 -r 参数): 时间(us),通道,占空比,脉宽(us)
+ */
+#include "driver/ledc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_port.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+static const char *TAG = "host_ledc";
+
+static pthread_mutex_t ledc_lock = PTHREAD_MUTEX_INITIALIZER;
+static ledc_timer_config_t ledc_timers[LEDC_TIMER_MAX];
+static ledc_channel_config_t ledc_channels[LEDC_CHANNEL_MAX];
+static uint32_t ledc_pending_duty[LEDC_CHANNEL_MAX];
+static uint32_t ledc_updates;
+static FILE *ledc_log;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if(timer_conf->timer_num >= LEDC_TIMER_MAX || timer_conf->freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ledc_lock);
+    ledc_timers[timer_conf->timer_num] = *timer_conf;
+    if(ledc_log == NULL && host_port.servo_log) {
+        ledc_log = fopen(host_port.servo_log, "w");
+        if(ledc_log) {
+            fprintf(ledc_log, "time_us,channel,duty,pulse_us\n");
+        } else {
+            ESP_LOGE(TAG, "open %s fail", host_port.servo_log);
+        }
+    }
+    pthread_mutex_unlock(&ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if(ledc_conf->channel >= LEDC_CHANNEL_MAX || ledc_conf->timer_sel >= LEDC_TIMER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ledc_lock);
+    ledc_channels[ledc_conf->channel] = *ledc_conf;
+    ledc_pending_duty[ledc_conf->channel] = ledc_conf->duty;
+    pthread_mutex_unlock(&ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    (void)speed_mode;
+    if(channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ledc_lock);
+    ledc_pending_duty[channel] = duty;
+    pthread_mutex_unlock(&ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    (void)speed_mode;
+    if(channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ledc_lock);
+    ledc_channel_config_t *ch = &ledc_channels[channel];
+    const ledc_timer_config_t *timer = &ledc_timers[ch->timer_sel];
+    ch->duty = ledc_pending_duty[channel];
+    ledc_updates++;
+    if(ledc_log && timer->freq_hz) {
+        uint64_t period_us = 1000000 / timer->freq_hz;
+        uint32_t pulse_us = (uint32_t)(ch->duty * period_us >> timer->duty_resolution);
+        fprintf(ledc_log, "%lld,%d,%lu,%lu\n", (long long)esp_timer_get_time(), channel, (unsigned long)ch->duty,
+                (unsigned long)pulse_us);
+    }
+    pthread_mutex_unlock(&ledc_lock);
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    (void)speed_mode;
+    return channel < LEDC_CHANNEL_MAX ? ledc_channels[channel].duty : 0;
+}
+
+void host_ledc_report(void)
+{
+    pthread_mutex_lock(&ledc_lock);
+    if(ledc_log) {
+        fflush(ledc_log);
+    }
+    ESP_LOGI(TAG, "servo: %lu duty updates, channel 0 duty %lu", (unsigned long)ledc_updates,
+             (unsigned long)ledc_channels[0].duty);
+    pthread_mutex_unlock(&ledc_lock);
+}
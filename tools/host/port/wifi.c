@@ -0,0 +1,99 @@
+/**
+ * Wi-Fi 替身，代替 driver/d_wifi.c: 主机已经在网络上，sta 立即连上，
+ * HTTP/WebSocket 服务监听本机回环地址(见 httpd.c)。状态回调和设备上一样在单独的任务中调用
+ */
+#include "d_wifi.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "WIFI";
+
+static sta_status_cb sta_sta_cb;
+static ap_status_cb ap_sta_cb;
+static SemaphoreHandle_t scan_sign = NULL;
+
+static void wifi_sta_task(void *arg)
+{
+    (void)arg;
+    if(sta_sta_cb) {
+        sta_sta_cb(WIFI_STA_CONNECTING);
+        ESP_LOGI(TAG, "got ip: 127.0.0.1 (loopback)");
+        sta_sta_cb(WIFI_STA_CONNECTED);
+    }
+    vTaskDelete(NULL);
+}
+
+static void wifi_ap_task(void *arg)
+{
+    (void)arg;
+    ESP_LOGI(TAG, "wifi ap start");
+    if(ap_sta_cb) {
+        ap_sta_cb(WIFI_AP_STARTED);
+    }
+    vTaskDelete(NULL);
+}
+
+esp_err_t wifi_init_sta(sta_status_cb cb)
+{
+    sta_sta_cb = cb;
+    return xTaskCreate(wifi_sta_task, "wifi_sta", 4096, NULL, 3, NULL) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t wifi_connect_sta(const char *ssid, const char *pass)
+{
+    (void)pass;
+    ESP_LOGI(TAG, "connect to %s", ssid ? ssid : "(null)");
+    return xTaskCreate(wifi_sta_task, "wifi_sta", 4096, NULL, 3, NULL) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t wifi_init_ap_sta(ap_status_cb ap_cb, sta_status_cb sta_cb)
+{
+    if(!ap_cb || !sta_cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ap_sta_cb = ap_cb;
+    sta_sta_cb = sta_cb;
+    return xTaskCreate(wifi_ap_task, "wifi_ap", 4096, NULL, 3, NULL) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+/* 扫描结果只有一个假的开放热点 */
+static void wifi_scan_task(void *arg)
+{
+    wifi_scan_cb cb = (wifi_scan_cb)arg;
+    wifi_ap_record_t record = {
+        .primary = 7,
+        .rssi = -40,
+        .authmode = WIFI_AUTH_OPEN,
+    };
+    snprintf((char *)record.ssid, sizeof(record.ssid), "%s_host", WIFI_AP_SSID);
+    ESP_LOGI(TAG, "ap scan result: 1");
+    if(cb) {
+        cb(1, &record);
+    }
+    xSemaphoreGive(scan_sign);
+    vTaskDelete(NULL);
+}
+
+esp_err_t wifi_scan(wifi_scan_cb cb)
+{
+    if(!scan_sign) {
+        scan_sign = xSemaphoreCreateBinary();
+        xSemaphoreGive(scan_sign);
+    }
+    if(xSemaphoreTake(scan_sign, 0) == pdTRUE) {
+        if(xTaskCreate(wifi_scan_task, "scan", 8192, cb, 2, NULL) == pdPASS) {
+            return ESP_OK;
+        }
+        xSemaphoreGive(scan_sign);
+    }
+    return ESP_FAIL;
+}
+
+void dns_server_stop(void)
+{
+}
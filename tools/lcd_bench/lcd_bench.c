@@ -0,0 +1,720 @@
+/**
+ * 屏幕渲染模式主机端基准测试
+ * 用假屏(240x240 RGB565显存)比较 d_lcd.c 的渲染模式播放表情GIF时的开销:
+ *   swap:    原来的做法，按 RGB565 渲染、GIF解码成 RGB565 画布，flush 原地交换字节后整块发送，作为参考画面
+ *   partial: 两块20行缓冲，按屏幕字节序(RGB565_SWAPPED)渲染、GIF画布也是 RGB565_SWAPPED，flush 直接发送
+ *   direct:  同样按 RGB565_SWAPPED 渲染，两块整帧缓冲，LVGL只重画脏区并同步到另一块缓冲，
+ *            flush 把脏区逐行拷贝到20行中转缓冲后发送
+ *   round-p / round-d: partial / direct 加上 d_lcd.c 的圆屏裁剪(CONFIG_LCD_ROUND_DISPLAY)，
+ *            失效区域按20行的行带拆开并裁剪到可见圆内，四角不渲染也不发送。
+ *            主机上每个区域的固定开销比画像素贵得多，CPU时间反而会增加，主要看SPI字节数的变化
+ * 每帧像 emoji_gif 一样只标记本帧变化的矩形，各模式同时播放，每帧把其它模式假屏的显存与 swap 比较，
+ * 必须逐字节一致，圆屏模式只比较可见圆内的像素。swap 模式单独统计 flush 中交换字节的耗时，
+ * 即按屏幕字节序渲染每帧省下的CPU时间。
+ * 假屏的SPI传输在单独的线程中按20MHz的耗时异步完成，与 d_lcd.c 一样只在传输完成时归还缓冲
+ * (partial 调用 lv_display_flush_ready，direct 归还中转缓冲)，传输完成时才把数据写进显存，
+ * LVGL 提前改写了正在发送的缓冲就会出现显存不一致。
+ * 输出每帧渲染+flush的CPU耗时、SPI发送字节数和耗时、渲染与SPI并行的时间，按20MHz SPI估算的帧率上限
+ * min(1/CPU, 1/SPI)，以及按GIF自身帧间隔播放时的CPU占用。主机CPU比ESP32-S3快得多，只看各模式的相对值，
+ * PSRAM比内部RAM慢的影响也没有体现，设备上的数据看 d_lcd.c 的LVGL任务统计日志。
+ * 用法: lcd_bench [gif目录，默认 main/spiffs/gif]
+ * 输出的 swap us/f 为 flush 中交换字节的耗时，最后汇总 partial 比 swap、圆屏裁剪前后每帧的CPU时间和SPI字节数
+ * partial 模式像设备一样用 main/telemetry.c 记录 refr/flush/frame 事件(flush 在假DMA线程中记录，相当于中断)，
+ * 最后单独计时 telemetry_record 单线程和两个线程同时记录时每个事件的耗时，按每帧的事件数折算成每帧开销，
+ * 并检查 max_us 在普通查询后保留、reset_max 查询后清零
+ * 显存与参考画面不一致或 telemetry 检查失败时返回1
+ */
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "gif_dec.h"
+#include "telemetry.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LCD_H_RES           240
+#define LCD_V_RES           240
+#define DRAW_BUF_LINES      20
+#define SPI_CLOCK_HZ        (20 * 1000 * 1000)
+/* 每次 draw_bitmap 先发 CASET/RASET/RAMWR 三条命令和8字节参数 */
+#define SPI_CMD_BYTES       11
+
+/* 在途传输上限，与设备 esp_lcd 的 trans_queue_depth 一样足够放下两块中转缓冲 */
+#define FAKE_QUEUE_LEN      8
+#define BOUNCE_BUF_CNT      2
+/* 一帧内记录的渲染/传输时间段上限 */
+#define FRAME_SPANS         128
+/* 与 d_lcd.c 相同: 可见圆多留1个像素，按20行的行带裁剪，合并后多画的像素不超过两行就合并 */
+#define ROUND_MARGIN        1
+#define ROUND_BAND_LINES    DRAW_BUF_LINES
+#define ROUND_MERGE_PX      (LCD_H_RES * 2)
+
+#define BENCH_MAX_FILES     64
+#define BENCH_NAME_LEN      64
+/* 计时 telemetry_record 时每个线程记录的事件数 */
+#define TELEMETRY_BENCH_EVENTS  (2 * 1000 * 1000)
+
+typedef enum {
+    MODE_SWAP,
+    MODE_PARTIAL,
+    MODE_DIRECT,
+    MODE_ROUND_PARTIAL,
+    MODE_ROUND_DIRECT,
+    MODE_CNT,
+} bench_mode_t;
+
+static const char * mode_names[MODE_CNT] = {"swap", "partial", "direct", "round-p", "round-d"};
+
+typedef struct {
+    double cpu_sec;                       /* 渲染+flush 的CPU时间，不含等待 */
+    double spi_sec;                       /* SPI传输时间 */
+    double overlap_sec;                   /* 渲染与SPI传输同时进行的时间 */
+    double swap_sec;                      /* 其中 flush 交换字节的CPU时间，只有 swap 模式有 */
+    uint64_t spi_bytes;                   /* 发送到屏幕的字节数(含命令) */
+    uint32_t flushes;
+} bench_stats_t;
+
+typedef struct {
+    double start, end;
+} span_t;
+
+/* 一帧内渲染(不含等待)和SPI传输的时间段，帧结束时求交集得到并行时间 */
+typedef struct {
+    span_t render[FRAME_SPANS];
+    span_t spi[FRAME_SPANS];
+    uint32_t render_cnt, spi_cnt;
+    double render_start;                  /* 当前渲染段的起点 */
+} frame_spans_t;
+
+/* 一种模式的显示、假屏显存和统计 */
+typedef struct {
+    lv_display_t * disp;
+    lv_obj_t * img;
+    lv_color_format_t cf;                 /* 显示和GIF画布的颜色格式 */
+    uint8_t * fb[2];                      /* LVGL 渲染缓冲 */
+    uint8_t * bounce[BOUNCE_BUF_CNT];     /* direct 模式的中转缓冲 */
+    uint8_t bounce_index;
+    uint8_t bounce_free;
+    uint16_t gram[LCD_H_RES * LCD_V_RES]; /* 假屏显存，按屏幕字节序(大端)存放 */
+    bench_stats_t stats;
+    bench_stats_t full;                   /* 每个GIF开始时整屏刷新的统计 */
+    frame_spans_t spans;
+} bench_disp_t;
+
+/* 一次排队的假SPI传输 */
+typedef struct {
+    bench_disp_t * bd;
+    lv_area_t area;
+    const uint8_t * px;
+} fake_trans_t;
+
+static bench_disp_t bench_disps[MODE_CNT];
+
+/* 圆屏每行可见的像素区间 */
+static int16_t round_x1[LCD_V_RES];
+static int16_t round_x2[LCD_V_RES];
+
+static fake_trans_t fake_queue[FAKE_QUEUE_LEN];
+static uint32_t fake_head, fake_cnt;
+static pthread_mutex_t fake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fake_cond = PTHREAD_COND_INITIALIZER;
+
+static double cpu_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* telemetry.c 用的时钟 */
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)(now_sec() * 1e6);
+}
+
+static void * load_file(const char * path, long * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void * data = malloc(*size);
+    if(data && fread(data, 1, *size, f) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int name_cmp(const void * a, const void * b)
+{
+    return strcmp(a, b);
+}
+
+static void span_add(span_t * spans, uint32_t * cnt, double start, double end)
+{
+    if(*cnt < FRAME_SPANS) spans[(*cnt)++] = (span_t) {start, end};
+}
+
+/* LVGL 开始等待传输，结束当前渲染段 */
+static void render_pause(bench_disp_t * bd)
+{
+    span_add(bd->spans.render, &bd->spans.render_cnt, bd->spans.render_start, now_sec());
+}
+
+static void render_resume(bench_disp_t * bd)
+{
+    bd->spans.render_start = now_sec();
+}
+
+/**
+ * 假SPI DMA: 按顺序处理排队的传输，每次按20MHz的耗时等待后才把数据写进显存，
+ * 然后像 d_lcd.c 的传输完成中断一样归还缓冲
+ */
+static void * fake_dma_thread(void * arg)
+{
+    LV_UNUSED(arg);
+    pthread_mutex_lock(&fake_lock);
+    while(1) {
+        while(fake_cnt == 0) pthread_cond_wait(&fake_cond, &fake_lock);
+        fake_trans_t t = fake_queue[fake_head];
+        pthread_mutex_unlock(&fake_lock);
+
+        uint64_t bytes = lv_area_get_size(&t.area) * 2 + SPI_CMD_BYTES;
+        uint64_t ns = bytes * 8 * 1000000000ULL / SPI_CLOCK_HZ;
+        double start = now_sec();
+        struct timespec ts = {ns / 1000000000ULL, ns % 1000000000ULL};
+        nanosleep(&ts, NULL);
+        /* 相当于 esp_lcd_panel_draw_bitmap: 连续的像素写进显存的矩形 */
+        int32_t w = lv_area_get_width(&t.area);
+        const uint8_t * px = t.px;
+        for(int32_t y = t.area.y1; y <= t.area.y2; y++) {
+            memcpy(&t.bd->gram[y * LCD_H_RES + t.area.x1], px, w * 2);
+            px += w * 2;
+        }
+        if(t.bd == &bench_disps[MODE_PARTIAL]) {
+            telemetry_record(TELEMETRY_FLUSH, (int64_t)(start * 1e6), esp_timer_get_time(), bytes);
+        }
+
+        pthread_mutex_lock(&fake_lock);
+        double end = now_sec();
+        t.bd->stats.spi_sec += end - start;
+        span_add(t.bd->spans.spi, &t.bd->spans.spi_cnt, start, end);
+        t.bd->stats.spi_bytes += bytes;
+        t.bd->stats.flushes++;
+        fake_head = (fake_head + 1) % FAKE_QUEUE_LEN;
+        fake_cnt--;
+        if(t.bd->fb[0] && t.px != t.bd->fb[0] && t.px != t.bd->fb[1]) t.bd->bounce_free++;
+        else lv_display_flush_ready(t.bd->disp);
+        pthread_cond_broadcast(&fake_cond);
+    }
+    return NULL;
+}
+
+/* 相当于 esp_lcd_panel_draw_bitmap: 传输排队后马上返回 */
+static void fake_draw_bitmap(bench_disp_t * bd, const lv_area_t * area, const uint8_t * px)
+{
+    pthread_mutex_lock(&fake_lock);
+    while(fake_cnt == FAKE_QUEUE_LEN) pthread_cond_wait(&fake_cond, &fake_lock);
+    fake_queue[(fake_head + fake_cnt) % FAKE_QUEUE_LEN] = (fake_trans_t) {bd, *area, px};
+    fake_cnt++;
+    pthread_cond_broadcast(&fake_cond);
+    pthread_mutex_unlock(&fake_lock);
+}
+
+/* 与 d_lcd.c 的 lcd_flush_wait_cb 相同: 阻塞到传输完成 */
+static void flush_wait_cb(lv_display_t * disp)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    render_pause(bd);
+    pthread_mutex_lock(&fake_lock);
+    while(disp->flushing) pthread_cond_wait(&fake_cond, &fake_lock);
+    pthread_mutex_unlock(&fake_lock);
+    render_resume(bd);
+}
+
+/* 原来的 disp_flush: RGB565 缓冲原地交换成屏幕字节序再发送 */
+static void flush_swap(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    double t0 = cpu_sec();
+    lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    bd->stats.swap_sec += cpu_sec() - t0;
+    fake_draw_bitmap(bd, area, px_map);
+}
+
+/* 与 d_lcd.c 的 disp_flush 相同: 缓冲已是屏幕字节序，直接发送 */
+static void flush_partial(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    fake_draw_bitmap(bd, area, px_map);
+}
+
+/* 与 d_lcd.c 的 disp_flush_direct 相同 */
+static void flush_direct(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    uint32_t stride = lv_draw_buf_width_to_stride(LCD_H_RES, bd->cf);
+    uint32_t line_size = lv_area_get_width(area) * 2;
+    int32_t lines = LCD_H_RES * DRAW_BUF_LINES * 2 / line_size;
+    const uint8_t * src = px_map + area->y1 * stride + area->x1 * 2;
+    for(int32_t y = area->y1; y <= area->y2; y += lines) {
+        int32_t h = LV_MIN(lines, area->y2 - y + 1);
+        pthread_mutex_lock(&fake_lock);
+        if(bd->bounce_free == 0) {
+            pthread_mutex_unlock(&fake_lock);
+            render_pause(bd);
+            pthread_mutex_lock(&fake_lock);
+            while(bd->bounce_free == 0) pthread_cond_wait(&fake_cond, &fake_lock);
+            render_resume(bd);
+        }
+        bd->bounce_free--;
+        pthread_mutex_unlock(&fake_lock);
+        uint8_t * dst = bd->bounce[bd->bounce_index];
+        bd->bounce_index = (bd->bounce_index + 1) % BOUNCE_BUF_CNT;
+        for(int32_t i = 0; i < h; i++) {
+            memcpy(dst + i * line_size, src, line_size);
+            src += stride;
+        }
+        lv_area_t chunk = {area->x1, y, area->x2, y + h - 1};
+        fake_draw_bitmap(bd, &chunk, dst);
+    }
+    lv_display_flush_ready(disp);
+}
+
+/* 与 d_lcd.c 的 lcd_round_init 相同 */
+static void round_init(void)
+{
+    int32_t r2 = (LCD_H_RES + 2 * ROUND_MARGIN) * (LCD_H_RES + 2 * ROUND_MARGIN);
+    for(int32_t y = 0; y < LCD_V_RES; y++) {
+        int32_t dy = 2 * y + 1 - LCD_V_RES;
+        int32_t x = 0;
+        while(x < LCD_H_RES / 2 && (2 * x + 1 - LCD_H_RES) * (2 * x + 1 - LCD_H_RES) + dy * dy > r2) x++;
+        round_x1[y] = x;
+        round_x2[y] = LCD_H_RES - 1 - x;
+    }
+}
+
+/* 像素中心在屏幕的圆内，即真正能看到的像素(不含裁剪多留的边) */
+static bool round_visible(int32_t x, int32_t y)
+{
+    int32_t dx = 2 * x + 1 - LCD_H_RES, dy = 2 * y + 1 - LCD_V_RES;
+    return dx * dx + dy * dy <= LCD_H_RES * LCD_H_RES;
+}
+
+/* 与 d_lcd.c 的 lcd_round_crop 相同 */
+static bool round_crop(lv_area_t * area)
+{
+    while(area->y1 <= area->y2 && (round_x2[area->y1] < area->x1 || round_x1[area->y1] > area->x2)) area->y1++;
+    while(area->y2 >= area->y1 && (round_x2[area->y2] < area->x1 || round_x1[area->y2] > area->x2)) area->y2--;
+    if(area->y1 > area->y2) return false;
+    int32_t x1 = LCD_H_RES, x2 = -1;
+    for(int32_t y = area->y1; y <= area->y2; y++) {
+        x1 = LV_MIN(x1, round_x1[y]);
+        x2 = LV_MAX(x2, round_x2[y]);
+    }
+    area->x1 = LV_MAX(area->x1, x1);
+    area->x2 = LV_MIN(area->x2, x2);
+    return true;
+}
+
+/* 与 d_lcd.c 的 lcd_round_size 相同 */
+static uint32_t round_size(const lv_area_t * area)
+{
+    lv_area_t a = *area;
+    return round_crop(&a) ? lv_area_get_size(&a) : 0;
+}
+
+/* 与 d_lcd.c 的 lcd_round_invalidate_cb 相同 */
+static void round_invalidate_cb(lv_event_t * e)
+{
+    lv_display_t * disp = lv_event_get_current_target(e);
+    lv_area_t * area = lv_event_get_invalidated_area(e);
+    if(disp->rendering_in_progress) return;
+    lv_area_t group = *area;
+    group.y2 = LV_MIN(area->y2, group.y1 / ROUND_BAND_LINES * ROUND_BAND_LINES + ROUND_BAND_LINES - 1);
+    while(group.y2 < area->y2) {
+        lv_area_t next = group, merged = group;
+        next.y1 = group.y2 + 1;
+        next.y2 = LV_MIN(area->y2, group.y2 + ROUND_BAND_LINES);
+        merged.y2 = next.y2;
+        if(round_size(&merged) > round_size(&group) + round_size(&next) + ROUND_MERGE_PX) break;
+        group.y2 = next.y2;
+    }
+    if(group.y2 < area->y2) {
+        lv_area_t rest = *area;
+        rest.y1 = group.y2 + 1;
+        area->y2 = group.y2;
+        lv_inv_area(disp, &rest);
+    }
+    lv_area_t cropped = *area;
+    if(round_crop(&cropped)) {
+        *area = cropped;
+    }
+    else if(disp->inv_p) {
+        *area = disp->inv_areas[0];
+    }
+    else {
+        area->x2 = area->x1;
+        area->y2 = area->y1;
+    }
+}
+
+/* 比较可见圆内的显存 */
+static bool gram_equal(const bench_disp_t * ref, const bench_disp_t * bd, bool round)
+{
+    if(!round) return memcmp(ref->gram, bd->gram, sizeof(ref->gram)) == 0;
+    for(int32_t y = 0; y < LCD_V_RES; y++) {
+        for(int32_t x = round_x1[y]; x <= round_x2[y]; x++) {
+            if(round_visible(x, y) && ref->gram[y * LCD_H_RES + x] != bd->gram[y * LCD_H_RES + x]) return false;
+        }
+    }
+    return true;
+}
+
+static void disp_create(bench_disp_t * bd, bench_mode_t mode)
+{
+    memset(bd, 0, sizeof(*bd));
+    bd->cf = mode == MODE_SWAP ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_RGB565_SWAPPED;
+    bd->disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    lv_display_set_color_format(bd->disp, bd->cf);
+    lv_display_set_user_data(bd->disp, bd);
+    uint32_t small_size = LCD_H_RES * DRAW_BUF_LINES * 2;
+    if(mode == MODE_DIRECT || mode == MODE_ROUND_DIRECT) {
+        uint32_t fb_size = lv_draw_buf_width_to_stride(LCD_H_RES, bd->cf) * LCD_V_RES;
+        bd->fb[0] = malloc(fb_size);
+        bd->fb[1] = malloc(fb_size);
+        for(int i = 0; i < BOUNCE_BUF_CNT; i++) bd->bounce[i] = malloc(small_size);
+        bd->bounce_free = BOUNCE_BUF_CNT;
+        lv_display_set_buffers(bd->disp, bd->fb[0], bd->fb[1], fb_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+        lv_display_set_flush_cb(bd->disp, flush_direct);
+    }
+    else {
+        bd->fb[0] = malloc(small_size);
+        bd->fb[1] = malloc(small_size);
+        lv_display_set_buffers(bd->disp, bd->fb[0], bd->fb[1], small_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+        lv_display_set_flush_cb(bd->disp, mode == MODE_SWAP ? flush_swap : flush_partial);
+        lv_display_set_flush_wait_cb(bd->disp, flush_wait_cb);
+    }
+    if(mode == MODE_ROUND_PARTIAL || mode == MODE_ROUND_DIRECT) {
+        lv_display_add_event_cb(bd->disp, round_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    }
+    /* 与设备一样黑色背景，表情图像居中 */
+    lv_obj_t * scr = lv_display_get_screen_active(bd->disp);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    bd->img = lv_image_create(scr);
+    lv_obj_center(bd->img);
+}
+
+/* 刷新一帧并等待传输全部完成，再求这一帧渲染段与传输段的交集 */
+static void disp_refresh(bench_disp_t * bd)
+{
+    frame_spans_t * fs = &bd->spans;
+    fs->render_cnt = fs->spi_cnt = 0;
+    double t0 = cpu_sec();
+    int64_t refr_start = esp_timer_get_time();
+    render_resume(bd);
+    lv_refr_now(bd->disp);
+    render_pause(bd);
+    if(bd == &bench_disps[MODE_PARTIAL]) telemetry_record(TELEMETRY_REFR, refr_start, esp_timer_get_time(), 0);
+    bd->stats.cpu_sec += cpu_sec() - t0;
+
+    pthread_mutex_lock(&fake_lock);
+    while(fake_cnt) pthread_cond_wait(&fake_cond, &fake_lock);
+    pthread_mutex_unlock(&fake_lock);
+    for(uint32_t i = 0; i < fs->render_cnt; i++) {
+        for(uint32_t j = 0; j < fs->spi_cnt; j++) {
+            double start = LV_MAX(fs->render[i].start, fs->spi[j].start);
+            double end = LV_MIN(fs->render[i].end, fs->spi[j].end);
+            if(end > start) bd->stats.overlap_sec += end - start;
+        }
+    }
+}
+
+static void disp_reset_stats(void)
+{
+    for(int m = 0; m < MODE_CNT; m++) {
+        memset(&bench_disps[m].stats, 0, sizeof(bench_stats_t));
+    }
+}
+
+static void stats_add(bench_stats_t * dst, const bench_stats_t * src)
+{
+    dst->cpu_sec += src->cpu_sec;
+    dst->spi_sec += src->spi_sec;
+    dst->overlap_sec += src->overlap_sec;
+    dst->swap_sec += src->swap_sec;
+    dst->spi_bytes += src->spi_bytes;
+    dst->flushes += src->flushes;
+}
+
+/* 以 gif 的画布作为图像源 */
+static void canvas_dsc_init(lv_image_dsc_t * dsc, const gif_dec_t * gif)
+{
+    memset(dsc, 0, sizeof(*dsc));
+    dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc->header.flags = LV_IMAGE_FLAGS_MODIFIABLE;
+    dsc->header.cf = gif->cf;
+    dsc->header.w = gif->width;
+    dsc->header.h = gif->height;
+    dsc->header.stride = gif->width * gif_dec_canvas_bpp(gif);
+    dsc->data_size = gif_dec_canvas_size(gif);
+    dsc->data = gif->canvas;
+}
+
+/**
+ * 各模式同时播放一个GIF，返回帧数，显存与 swap 模式不一致返回-1
+ * swap 模式用 RGB565 画布，其它模式用 RGB565_SWAPPED 画布，两个解码器同步逐帧解码。
+ * 第0帧之前的整屏刷新单独计入各模式的 full 统计
+ * @param duration_ms 输出GIF一遍的总时长
+ */
+static int play(const char * name, const void * data, uint32_t * duration_ms)
+{
+    gif_dec_t * gifs[MODE_CNT] = {NULL};
+    static lv_image_dsc_t dscs[MODE_CNT];
+    int frames = 0;
+    *duration_ms = 0;
+    for(int m = 0; m < MODE_CNT; m++) {
+        /* swap 以外的模式格式相同，共用一个解码器 */
+        if(m > MODE_PARTIAL) {
+            gifs[m] = gifs[MODE_PARTIAL];
+            dscs[m] = dscs[MODE_PARTIAL];
+            continue;
+        }
+        gifs[m] = gif_dec_open_data(data, bench_disps[m].cf, NULL, 0);
+        if(gifs[m] == NULL) {
+            printf("%s: open failed\n", name);
+            frames = -1;
+            goto out;
+        }
+        canvas_dsc_init(&dscs[m], gifs[m]);
+    }
+    gif_dec_t * gif = gifs[MODE_PARTIAL];
+
+    /* 第0帧之前先整屏刷新一次，只计入 full 统计 */
+    disp_reset_stats();
+    for(int m = 0; m < MODE_CNT; m++) {
+        lv_image_set_src(bench_disps[m].img, &dscs[m]);
+        lv_obj_invalidate(lv_display_get_screen_active(bench_disps[m].disp));
+        disp_refresh(&bench_disps[m]);
+        stats_add(&bench_disps[m].full, &bench_disps[m].stats);
+    }
+    disp_reset_stats();
+
+    while(1) {
+        /* 与 emoji_gif 的 decode_frame 相同: 本帧矩形，上一帧需要恢复背景或恢复到之前时并上上一帧矩形 */
+        lv_area_t prev = {gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1};
+        bool prev_restored = gif->gce.disposal == 2 || gif->gce.disposal == 3;
+        int64_t frame_start = esp_timer_get_time();
+        int res = gif_dec_get_frame(gif);
+        if(gif_dec_get_frame(gifs[MODE_SWAP]) != res) {
+            printf("%s: frame %d decodes differently in RGB565\n", name, frames);
+            frames = -1;
+            goto out;
+        }
+        if(res <= 0) break;
+        gif->loop_count = gifs[MODE_SWAP]->loop_count = 1;
+        gif_dec_render_frame(gif, gif->canvas);
+        gif_dec_render_frame(gifs[MODE_SWAP], gifs[MODE_SWAP]->canvas);
+        lv_area_t area = {gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1};
+        if(prev_restored) lv_area_join(&area, &area, &prev);
+        telemetry_record(TELEMETRY_FRAME, frame_start, esp_timer_get_time(), lv_area_get_size(&area));
+        *duration_ms += gif->gce.delay > 1 ? gif->gce.delay * 10 : 100;
+
+        for(int m = 0; m < MODE_CNT; m++) {
+            lv_obj_t * img = bench_disps[m].img;
+            lv_area_t coords, abs_area = area;
+            lv_obj_get_coords(img, &coords);
+            lv_area_move(&abs_area, coords.x1, coords.y1);
+            lv_image_cache_drop(&dscs[m]);
+            lv_obj_invalidate_area(img, &abs_area);
+            disp_refresh(&bench_disps[m]);
+        }
+        for(int m = MODE_PARTIAL; m < MODE_CNT; m++) {
+            bool round = m == MODE_ROUND_PARTIAL || m == MODE_ROUND_DIRECT;
+            if(!gram_equal(&bench_disps[MODE_SWAP], &bench_disps[m], round)) {
+                printf("%s: frame %d of %s differs from swap\n", name, frames, mode_names[m]);
+                frames = -1;
+                goto out;
+            }
+        }
+        frames++;
+    }
+out:
+    for(int m = 0; m <= MODE_PARTIAL; m++) {
+        if(gifs[m]) gif_dec_close(gifs[m]);
+    }
+    for(int m = 0; m < MODE_CNT; m++) lv_image_set_src(bench_disps[m].img, NULL);
+    return frames;
+}
+
+static void print_row(const char * name, int frames, uint32_t duration_ms, bench_mode_t mode, const bench_stats_t * st)
+{
+    double cpu_ms = st->cpu_sec * 1000 / frames;
+    double spi_ms = st->spi_bytes * 8 * 1000.0 / SPI_CLOCK_HZ / frames;
+    double overlap_ms = st->overlap_sec * 1000 / frames;
+    double swap_us = st->swap_sec * 1e6 / frames;
+    double fps = 1000 / LV_MAX(cpu_ms, spi_ms);
+    double load = duration_ms ? st->cpu_sec * 1000 * 100 / duration_ms : 0;
+    printf("%-16s %-8s %6d %9.3f %9.1f %9.1f %8.1f %9.2f %9.3f %8.0f %7.2f%%\n", name, mode_names[mode], frames,
+           cpu_ms, swap_us, st->spi_bytes / 1024.0 / frames, (double)st->flushes / frames, spi_ms, overlap_ms, fps, load);
+}
+
+/* 圆屏裁剪前后每帧的CPU时间和SPI字节数 */
+static void round_summary(const char * what, int frames, const bench_stats_t * st)
+{
+    for(int m = MODE_ROUND_PARTIAL; m <= MODE_ROUND_DIRECT; m++) {
+        const bench_stats_t * off = &st[m == MODE_ROUND_PARTIAL ? MODE_PARTIAL : MODE_DIRECT];
+        const bench_stats_t * on = &st[m];
+        printf("%s %s: cpu %.1f -> %.1f us/frame (%.1f%%), spi %.1f -> %.1f KB/frame (%.1f%%)\n",
+               mode_names[m], what, off->cpu_sec * 1e6 / frames, on->cpu_sec * 1e6 / frames,
+               (on->cpu_sec - off->cpu_sec) * 100 / off->cpu_sec,
+               off->spi_bytes / 1024.0 / frames, on->spi_bytes / 1024.0 / frames,
+               ((double)on->spi_bytes - off->spi_bytes) * 100 / off->spi_bytes);
+    }
+}
+
+static void * telemetry_bench_thread(void * arg)
+{
+    double * cpu = arg;
+    double t0 = cpu_sec();
+    for(uint32_t i = 0; i < TELEMETRY_BENCH_EVENTS; i++) telemetry_record(TELEMETRY_FLUSH, i, i + (i & 0xfff), i);
+    *cpu = cpu_sec() - t0;
+    return NULL;
+}
+
+/* threads 个线程同时记录，返回每个事件的平均CPU时间(ns) */
+static double telemetry_bench(int threads)
+{
+    pthread_t tids[2];
+    double cpu[2];
+    double sum = 0;
+    for(int i = 0; i < threads; i++) pthread_create(&tids[i], NULL, telemetry_bench_thread, &cpu[i]);
+    for(int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+        sum += cpu[i];
+    }
+    return sum * 1e9 / threads / TELEMETRY_BENCH_EVENTS;
+}
+
+/**
+ * 检查 max_us 的语义并计时 telemetry_record，每帧的事件数取自播放时 partial 模式记录的事件
+ * @return 检查通过返回 true
+ */
+static bool telemetry_report(int frames, const bench_stats_t * partial)
+{
+    static telemetry_snapshot_t snap;
+    uint32_t events = 0;
+    telemetry_snapshot(&snap, 0, false);
+    for(int i = 0; i < TELEMETRY_TYPE_CNT; i++) events += snap.hist[i].count;
+    uint32_t max = snap.hist[TELEMETRY_REFR].max_us;
+    telemetry_snapshot(&snap, 0, false);
+    bool kept = max > 0 && snap.hist[TELEMETRY_REFR].max_us == max;
+    telemetry_snapshot(&snap, 0, true);
+    telemetry_snapshot(&snap, 0, false);
+    bool cleared = snap.hist[TELEMETRY_REFR].max_us == 0;
+    printf("telemetry max_us: %s after a plain query, %s after reset_max\n", kept ? "kept" : "LOST",
+           cleared ? "cleared" : "NOT cleared");
+
+    double ns1 = telemetry_bench(1), ns2 = telemetry_bench(2);
+    double per_frame = (double)events / frames;
+    double frame_us = per_frame * ns2 / 1000;
+    printf("telemetry: %.1f ns/event (1 thread), %.1f ns/event (2 threads), %.1f events/frame -> %.2f us/frame "
+           "(%.2f%% of partial cpu)\n", ns1, ns2, per_frame, frame_us, frame_us * 100 / (partial->cpu_sec * 1e6 / frames));
+    return kept && cleared;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * dir_path = argc > 1 ? argv[1] : "main/spiffs/gif";
+    static char names[BENCH_MAX_FILES][BENCH_NAME_LEN];
+    int name_cnt = 0;
+
+    DIR * dir = opendir(dir_path);
+    if(dir == NULL) {
+        printf("open %s failed\n", dir_path);
+        return 1;
+    }
+    struct dirent * ent;
+    while((ent = readdir(dir)) != NULL && name_cnt < BENCH_MAX_FILES) {
+        size_t len = strlen(ent->d_name);
+        if(len > 4 && len < BENCH_NAME_LEN && strcmp(&ent->d_name[len - 4], ".gif") == 0) {
+            strcpy(names[name_cnt++], ent->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, name_cnt, BENCH_NAME_LEN, name_cmp);
+
+    lv_init();
+    round_init();
+    for(int m = 0; m < MODE_CNT; m++) disp_create(&bench_disps[m], m);
+    pthread_t dma;
+    pthread_create(&dma, NULL, fake_dma_thread, NULL);
+
+    printf("%-16s %-8s %6s %9s %9s %9s %8s %9s %9s %8s %8s\n", "file", "mode", "frames", "cpu ms/f", "swap us/f", "spi KB/f",
+           "flush/f", "spi ms/f", "overlap", "max fps", "cpu");
+    bench_stats_t total[MODE_CNT] = {0};
+    uint32_t total_ms = 0;
+    int frame_total = 0, gif_total = 0, fail = 0;
+    for(int i = 0; i < name_cnt; i++) {
+        char path[512];
+        long size;
+        snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+        void * data = load_file(path, &size);
+        if(data == NULL) {
+            printf("%s: read failed\n", names[i]);
+            fail = 1;
+            continue;
+        }
+        uint32_t duration_ms;
+        int frames = play(names[i], data, &duration_ms);
+        free(data);
+        if(frames <= 0) {
+            fail |= frames < 0;
+            continue;
+        }
+        for(int m = 0; m < MODE_CNT; m++) {
+            print_row(names[i], frames, duration_ms, m, &bench_disps[m].stats);
+            stats_add(&total[m], &bench_disps[m].stats);
+        }
+        frame_total += frames;
+        gif_total++;
+        total_ms += duration_ms;
+    }
+    if(frame_total > 0) {
+        for(int m = 0; m < MODE_CNT; m++) {
+            print_row("total", frame_total, total_ms, m, &total[m]);
+        }
+        /* partial 与 swap 只差 flush 里的字节交换和画布格式，两者CPU时间之差就是每帧省下的时间 */
+        double swap_cpu_us = total[MODE_SWAP].cpu_sec * 1e6 / frame_total;
+        double partial_cpu_us = total[MODE_PARTIAL].cpu_sec * 1e6 / frame_total;
+        printf("swap pass %.1f us/frame over %.1f KB; partial without it %.1f us/frame, saved %.1f us/frame (%.1f%%)\n",
+               total[MODE_SWAP].swap_sec * 1e6 / frame_total, total[MODE_SWAP].spi_bytes / 1024.0 / frame_total,
+               partial_cpu_us, swap_cpu_us - partial_cpu_us, (swap_cpu_us - partial_cpu_us) * 100 / swap_cpu_us);
+        for(int m = 0; m < MODE_CNT; m++) {
+            print_row("full", gif_total, 0, m, &bench_disps[m].full);
+        }
+        round_summary("animation", frame_total, total);
+        bench_stats_t full[MODE_CNT];
+        for(int m = 0; m < MODE_CNT; m++) full[m] = bench_disps[m].full;
+        round_summary("full-screen", gif_total, full);
+        if(!telemetry_report(frame_total, &total[MODE_PARTIAL])) fail = 1;
+    }
+    printf("%s\n", fail ? "FAIL: panel content differs from the RGB565 + swap reference or telemetry check failed"
+           : "all modes produce the same visible panel content as RGB565 + swap");
+    lv_deinit();
+    return fail;
+}
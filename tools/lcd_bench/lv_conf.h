@@ -0,0 +1,14 @@
+/**
+ * lcd_bench 使用的 LVGL 配置，与 gif_bench 相同，其余取默认值
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_USE_OS                   LV_OS_NONE
+#define LV_USE_LOG                  0
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * pack_bench 使用的 LVGL 配置，打开对比用的 lv_gif，其余取默认值
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_USE_OS                   LV_OS_NONE
+#define LV_USE_LOG                  0
+
+/* 与设备上 LV_GIF_CACHE_DECODE_DATA 的默认值一致 */
+#define LV_USE_GIF                  1
+#define LV_GIF_CACHE_DECODE_DATA    0
+
+#endif
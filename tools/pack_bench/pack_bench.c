@@ -0,0 +1,321 @@
+/**
+ * 帧包播放(emoji_pack)与 lv_gif 的主机端CPU对比
+ * 两个假屏(240x240，20行缓冲，与设备一样按 RGB565_SWAPPED 渲染)分别用 lv_gif 播放GIF、用 emoji_pack 播放
+ * gif2pack.py 转出的同名帧包(都从内存读取)，每个表情各播放一遍:
+ *   lv_gif:  每帧 LZW 解码成 ARGB8888 画布，整个对象失效，按 ARGB8888 混合到屏幕
+ *   pack:    每帧把变化的矩形拷贝进 RGB565_SWAPPED 画布，只有这个矩形失效，渲染时直接拷贝
+ * 时钟由程序推进: 每次 lv_timer_handler 后直接跳到它返回的下一个定时器时刻，不空等，
+ * 统计播放期间进程的CPU时间，其中 LVGL 刷新(渲染+flush)的部分单独统计，其余为解码(取帧)的时间。
+ * 每个表情重复播放几遍取最快的一遍。播放结束时两块假屏的显存必须逐像素一致。
+ * 输出每帧的CPU时间(总计/解码/渲染)和每帧刷新的像素数。主机CPU比ESP32-S3快得多，只看相对值。
+ * 用法: pack_bench [gif目录，默认 main/spiffs/gif] [帧包目录，默认构建目录下的 pack]
+ * 显存不一致时返回1
+ */
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include "emoji_pack.h"
+#include "telemetry.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LCD_H_RES           240
+#define LCD_V_RES           240
+#define DRAW_BUF_LINES      20
+/* 每个表情播放的遍数，取最快的一遍 */
+#define PLAY_REPEAT         5
+
+#define BENCH_MAX_FILES     64
+#define BENCH_NAME_LEN      64
+
+typedef enum {
+    PLAYER_GIF,
+    PLAYER_PACK,
+    PLAYER_CNT,
+} bench_player_t;
+
+static const char * player_names[PLAYER_CNT] = {"lv_gif", "pack"};
+
+typedef struct {
+    double cpu_sec;                       /* 播放期间进程的CPU时间 */
+    double refr_sec;                      /* 其中 LVGL 刷新的CPU时间 */
+    uint64_t px;                          /* flush 的像素数 */
+    uint32_t frames;
+} bench_stats_t;
+
+typedef struct {
+    lv_display_t * disp;
+    lv_obj_t * obj;
+    uint8_t * buf[2];
+    uint16_t gram[LCD_H_RES * LCD_V_RES]; /* 假屏显存，与渲染缓冲的字节序相同 */
+    double refr_start;
+    bool ready;
+    bench_stats_t stats;
+} bench_disp_t;
+
+static bench_disp_t bench_disps[PLAYER_CNT];
+static uint32_t bench_tick;
+
+/* emoji_pack.c 用到的固件函数 */
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return bench_tick;
+}
+
+void telemetry_record(telemetry_type_t type, int64_t start_us, int64_t end_us, uint32_t aux)
+{
+    (void)type;
+    (void)start_us;
+    (void)end_us;
+    (void)aux;
+}
+
+static double cpu_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t tick_cb(void)
+{
+    return bench_tick;
+}
+
+static void * load_file(const char * path, long * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void * data = malloc(*size);
+    if(data && fread(data, 1, *size, f) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int name_cmp(const void * a, const void * b)
+{
+    return strcmp(a, b);
+}
+
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    bench_disp_t * bd = lv_display_get_user_data(disp);
+    int32_t w = lv_area_get_width(area);
+    for(int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&bd->gram[y * LCD_H_RES + area->x1], px_map, w * 2);
+        px_map += w * 2;
+    }
+    bd->stats.px += (uint64_t)w * lv_area_get_height(area);
+    lv_display_flush_ready(disp);
+}
+
+static void refr_event_cb(lv_event_t * e)
+{
+    bench_disp_t * bd = lv_event_get_user_data(e);
+    if(lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        bd->refr_start = cpu_sec();
+    }
+    else {
+        bd->stats.refr_sec += cpu_sec() - bd->refr_start;
+    }
+}
+
+static void ready_event_cb(lv_event_t * e)
+{
+    bench_disp_t * bd = lv_event_get_user_data(e);
+    bd->ready = true;
+}
+
+static void disp_create(bench_disp_t * bd, bench_player_t player)
+{
+    memset(bd, 0, sizeof(*bd));
+    bd->disp = lv_display_create(LCD_H_RES, LCD_V_RES);
+    lv_display_set_color_format(bd->disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    lv_display_set_user_data(bd->disp, bd);
+    lv_display_set_flush_cb(bd->disp, flush_cb);
+    uint32_t size = LCD_H_RES * DRAW_BUF_LINES * 2;
+    bd->buf[0] = malloc(size);
+    bd->buf[1] = malloc(size);
+    lv_display_set_buffers(bd->disp, bd->buf[0], bd->buf[1], size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(bd->disp, refr_event_cb, LV_EVENT_REFR_START, bd);
+    lv_display_add_event_cb(bd->disp, refr_event_cb, LV_EVENT_REFR_READY, bd);
+    /* 与设备一样黑色背景，表情图像居中 */
+    lv_obj_t * scr = lv_display_get_screen_active(bd->disp);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    bd->obj = player == PLAYER_GIF ? lv_gif_create(scr) : emoji_pack_create(scr);
+    lv_obj_center(bd->obj);
+    lv_obj_add_event_cb(bd->obj, ready_event_cb, LV_EVENT_READY, bd);
+}
+
+/**
+ * 播放一遍，从设置源开始(含第0帧)到 LV_EVENT_READY，结果写入 bd->stats
+ */
+static bool play_once(bench_disp_t * bd, bench_player_t player, const void * data, uint32_t size,
+                      uint32_t frames)
+{
+    static lv_image_dsc_t gif_dsc;
+    lv_display_set_default(bd->disp);
+    memset(&bd->stats, 0, sizeof(bd->stats));
+    bd->ready = false;
+    /* 先把上一遍的刷新做完，不计入本遍 */
+    lv_refr_now(bd->disp);
+    bd->stats.px = 0;
+    bd->stats.refr_sec = 0;
+
+    double c0 = cpu_sec();
+    if(player == PLAYER_GIF) {
+        memset(&gif_dsc, 0, sizeof(gif_dsc));
+        gif_dsc.data = data;
+        gif_dsc.data_size = size;
+        lv_gif_set_src(bd->obj, &gif_dsc);
+        if(!lv_gif_is_loaded(bd->obj)) return false;
+        lv_gif_set_loop_count(bd->obj, 1);
+    }
+    else {
+        emoji_pack_set_data(bd->obj, data, size);
+        if(!emoji_pack_is_loaded(bd->obj)) return false;
+        emoji_pack_set_loop_count(bd->obj, 1);
+    }
+    /* 时钟直接跳到下一个定时器到期的时刻 */
+    while(!bd->ready) {
+        uint32_t next = lv_timer_handler();
+        bench_tick += next == LV_NO_TIMER_READY || next == 0 ? 1 : next;
+    }
+    lv_refr_now(bd->disp);
+    bd->stats.cpu_sec = cpu_sec() - c0;
+    bd->stats.frames = frames;
+    return true;
+}
+
+/**
+ * 两种播放方式各播放 PLAY_REPEAT 遍，stats 取最快的一遍，返回帧数，失败或显存不一致返回-1
+ */
+static int play(const char * name, const void * gif, uint32_t gif_size, const void * pack, uint32_t pack_size,
+                bench_stats_t * best)
+{
+    uint32_t frames = ((const emoji_pack_header_t *)pack)->frame_count;
+    for(int p = 0; p < PLAYER_CNT; p++) {
+        bench_disp_t * bd = &bench_disps[p];
+        for(int i = 0; i < PLAY_REPEAT; i++) {
+            if(!play_once(bd, p, p == PLAYER_GIF ? gif : pack, p == PLAYER_GIF ? gif_size : pack_size, frames)) {
+                printf("%s: %s open failed\n", name, player_names[p]);
+                return -1;
+            }
+            if(i == 0 || bd->stats.cpu_sec < best[p].cpu_sec) best[p] = bd->stats;
+        }
+    }
+    if(memcmp(bench_disps[PLAYER_GIF].gram, bench_disps[PLAYER_PACK].gram, sizeof(bench_disps[0].gram)) != 0) {
+        printf("%s: last frame of the pack differs from lv_gif\n", name);
+        return -1;
+    }
+    return frames;
+}
+
+static void print_row(const char * name, bench_player_t player, const bench_stats_t * st)
+{
+    printf("%-16s %-7s %6lu %9.1f %9.1f %9.1f %9lu\n", name, player_names[player], (unsigned long)st->frames,
+           st->cpu_sec * 1e6 / st->frames, (st->cpu_sec - st->refr_sec) * 1e6 / st->frames,
+           st->refr_sec * 1e6 / st->frames, (unsigned long)(st->px / st->frames));
+}
+
+static void stats_add(bench_stats_t * dst, const bench_stats_t * src)
+{
+    dst->cpu_sec += src->cpu_sec;
+    dst->refr_sec += src->refr_sec;
+    dst->px += src->px;
+    dst->frames += src->frames;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * gif_dir = argc > 1 ? argv[1] : "main/spiffs/gif";
+    const char * pack_dir = argc > 2 ? argv[2] : PACK_BENCH_DIR;
+    static char names[BENCH_MAX_FILES][BENCH_NAME_LEN];
+    static void * files[BENCH_MAX_FILES][PLAYER_CNT];
+    int name_cnt = 0;
+
+    DIR * dir = opendir(gif_dir);
+    if(dir == NULL) {
+        printf("open %s failed\n", gif_dir);
+        return 1;
+    }
+    struct dirent * ent;
+    while((ent = readdir(dir)) != NULL && name_cnt < BENCH_MAX_FILES) {
+        size_t len = strlen(ent->d_name);
+        if(len > 4 && len < BENCH_NAME_LEN && strcmp(&ent->d_name[len - 4], ".gif") == 0) {
+            strcpy(names[name_cnt], ent->d_name);
+            names[name_cnt++][len - 4] = '\0';
+        }
+    }
+    closedir(dir);
+    qsort(names, name_cnt, BENCH_NAME_LEN, name_cmp);
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    for(int p = 0; p < PLAYER_CNT; p++) disp_create(&bench_disps[p], p);
+
+    printf("%-16s %-7s %6s %9s %9s %9s %9s\n", "file", "player", "frames", "cpu us/f", "dec us/f", "refr us/f",
+           "px/f");
+    bench_stats_t total[PLAYER_CNT] = {0};
+    int fail = 0;
+    for(int i = 0; i < name_cnt; i++) {
+        char path[512];
+        long gif_size, pack_size;
+        snprintf(path, sizeof(path), "%s/%s.gif", gif_dir, names[i]);
+        void * gif = load_file(path, &gif_size);
+        snprintf(path, sizeof(path), "%s/%s.epk", pack_dir, names[i]);
+        void * pack = load_file(path, &pack_size);
+        if(gif == NULL || pack == NULL) {
+            printf("%s: read failed\n", names[i]);
+            fail = 1;
+            free(gif);
+            free(pack);
+            continue;
+        }
+        /* 对象在下一次设置源之前还引用着这次的数据，全部测完再释放 */
+        files[i][PLAYER_GIF] = gif;
+        files[i][PLAYER_PACK] = pack;
+        bench_stats_t best[PLAYER_CNT];
+        int frames = play(names[i], gif, gif_size, pack, pack_size, best);
+        if(frames <= 0) {
+            fail = 1;
+            continue;
+        }
+        for(int p = 0; p < PLAYER_CNT; p++) {
+            print_row(names[i], p, &best[p]);
+            stats_add(&total[p], &best[p]);
+        }
+    }
+    if(total[PLAYER_GIF].frames > 0) {
+        for(int p = 0; p < PLAYER_CNT; p++) print_row("total", p, &total[p]);
+        double gif_us = total[PLAYER_GIF].cpu_sec * 1e6 / total[PLAYER_GIF].frames;
+        double pack_us = total[PLAYER_PACK].cpu_sec * 1e6 / total[PLAYER_PACK].frames;
+        printf("pack vs lv_gif: cpu %.1f -> %.1f us/frame (%.1f%%), refreshed px %.0f -> %.0f per frame\n",
+               gif_us, pack_us, (pack_us - gif_us) * 100 / gif_us,
+               (double)total[PLAYER_GIF].px / total[PLAYER_GIF].frames,
+               (double)total[PLAYER_PACK].px / total[PLAYER_PACK].frames);
+    }
+    printf("%s\n", fail ? "FAIL: pack output differs from lv_gif" : "pack output matches lv_gif");
+    lv_deinit();
+    for(int i = 0; i < name_cnt; i++) {
+        free(files[i][PLAYER_GIF]);
+        free(files[i][PLAYER_PACK]);
+    }
+    return fail;
+}